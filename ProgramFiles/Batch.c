@@ -0,0 +1,496 @@
+/*
+  Author: Benjamin G. Friedman
+  Date: 10/18/2026
+  File: Batch.c
+  Description:
+	  - Implementation file for the batch interface. A script runs every job in the same process, so a pipeline pays
+		for starting the program once instead of once per job.
+*/
+
+
+#define _DEFAULT_SOURCE        // getline
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <limits.h>
+#include <float.h>
+#include "Batch.h"
+
+
+#define MAX_JOB_WORDS 256              // most words in one line of a script
+
+
+
+
+/***** Structures *****/
+typedef enum batchOperationType {
+	BATCH_MULTIPLY, BATCH_ADD, BATCH_SUBTRACT, BATCH_POWER, BATCH_TRANSPOSE,
+	BATCH_DETERMINANT, BATCH_INVERSE, BATCH_SOLVE, BATCH_LEAST_SQUARES, BATCH_CHOLESKY
+} BatchOperationType;
+
+typedef struct batchOperation {
+	const char* name;                  // name of the operation in a job
+	BatchOperationType type;
+	int minOperands;                   // matrices the operation takes
+	int maxOperands;                   // -1 for any number of matrices
+	Boolean takesPower;                // a positive integer follows the matrices
+} BatchOperation;
+
+
+
+
+/***** Global variables *****/
+static const BatchOperation batchOperations[] = {
+	{ "multiply", BATCH_MULTIPLY, 2, 2, FALSE },
+	{ "add", BATCH_ADD, 2, -1, FALSE },
+	{ "subtract", BATCH_SUBTRACT, 2, -1, FALSE },
+	{ "power", BATCH_POWER, 1, 1, TRUE },
+	{ "transpose", BATCH_TRANSPOSE, 1, 1, FALSE },
+	{ "determinant", BATCH_DETERMINANT, 1, 1, FALSE },
+	{ "inverse", BATCH_INVERSE, 1, 1, FALSE },
+	{ "solve", BATCH_SOLVE, 2, 2, FALSE },
+	{ "leastsquares", BATCH_LEAST_SQUARES, 2, 2, FALSE },
+	{ "cholesky", BATCH_CHOLESKY, 1, 1, FALSE }
+};
+static const int batchOperationsSize = sizeof(batchOperations) / sizeof(*batchOperations);
+
+static const char* programName;        // argv[0], the prefix of every error message
+
+
+
+
+/***** Helper functions used only in this file *****/
+/*
+PRECONDITION
+  - None.
+POSTCONDITION
+  - Prints how to use the batch interface on stderr.
+*/
+static void printUsage(void);
+
+
+/*
+PRECONDITION
+  - path is the name of the script to run, "-" for stdin.
+POSTCONDITION
+  - Runs every job in the script and returns SUCCESS, else FAILURE if the script couldn't be read or any job failed.
+*/
+static Status runScript(const char* path);
+
+
+/*
+PRECONDITION
+  - words is an array of wordsSize words making up a job, the same as for batch_parseJob.
+  - job describes where the job came from for error messages, or is NULL for the command line.
+POSTCONDITION
+  - Runs the job and writes its result. Returns SUCCESS, else FAILURE after reporting the error.
+*/
+static Status runJob(char* words[], int wordsSize, const char* job);
+
+
+/*
+PRECONDITION
+  - name is the name of an operation.
+POSTCONDITION
+  - Returns a pointer to the operation with the name, else NULL if there isn't one.
+*/
+static const BatchOperation* findOperation(const char* name);
+
+
+/*
+PRECONDITION
+  - pOperation is a pointer to an operation.
+  - operandsSize is the number of matrices it's given.
+  - error is an array of at least BATCH_ERROR_SIZE characters.
+POSTCONDITION
+  - Returns SUCCESS if the operation takes that many matrices, else writes why not to error and returns FAILURE.
+*/
+static Status checkOperandsSize(const BatchOperation* pOperation, int operandsSize, char* error);
+
+
+/*
+PRECONDITION
+  - job is the same as for runJob.
+  - format/... are the error message, the same as for printf.
+POSTCONDITION
+  - Prints the error message on stderr and returns FAILURE.
+*/
+static Status reportError(const char* job, const char* format, ...);
+
+
+
+
+/***** Functions declared in Batch.h *****/
+int batch_run(int argc, char* argv[]) {
+	programName = argv[0];
+
+	if (argc >= 3 && !strcmp(argv[1], "--op"))
+		return runJob(argv + 2, argc - 2, NULL) ? 0 : 1;
+	if (argc == 3 && !strcmp(argv[1], "--script"))
+		return runScript(argv[2]) ? 0 : 1;
+
+	printUsage();
+	return 2;
+}
+
+
+
+Status batch_parseJob(char* words[], int wordsSize, BatchJob* pJob, char* error) {
+	const BatchOperation* pOperation = findOperation(words[0]);
+	int operandsSize = 0;              // the operands are moved to the front of words after the operation
+	long power = 0;
+
+	if (!pOperation) {
+		snprintf(error, BATCH_ERROR_SIZE, "unknown operation %.64s", words[0]);
+		return FAILURE;
+	}
+	pJob->output = NULL;
+	for (int i = 1; i < wordsSize; ++i) {
+		if (strcmp(words[i], "-o"))
+			words[1 + operandsSize++] = words[i];
+		else if (pJob->output || ++i == wordsSize) {
+			snprintf(error, BATCH_ERROR_SIZE, "-o takes a single output file");
+			return FAILURE;
+		}
+		else
+			pJob->output = words[i];
+	}
+
+	// the power comes after the matrices
+	if (pOperation->takesPower) {
+		char* end;
+		if (operandsSize == 0) {
+			snprintf(error, BATCH_ERROR_SIZE, "%s needs a power", pOperation->name);
+			return FAILURE;
+		}
+		power = strtol(words[operandsSize], &end, 10);
+		if (*end != '\0' || end == words[operandsSize] || power < 1 || power > INT_MAX) {
+			snprintf(error, BATCH_ERROR_SIZE, "the power %.64s isn't a positive integer", words[operandsSize]);
+			return FAILURE;
+		}
+		--operandsSize;
+	}
+	if (!checkOperandsSize(pOperation, operandsSize, error))
+		return FAILURE;
+
+	pJob->operation = pOperation->name;
+	pJob->operands = words + 1;
+	pJob->operandsSize = operandsSize;
+	pJob->power = (int)power;
+
+	return SUCCESS;
+}
+
+
+
+Status batch_compute(const char* operation, MATRIX* hOperands, int hOperandsSize, int power, MATRIX* phResult,
+	long double* pNumber, char* error) {
+	const BatchOperation* pOperation = findOperation(operation);
+	Status status = SUCCESS;           // result of the operation itself
+	Boolean isVertible = TRUE;         // the operation found the matrix is singular
+	Boolean isPositiveDefinite = TRUE;
+	size_t rank;
+	MATRIX hGiven = *phResult;         // matrix object the caller wants the result stored in
+
+	if (!pOperation) {
+		snprintf(error, BATCH_ERROR_SIZE, "unknown operation %.64s", operation);
+		return FAILURE;
+	}
+	if (!checkOperandsSize(pOperation, hOperandsSize, error))
+		return FAILURE;
+	if (pOperation->takesPower && power < 1) {
+		snprintf(error, BATCH_ERROR_SIZE, "the power %d isn't a positive integer", power);
+		return FAILURE;
+	}
+
+	// operations on square matrices
+	switch (pOperation->type) {
+	case BATCH_POWER:
+	case BATCH_DETERMINANT:
+	case BATCH_INVERSE:
+	case BATCH_SOLVE:
+	case BATCH_CHOLESKY:
+		if (matrix_getRows(hOperands[0]) != matrix_getColumns(hOperands[0])) {
+			snprintf(error, BATCH_ERROR_SIZE, "%s needs a square matrix", pOperation->name);
+			return FAILURE;
+		}
+		break;
+	default:
+		break;
+	}
+
+	switch (pOperation->type) {
+	case BATCH_MULTIPLY:
+		if (!matrix_canBeMultipliedM(hOperands[0], hOperands[1])) {
+			snprintf(error, BATCH_ERROR_SIZE, "the dimensions don't allow multiplication");
+			return FAILURE;
+		}
+		status = matrix_multiply(hOperands[0], hOperands[1], phResult);
+		break;
+	case BATCH_ADD:
+	case BATCH_SUBTRACT:
+		for (int i = 1; i < hOperandsSize; ++i) {
+			if (!matrix_canBeAdded(hOperands[0], hOperands[i])) {
+				snprintf(error, BATCH_ERROR_SIZE, "the matrices don't all have the same dimensions");
+				return FAILURE;
+			}
+		}
+		status = (pOperation->type == BATCH_ADD) ? matrix_add(hOperands, hOperandsSize, phResult)
+			: matrix_subtract(hOperands, hOperandsSize, phResult);
+		break;
+	case BATCH_POWER:
+		status = matrix_power(hOperands[0], power, phResult);
+		break;
+	case BATCH_TRANSPOSE:
+		status = matrix_transpose(hOperands[0], phResult);
+		break;
+	case BATCH_DETERMINANT:
+		*pNumber = matrix_determinant(hOperands[0], &status);
+		break;
+	case BATCH_INVERSE:
+		status = matrix_inverse(hOperands[0], phResult, &isVertible);
+		break;
+	case BATCH_SOLVE:
+	case BATCH_LEAST_SQUARES:
+		if (matrix_getRows(hOperands[1]) != matrix_getRows(hOperands[0])) {
+			snprintf(error, BATCH_ERROR_SIZE, "the right hand side doesn't have as many rows as the matrix");
+			return FAILURE;
+		}
+		status = (pOperation->type == BATCH_SOLVE) ? matrix_solve(hOperands[0], hOperands[1], phResult, &isVertible)
+			: matrix_leastSquaresPivoted(hOperands[0], hOperands[1], phResult, &rank);
+		break;
+	case BATCH_CHOLESKY:
+		status = matrix_cholesky(hOperands[0], phResult, &isPositiveDefinite);
+		break;
+	}
+
+	if (!status) {
+		if (*phResult && !hGiven)
+			matrix_destroy(phResult);
+		if (!isVertible)
+			snprintf(error, BATCH_ERROR_SIZE, "the matrix is singular");
+		else if (!isPositiveDefinite)
+			snprintf(error, BATCH_ERROR_SIZE, "the matrix isn't symmetric positive definite");
+		else
+			snprintf(error, BATCH_ERROR_SIZE, "memory allocation failure");
+	}
+
+	return status;
+}
+
+
+
+Boolean batch_resultIsNumber(const char* operation) {
+	const BatchOperation* pOperation = findOperation(operation);
+	return (pOperation && pOperation->type == BATCH_DETERMINANT) ? TRUE : FALSE;
+}
+
+
+
+MATRIX batch_readMatrix(const char* path) {
+	size_t length = strlen(path);
+	MATRIX hMatrix;
+	FILE* fp;
+
+	// matrix files are recognized by their header, anything else is picked by its extension
+	if ((hMatrix = matrix_load(path, TRUE)))
+		return hMatrix;
+	if (length >= 4 && !strcmp(path + length - 4, ".npy"))
+		return matrix_loadNpy(path);
+	if (length >= 4 && !strcmp(path + length - 4, ".csv"))
+		return matrix_loadCsv(path, 0);
+	if (!(fp = fopen(path, "r")))
+		return NULL;
+	if (length >= 4 && !strcmp(path + length - 4, ".mtx"))
+		hMatrix = matrix_initFromMatrixMarket(fp);
+	else
+		hMatrix = matrix_initFromText(fp);
+	fclose(fp);
+
+	return hMatrix;
+}
+
+
+
+Status batch_writeMatrix(MATRIX hMatrix, const char* output) {
+	size_t length = output ? strlen(output) : 0;
+	FILE* fp;
+
+	if (!output)
+		return (matrix_writeText(hMatrix, stdout, MATRIX_TEXT_PLAIN) && !fflush(stdout)) ? SUCCESS : FAILURE;
+	if (length >= 4 && !strcmp(output + length - 4, ".bin"))
+		return matrix_save(hMatrix, output);
+	if (length >= 4 && !strcmp(output + length - 4, ".npy"))
+		return matrix_saveNpy(hMatrix, output, MATRIX_NPY_FLOAT64);
+	if (length >= 4 && !strcmp(output + length - 4, ".csv"))
+		return matrix_saveCsv(hMatrix, output, 0);
+
+	// the extension picks the text format
+	Boolean matrixMarket = length >= 4 && !strcmp(output + length - 4, ".mtx");
+	MatrixTextFormat format = MATRIX_TEXT_PLAIN;
+	if (length >= 4 && !strcmp(output + length - 4, ".tsv"))
+		format = MATRIX_TEXT_TSV;
+	if (!(fp = fopen(output, "w")))
+		return FAILURE;
+	Status status = matrixMarket ? matrix_writeMatrixMarket(hMatrix, fp, MATRIX_MARKET_COORDINATE, FALSE)
+		: matrix_writeText(hMatrix, fp, format);
+	if (fclose(fp))
+		status = FAILURE;
+
+	return status;
+}
+
+
+
+Status batch_writeNumber(long double number, const char* output) {
+	FILE* fp = output ? fopen(output, "w") : stdout;
+
+	if (!fp)
+		return FAILURE;
+	Status status = (fprintf(fp, "%.*Lg\n", LDBL_DECIMAL_DIG, number) < 0) ? FAILURE : SUCCESS;
+	if (fp == stdout ? fflush(fp) : fclose(fp))
+		status = FAILURE;
+
+	return status;
+}
+
+
+
+
+/***** Helper functions used only in this file *****/
+static void printUsage(void) {
+	fprintf(stderr, "Usage: %s\n", programName);
+	fprintf(stderr, "       %s --op <operation> <operands> [-o <output>]\n", programName);
+	fprintf(stderr, "       %s --script <file>\n", programName);
+	fprintf(stderr, "       %s --daemon <socket> [--workers <n>] [--queue <n>] [--timeout <ms>] [--max-bytes <n>] [--cache <n>]\n", programName);
+	fprintf(stderr, "       %s --client <socket> [--timeout <ms>] [--repeat <n>] <operation> <operands> [-o <output>]\n", programName);
+	fprintf(stderr, "       %s --distributed [--processes <n>] [--transport shm|tcp] [--block <n>] <A> <B> [-o <output>]\n", programName);
+	fprintf(stderr, "       %s --distributed --rank <r> --hosts <host:port>,... [--block <n>] <A> <B> [-o <output>]\n\n", programName);
+	fprintf(stderr, "Without arguments the interactive menu is displayed. A script has one job per line, written the same as\n");
+	fprintf(stderr, "the arguments after --op, and \"-\" reads it from stdin. The daemon does the jobs sent to it by clients over\n");
+	fprintf(stderr, "a Unix domain socket until it's sent SIGINT or SIGTERM. --distributed multiplies A by B with a group of\n");
+	fprintf(stderr, "processes, on this machine or one at each host, that each hold only their blocks of the matrices.\n");
+	fprintf(stderr, "Operations:");
+	for (int i = 0; i < batchOperationsSize; ++i)
+		fprintf(stderr, " %s", batchOperations[i].name);
+	fprintf(stderr, "\nOperands are matrix files, NumPy (.npy), CSV (.csv), Matrix Market (.mtx) or text files. Outputs\n");
+	fprintf(stderr, "ending in \".bin\" are matrix files, \".npy\" float64 NumPy files, \".mtx\" Matrix Market files and\n");
+	fprintf(stderr, "anything else is text.\n");
+}
+
+
+
+static Status runScript(const char* path) {
+	FILE* fp = strcmp(path, "-") ? fopen(path, "r") : stdin;
+	char* line = NULL;                 // each line of the script, grown by getline as needed
+	size_t lineCapacity = 0;
+	size_t lineNumber = 0;
+	char* words[MAX_JOB_WORDS];
+	char job[64];                      // "line n" for error messages
+	Status status = SUCCESS;
+
+	if (!fp)
+		return reportError(NULL, "can't open the script %s", path);
+
+	while (getline(&line, &lineCapacity, fp) != -1) {
+		int wordsSize = 0;
+		++lineNumber;
+		sprintf(job, "line %zu", lineNumber);
+
+		for (char* word = strtok(line, " \t\r\n"); word; word = strtok(NULL, " \t\r\n")) {
+			if (wordsSize == MAX_JOB_WORDS) {
+				wordsSize = -1;
+				break;
+			}
+			words[wordsSize++] = word;
+		}
+
+		if (wordsSize == -1)
+			status = reportError(job, "more than %d words", MAX_JOB_WORDS);
+		else if (wordsSize > 0 && words[0][0] != '#' && !runJob(words, wordsSize, job))
+			status = FAILURE;
+	}
+	if (ferror(fp))
+		status = reportError(NULL, "can't read the script %s", path);
+
+	free(line);
+	if (fp != stdin)
+		fclose(fp);
+
+	return status;
+}
+
+
+
+static Status runJob(char* words[], int wordsSize, const char* job) {
+	char error[BATCH_ERROR_SIZE];
+	BatchJob batchJob;
+	MATRIX hResult = NULL;
+	long double number;
+
+	if (!batch_parseJob(words, wordsSize, &batchJob, error))
+		return reportError(job, "%s", error);
+
+	MATRIX* hOperands = calloc(batchJob.operandsSize, sizeof(*hOperands));
+	if (!hOperands)
+		return reportError(job, "memory allocation failure");
+
+	Status status = SUCCESS;
+	for (int i = 0; status && i < batchJob.operandsSize; ++i)
+		if (!(hOperands[i] = batch_readMatrix(batchJob.operands[i])))
+			status = reportError(job, "can't read the matrix in %s", batchJob.operands[i]);
+	if (status && !batch_compute(batchJob.operation, hOperands, batchJob.operandsSize, batchJob.power, &hResult, &number, error))
+		status = reportError(job, "%s", error);
+	if (status && !(hResult ? batch_writeMatrix(hResult, batchJob.output) : batch_writeNumber(number, batchJob.output)))
+		status = reportError(job, "can't write the result to %s", batchJob.output ? batchJob.output : "stdout");
+
+	if (hResult)
+		matrix_destroy(&hResult);
+	for (int i = 0; i < batchJob.operandsSize; ++i)
+		if (hOperands[i])
+			matrix_destroy(&hOperands[i]);
+	free(hOperands);
+
+	return status;
+}
+
+
+
+static const BatchOperation* findOperation(const char* name) {
+	for (int i = 0; i < batchOperationsSize; ++i)
+		if (!strcmp(name, batchOperations[i].name))
+			return &batchOperations[i];
+
+	return NULL;
+}
+
+
+
+static Status checkOperandsSize(const BatchOperation* pOperation, int operandsSize, char* error) {
+	if (operandsSize >= pOperation->minOperands && (pOperation->maxOperands < 0 || operandsSize <= pOperation->maxOperands))
+		return SUCCESS;
+	if (pOperation->maxOperands < 0)
+		snprintf(error, BATCH_ERROR_SIZE, "%s takes at least %d matrices", pOperation->name, pOperation->minOperands);
+	else
+		snprintf(error, BATCH_ERROR_SIZE, "%s takes %d matri%s", pOperation->name, pOperation->minOperands,
+			(pOperation->minOperands == 1) ? "x" : "ces");
+
+	return FAILURE;
+}
+
+
+
+static Status reportError(const char* job, const char* format, ...) {
+	va_list arguments;
+
+	fprintf(stderr, "%s: ", programName);
+	if (job)
+		fprintf(stderr, "%s: ", job);
+	va_start(arguments, format);
+	vfprintf(stderr, format, arguments);
+	va_end(arguments);
+	fprintf(stderr, "\n");
+
+	return FAILURE;
+}
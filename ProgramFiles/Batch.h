@@ -0,0 +1,128 @@
+/*
+  Author: Benjamin G. Friedman
+  Date: 10/18/2026
+  File: Batch.h
+  Description:
+      - Header file for the batch interface, which runs matrix operations given on the command line or in a job script
+        without prompting or displaying anything.
+*/
+
+
+#ifndef BATCH_H
+#define BATCH_H
+
+
+#include "Matrix.h"
+
+
+/***** Global variables, macros, and structures *****/
+#define BATCH_ERROR_SIZE 256           // characters of the error messages of batch_parseJob and batch_compute
+
+// A job given as words, i.e. "multiply a.txt b.txt -o c.bin"
+typedef struct batchJob {
+    const char* operation;             // name of the operation
+    char** operands;                   // names of the files holding the matrices
+    int operandsSize;
+    int power;                         // the power for "power", else 0
+    const char* output;                // file the result goes to, NULL for stdout
+} BatchJob;
+
+
+
+
+/***** Functions defined in Batch.c *****/
+/*
+PRECONDITION
+  - argc/argv are the arguments the program was started with and argc >= 2.
+POSTCONDITION
+  - Runs the jobs given by the arguments:
+        --op <operation> <operands> [-o <output>]     runs a single job
+        --script <file>                               runs the job on each line of the file ("-" for stdin), written
+                                                      without the --op. Blank lines and lines starting with '#' are skipped.
+  - The operations are multiply A B, add A B..., subtract A B..., power A n (n a positive integer), transpose A,
+    determinant A, inverse A, solve A B (A * X = B), leastsquares A B and cholesky A.
+  - Operands are matrix files saved by matrix_save, NumPy files ending in ".npy", CSV files ending in ".csv", Matrix
+    Market files ending in ".mtx" or text files in the format of matrix_readText. Outputs ending in ".bin" are saved
+    with matrix_save, ".npy" as float64 NumPy files, ".mtx" as coordinate Matrix Market files, ".csv" and ".tsv" are
+    written as CSV and TSV and anything else is written as text in the format of matrix_readText. Without -o the
+    result goes to stdout as text.
+  - Errors are reported on stderr and the remaining jobs of a script are still run.
+  - Returns the exit status of the program: 0 if every job succeeded, 1 if any job failed and 2 for invalid arguments.
+*/
+int batch_run(int argc, char* argv[]);
+
+
+/*
+PRECONDITION
+  - words is an array of wordsSize >= 1 words making up a job: the operation, its operands, the power if the operation
+    takes one and an optional "-o <output>". The array may be reordered.
+  - pJob is a pointer to the job that receives the parts.
+  - error is an array of at least BATCH_ERROR_SIZE characters.
+POSTCONDITION
+  - Splits the words into the parts of the job, which point into words, and returns SUCCESS. Else writes what's wrong
+    with the job to error and returns FAILURE. Only the number of operands is checked, not the files.
+*/
+Status batch_parseJob(char* words[], int wordsSize, BatchJob* pJob, char* error);
+
+
+/*
+PRECONDITION
+  - operation is the name of an operation (see batch_run).
+  - hOperands is an array of hOperandsSize handles to valid matrix objects.
+  - power is the power for "power", which has to be a positive integer, ignored by the other operations.
+  - phResult/pNumber are pointers to the variables that receive the result. The variable pointed to by phResult is NULL
+    or a handle to a valid matrix object the result is stored in (a mapped one keeps its file).
+  - error is an array of at least BATCH_ERROR_SIZE characters.
+POSTCONDITION
+  - Checks the number and dimensions of the operands and runs the operation. Returns SUCCESS with the result in the
+    matrix object the variable pointed to by phResult holds (a new one if it was NULL), or the number in the variable
+    pointed to by pNumber for operations whose result is a number (see batch_resultIsNumber), which leave the variable
+    pointed to by phResult as it is.
+  - Else writes why the operation couldn't be done to error and returns FAILURE. A matrix object created for the result
+    is destroyed and the variable pointed to by phResult is NULL again, while one that was passed in is kept.
+*/
+Status batch_compute(const char* operation, MATRIX* hOperands, int hOperandsSize, int power, MATRIX* phResult,
+    long double* pNumber, char* error);
+
+
+/*
+PRECONDITION
+  - operation is the name of an operation.
+POSTCONDITION
+  - Returns TRUE if the result of the operation is a number (determinant), else FALSE, including for unknown operations.
+*/
+Boolean batch_resultIsNumber(const char* operation);
+
+
+/*
+PRECONDITION
+  - path is the name of a matrix file, NumPy file (ending in ".npy"), CSV file (ending in ".csv"), Matrix Market file
+    (ending in ".mtx") or text file.
+POSTCONDITION
+  - Returns a handle to the matrix in the file, else NULL if it couldn't be read or for any memory allocation failure.
+*/
+MATRIX batch_readMatrix(const char* path);
+
+
+/*
+PRECONDITION
+  - hMatrix is a handle to a valid matrix object.
+  - output is the name of the file to write the matrix to, NULL for stdout.
+POSTCONDITION
+  - Saves the matrix if output ends in ".bin", as a float64 NumPy file if it ends in ".npy", as a coordinate Matrix
+    Market file if it ends in ".mtx", else writes it as text. Returns SUCCESS, else FAILURE.
+*/
+Status batch_writeMatrix(MATRIX hMatrix, const char* output);
+
+
+/*
+PRECONDITION
+  - number is the result of a job.
+  - output is the name of the file to write the number to, NULL for stdout.
+POSTCONDITION
+  - Writes the number as text with enough digits to read back the same. Returns SUCCESS, else FAILURE.
+*/
+Status batch_writeNumber(long double number, const char* output);
+
+
+#endif
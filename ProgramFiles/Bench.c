@@ -0,0 +1,680 @@
+/*
+  Author: Benjamin G. Friedman
+  Date: 10/18/2026
+  File: Bench.c
+  Description:
+	  - Benchmark program for the matrix interface (make bench). Times multiply, add and subtract (of 2, 4 and 8
+		matrices), power, transpose, determinant and inverse over a sweep of sizes with square, tall and wide shapes.
+	  - Every case is run until it has taken the minimum time (and at least the minimum repetitions), storing into
+		the same result each time the way a program reusing its handles would. It reports the latency percentiles,
+		GFLOP/s and GB/s at the median latency, and the allocations made per call.
+	  - The results are printed as a table and can be written as JSON to compare builds and releases.
+	  - Allocations are counted by wrapping malloc, calloc and realloc at link time (-Wl,--wrap, see the Makefile).
+*/
+
+
+#define _DEFAULT_SOURCE        // clock_gettime, gmtime_r, sysconf(_SC_NPROCESSORS_ONLN)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <stdatomic.h>
+#include "Matrix.h"
+
+
+#define BENCH_SIZES_MAX 16             // most sizes in a sweep
+#define BENCH_REPETITIONS_MAX 100000   // most repetitions of one case
+#define BENCH_EXPONENT 4               // power the power operation is benchmarked with
+
+
+
+
+/***** Structures *****/
+typedef enum benchOperationType {
+	BENCH_MULTIPLY, BENCH_ADD, BENCH_SUBTRACT, BENCH_POWER, BENCH_TRANSPOSE, BENCH_DETERMINANT, BENCH_INVERSE
+} BenchOperationType;
+
+// Square is size x size, tall is 4 * size x size / 4 and wide is size / 4 x 4 * size, so all of them have the same
+// number of entries. Multiplying a tall or wide matrix takes a size x size matrix on the inside, i.e. tall is
+// (4 * size x size) * (size x size / 4), so it does the same number of operations as the square product.
+typedef enum benchShape { BENCH_SQUARE, BENCH_TALL, BENCH_WIDE } BenchShape;
+
+typedef struct benchOperation {
+	const char* name;
+	BenchOperationType type;
+	Boolean allShapes;                 // tall and wide shapes are benchmarked, else only square
+	Boolean variesMatrices;            // benchmarked with 2, 4 and 8 operands
+} BenchOperation;
+
+typedef struct benchCase {
+	const BenchOperation* pOperation;
+	BenchShape shape;
+	size_t rows;                       // dimensions of the first operand
+	size_t columns;
+	size_t inner;                      // columns of the second operand of a product
+	int matrices;                      // operands of add and subtract
+	double flops;                      // floating point operations of one call
+	double bytes;                      // bytes of the operands read and the result written by one call
+} BenchCase;
+
+typedef struct benchResult {
+	size_t repetitions;
+	double min;                        // seconds per call
+	double p50;
+	double p90;
+	double p99;
+	double max;
+	double mean;
+	double allocations;                // memory allocations per call
+	double allocatedBytes;             // bytes allocated per call
+} BenchResult;
+
+typedef struct benchOptions {
+	size_t sizes[BENCH_SIZES_MAX];
+	int sizesSize;
+	double minTime;                    // seconds each case runs for at least
+	size_t minRepetitions;
+	MatrixLayout layout;               // layout of the operands and results
+	const char* operation;             // only this operation is benchmarked, NULL for all of them
+	const char* jsonPath;              // file the JSON results are written to, NULL for none
+	int threads;                       // threads large factorizations run on, 0 for one per processor
+	MatrixNumaPolicy numaPolicy;       // where large matrices and the threads factoring them are placed
+} BenchOptions;
+
+
+
+
+/***** Global variables *****/
+static const BenchOperation benchOperations[] = {
+	{ "multiply", BENCH_MULTIPLY, TRUE, FALSE },
+	{ "add", BENCH_ADD, TRUE, TRUE },
+	{ "subtract", BENCH_SUBTRACT, TRUE, TRUE },
+	{ "power", BENCH_POWER, FALSE, FALSE },
+	{ "transpose", BENCH_TRANSPOSE, TRUE, FALSE },
+	{ "determinant", BENCH_DETERMINANT, FALSE, FALSE },
+	{ "inverse", BENCH_INVERSE, FALSE, FALSE }
+};
+static const int benchOperationsSize = sizeof(benchOperations) / sizeof(*benchOperations);
+static const char* const shapeNames[] = { "square", "tall", "wide" };
+static const char* const layoutNames[] = { "row-major", "column-major", "tiled" };
+static const char* const numaPolicyNames[] = { "off", "interleave", "first-touch" };
+
+static atomic_ullong allocations;      // counted by the allocation wrappers
+static atomic_ullong allocatedBytes;
+
+
+
+
+/***** Helper functions used only in this file *****/
+/*
+PRECONDITION
+  - argc/argv are the arguments of the program.
+  - pOptions is a pointer to the options to fill in.
+POSTCONDITION
+  - Parses the options into the variable pointed to by pOptions, with the defaults for the ones not given.
+  - Returns SUCCESS, else FAILURE for invalid arguments after printing the usage.
+*/
+static Status parseOptions(int argc, char* argv[], BenchOptions* pOptions);
+
+
+/*
+PRECONDITION
+  - pOperation is a pointer to an operation of benchOperations.
+  - shape/size/matrices describe the case.
+  - pCase is a pointer to the case to fill in.
+POSTCONDITION
+  - Works out the dimensions, operations and bytes of the case and stores it in the variable pointed to by pCase.
+*/
+static void describeCase(const BenchOperation* pOperation, BenchShape shape, size_t size, int matrices, BenchCase* pCase);
+
+
+/*
+PRECONDITION
+  - pCase is a pointer to a case made by describeCase.
+  - pOptions is a pointer to the options of the benchmark.
+  - pResult is a pointer to the variable that receives the measurements.
+POSTCONDITION
+  - Creates the operands, runs the operation once to warm up and size the result, then times it.
+  - Returns SUCCESS, else FAILURE if the operation or any memory allocation failed.
+*/
+static Status runCase(const BenchCase* pCase, const BenchOptions* pOptions, BenchResult* pResult);
+
+
+/*
+PRECONDITION
+  - pCase is a pointer to a case made by describeCase.
+  - hOperands holds its operands and phResult points to its result handle.
+POSTCONDITION
+  - Runs the operation of the case once.
+  - Returns the status of the operation.
+*/
+static Status callOperation(const BenchCase* pCase, MATRIX* hOperands, MATRIX* phResult);
+
+
+/*
+PRECONDITION
+  - rows/columns/layout describe the matrix.
+  - pState is a pointer to the state of the random number generator.
+POSTCONDITION
+  - Returns a new matrix with entries in [-1, 1) from the generator, and a larger diagonal if it's square so it's
+	well conditioned, else NULL for any memory allocation failure.
+*/
+static MATRIX randomMatrix(size_t rows, size_t columns, MatrixLayout layout, unsigned long long* pState);
+
+
+/*
+PRECONDITION
+  - latencies is an array of size seconds sorted in increasing order.
+  - percentile is in [0, 100].
+POSTCONDITION
+  - Returns the nearest rank percentile of the latencies.
+*/
+static double percentile(const double* latencies, size_t size, double percentile);
+
+
+/*
+PRECONDITION
+  - pA/pB are pointers to doubles.
+POSTCONDITION
+  - Returns a negative number, 0 or a positive number if the double pointed to by pA is less than, equal to or greater
+	than the one pointed to by pB, for qsort.
+*/
+static int compareDoubles(const void* pA, const void* pB);
+
+
+/*
+PRECONDITION
+  - none.
+POSTCONDITION
+  - Returns the time of the monotonic clock in seconds.
+*/
+static double now(void);
+
+
+/*
+PRECONDITION
+  - pCase/pResult are pointers to a case and its measurements.
+POSTCONDITION
+  - Prints a line of the table for the case.
+*/
+static void printResult(const BenchCase* pCase, const BenchResult* pResult);
+
+
+/*
+PRECONDITION
+  - fp is a file open for writing.
+  - pOptions is a pointer to the options of the benchmark.
+  - cases/results are arrays of size cases and their measurements.
+POSTCONDITION
+  - Writes the description of the machine and build and the results of the cases to the file as JSON.
+*/
+static void writeJson(FILE* fp, const BenchOptions* pOptions, const BenchCase* cases, const BenchResult* results, size_t size);
+
+
+/*
+PRECONDITION
+  - size is the number of bytes to allocate (nmemb * size for calloc) and pointer is the block to reallocate.
+POSTCONDITION
+  - Counts the allocation and forwards it to the C library. The linker sends every call to malloc, calloc and realloc
+	in the program to these.
+*/
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t nmemb, size_t size);
+void* __real_realloc(void* pointer, size_t size);
+void* __wrap_malloc(size_t size);
+void* __wrap_calloc(size_t nmemb, size_t size);
+void* __wrap_realloc(void* pointer, size_t size);
+
+
+
+
+int main(int argc, char* argv[]) {
+	BenchOptions options;
+	if (!parseOptions(argc, argv, &options))
+		return 2;
+	matrix_setFactorizationThreads(options.threads);
+	matrix_setNumaPolicy(options.numaPolicy);
+
+	// every case of the sweep
+	size_t casesCapacity = (size_t)options.sizesSize * benchOperationsSize * 3 * 3;
+	BenchCase* cases = malloc(casesCapacity * sizeof(*cases));
+	BenchResult* results = malloc(casesCapacity * sizeof(*results));
+	if (!cases || !results) {
+		fprintf(stderr, "%s: memory allocation failure\n", argv[0]);
+		free(cases);
+		free(results);
+		return 1;
+	}
+	size_t casesSize = 0;
+	for (int s = 0; s < options.sizesSize; ++s) {
+		for (int i = 0; i < benchOperationsSize; ++i) {
+			const BenchOperation* pOperation = &benchOperations[i];
+			if (options.operation && strcmp(options.operation, pOperation->name))
+				continue;
+			int shapes = pOperation->allShapes ? 3 : 1;
+			for (int shape = 0; shape < shapes; ++shape)
+				describeCase(pOperation, shape, options.sizes[s], 2, &cases[casesSize++]);
+			for (int matrices = 4; pOperation->variesMatrices && matrices <= 8; matrices *= 2)
+				describeCase(pOperation, BENCH_SQUARE, options.sizes[s], matrices, &cases[casesSize++]);
+		}
+	}
+
+	printf("%-12s %-7s %-17s %-2s %7s %11s %11s %11s %9s %8s %9s\n", "operation", "shape", "dimensions", "n", "reps",
+		"p50 (ms)", "p90 (ms)", "p99 (ms)", "GFLOP/s", "GB/s", "allocs");
+	int exitStatus = 0;
+	size_t resultsSize = 0;
+	for (size_t i = 0; i < casesSize; ++i) {
+		if (!runCase(&cases[i], &options, &results[resultsSize])) {
+			fprintf(stderr, "%s: %s failed for %zu x %zu\n", argv[0], cases[i].pOperation->name, cases[i].rows, cases[i].columns);
+			exitStatus = 1;
+			continue;
+		}
+		printResult(&cases[i], &results[resultsSize]);
+		cases[resultsSize++] = cases[i];
+	}
+
+	if (options.jsonPath) {
+		FILE* fp = fopen(options.jsonPath, "w");
+		if (fp) {
+			writeJson(fp, &options, cases, results, resultsSize);
+			if (fclose(fp))
+				fp = NULL;
+		}
+		if (!fp) {
+			fprintf(stderr, "%s: could not write %s\n", argv[0], options.jsonPath);
+			exitStatus = 1;
+		}
+	}
+
+	free(cases);
+	free(results);
+
+	return exitStatus;
+}
+
+
+
+
+/***** Helper functions used only in this file *****/
+static Status parseOptions(int argc, char* argv[], BenchOptions* pOptions) {
+	static const size_t defaultSizes[] = { 64, 128, 256, 512 };
+	pOptions->sizesSize = sizeof(defaultSizes) / sizeof(*defaultSizes);
+	memcpy(pOptions->sizes, defaultSizes, sizeof(defaultSizes));
+	pOptions->minTime = 0.25;
+	pOptions->minRepetitions = 3;
+	pOptions->layout = MATRIX_ROW_MAJOR;
+	pOptions->operation = NULL;
+	pOptions->jsonPath = NULL;
+	pOptions->threads = 0;
+	pOptions->numaPolicy = matrix_getNumaPolicy();
+
+	Status status = SUCCESS;
+	for (int i = 1; status && i < argc; ++i) {
+		char* end;
+		if (i + 1 >= argc)
+			status = FAILURE;
+		else if (!strcmp(argv[i], "--sizes")) {
+			// a comma separated list of sizes, each at least 4 so the tall and wide shapes exist
+			char* size = argv[++i];
+			pOptions->sizesSize = 0;
+			do {
+				unsigned long long n = strtoull(size, &end, 10);
+				if (end == size || n < 4 || pOptions->sizesSize == BENCH_SIZES_MAX)
+					status = FAILURE;
+				else
+					pOptions->sizes[pOptions->sizesSize++] = n;
+				size = end + 1;
+			} while (status && *end == ',');
+			if (*end != '\0')
+				status = FAILURE;
+		}
+		else if (!strcmp(argv[i], "--min-time")) {
+			pOptions->minTime = strtod(argv[++i], &end);
+			if (*end != '\0' || !(pOptions->minTime >= 0))
+				status = FAILURE;
+		}
+		else if (!strcmp(argv[i], "--min-reps")) {
+			unsigned long long n = strtoull(argv[++i], &end, 10);
+			if (*end != '\0' || n < 1 || n > BENCH_REPETITIONS_MAX)
+				status = FAILURE;
+			pOptions->minRepetitions = n;
+		}
+		else if (!strcmp(argv[i], "--layout")) {
+			++i;
+			if (!strcmp(argv[i], "row"))
+				pOptions->layout = MATRIX_ROW_MAJOR;
+			else if (!strcmp(argv[i], "column"))
+				pOptions->layout = MATRIX_COLUMN_MAJOR;
+			else if (!strcmp(argv[i], "tiled"))
+				pOptions->layout = MATRIX_TILED;
+			else
+				status = FAILURE;
+		}
+		else if (!strcmp(argv[i], "--operation")) {
+			pOptions->operation = argv[++i];
+			status = FAILURE;
+			for (int j = 0; j < benchOperationsSize; ++j)
+				if (!strcmp(pOptions->operation, benchOperations[j].name))
+					status = SUCCESS;
+		}
+		else if (!strcmp(argv[i], "--json"))
+			pOptions->jsonPath = argv[++i];
+		else if (!strcmp(argv[i], "--threads")) {
+			long n = strtol(argv[++i], &end, 10);
+			if (*end != '\0' || n < 1 || n > 1024)
+				status = FAILURE;
+			pOptions->threads = (int)n;
+		}
+		else if (!strcmp(argv[i], "--numa")) {
+			++i;
+			status = FAILURE;
+			for (int policy = 0; policy < (int)(sizeof(numaPolicyNames) / sizeof(*numaPolicyNames)); ++policy) {
+				if (!strcmp(argv[i], numaPolicyNames[policy])) {
+					pOptions->numaPolicy = policy;
+					status = SUCCESS;
+				}
+			}
+		}
+		else
+			status = FAILURE;
+	}
+
+	if (!status) {
+		fprintf(stderr, "Usage: %s [--sizes <n>,<n>,...] [--min-time <seconds>] [--min-reps <n>] [--layout row|column|tiled]\n", argv[0]);
+		fprintf(stderr, "       [--operation <operation>] [--json <output>] [--threads <n>] [--numa off|interleave|first-touch]\n\n");
+		fprintf(stderr, "Times the operations of the matrix interface for each size (default 64,128,256,512). Each case runs\n");
+		fprintf(stderr, "for at least the minimum time (default 0.25) and repetitions (default 3). Large factorizations run\n");
+		fprintf(stderr, "on the given number of threads (default one per processor), with their matrices placed on the NUMA\n");
+		fprintf(stderr, "nodes by the given policy (default off, or MATRIX_NUMA).\n");
+		fprintf(stderr, "Operations:");
+		for (int i = 0; i < benchOperationsSize; ++i)
+			fprintf(stderr, " %s", benchOperations[i].name);
+		fprintf(stderr, "\n");
+	}
+
+	return status;
+}
+
+
+
+static void describeCase(const BenchOperation* pOperation, BenchShape shape, size_t size, int matrices, BenchCase* pCase) {
+	double entrySize = sizeof(long double);
+	pCase->pOperation = pOperation;
+	pCase->shape = shape;
+	pCase->rows = (shape == BENCH_TALL) ? 4 * size : (shape == BENCH_WIDE) ? size / 4 : size;
+	pCase->columns = (shape == BENCH_TALL) ? size / 4 : (shape == BENCH_WIDE) ? 4 * size : size;
+	pCase->inner = pCase->columns;
+	pCase->matrices = matrices;
+
+	double entries = (double)pCase->rows * pCase->columns;
+	double cube = (double)size * size * size;
+	switch (pOperation->type) {
+	case BENCH_MULTIPLY:
+		// (rows x size) * (size x inner), the first operand's columns are the size of the inner dimension
+		pCase->inner = (shape == BENCH_TALL) ? size / 4 : (shape == BENCH_WIDE) ? 4 * size : size;
+		pCase->columns = size;
+		pCase->flops = 2 * cube;
+		pCase->bytes = entrySize * ((double)pCase->rows * size + (double)size * pCase->inner + (double)pCase->rows * pCase->inner);
+		break;
+	case BENCH_ADD:
+	case BENCH_SUBTRACT:
+		pCase->flops = (matrices - 1) * entries;
+		pCase->bytes = entrySize * (matrices + 1) * entries;
+		break;
+	case BENCH_POWER:
+		// matrix_power multiplies by the matrix power - 1 times
+		pCase->flops = (BENCH_EXPONENT - 1) * 2 * cube;
+		pCase->bytes = entrySize * (BENCH_EXPONENT - 1) * 3 * entries;
+		break;
+	case BENCH_TRANSPOSE:
+		pCase->flops = 0;
+		pCase->bytes = entrySize * 2 * entries;
+		break;
+	case BENCH_DETERMINANT:
+		// the LU or Cholesky factorization, counted as LU
+		pCase->flops = 2 * cube / 3;
+		pCase->bytes = entrySize * entries;
+		break;
+	case BENCH_INVERSE:
+		pCase->flops = 2 * cube;
+		pCase->bytes = entrySize * 2 * entries;
+		break;
+	}
+}
+
+
+
+static Status runCase(const BenchCase* pCase, const BenchOptions* pOptions, BenchResult* pResult) {
+	MATRIX hOperands[8] = { NULL };
+	MATRIX hResult = NULL;
+	double* latencies = NULL;
+	size_t latenciesCapacity = 0;
+	unsigned long long state = 0x9E3779B97F4A7C15ull;        // the same operands every run
+	int operandsSize = (pCase->pOperation->type == BENCH_MULTIPLY) ? 2 : pCase->matrices;
+	if (pCase->pOperation->type != BENCH_MULTIPLY && !pCase->pOperation->variesMatrices)
+		operandsSize = 1;
+
+	Status status = SUCCESS;
+	for (int i = 0; status && i < operandsSize; ++i) {
+		size_t rows = (pCase->pOperation->type == BENCH_MULTIPLY && i == 1) ? pCase->columns : pCase->rows;
+		size_t columns = (pCase->pOperation->type == BENCH_MULTIPLY && i == 1) ? pCase->inner : pCase->columns;
+		if (!(hOperands[i] = randomMatrix(rows, columns, pOptions->layout, &state)))
+			status = FAILURE;
+	}
+
+	// the warm up call creates the result, which keeps the layout of the benchmark for every call after it
+	if (status && pOptions->layout != MATRIX_ROW_MAJOR && pCase->pOperation->type != BENCH_DETERMINANT)
+		status = (hResult = matrix_initLayout(1, 1, pOptions->layout)) ? SUCCESS : FAILURE;
+	if (status)
+		status = callOperation(pCase, hOperands, &hResult);
+
+	// each call is timed on its own for the percentiles
+	unsigned long long allocationsBefore = atomic_load(&allocations);
+	unsigned long long bytesBefore = atomic_load(&allocatedBytes);
+	double total = 0;
+	size_t repetitions = 0;
+	while (status && repetitions < BENCH_REPETITIONS_MAX && (repetitions < pOptions->minRepetitions || total < pOptions->minTime)) {
+		if (repetitions == latenciesCapacity) {
+			latenciesCapacity = latenciesCapacity ? 2 * latenciesCapacity : 64;
+			double* resized = realloc(latencies, latenciesCapacity * sizeof(*latencies));
+			if (!resized) {
+				status = FAILURE;
+				break;
+			}
+			latencies = resized;
+		}
+		double start = now();
+		status = callOperation(pCase, hOperands, &hResult);
+		latencies[repetitions] = now() - start;
+		total += latencies[repetitions++];
+	}
+
+	// the latencies array grew while counting, which the allocations of the operation don't include
+	if (status) {
+		size_t resizes = 0;
+		for (size_t capacity = 64; capacity < latenciesCapacity; capacity *= 2)
+			++resizes;
+		unsigned long long resizedBytes = 0;
+		for (size_t capacity = 64; capacity <= latenciesCapacity; capacity *= 2)
+			resizedBytes += capacity * sizeof(*latencies);
+		qsort(latencies, repetitions, sizeof(*latencies), compareDoubles);
+		pResult->repetitions = repetitions;
+		pResult->min = latencies[0];
+		pResult->p50 = percentile(latencies, repetitions, 50);
+		pResult->p90 = percentile(latencies, repetitions, 90);
+		pResult->p99 = percentile(latencies, repetitions, 99);
+		pResult->max = latencies[repetitions - 1];
+		pResult->mean = total / repetitions;
+		pResult->allocations = (double)(atomic_load(&allocations) - allocationsBefore - (resizes + 1)) / repetitions;
+		pResult->allocatedBytes = (double)(atomic_load(&allocatedBytes) - bytesBefore - resizedBytes) / repetitions;
+	}
+
+	for (int i = 0; i < operandsSize; ++i)
+		matrix_destroy(&hOperands[i]);
+	matrix_destroy(&hResult);
+	free(latencies);
+
+	return status;
+}
+
+
+
+static Status callOperation(const BenchCase* pCase, MATRIX* hOperands, MATRIX* phResult) {
+	Status memoryAllocation;
+	Boolean matrixIsVertible;
+
+	switch (pCase->pOperation->type) {
+	case BENCH_MULTIPLY:
+		return matrix_multiply(hOperands[0], hOperands[1], phResult);
+	case BENCH_ADD:
+		return matrix_add(hOperands, pCase->matrices, phResult);
+	case BENCH_SUBTRACT:
+		return matrix_subtract(hOperands, pCase->matrices, phResult);
+	case BENCH_POWER:
+		return matrix_power(hOperands[0], BENCH_EXPONENT, phResult);
+	case BENCH_TRANSPOSE:
+		return matrix_transpose(hOperands[0], phResult);
+	case BENCH_DETERMINANT:
+		matrix_determinant(hOperands[0], &memoryAllocation);
+		return memoryAllocation;
+	case BENCH_INVERSE:
+		return matrix_inverse(hOperands[0], phResult, &matrixIsVertible);
+	}
+
+	return FAILURE;
+}
+
+
+
+static MATRIX randomMatrix(size_t rows, size_t columns, MatrixLayout layout, unsigned long long* pState) {
+	MATRIX hMatrix = matrix_initLayout(rows, columns, layout);
+	if (!hMatrix)
+		return NULL;
+
+	// xorshift64*, so the operands don't depend on the C library
+	for (size_t i = 0; i < rows; ++i) {
+		for (size_t j = 0; j < columns; ++j) {
+			*pState ^= *pState >> 12;
+			*pState ^= *pState << 25;
+			*pState ^= *pState >> 27;
+			long double entry = (long double)((*pState * 0x2545F4914F6CDD1Dull) >> 11) / (1ull << 52) - 1;
+			if (i == j && rows == columns)
+				entry += 4;
+			matrix_setEntry(hMatrix, entry, i, j);
+		}
+	}
+
+	return hMatrix;
+}
+
+
+
+static double percentile(const double* latencies, size_t size, double percentile) {
+	size_t rank = (size_t)(percentile / 100 * size + 0.999999);
+	return latencies[(rank > 0) ? rank - 1 : 0];
+}
+
+
+
+static int compareDoubles(const void* pA, const void* pB) {
+	double a = *(const double*)pA;
+	double b = *(const double*)pB;
+	return (a > b) - (a < b);
+}
+
+
+
+static double now(void) {
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+
+
+static void printResult(const BenchCase* pCase, const BenchResult* pResult) {
+	char dimensions[64];
+	if (pCase->pOperation->type == BENCH_MULTIPLY)
+		snprintf(dimensions, sizeof(dimensions), "%zux%zux%zu", pCase->rows, pCase->columns, pCase->inner);
+	else
+		snprintf(dimensions, sizeof(dimensions), "%zux%zu", pCase->rows, pCase->columns);
+
+	printf("%-12s %-7s %-17s %-2d %7zu %11.4f %11.4f %11.4f %9.3f %8.3f %9.1f\n", pCase->pOperation->name,
+		shapeNames[pCase->shape], dimensions, pCase->pOperation->variesMatrices ? pCase->matrices : 1, pResult->repetitions,
+		pResult->p50 * 1e3, pResult->p90 * 1e3, pResult->p99 * 1e3, pCase->flops / pResult->p50 / 1e9,
+		pCase->bytes / pResult->p50 / 1e9, pResult->allocations);
+	fflush(stdout);
+}
+
+
+
+static void writeJson(FILE* fp, const BenchOptions* pOptions, const BenchCase* cases, const BenchResult* results, size_t size) {
+	char timestamp[32];
+	time_t seconds = time(NULL);
+	struct tm utc;
+	strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", gmtime_r(&seconds, &utc));
+
+	fprintf(fp, "{\n");
+	fprintf(fp, "  \"version\": 1,\n");
+	fprintf(fp, "  \"timestamp\": \"%s\",\n", timestamp);
+	fprintf(fp, "  \"processors\": %ld,\n", sysconf(_SC_NPROCESSORS_ONLN));
+#ifdef __VERSION__
+	fprintf(fp, "  \"compiler\": \"%s\",\n", __VERSION__);
+#endif
+#ifdef __OPTIMIZE__
+	fprintf(fp, "  \"optimized\": true,\n");
+#else
+	fprintf(fp, "  \"optimized\": false,\n");
+#endif
+	fprintf(fp, "  \"entry_bytes\": %zu,\n", sizeof(long double));
+	fprintf(fp, "  \"layout\": \"%s\",\n", layoutNames[pOptions->layout]);
+	fprintf(fp, "  \"min_time\": %g,\n", pOptions->minTime);
+	fprintf(fp, "  \"factorization_threads\": %d,\n", matrix_getFactorizationThreads());
+	fprintf(fp, "  \"numa_policy\": \"%s\",\n", numaPolicyNames[pOptions->numaPolicy]);
+	fprintf(fp, "  \"numa_nodes\": %d,\n", matrix_getNumaNodes());
+	fprintf(fp, "  \"results\": [");
+	for (size_t i = 0; i < size; ++i) {
+		const BenchCase* pCase = &cases[i];
+		const BenchResult* pResult = &results[i];
+		fprintf(fp, "%s\n    {\"operation\": \"%s\", \"shape\": \"%s\", \"rows\": %zu, \"columns\": %zu", i ? "," : "",
+			pCase->pOperation->name, shapeNames[pCase->shape], pCase->rows, pCase->columns);
+		if (pCase->pOperation->type == BENCH_MULTIPLY)
+			fprintf(fp, ", \"inner\": %zu", pCase->inner);
+		if (pCase->pOperation->variesMatrices)
+			fprintf(fp, ", \"matrices\": %d", pCase->matrices);
+		if (pCase->pOperation->type == BENCH_POWER)
+			fprintf(fp, ", \"power\": %d", BENCH_EXPONENT);
+		fprintf(fp, ",\n     \"repetitions\": %zu, \"seconds\": {\"min\": %.9g, \"p50\": %.9g, \"p90\": %.9g, \"p99\": %.9g, "
+			"\"max\": %.9g, \"mean\": %.9g},\n", pResult->repetitions, pResult->min, pResult->p50, pResult->p90, pResult->p99,
+			pResult->max, pResult->mean);
+		fprintf(fp, "     \"flops\": %.9g, \"gflops\": %.6g, \"bytes\": %.9g, \"gbytes_per_second\": %.6g, "
+			"\"allocations\": %.6g, \"allocated_bytes\": %.9g}", pCase->flops, pCase->flops / pResult->p50 / 1e9,
+			pCase->bytes, pCase->bytes / pResult->p50 / 1e9, pResult->allocations, pResult->allocatedBytes);
+	}
+	fprintf(fp, "\n  ]\n}\n");
+}
+
+
+
+void* __wrap_malloc(size_t size) {
+	atomic_fetch_add(&allocations, 1);
+	atomic_fetch_add(&allocatedBytes, size);
+	return __real_malloc(size);
+}
+
+
+
+void* __wrap_calloc(size_t nmemb, size_t size) {
+	atomic_fetch_add(&allocations, 1);
+	atomic_fetch_add(&allocatedBytes, nmemb * size);
+	return __real_calloc(nmemb, size);
+}
+
+
+
+void* __wrap_realloc(void* pointer, size_t size) {
+	atomic_fetch_add(&allocations, 1);
+	atomic_fetch_add(&allocatedBytes, size);
+	return __real_realloc(pointer, size);
+}
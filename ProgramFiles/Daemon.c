@@ -0,0 +1,1174 @@
+/*
+  Author: Benjamin G. Friedman
+  Date: 10/18/2026
+  File: Daemon.c
+  Description:
+	  - Implementation file for the daemon interface. The main thread accepts connections and queues them for a pool of
+		worker threads, each of which serves one connection at a time, request after request.
+	  - Each operation runs on a thread of its own so the worker can give up on it at the timeout. The operation can't
+		be stopped partway, so it keeps running and its result is thrown away when it finishes. While as many abandoned
+		operations as there are workers are still running, new requests are refused with DAEMON_BUSY.
+	  - Operands and results in shared memory are memfds mapped as the storage of mapped matrix objects (see
+		matrix_initFromFd), so their entries never go through the socket.
+*/
+
+
+#define _GNU_SOURCE            // sockets, sigaction, clock_gettime, memfd_create and file seals
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <signal.h>
+#include <time.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <poll.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "Daemon.h"
+#include "Batch.h"
+
+
+#define DAEMON_DEFAULT_QUEUE 64                // connections that can wait for a worker
+#define DAEMON_DEFAULT_TIMEOUT 30000           // milliseconds an operation may take
+#define DAEMON_DEFAULT_MAX_BYTES (1ull << 30)  // bytes of entries in a request
+#define DAEMON_POLL_INTERVAL 100               // milliseconds between checks for shutting down while a connection is idle
+#define DAEMON_CHUNK_SIZE 8192                 // entries converted between doubles and long doubles at a time
+
+
+
+
+/***** Structures *****/
+typedef struct daemonOptions {
+	const char* socketPath;
+	int workers;                       // connections served at once
+	int queueSize;                     // connections that can wait for a worker
+	uint32_t timeout;                  // default milliseconds an operation may take
+	uint64_t maxBytes;                 // most bytes of entries in a request
+} DaemonOptions;
+
+
+// An operation run on its own thread. The worker and the thread each hold a reference and the last one to let go
+// frees it, so a worker that gives up at the timeout doesn't have to wait for the operation to finish.
+typedef struct daemonTask {
+	pthread_mutex_t lock;
+	pthread_cond_t finished;           // signaled when done is set
+	int references;
+	Boolean done;                      // the operation has finished
+	Boolean abandoned;                 // the worker gave up on the operation at the timeout
+	char operation[DAEMON_OPERATION_MAX + 1];
+	MATRIX* hOperands;
+	int hOperandsSize;
+	int power;
+	MATRIX hResult;                    // result of the operation (see batch_compute)
+	long double number;
+	Status status;
+	char error[BATCH_ERROR_SIZE];
+} DaemonTask;
+
+
+
+
+/***** Global variables *****/
+static DaemonOptions options;
+static const char* programName;                // argv[0], the prefix of every error message
+
+static pthread_mutex_t queueLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t queueChanged = PTHREAD_COND_INITIALIZER;
+static int* queue;                             // connections waiting for a worker, a circular buffer of options.queueSize
+static int queueFirst;
+static int queueLength;
+
+static atomic_int stopping;                    // the daemon is shutting down
+static atomic_int abandonedTasks;              // operations given up on at the timeout that are still running
+static int signalPipe[2] = { -1, -1 };         // the signal handler writes to it to wake up the main thread
+
+
+
+
+/***** Helper functions used only in this file *****/
+/*
+PRECONDITION
+  - argc/argv are the arguments after "--daemon".
+POSTCONDITION
+  - Runs the daemon until it's shut down. Returns the exit status of the program.
+*/
+static int runDaemon(int argc, char* argv[]);
+
+
+/*
+PRECONDITION
+  - argc/argv are the arguments after "--client".
+POSTCONDITION
+  - Sends the job to the daemon and writes the result. Returns the exit status of the program.
+*/
+static int runClient(int argc, char* argv[]);
+
+
+/*
+PRECONDITION
+  - text is the value of an option.
+  - minimum/maximum are the bounds of the value.
+  - pValue is a pointer to the variable that receives the value.
+POSTCONDITION
+  - Returns SUCCESS, else FAILURE if text isn't an integer from minimum to maximum.
+*/
+static Status parseOption(const char* text, unsigned long long minimum, unsigned long long maximum, unsigned long long* pValue);
+
+
+/*
+PRECONDITION
+  - path is the name of the socket.
+  - listening is TRUE to create the socket and listen on it, FALSE to connect to it.
+POSTCONDITION
+  - Returns the file descriptor of the socket, else -1.
+*/
+static int openSocket(const char* path, Boolean listening);
+
+
+/*
+PRECONDITION
+  - signalNumber is SIGINT or SIGTERM.
+POSTCONDITION
+  - Wakes up the main thread of the daemon to shut it down.
+*/
+static void requestShutdown(int signalNumber);
+
+
+/*
+PRECONDITION
+  - pArgument is unused.
+POSTCONDITION
+  - Serves the connections in the queue until the daemon shuts down. Returns NULL.
+*/
+static void* serveConnections(void* pArgument);
+
+
+/*
+PRECONDITION
+  - fd is a connected socket.
+POSTCONDITION
+  - Serves the requests sent on the connection until it's closed by the client, a request is invalid, it's been idle
+    for the timeout or the daemon shuts down. The connection is not closed.
+*/
+static void serveConnection(int fd);
+
+
+/*
+PRECONDITION
+  - fd is a connected socket with the start of a request waiting.
+  - pTask is a pointer to a task that receives the request, with no operands yet.
+  - pRequest is a pointer to the variable that receives the header of the request.
+  - error is an array of at least BATCH_ERROR_SIZE characters.
+POSTCONDITION
+  - Reads the request into the task. Returns DAEMON_OK, else DAEMON_INVALID with the reason in error (the rest of the
+    request may be left unread). error is empty if the connection was closed before the request started.
+*/
+static DaemonStatus readRequest(int fd, DaemonTask* pTask, DaemonRequestHeader* pRequest, char* error);
+
+
+/*
+PRECONDITION
+  - fd is a connected socket with the operands of a DAEMON_SHARED_OPERANDS request waiting.
+  - pTask is a pointer to a task with room for operandsSize operands and none yet.
+  - error is an array of at least BATCH_ERROR_SIZE characters.
+POSTCONDITION
+  - Maps the memfd of each operand as a matrix object of the task. Returns DAEMON_OK, else DAEMON_INVALID with the
+    reason in error. Every memfd received that isn't taken over by a matrix object is closed.
+*/
+static DaemonStatus readSharedOperands(int fd, DaemonTask* pTask, uint32_t operandsSize, char* error);
+
+
+/*
+PRECONDITION
+  - pTask is a pointer to a task without a result.
+POSTCONDITION
+  - Gives the task a result mapped from a new memfd for the operation to store its result in. Returns the memfd, which
+    stays open after the result is destroyed, else -1.
+*/
+static int createSharedResult(DaemonTask* pTask);
+
+
+/*
+PRECONDITION
+  - phMatrix is a pointer to a handle to a valid matrix object.
+POSTCONDITION
+  - Copies the matrix into a new memfd sealed against resizing and replaces the handle with one mapped from it.
+    Returns the memfd, else -1 with the handle unchanged.
+*/
+static int shareMatrix(MATRIX* phMatrix);
+
+
+/*
+PRECONDITION
+  - fd is a connected socket.
+  - elementSize is 8 or sizeof(long double).
+  - rows/columns are the dimensions of the matrix.
+  - phMatrix is a pointer to the variable that receives the handle of the matrix.
+POSTCONDITION
+  - Reads the rows * columns entries of a matrix in row-major order into a new matrix object.
+  - Returns SUCCESS, else FAILURE if the connection fails or for any memory allocation failure.
+*/
+static Status readEntries(int fd, uint32_t elementSize, size_t rows, size_t columns, MATRIX* phMatrix);
+
+
+/*
+PRECONDITION
+  - fd is a connected socket.
+  - elementSize is 8 or sizeof(long double).
+  - hMatrix is a handle to a valid matrix object.
+POSTCONDITION
+  - Sends the entries of the matrix in row-major order. Returns SUCCESS, else FAILURE.
+*/
+static Status sendEntries(int fd, uint32_t elementSize, MATRIX hMatrix);
+
+
+/*
+PRECONDITION
+  - fd is a connected socket.
+  - status is the status of the response.
+  - message is the error message for anything but DAEMON_OK, else NULL.
+POSTCONDITION
+  - Sends a response without a result. Returns SUCCESS, else FAILURE.
+*/
+static Status sendError(int fd, DaemonStatus status, const char* message);
+
+
+/*
+PRECONDITION
+  - pTask is a pointer to a task that holds a request.
+  - timeout is the milliseconds the operation may take.
+POSTCONDITION
+  - Runs the operation of the task on a thread of its own (or on this one if a thread can't be created) and waits for
+    it to finish. Returns TRUE if it finished within the timeout, else FALSE with the task marked as abandoned.
+*/
+static Boolean runTask(DaemonTask* pTask, uint32_t timeout);
+
+
+/*
+PRECONDITION
+  - pArgument is a pointer to a task that holds a request.
+POSTCONDITION
+  - Runs the operation of the task and lets go of the thread's reference to it. Returns NULL.
+*/
+static void* computeTask(void* pArgument);
+
+
+/*
+PRECONDITION
+  - pTask is a pointer to a task.
+POSTCONDITION
+  - Lets go of a reference to the task and frees it, including its operands and result, if it was the last one.
+*/
+static void releaseTask(DaemonTask* pTask);
+
+
+/*
+PRECONDITION
+  - fd is a connected socket.
+  - data is an array of bytes bytes.
+POSTCONDITION
+  - Receives/sends all of the data, retrying after partial transfers and interruptions, and returns SUCCESS,
+    else FAILURE if the connection fails, is closed or times out.
+*/
+static Status receiveAll(int fd, void* data, size_t bytes);
+static Status sendAll(int fd, const void* data, size_t bytes);
+
+
+/*
+PRECONDITION
+  - fd is a connected socket.
+  - data is an array of bytes >= 1 bytes.
+  - fds is an array of fdsSize <= DAEMON_OPERANDS_MAX file descriptors.
+POSTCONDITION
+  - Sends all of the data with the file descriptors attached to its first byte (SCM_RIGHTS). Returns SUCCESS, else
+    FAILURE. The file descriptors stay open in this process.
+*/
+static Status sendWithFds(int fd, const void* data, size_t bytes, const int* fds, int fdsSize);
+
+
+/*
+PRECONDITION
+  - fd is a connected socket.
+  - data is an array of bytes bytes.
+  - fds is an array of fdsSize file descriptors.
+  - pFdsReceived is a pointer to the variable that receives the number of file descriptors received.
+POSTCONDITION
+  - Receives all of the data, the same as receiveAll, and the file descriptors attached to it, the first fdsSize of
+    which are stored in fds and the rest closed. Returns SUCCESS, else FAILURE (the file descriptors received are still
+    stored).
+*/
+static Status receiveWithFds(int fd, void* data, size_t bytes, int* fds, int fdsSize, int* pFdsReceived);
+
+
+/*
+PRECONDITION
+  - format/... are the error message, the same as for printf.
+POSTCONDITION
+  - Prints the error message on stderr and returns FAILURE.
+*/
+static Status reportError(const char* format, ...);
+
+
+
+
+/***** Functions declared in Daemon.h *****/
+int daemon_run(int argc, char* argv[]) {
+	programName = argv[0];
+
+	if (!strcmp(argv[1], "--daemon"))
+		return runDaemon(argc - 2, argv + 2);
+
+	return runClient(argc - 2, argv + 2);
+}
+
+
+
+
+/***** Helper functions used only in this file *****/
+static int runDaemon(int argc, char* argv[]) {
+	unsigned long long value;
+	long processors = sysconf(_SC_NPROCESSORS_ONLN);
+
+	options.socketPath = NULL;
+	options.workers = (processors > 0 && processors < 256) ? (int)processors : 1;
+	options.queueSize = DAEMON_DEFAULT_QUEUE;
+	options.timeout = DAEMON_DEFAULT_TIMEOUT;
+	options.maxBytes = DAEMON_DEFAULT_MAX_BYTES;
+	for (int i = 0; i < argc; ++i) {
+		if (i + 1 < argc && !strcmp(argv[i], "--workers") && parseOption(argv[i + 1], 1, 1024, &value))
+			options.workers = (int)value;
+		else if (i + 1 < argc && !strcmp(argv[i], "--queue") && parseOption(argv[i + 1], 1, 65536, &value))
+			options.queueSize = (int)value;
+		else if (i + 1 < argc && !strcmp(argv[i], "--timeout") && parseOption(argv[i + 1], 1, UINT32_MAX, &value))
+			options.timeout = (uint32_t)value;
+		else if (i + 1 < argc && !strcmp(argv[i], "--max-bytes") && parseOption(argv[i + 1], 1, UINT64_MAX, &value))
+			options.maxBytes = value;
+		else if (i + 1 < argc && !strcmp(argv[i], "--cache") && parseOption(argv[i + 1], 0, SIZE_MAX, &value))
+			matrix_setCacheCapacity((size_t)value);
+		else if (!options.socketPath && argv[i][0] != '-') {
+			options.socketPath = argv[i];
+			continue;
+		}
+		else {
+			fprintf(stderr, "Usage: %s --daemon <socket> [--workers <n>] [--queue <n>] [--timeout <ms>] [--max-bytes <n>] [--cache <n>]\n", programName);
+			return 2;
+		}
+		++i;
+	}
+	if (!options.socketPath) {
+		fprintf(stderr, "Usage: %s --daemon <socket> [--workers <n>] [--queue <n>] [--timeout <ms>] [--max-bytes <n>] [--cache <n>]\n", programName);
+		return 2;
+	}
+
+	pthread_t* workers = malloc(options.workers * sizeof(*workers));
+	queue = malloc(options.queueSize * sizeof(*queue));
+	int listenFd = openSocket(options.socketPath, TRUE);
+	if (!workers || !queue || listenFd < 0 || pipe(signalPipe)) {
+		reportError("can't listen on %s", options.socketPath);
+		if (listenFd >= 0) {
+			close(listenFd);
+			unlink(options.socketPath);
+		}
+		free(workers);
+		free(queue);
+		return 1;
+	}
+
+	// SIGINT and SIGTERM shut the daemon down, and writing to a closed connection shouldn't end it
+	struct sigaction action;
+	memset(&action, 0, sizeof(action));
+	action.sa_handler = requestShutdown;
+	sigemptyset(&action.sa_mask);
+	sigaction(SIGINT, &action, NULL);
+	sigaction(SIGTERM, &action, NULL);
+	action.sa_handler = SIG_IGN;
+	sigaction(SIGPIPE, &action, NULL);
+
+	int workersStarted = 0;
+	while (workersStarted < options.workers && !pthread_create(&workers[workersStarted], NULL, serveConnections, NULL))
+		++workersStarted;
+	if (workersStarted == 0)
+		reportError("can't start any workers");
+
+	// accept connections until a signal arrives
+	struct pollfd fds[2] = { { listenFd, POLLIN, 0 }, { signalPipe[0], POLLIN, 0 } };
+	while (workersStarted > 0) {
+		if (poll(fds, 2, -1) < 0) {
+			if (errno == EINTR)
+				continue;
+			break;
+		}
+		if (fds[1].revents)
+			break;
+		if (!(fds[0].revents & POLLIN))
+			continue;
+
+		int fd = accept(listenFd, NULL, NULL);
+		if (fd < 0)
+			continue;
+		pthread_mutex_lock(&queueLock);
+		if (queueLength == options.queueSize) {
+			pthread_mutex_unlock(&queueLock);
+			sendError(fd, DAEMON_BUSY, "too many connections");
+			close(fd);
+			continue;
+		}
+		queue[(queueFirst + queueLength++) % options.queueSize] = fd;
+		pthread_cond_signal(&queueChanged);
+		pthread_mutex_unlock(&queueLock);
+	}
+
+	// stop taking connections, turn away the ones still waiting and let the workers finish their requests
+	close(listenFd);
+	unlink(options.socketPath);
+	pthread_mutex_lock(&queueLock);
+	atomic_store(&stopping, 1);
+	for (; queueLength > 0; --queueLength, queueFirst = (queueFirst + 1) % options.queueSize) {
+		sendError(queue[queueFirst], DAEMON_SHUTTING_DOWN, "the daemon is shutting down");
+		close(queue[queueFirst]);
+	}
+	pthread_cond_broadcast(&queueChanged);
+	pthread_mutex_unlock(&queueLock);
+	for (int i = 0; i < workersStarted; ++i)
+		pthread_join(workers[i], NULL);
+
+	close(signalPipe[0]);
+	close(signalPipe[1]);
+	free(workers);
+	free(queue);
+
+	return workersStarted > 0 ? 0 : 1;
+}
+
+
+
+static int runClient(int argc, char* argv[]) {
+	char error[BATCH_ERROR_SIZE];
+	unsigned long long value;
+	const char* socketPath = NULL;
+	uint32_t timeout = 0;
+	unsigned long long repeat = 1;
+	Boolean shared = FALSE;
+	BatchJob job;
+	int i;
+
+	// the options and the socket come before the job
+	for (i = 0; i < argc; ++i) {
+		if (!strcmp(argv[i], "--shared")) {
+			shared = TRUE;
+			continue;
+		}
+		if (i + 1 < argc && !strcmp(argv[i], "--timeout") && parseOption(argv[i + 1], 1, UINT32_MAX, &value))
+			timeout = (uint32_t)value;
+		else if (i + 1 < argc && !strcmp(argv[i], "--repeat") && parseOption(argv[i + 1], 1, ULLONG_MAX, &value))
+			repeat = value;
+		else if (!socketPath && argv[i][0] != '-') {
+			socketPath = argv[i];
+			continue;
+		}
+		else
+			break;
+		++i;
+	}
+	if (!socketPath || i == argc || argv[i][0] == '-') {
+		fprintf(stderr, "Usage: %s --client <socket> [--timeout <ms>] [--repeat <n>] [--shared] <operation> <operands> [-o <output>]\n", programName);
+		return 2;
+	}
+	if (!batch_parseJob(argv + i, argc - i, &job, error)) {
+		reportError("%s", error);
+		return 2;
+	}
+	if (shared && job.operandsSize > DAEMON_OPERANDS_MAX) {
+		reportError("at most %d operands can be shared", DAEMON_OPERANDS_MAX);
+		return 2;
+	}
+
+	MATRIX* hOperands = calloc(job.operandsSize, sizeof(*hOperands));
+	int sharedFds[DAEMON_OPERANDS_MAX];        // memfds of the operands for --shared
+	int sharedFdsSize = 0;
+	if (!hOperands) {
+		reportError("memory allocation failure");
+		return 1;
+	}
+	Status status = SUCCESS;
+	for (int j = 0; status && j < job.operandsSize; ++j) {
+		if (!(hOperands[j] = batch_readMatrix(job.operands[j])))
+			status = reportError("can't read the matrix in %s", job.operands[j]);
+		else if (shared && (sharedFds[sharedFdsSize++] = shareMatrix(&hOperands[j])) < 0) {
+			--sharedFdsSize;
+			status = reportError("can't create shared memory for %s", job.operands[j]);
+		}
+	}
+
+	int fd = -1;
+	if (status && (fd = openSocket(socketPath, FALSE)) < 0)
+		status = reportError("can't connect to %s", socketPath);
+
+	DaemonResponseHeader response;
+	MATRIX hResult = NULL;
+	struct timespec start, end;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (unsigned long long k = 0; status && k < repeat; ++k) {
+		DaemonRequestHeader request = { DAEMON_REQUEST_MAGIC, sizeof(long double), (uint32_t)strlen(job.operation),
+			(uint32_t)job.operandsSize, job.power, timeout, shared ? DAEMON_SHARED_OPERANDS | DAEMON_SHARED_RESULT : 0, 0 };
+		status = sendAll(fd, &request, sizeof(request)) && sendAll(fd, job.operation, request.operationLength);
+		if (status && shared) {
+			DaemonOperand operands[DAEMON_OPERANDS_MAX];
+			for (int j = 0; j < job.operandsSize; ++j) {
+				DaemonOperand operand = { matrix_getRows(hOperands[j]), matrix_getColumns(hOperands[j]),
+					matrix_getLayout(hOperands[j]), 0 };
+				operands[j] = operand;
+			}
+			status = sendWithFds(fd, operands, job.operandsSize * sizeof(*operands), sharedFds, sharedFdsSize);
+		}
+		for (int j = 0; status && !shared && j < job.operandsSize; ++j) {
+			uint64_t dimensions[2] = { matrix_getRows(hOperands[j]), matrix_getColumns(hOperands[j]) };
+			status = sendAll(fd, dimensions, sizeof(dimensions)) && sendEntries(fd, sizeof(long double), hOperands[j]);
+		}
+
+		int resultFd = -1;                     // memfd of a result in shared memory
+		int fdsReceived;
+		if (!status || !receiveWithFds(fd, &response, sizeof(response), &resultFd, 1, &fdsReceived)
+			|| response.magic != DAEMON_RESPONSE_MAGIC) {
+			if (resultFd >= 0)
+				close(resultFd);
+			status = reportError("the connection to %s failed", socketPath);
+			break;
+		}
+
+		if (response.status != DAEMON_OK) {
+			char message[BATCH_ERROR_SIZE] = "";
+			size_t length = (response.messageLength < sizeof(message)) ? response.messageLength : sizeof(message) - 1;
+			if (resultFd >= 0)
+				close(resultFd);
+			receiveAll(fd, message, length);
+			message[length] = '\0';
+			status = reportError("%s", message);
+			break;
+		}
+		if (hResult)
+			matrix_destroy(&hResult);
+		if (resultFd >= 0) {
+			if (response.layout > MATRIX_TILED || response.rows > SIZE_MAX || response.columns > SIZE_MAX
+				|| !(hResult = matrix_initFromFd(resultFd, (size_t)response.rows, (size_t)response.columns, response.layout))) {
+				close(resultFd);
+				status = reportError("can't map the result from %s", socketPath);
+			}
+		}
+		else if (response.elementSize != sizeof(long double) || response.rows == 0 || response.columns == 0
+			|| response.rows > SIZE_MAX || response.columns > SIZE_MAX
+			|| !readEntries(fd, response.elementSize, (size_t)response.rows, (size_t)response.columns, &hResult))
+			status = reportError("the connection to %s failed", socketPath);
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	if (status && repeat > 1)
+		fprintf(stderr, "%llu requests, %.1f us per request\n", repeat,
+			((end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec)) / 1e3 / repeat);
+
+	if (status) {
+		Boolean ignored;
+		if (response.isNumber)
+			status = batch_writeNumber(matrix_getEntry(hResult, 0, 0, &ignored), job.output);
+		else
+			status = batch_writeMatrix(hResult, job.output);
+		if (!status)
+			reportError("can't write the result to %s", job.output ? job.output : "stdout");
+	}
+
+	if (fd >= 0)
+		close(fd);
+	if (hResult)
+		matrix_destroy(&hResult);
+	for (int j = 0; j < job.operandsSize; ++j)
+		if (hOperands[j])
+			matrix_destroy(&hOperands[j]);
+	for (int j = 0; j < sharedFdsSize; ++j)
+		close(sharedFds[j]);
+	free(hOperands);
+
+	return status ? 0 : 1;
+}
+
+
+
+static Status parseOption(const char* text, unsigned long long minimum, unsigned long long maximum, unsigned long long* pValue) {
+	char* end;
+
+	errno = 0;
+	*pValue = strtoull(text, &end, 10);
+
+	return (text[0] >= '0' && text[0] <= '9' && *end == '\0' && errno == 0 && *pValue >= minimum && *pValue <= maximum)
+		? SUCCESS : FAILURE;
+}
+
+
+
+static int openSocket(const char* path, Boolean listening) {
+	struct sockaddr_un address;
+	int fd;
+
+	if (strlen(path) >= sizeof(address.sun_path) || (fd = socket(AF_UNIX, SOCK_STREAM, 0)) < 0)
+		return -1;
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	strcpy(address.sun_path, path);
+
+	// a socket left behind by a daemon that didn't shut down cleanly is replaced
+	if (listening) {
+		unlink(path);
+		if (bind(fd, (struct sockaddr*)&address, sizeof(address)) || listen(fd, SOMAXCONN)) {
+			close(fd);
+			return -1;
+		}
+	}
+	else if (connect(fd, (struct sockaddr*)&address, sizeof(address))) {
+		close(fd);
+		return -1;
+	}
+
+	return fd;
+}
+
+
+
+static void requestShutdown(int signalNumber) {
+	int savedErrno = errno;
+
+	(void)signalNumber;
+	if (write(signalPipe[1], "", 1) < 0) {
+		// the pipe only has to be readable, so a full pipe is fine
+	}
+	errno = savedErrno;
+}
+
+
+
+static void* serveConnections(void* pArgument) {
+	(void)pArgument;
+
+	for (;;) {
+		pthread_mutex_lock(&queueLock);
+		while (queueLength == 0 && !atomic_load(&stopping))
+			pthread_cond_wait(&queueChanged, &queueLock);
+		if (queueLength == 0) {
+			pthread_mutex_unlock(&queueLock);
+			return NULL;
+		}
+		int fd = queue[queueFirst];
+		queueFirst = (queueFirst + 1) % options.queueSize;
+		--queueLength;
+		pthread_mutex_unlock(&queueLock);
+
+		serveConnection(fd);
+		close(fd);
+	}
+}
+
+
+
+static void serveConnection(int fd) {
+	struct timeval timeout = { (time_t)(options.timeout / 1000), (suseconds_t)(options.timeout % 1000 * 1000) };
+	char error[BATCH_ERROR_SIZE];
+	uint32_t idle = 0;                 // milliseconds since the last request
+
+	// a client that stops partway through a message is dropped after the timeout
+	setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+	setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+	while (!atomic_load(&stopping)) {
+		struct pollfd pollFd = { fd, POLLIN, 0 };
+		int ready = poll(&pollFd, 1, DAEMON_POLL_INTERVAL);
+		if (ready < 0 && errno != EINTR)
+			return;
+		if (ready <= 0) {
+			idle += DAEMON_POLL_INTERVAL;
+			if (idle >= options.timeout)
+				return;
+			continue;
+		}
+		idle = 0;
+
+		DaemonTask* pTask = calloc(1, sizeof(*pTask));
+		DaemonRequestHeader request;
+		if (!pTask) {
+			sendError(fd, DAEMON_INVALID, "memory allocation failure");
+			return;
+		}
+		pthread_mutex_init(&pTask->lock, NULL);
+		pthread_cond_init(&pTask->finished, NULL);
+		pTask->references = 1;
+
+		DaemonStatus status = readRequest(fd, pTask, &request, error);
+		if (status == DAEMON_INVALID) {
+			// a request that ends where the previous one did is the client closing the connection
+			if (error[0])
+				sendError(fd, status, error);
+			releaseTask(pTask);
+			return;
+		}
+		if (atomic_load(&abandonedTasks) >= options.workers) {
+			sendError(fd, DAEMON_BUSY, "too many operations are still running after their timeout");
+			releaseTask(pTask);
+			continue;
+		}
+
+		// a matrix result in shared memory is stored straight into the memfd sent back
+		int resultFd = -1;
+		if ((request.flags & DAEMON_SHARED_RESULT) && !batch_resultIsNumber(pTask->operation)
+			&& (resultFd = createSharedResult(pTask)) < 0) {
+			sendError(fd, DAEMON_FAILED, "can't create shared memory for the result");
+			releaseTask(pTask);
+			continue;
+		}
+
+		Status sent;
+		if (!runTask(pTask, request.timeout ? request.timeout : options.timeout))
+			sent = sendError(fd, DAEMON_TIMEOUT, "the operation didn't finish within the timeout");
+		else if (!pTask->status)
+			sent = sendError(fd, DAEMON_FAILED, pTask->error);
+		else {
+			MATRIX hResult = pTask->hResult;
+			uint32_t elementSize = request.elementSize;
+			DaemonResponseHeader response = { DAEMON_RESPONSE_MAGIC, DAEMON_OK, elementSize, 0, 0, 0, 1, 1 };
+			if (resultFd >= 0) {
+				response.rows = matrix_getRows(hResult);
+				response.columns = matrix_getColumns(hResult);
+				response.layout = matrix_getLayout(hResult);
+				sent = sendWithFds(fd, &response, sizeof(response), &resultFd, 1);
+			}
+			else if (hResult) {
+				response.rows = matrix_getRows(hResult);
+				response.columns = matrix_getColumns(hResult);
+				sent = sendAll(fd, &response, sizeof(response)) && sendEntries(fd, elementSize, hResult);
+			}
+			else {
+				response.isNumber = 1;
+				if (elementSize == sizeof(long double))
+					sent = sendAll(fd, &response, sizeof(response)) && sendAll(fd, &pTask->number, sizeof(pTask->number));
+				else {
+					double number = (double)pTask->number;
+					sent = sendAll(fd, &response, sizeof(response)) && sendAll(fd, &number, sizeof(number));
+				}
+			}
+		}
+		if (resultFd >= 0)
+			close(resultFd);
+		releaseTask(pTask);
+		if (!sent)
+			return;
+	}
+}
+
+
+
+static DaemonStatus readRequest(int fd, DaemonTask* pTask, DaemonRequestHeader* pRequest, char* error) {
+	DaemonRequestHeader request;
+	uint64_t bytes = 0;                // bytes of entries in the request so far
+
+	error[0] = '\0';
+	if (!receiveAll(fd, &request, sizeof(request)))
+		return DAEMON_INVALID;
+	*pRequest = request;
+	if (request.magic != DAEMON_REQUEST_MAGIC) {
+		snprintf(error, BATCH_ERROR_SIZE, "not a request");
+		return DAEMON_INVALID;
+	}
+	if (request.elementSize != sizeof(double) && request.elementSize != sizeof(long double)) {
+		snprintf(error, BATCH_ERROR_SIZE, "entries of %u bytes aren't supported", (unsigned)request.elementSize);
+		return DAEMON_INVALID;
+	}
+	if (request.operationLength == 0 || request.operationLength > DAEMON_OPERATION_MAX
+		|| request.operandsSize == 0 || request.operandsSize > DAEMON_OPERANDS_MAX) {
+		snprintf(error, BATCH_ERROR_SIZE, "the operation or number of operands is invalid");
+		return DAEMON_INVALID;
+	}
+	if (request.flags & ~(DAEMON_SHARED_OPERANDS | DAEMON_SHARED_RESULT)) {
+		snprintf(error, BATCH_ERROR_SIZE, "unknown flags 0x%x", (unsigned)request.flags);
+		return DAEMON_INVALID;
+	}
+	if (!receiveAll(fd, pTask->operation, request.operationLength) || !(pTask->hOperands = calloc(request.operandsSize, sizeof(MATRIX)))) {
+		snprintf(error, BATCH_ERROR_SIZE, "the request is incomplete");
+		return DAEMON_INVALID;
+	}
+	pTask->operation[request.operationLength] = '\0';
+	pTask->power = request.power;
+	if (request.flags & DAEMON_SHARED_OPERANDS)
+		return readSharedOperands(fd, pTask, request.operandsSize, error);
+
+	for (uint32_t i = 0; i < request.operandsSize; ++i) {
+		uint64_t dimensions[2];
+		if (!receiveAll(fd, dimensions, sizeof(dimensions))) {
+			snprintf(error, BATCH_ERROR_SIZE, "the request is incomplete");
+			return DAEMON_INVALID;
+		}
+		// the entries have to fit in what's left of the limit
+		uint64_t left = (options.maxBytes - bytes) / request.elementSize;
+		if (dimensions[0] == 0 || dimensions[1] == 0 || dimensions[0] > left || dimensions[1] > left / dimensions[0]) {
+			snprintf(error, BATCH_ERROR_SIZE, "operand %u is empty or the request is larger than %llu bytes",
+				(unsigned)i + 1, (unsigned long long)options.maxBytes);
+			return DAEMON_INVALID;
+		}
+		bytes += dimensions[0] * dimensions[1] * request.elementSize;
+		if (!readEntries(fd, request.elementSize, (size_t)dimensions[0], (size_t)dimensions[1], &pTask->hOperands[i])) {
+			snprintf(error, BATCH_ERROR_SIZE, "the request is incomplete or the daemon is out of memory");
+			return DAEMON_INVALID;
+		}
+		++pTask->hOperandsSize;
+	}
+
+	return DAEMON_OK;
+}
+
+
+
+static DaemonStatus readSharedOperands(int fd, DaemonTask* pTask, uint32_t operandsSize, char* error) {
+	DaemonOperand operands[DAEMON_OPERANDS_MAX];
+	int fds[DAEMON_OPERANDS_MAX];
+	int fdsSize;
+	DaemonStatus status = DAEMON_OK;
+
+	if (!receiveWithFds(fd, operands, operandsSize * sizeof(*operands), fds, DAEMON_OPERANDS_MAX, &fdsSize)) {
+		snprintf(error, BATCH_ERROR_SIZE, "the request is incomplete");
+		status = DAEMON_INVALID;
+	}
+	else if (fdsSize != (int)operandsSize) {
+		snprintf(error, BATCH_ERROR_SIZE, "%d memfds were sent for %u operands", fdsSize, (unsigned)operandsSize);
+		status = DAEMON_INVALID;
+	}
+
+	// a memfd that can shrink could be cut short while it's mapped, which would crash the daemon
+	for (uint32_t i = 0; status == DAEMON_OK && i < operandsSize; ++i) {
+		int seals = fcntl(fds[i], F_GET_SEALS);
+		if (seals < 0 || !(seals & F_SEAL_SHRINK)) {
+			snprintf(error, BATCH_ERROR_SIZE, "operand %u isn't a memfd sealed with F_SEAL_SHRINK", (unsigned)i + 1);
+			status = DAEMON_INVALID;
+		}
+		else if (operands[i].layout > MATRIX_TILED || operands[i].rows == 0 || operands[i].columns == 0
+			|| operands[i].rows > SIZE_MAX || operands[i].columns > SIZE_MAX
+			|| !(pTask->hOperands[i] = matrix_initFromFd(fds[i], (size_t)operands[i].rows, (size_t)operands[i].columns,
+				operands[i].layout))) {
+			snprintf(error, BATCH_ERROR_SIZE, "operand %u doesn't match the size of its memfd", (unsigned)i + 1);
+			status = DAEMON_INVALID;
+		}
+		else {
+			fds[i] = -1;
+			++pTask->hOperandsSize;
+		}
+	}
+	for (int i = 0; i < fdsSize; ++i)
+		if (fds[i] >= 0)
+			close(fds[i]);
+
+	return status;
+}
+
+
+
+static int createSharedResult(DaemonTask* pTask) {
+	int fd = memfd_create("matrix-result", MFD_CLOEXEC);
+	int copy = (fd >= 0) ? dup(fd) : -1;
+
+	// the result takes over the copy and is resized by the operation
+	if (copy < 0 || !(pTask->hResult = matrix_initFromFd(copy, 1, 1, MATRIX_ROW_MAJOR))) {
+		if (copy >= 0)
+			close(copy);
+		if (fd >= 0)
+			close(fd);
+		return -1;
+	}
+
+	return fd;
+}
+
+
+
+static int shareMatrix(MATRIX* phMatrix) {
+	int fd = memfd_create("matrix-operand", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+	int copy = (fd >= 0) ? dup(fd) : -1;
+	MATRIX hShared = NULL;
+
+	if (copy >= 0 && !(hShared = matrix_initFromFd(copy, matrix_getRows(*phMatrix), matrix_getColumns(*phMatrix),
+		matrix_getLayout(*phMatrix))))
+		close(copy);
+	if (!hShared || !matrix_assignment(*phMatrix, &hShared)
+		|| fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL)) {
+		if (hShared)
+			matrix_destroy(&hShared);
+		if (fd >= 0)
+			close(fd);
+		return -1;
+	}
+	matrix_destroy(phMatrix);
+	*phMatrix = hShared;
+
+	return fd;
+}
+
+
+
+static Status readEntries(int fd, uint32_t elementSize, size_t rows, size_t columns, MATRIX* phMatrix) {
+	long double* entries = malloc(rows * columns * sizeof(*entries));
+	Status status = entries ? SUCCESS : FAILURE;
+
+	if (status && elementSize == sizeof(long double))
+		status = receiveAll(fd, entries, rows * columns * sizeof(*entries));
+	else if (status) {
+		double chunk[DAEMON_CHUNK_SIZE];
+		for (size_t first = 0; status && first < rows * columns; first += DAEMON_CHUNK_SIZE) {
+			size_t count = (rows * columns - first < DAEMON_CHUNK_SIZE) ? rows * columns - first : DAEMON_CHUNK_SIZE;
+			status = receiveAll(fd, chunk, count * sizeof(*chunk));
+			for (size_t i = 0; status && i < count; ++i)
+				entries[first + i] = chunk[i];
+		}
+	}
+	if (status && !(*phMatrix = matrix_initFromArray(rows, columns, MATRIX_ROW_MAJOR, entries)))
+		status = FAILURE;
+	free(entries);
+
+	return status;
+}
+
+
+
+static Status sendEntries(int fd, uint32_t elementSize, MATRIX hMatrix) {
+	size_t rows = matrix_getRows(hMatrix);
+	size_t columns = matrix_getColumns(hMatrix);
+	long double chunk[DAEMON_CHUNK_SIZE];
+	size_t count = 0;
+	Boolean ignored;
+
+	// entries are gathered in row-major order whatever the layout of the matrix
+	for (size_t i = 0; i < rows; ++i) {
+		for (size_t j = 0; j < columns; ++j) {
+			long double n = matrix_getEntry(hMatrix, i, j, &ignored);
+			if (elementSize == sizeof(long double))
+				chunk[count++] = n;
+			else
+				((double*)chunk)[count++] = (double)n;
+			if (count == DAEMON_CHUNK_SIZE) {
+				if (!sendAll(fd, chunk, count * elementSize))
+					return FAILURE;
+				count = 0;
+			}
+		}
+	}
+
+	return sendAll(fd, chunk, count * elementSize);
+}
+
+
+
+static Status sendError(int fd, DaemonStatus status, const char* message) {
+	DaemonResponseHeader response = { DAEMON_RESPONSE_MAGIC, status, 0, 0, (uint32_t)strlen(message), 0, 0, 0 };
+
+	return (sendAll(fd, &response, sizeof(response)) && sendAll(fd, message, response.messageLength)) ? SUCCESS : FAILURE;
+}
+
+
+
+static Boolean runTask(DaemonTask* pTask, uint32_t timeout) {
+	pthread_attr_t attributes;
+	pthread_t thread;
+	struct timespec deadline;
+
+	clock_gettime(CLOCK_REALTIME, &deadline);
+	deadline.tv_sec += timeout / 1000;
+	deadline.tv_nsec += (long)(timeout % 1000) * 1000000;
+	if (deadline.tv_nsec >= 1000000000) {
+		++deadline.tv_sec;
+		deadline.tv_nsec -= 1000000000;
+	}
+
+	// the thread gets its own reference, which it lets go of when the operation finishes
+	++pTask->references;
+	pthread_attr_init(&attributes);
+	pthread_attr_setdetachstate(&attributes, PTHREAD_CREATE_DETACHED);
+	if (pthread_create(&thread, &attributes, computeTask, pTask))
+		computeTask(pTask);
+	pthread_attr_destroy(&attributes);
+
+	pthread_mutex_lock(&pTask->lock);
+	while (!pTask->done && pthread_cond_timedwait(&pTask->finished, &pTask->lock, &deadline) != ETIMEDOUT)
+		;
+	Boolean done = pTask->done;
+	if (!done) {
+		pTask->abandoned = TRUE;
+		atomic_fetch_add(&abandonedTasks, 1);
+	}
+	pthread_mutex_unlock(&pTask->lock);
+
+	return done;
+}
+
+
+
+static void* computeTask(void* pArgument) {
+	DaemonTask* pTask = pArgument;
+
+	pTask->status = batch_compute(pTask->operation, pTask->hOperands, pTask->hOperandsSize, pTask->power,
+		&pTask->hResult, &pTask->number, pTask->error);
+
+	pthread_mutex_lock(&pTask->lock);
+	pTask->done = TRUE;
+	if (pTask->abandoned)
+		atomic_fetch_sub(&abandonedTasks, 1);
+	pthread_cond_signal(&pTask->finished);
+	pthread_mutex_unlock(&pTask->lock);
+	releaseTask(pTask);
+
+	return NULL;
+}
+
+
+
+static void releaseTask(DaemonTask* pTask) {
+	pthread_mutex_lock(&pTask->lock);
+	int references = --pTask->references;
+	pthread_mutex_unlock(&pTask->lock);
+	if (references > 0)
+		return;
+
+	for (int i = 0; i < pTask->hOperandsSize; ++i)
+		matrix_destroy(&pTask->hOperands[i]);
+	free(pTask->hOperands);
+	if (pTask->hResult)
+		matrix_destroy(&pTask->hResult);
+	pthread_cond_destroy(&pTask->finished);
+	pthread_mutex_destroy(&pTask->lock);
+	free(pTask);
+}
+
+
+
+static Status receiveAll(int fd, void* data, size_t bytes) {
+	char* pByte = data;
+
+	while (bytes > 0) {
+		ssize_t received = recv(fd, pByte, bytes, 0);
+		if (received <= 0) {
+			if (received < 0 && errno == EINTR)
+				continue;
+			return FAILURE;
+		}
+		pByte += received;
+		bytes -= (size_t)received;
+	}
+
+	return SUCCESS;
+}
+
+
+
+static Status sendAll(int fd, const void* data, size_t bytes) {
+	const char* pByte = data;
+
+	while (bytes > 0) {
+		ssize_t sent = send(fd, pByte, bytes, MSG_NOSIGNAL);
+		if (sent < 0) {
+			if (errno == EINTR)
+				continue;
+			return FAILURE;
+		}
+		pByte += sent;
+		bytes -= (size_t)sent;
+	}
+
+	return SUCCESS;
+}
+
+
+
+static Status sendWithFds(int fd, const void* data, size_t bytes, const int* fds, int fdsSize) {
+	union {
+		char buffer[CMSG_SPACE(DAEMON_OPERANDS_MAX * sizeof(int))];
+		struct cmsghdr alignment;
+	} control;
+	struct iovec vector = { (void*)data, bytes };
+	struct msghdr message;
+	ssize_t sent;
+
+	memset(&message, 0, sizeof(message));
+	message.msg_iov = &vector;
+	message.msg_iovlen = 1;
+	if (fdsSize > 0) {
+		message.msg_control = control.buffer;
+		message.msg_controllen = CMSG_SPACE(fdsSize * sizeof(int));
+		struct cmsghdr* pHeader = CMSG_FIRSTHDR(&message);
+		pHeader->cmsg_level = SOL_SOCKET;
+		pHeader->cmsg_type = SCM_RIGHTS;
+		pHeader->cmsg_len = CMSG_LEN(fdsSize * sizeof(int));
+		memcpy(CMSG_DATA(pHeader), fds, fdsSize * sizeof(int));
+	}
+
+	// the file descriptors go with the first byte, so only the data is sent again after a partial send
+	while ((sent = sendmsg(fd, &message, MSG_NOSIGNAL)) < 0)
+		if (errno != EINTR)
+			return FAILURE;
+
+	return sendAll(fd, (const char*)data + sent, bytes - (size_t)sent);
+}
+
+
+
+static Status receiveWithFds(int fd, void* data, size_t bytes, int* fds, int fdsSize, int* pFdsReceived) {
+	union {
+		char buffer[CMSG_SPACE(DAEMON_OPERANDS_MAX * sizeof(int))];
+		struct cmsghdr alignment;
+	} control;
+	char* pByte = data;
+
+	*pFdsReceived = 0;
+	while (bytes > 0) {
+		struct iovec vector = { pByte, bytes };
+		struct msghdr message;
+		memset(&message, 0, sizeof(message));
+		message.msg_iov = &vector;
+		message.msg_iovlen = 1;
+		message.msg_control = control.buffer;
+		message.msg_controllen = sizeof(control.buffer);
+
+		ssize_t received = recvmsg(fd, &message, MSG_CMSG_CLOEXEC);
+		if (received <= 0) {
+			if (received < 0 && errno == EINTR)
+				continue;
+			return FAILURE;
+		}
+		for (struct cmsghdr* pHeader = CMSG_FIRSTHDR(&message); pHeader; pHeader = CMSG_NXTHDR(&message, pHeader)) {
+			if (pHeader->cmsg_level != SOL_SOCKET || pHeader->cmsg_type != SCM_RIGHTS)
+				continue;
+			size_t count = (pHeader->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+			for (size_t i = 0; i < count; ++i) {
+				int descriptor;
+				memcpy(&descriptor, CMSG_DATA(pHeader) + i * sizeof(int), sizeof(int));
+				if (*pFdsReceived < fdsSize)
+					fds[(*pFdsReceived)++] = descriptor;
+				else
+					close(descriptor);
+			}
+		}
+		pByte += received;
+		bytes -= (size_t)received;
+	}
+
+	return SUCCESS;
+}
+
+
+
+static Status reportError(const char* format, ...) {
+	va_list arguments;
+
+	fprintf(stderr, "%s: ", programName);
+	va_start(arguments, format);
+	vfprintf(stderr, format, arguments);
+	va_end(arguments);
+	fprintf(stderr, "\n");
+
+	return FAILURE;
+}
@@ -0,0 +1,109 @@
+/*
+  Author: Benjamin G. Friedman
+  Date: 10/18/2026
+  File: Daemon.h
+  Description:
+      - Header file for the daemon interface, which keeps the program running and does matrix operations sent to it
+        over a Unix domain socket, and for the client that sends them.
+      - Every message is a header followed by its data, all in the byte order of the machine (the socket is local):
+            request:   DaemonRequestHeader, the name of the operation (operationLength bytes, no NUL), then for each
+                       operand a uint64 rows, a uint64 columns and rows * columns entries in row-major order
+            response:  DaemonResponseHeader, then rows * columns entries in row-major order for DAEMON_OK, else an
+                       error message of messageLength bytes (no NUL)
+      - Entries are doubles (elementSize 8, i.e. numpy.float64) or long doubles (elementSize sizeof(long double)).
+        The response uses the element size of its request.
+      - Large matrices can be passed in shared memory instead, so only descriptors go over the socket:
+            DAEMON_SHARED_OPERANDS:  the operands are DaemonOperand descriptors, all sent in one message with a memfd per
+                                     operand attached in the same order (SCM_RIGHTS). Each memfd holds the storage
+                                     array of the matrix in its layout (long doubles, see matrix_initFromFd) and must be
+                                     sealed with F_SEAL_SHRINK so the daemon can't be cut off from it while it's mapped.
+            DAEMON_SHARED_RESULT:    a matrix result is stored by the daemon in a new memfd that's attached to the
+                                     response header, with no entries following. The layout field gives its layout.
+      - A connection can send any number of requests, one after another. The daemon closes it after an invalid request,
+        after it's been idle for the request timeout and when the daemon shuts down.
+*/
+
+
+#ifndef DAEMON_H
+#define DAEMON_H
+
+
+#include <stdint.h>
+#include "Matrix.h"
+
+
+/***** Global variables, macros, and structures *****/
+#define DAEMON_REQUEST_MAGIC 0x5152584Du       // "MXRQ" on a little-endian machine
+#define DAEMON_RESPONSE_MAGIC 0x5352584Du      // "MXRS" on a little-endian machine
+#define DAEMON_OPERATION_MAX 32                // longest operation name
+#define DAEMON_OPERANDS_MAX 64                 // most operands in a request
+#define DAEMON_SHARED_OPERANDS 0x1u            // flags of a request (see the description above)
+#define DAEMON_SHARED_RESULT 0x2u
+
+// The status of a response
+// - DAEMON_OK: the result follows
+// - DAEMON_FAILED: the operation couldn't be done, i.e. the matrix is singular
+// - DAEMON_INVALID: the request is malformed or too large, the daemon closes the connection
+// - DAEMON_TIMEOUT: the operation didn't finish within the timeout
+// - DAEMON_BUSY: the daemon is at its concurrency limit, the request can be sent again later
+// - DAEMON_SHUTTING_DOWN: the daemon is shutting down and isn't taking requests
+typedef enum daemonStatus {
+    DAEMON_OK, DAEMON_FAILED, DAEMON_INVALID, DAEMON_TIMEOUT, DAEMON_BUSY, DAEMON_SHUTTING_DOWN
+} DaemonStatus;
+
+typedef struct daemonRequestHeader {
+    uint32_t magic;                    // DAEMON_REQUEST_MAGIC
+    uint32_t elementSize;              // bytes of each entry of the operands and the result
+    uint32_t operationLength;          // bytes of the operation name, at most DAEMON_OPERATION_MAX
+    uint32_t operandsSize;             // matrices sent, at most DAEMON_OPERANDS_MAX
+    int32_t power;                     // the power for "power", else ignored
+    uint32_t timeout;                  // milliseconds the operation may take, 0 for the daemon's default
+    uint32_t flags;                    // DAEMON_SHARED_OPERANDS and/or DAEMON_SHARED_RESULT
+    uint32_t reserved;
+} DaemonRequestHeader;
+
+typedef struct daemonOperand {
+    uint64_t rows;                     // dimensions of an operand in shared memory
+    uint64_t columns;
+    uint32_t layout;                   // MatrixLayout of its storage array
+    uint32_t reserved;
+} DaemonOperand;
+
+typedef struct daemonResponseHeader {
+    uint32_t magic;                    // DAEMON_RESPONSE_MAGIC
+    uint32_t status;                   // DaemonStatus
+    uint32_t elementSize;              // bytes of each entry of the result
+    uint32_t isNumber;                 // 1 if the result is a number (determinant), sent as a 1 x 1 matrix
+    uint32_t messageLength;            // bytes of the error message
+    uint32_t layout;                   // MatrixLayout of a result in shared memory
+    uint64_t rows;                     // dimensions of the result
+    uint64_t columns;
+} DaemonResponseHeader;
+
+
+
+
+/***** Functions defined in Daemon.c *****/
+/*
+PRECONDITION
+  - argc/argv are the arguments the program was started with and argv[1] is "--daemon" or "--client".
+POSTCONDITION
+  - Runs the daemon or the client:
+        --daemon <socket> [--workers <n>] [--queue <n>] [--timeout <ms>] [--max-bytes <n>] [--cache <n>]
+            listens on the socket until SIGINT or SIGTERM. The operations of n connections are run at once (default one
+            per processor) and up to n more wait in the queue (default 64), the rest are refused with DAEMON_BUSY.
+            Each operation gets at most the request's timeout (default 30000 ms) and each request at most n bytes of
+            entries sent over the socket (default 1 GiB, operands in shared memory don't count). --cache keeps up to
+            n bytes of results for repeated requests (see matrix_setCacheCapacity). Shutting down stops taking
+            connections, finishes the requests being run and exits.
+        --client <socket> [--timeout <ms>] [--repeat <n>] [--shared] <operation> <operands> [-o <output>]
+            sends a job written the same as for --op (see batch_run) to the daemon with long double entries and writes
+            the result the same way. --shared passes the operands and result in shared memory. --repeat sends the
+            request n times over the connection and prints the mean time per request on stderr.
+  - Returns the exit status of the program: 0 for success, 1 if the daemon couldn't start or the job failed and 2 for
+    invalid arguments.
+*/
+int daemon_run(int argc, char* argv[]);
+
+
+#endif
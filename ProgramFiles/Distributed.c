@@ -0,0 +1,340 @@
+/*
+  Author: Benjamin G. Friedman
+  Date: 10/18/2026
+  File: Distributed.c
+  Description:
+	  - Implementation file for the distributed interface. On one machine the program forks the processes of the group
+		itself and waits for them, stopping the rest as soon as one fails so none of them waits on it forever.
+	  - Each process opens the transport, takes its blocks of the operands from process 0, multiplies them with the
+		others and sends its blocks of the product back to process 0 (see MatrixDistributed.c).
+*/
+
+
+#define _GNU_SOURCE            // fork, kill and sockets
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdint.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include "Distributed.h"
+#include "Batch.h"
+
+
+#define DISTRIBUTED_DEFAULT_PROCESSES 4        // processes started on this machine
+#define DISTRIBUTED_MAX_PROCESSES 64           // the most the shared memory transport connects
+#define DISTRIBUTED_ADDRESS_SIZE 32            // characters of "127.0.0.1:<port>"
+
+
+
+
+/***** Structures *****/
+typedef struct distributedOptions {
+	int processes;
+	Boolean sockets;                   // connect the processes with TCP rather than shared memory
+	size_t blockSize;                  // rows/columns of the blocks the matrices are split into
+	int rank;                          // this process with --hosts, else -1
+	char** addresses;                  // address of each process for TCP
+	char sharedName[64];               // name of the shared memory object for shared memory
+	const char* operands[2];
+	const char* output;                // file the product goes to, NULL for stdout
+} DistributedOptions;
+
+
+
+
+/***** Global variables *****/
+static const char* programName;        // argv[0], the prefix of every error message
+
+
+
+
+/***** Helper functions used only in this file *****/
+/*
+PRECONDITION
+  - pOptions is a pointer to the options, for processes on this machine.
+POSTCONDITION
+  - Starts the processes, each running runProcess, and waits for them. Returns the exit status of the program.
+*/
+static int runLocal(DistributedOptions* pOptions);
+
+
+/*
+PRECONDITION
+  - pOptions is a pointer to the options and rank is this process, from 0 to pOptions->processes - 1.
+POSTCONDITION
+  - Connects to the other processes and does this process's part of the multiplication, reading the operands and
+    writing the product if it's process 0.
+  - Returns SUCCESS, else FAILURE. Only process 0 reports why, unless the transport couldn't be opened.
+*/
+static Status runProcess(const DistributedOptions* pOptions, int rank);
+
+
+/*
+PRECONDITION
+  - addresses is an array of processes addresses that receive the addresses of the processes.
+POSTCONDITION
+  - Finds processes ports on 127.0.0.1 nothing is listening on, different from each other, and writes the addresses.
+    Returns SUCCESS, else FAILURE.
+*/
+static Status pickPorts(char addresses[][DISTRIBUTED_ADDRESS_SIZE], int processes);
+
+
+/*
+PRECONDITION
+  - text is the value of an option.
+  - minimum/maximum are the bounds of the value.
+  - pValue is a pointer to the variable that receives the value.
+POSTCONDITION
+  - Returns SUCCESS, else FAILURE if text isn't an integer from minimum to maximum.
+*/
+static Status parseOption(const char* text, unsigned long long minimum, unsigned long long maximum, unsigned long long* pValue);
+
+
+/*
+PRECONDITION
+  - format is a printf format string and the arguments match it.
+POSTCONDITION
+  - Writes the error message on stderr, prefixed with the program name. Always returns FAILURE.
+*/
+static Status reportError(const char* format, ...);
+
+
+
+
+/***** Functions declared in Distributed.h *****/
+int distributed_run(int argc, char* argv[]) {
+	DistributedOptions options = { DISTRIBUTED_DEFAULT_PROCESSES, FALSE, MATRIX_TILE_SIZE, -1, NULL, "", { NULL, NULL }, NULL };
+	unsigned long long value;
+	char* hosts = NULL;
+	int operandsSize = 0;
+	Boolean valid = TRUE;
+	programName = argv[0];
+
+	for (int i = 2; valid && i < argc; ++i) {
+		if (i + 1 < argc && !strcmp(argv[i], "--processes") && parseOption(argv[i + 1], 1, DISTRIBUTED_MAX_PROCESSES, &value))
+			options.processes = (int)value;
+		else if (i + 1 < argc && !strcmp(argv[i], "--transport") && (!strcmp(argv[i + 1], "shm") || !strcmp(argv[i + 1], "tcp")))
+			options.sockets = strcmp(argv[i + 1], "tcp") ? FALSE : TRUE;
+		else if (i + 1 < argc && !strcmp(argv[i], "--block") && parseOption(argv[i + 1], 1, SIZE_MAX, &value))
+			options.blockSize = (size_t)value;
+		else if (i + 1 < argc && !strcmp(argv[i], "--rank") && parseOption(argv[i + 1], 0, INT_MAX, &value))
+			options.rank = (int)value;
+		else if (i + 1 < argc && !strcmp(argv[i], "--hosts"))
+			hosts = argv[i + 1];
+		else if (i + 1 < argc && !strcmp(argv[i], "-o"))
+			options.output = argv[i + 1];
+		else if (argv[i][0] != '-' && operandsSize < 2) {
+			options.operands[operandsSize++] = argv[i];
+			continue;
+		}
+		else
+			valid = FALSE;
+		++i;
+	}
+	if (!valid || operandsSize != 2 || (hosts ? TRUE : FALSE) != (options.rank >= 0 ? TRUE : FALSE)) {
+		fprintf(stderr, "Usage: %s --distributed [--processes <n>] [--transport shm|tcp] [--block <n>] <A> <B> [-o <output>]\n", programName);
+		fprintf(stderr, "       %s --distributed --rank <r> --hosts <host:port>,... [--block <n>] <A> <B> [-o <output>]\n", programName);
+		return 2;
+	}
+	if (!hosts)
+		return runLocal(&options);
+
+	// one process at each address, split at the commas in place
+	options.processes = 1;
+	for (const char* c = hosts; *c; ++c)
+		options.processes += (*c == ',');
+	if (options.rank >= options.processes) {
+		reportError("rank %d isn't one of the %d hosts", options.rank, options.processes);
+		return 2;
+	}
+	if (!(options.addresses = malloc(options.processes * sizeof(*options.addresses)))) {
+		reportError("memory allocation failure");
+		return 1;
+	}
+	options.addresses[0] = hosts;
+	for (int i = 1; i < options.processes; ++i) {
+		options.addresses[i] = strchr(options.addresses[i - 1], ',');
+		*options.addresses[i]++ = '\0';
+	}
+	options.sockets = TRUE;
+	Status status = runProcess(&options, options.rank);
+	free(options.addresses);
+
+	return status ? 0 : 1;
+}
+
+
+
+
+/***** Helper functions used only in this file *****/
+static int runLocal(DistributedOptions* pOptions) {
+	char addresses[DISTRIBUTED_MAX_PROCESSES][DISTRIBUTED_ADDRESS_SIZE];
+	char* addressPointers[DISTRIBUTED_MAX_PROCESSES];
+	pid_t pids[DISTRIBUTED_MAX_PROCESSES];
+	int processes = pOptions->processes;
+
+	if (pOptions->sockets) {
+		if (!pickPorts(addresses, processes)) {
+			reportError("can't find free ports on 127.0.0.1");
+			return 1;
+		}
+		for (int i = 0; i < processes; ++i)
+			addressPointers[i] = addresses[i];
+		pOptions->addresses = addressPointers;
+	}
+	else
+		snprintf(pOptions->sharedName, sizeof(pOptions->sharedName), "/matrix-distributed-%ld", (long)getpid());
+
+	// the processes start as copies of this one, so nothing it has buffered is written twice
+	fflush(stdout);
+	fflush(stderr);
+	int started;
+	for (started = 0; started < processes; ++started) {
+		pid_t pid = fork();
+		if (pid == 0)
+			exit(runProcess(pOptions, started) ? 0 : 1);
+		if (pid < 0)
+			break;
+		pids[started] = pid;
+	}
+
+	int exitStatus = 0;
+	if (started < processes) {
+		reportError("can't start the processes");
+		exitStatus = 1;
+		for (int i = 0; i < started; ++i)
+			kill(pids[i], SIGTERM);
+	}
+	// once one process fails the others are stopped, since they may be waiting on it
+	for (int remaining = started; remaining; --remaining) {
+		int waitStatus;
+		pid_t pid;
+		while ((pid = waitpid(-1, &waitStatus, 0)) < 0 && errno == EINTR)
+			;
+		if (pid < 0)
+			break;
+		for (int i = 0; i < started; ++i) {
+			if (pids[i] == pid)
+				pids[i] = 0;
+		}
+		if (!WIFEXITED(waitStatus) || WEXITSTATUS(waitStatus)) {
+			for (int i = 0; !exitStatus && i < started; ++i) {
+				if (pids[i] > 0)
+					kill(pids[i], SIGTERM);
+			}
+			exitStatus = 1;
+		}
+	}
+
+	return exitStatus;
+}
+
+
+
+static Status runProcess(const DistributedOptions* pOptions, int rank) {
+	MatrixTransport transport;
+	Status status = pOptions->sockets
+		? matrix_openSocketTransport((const char* const*)pOptions->addresses, rank, pOptions->processes, &transport)
+		: matrix_openSharedMemoryTransport(pOptions->sharedName, rank, pOptions->processes, &transport);
+	if (!status)
+		return reportError("process %d can't connect to the other processes", rank);
+
+	// process 0 distributes nothing if it can't read the operands, which makes the others give up too
+	MATRIX hOperands[2] = { NULL, NULL };
+	if (rank == 0) {
+		for (int i = 0; status && i < 2; ++i) {
+			if (!(hOperands[i] = batch_readMatrix(pOptions->operands[i])))
+				status = reportError("can't read the matrix in %s", pOptions->operands[i]);
+		}
+		if (status && !matrix_canBeMultipliedM(hOperands[0], hOperands[1]))
+			status = reportError("the matrices can't be multiplied");
+	}
+
+	MATRIX_DISTRIBUTED hA = matrix_distribute(&transport, status ? hOperands[0] : NULL, 0, pOptions->blockSize);
+	MATRIX_DISTRIBUTED hB = hA ? matrix_distribute(&transport, hOperands[1], 0, pOptions->blockSize) : NULL;
+	MATRIX_DISTRIBUTED hProduct = NULL;
+	MATRIX hResult = NULL;
+	if (status && !(hB && matrix_multiplyDistributed(hA, hB, &hProduct) && matrix_collect(hProduct, 0, &hResult)))
+		status = (rank == 0) ? reportError("the distributed multiplication failed") : FAILURE;
+	if (status && rank == 0 && !batch_writeMatrix(hResult, pOptions->output))
+		status = reportError("can't write the product to %s", pOptions->output ? pOptions->output : "stdout");
+
+	// closing the transport after a failure wakes up the processes waiting on this one
+	matrix_destroyDistributed(&hA);
+	matrix_destroyDistributed(&hB);
+	matrix_destroyDistributed(&hProduct);
+	for (int i = 0; i < 2; ++i) {
+		if (hOperands[i])
+			matrix_destroy(&hOperands[i]);
+	}
+	if (hResult)
+		matrix_destroy(&hResult);
+	matrix_closeTransport(&transport);
+
+	return status;
+}
+
+
+
+static Status pickPorts(char addresses[][DISTRIBUTED_ADDRESS_SIZE], int processes) {
+	int fds[DISTRIBUTED_MAX_PROCESSES];
+	int opened = 0;
+	Status status = SUCCESS;
+
+	// the ports are held until they're all picked so they're all different, then the processes bind them again
+	while (status && opened < processes) {
+		struct sockaddr_in address;
+		socklen_t length = sizeof(address);
+		memset(&address, 0, sizeof(address));
+		address.sin_family = AF_INET;
+		address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		int fd = socket(AF_INET, SOCK_STREAM, 0);
+		if (fd < 0 || bind(fd, (struct sockaddr*)&address, sizeof(address)) ||
+			getsockname(fd, (struct sockaddr*)&address, &length)) {
+			if (fd >= 0)
+				close(fd);
+			status = FAILURE;
+		}
+		else {
+			snprintf(addresses[opened], DISTRIBUTED_ADDRESS_SIZE, "127.0.0.1:%d", ntohs(address.sin_port));
+			fds[opened++] = fd;
+		}
+	}
+	for (int i = 0; i < opened; ++i)
+		close(fds[i]);
+
+	return status;
+}
+
+
+
+static Status parseOption(const char* text, unsigned long long minimum, unsigned long long maximum, unsigned long long* pValue) {
+	char* end;
+
+	errno = 0;
+	*pValue = strtoull(text, &end, 10);
+
+	return (text[0] >= '0' && text[0] <= '9' && *end == '\0' && errno == 0 && *pValue >= minimum && *pValue <= maximum)
+		? SUCCESS : FAILURE;
+}
+
+
+
+static Status reportError(const char* format, ...) {
+	va_list arguments;
+
+	fprintf(stderr, "%s: ", programName);
+	va_start(arguments, format);
+	vfprintf(stderr, format, arguments);
+	va_end(arguments);
+	fprintf(stderr, "\n");
+
+	return FAILURE;
+}
@@ -0,0 +1,41 @@
+/*
+  Author: Benjamin G. Friedman
+  Date: 10/18/2026
+  File: Distributed.h
+  Description:
+      - Header file for the distributed interface, which multiplies matrices with a group of processes that each hold
+        only their blocks of the operands and the product (see matrix_multiplyDistributed).
+*/
+
+
+#ifndef DISTRIBUTED_H
+#define DISTRIBUTED_H
+
+
+#include "Matrix.h"
+
+
+
+
+/***** Functions defined in Distributed.c *****/
+/*
+PRECONDITION
+  - argc/argv are the arguments the program was started with and argv[1] is "--distributed".
+POSTCONDITION
+  - Multiplies the matrices in the files A and B with a group of processes:
+        --distributed [--processes <n>] [--transport shm|tcp] [--block <n>] <A> <B> [-o <output>]
+            starts n processes on this machine (default 4), connected by shared memory (the default) or by TCP
+            connections on 127.0.0.1, so the distributed mode can be run and tested on one machine.
+        --distributed --rank <r> --hosts <host:port>,... [--block <n>] <A> <B> [-o <output>]
+            runs process r of a group with a process at each address, connected by TCP, i.e. one on each of several
+            machines. Every process is started with the same hosts.
+  - Process 0 reads the operands the same as batch jobs, splits them into blocks of n x n (default 64) dealt out to
+    the processes, and writes the product the same as batch jobs once the others have sent it their blocks of it.
+    The other processes never read or write files, so they can be given any names for them.
+  - Returns the exit status of the program: 0 for success, 1 if the multiplication failed in any process and 2 for
+    invalid arguments.
+*/
+int distributed_run(int argc, char* argv[]);
+
+
+#endif
@@ -0,0 +1,1665 @@
+/*
+  Author: Benjamin G. Friedman
+  Date: 10/18/2026
+  File: Factorization.c
+  Description:
+	  - Implementation file for the matrix factorizations and the solvers built on them.
+*/
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+#include "MatrixInternal.h"
+
+
+#define QR_BLOCK_SIZE 32              // columns per panel in the blocked Householder QR
+#define CHOLESKY_BLOCK_SIZE 64        // columns per panel in the blocked Cholesky factorization
+#define LU_BLOCK_SIZE 64              // columns per panel in the blocked LU factorization
+#define COFACTOR_MAX_SIZE 8           // largest matrix that still uses cofactor expansion when it isn't positive definite
+
+
+
+
+/***** Structures *****/
+// The factorization matrix_solve found for its coefficient matrix, kept with it in the result cache
+typedef enum factorization { FACTORIZATION_SINGULAR, FACTORIZATION_CHOLESKY, FACTORIZATION_LU } Factorization;
+
+// The tasks of the tiled factorizations, run on tile row i and tile column j at step k (see runTileTask)
+typedef enum tileTask {
+	LU_PANEL, LU_ROWS, LU_UPDATE, CHOLESKY_DIAGONAL, CHOLESKY_PANEL, CHOLESKY_UPDATE
+} TileTask;
+
+// The array a tiled factorization works on, shared by its tasks
+typedef struct tiledFactorization {
+	long double* a;                   // row-major n x n array factored in place
+	size_t n;
+	size_t nb;                        // rows/columns of the tiles, except the last ones
+	size_t* pivots;                   // row interchanges of the LU factorization
+	Boolean nonsingular;              // only written by the LU panel tasks, which run one after the other
+	Boolean positiveDefinite;         // only written by the Cholesky diagonal tasks, which run one after the other
+} TiledFactorization;
+
+
+
+
+/***** Helper functions used only in this file *****/
+/*
+PRECONDITION
+  - x points to the first entry of a vector with length entries that are stride apart.
+  - pTau is a pointer to the long double that will hold the scalar factor of the reflector.
+POSTCONDITION
+  - Generates the Householder reflector H = I - tau * v * v^T such that H * x = (beta, 0, ..., 0).
+  - beta is stored in x[0] and the rest of x is overwritten with v (v[0] = 1 is implied and not stored).
+  - If x is already in the form (beta, 0, ..., 0), tau is 0 and H is the identity.
+*/
+static void generateReflector(long double* x, size_t length, size_t stride, long double* pTau);
+
+
+/*
+PRECONDITION
+  - a is a row-major m x ? array with leading dimension lda whose column reflectorColumn holds a reflector
+	generated by generateReflector starting at row reflectorColumn.
+  - tau is the scalar factor of the reflector.
+  - work is an array of at least numColumns long doubles.
+POSTCONDITION
+  - Applies the reflector to the numColumns columns of a starting at firstColumn (rows reflectorColumn to m - 1).
+*/
+static void applyReflector(long double* a, size_t m, size_t lda, size_t reflectorColumn, size_t firstColumn, size_t numColumns,
+	long double tau, long double* work);
+
+
+/*
+PRECONDITION
+  - a is a row-major m x ? array with leading dimension lda.
+  - column/panelColumns describe the panel a[column:m, column:column + panelColumns].
+  - tau is an array that receives a scalar factor for each column of the panel.
+  - work is an array of at least panelColumns long doubles.
+POSTCONDITION
+  - Computes the unblocked Householder QR factorization of the panel in place. The reflectors are stored below
+	the diagonal and the scalar factors in tau[column:column + panelColumns].
+*/
+static void factorPanel(long double* a, size_t m, size_t lda, size_t column, size_t panelColumns, long double* tau, long double* work);
+
+
+/*
+PRECONDITION
+  - a is a row-major m x ? array with leading dimension lda holding nb reflectors starting at column.
+  - v is an array of at least (m - column) * nb long doubles.
+POSTCONDITION
+  - Copies the reflectors into v as a dense (m - column) x nb row-major array with the implied unit diagonal
+	and zeroes above it filled in, so v can be passed directly to multiplyKernel.
+*/
+static void copyReflectors(const long double* a, size_t m, size_t lda, size_t column, size_t nb, long double* v);
+
+
+/*
+PRECONDITION
+  - v is a dense vRows x nb array of reflectors created by copyReflectors.
+  - tau holds the nb scalar factors of the reflectors.
+  - t is an array of at least nb * nb long doubles.
+POSTCONDITION
+  - Stores the nb x nb upper triangular factor T of the compact WY representation in t so that
+	H(1) * H(2) * ... * H(nb) = I - V * T * V^T.
+*/
+static void formBlockFactor(const long double* v, size_t vRows, size_t nb, const long double* tau, long double* t);
+
+
+/*
+PRECONDITION
+  - v/t are the compact WY representation of a block reflector Q = I - V * T * V^T (V is vRows x nb).
+  - c is a row-major vRows x cColumns array with leading dimension ldc.
+  - work is an array of at least 2 * nb * cColumns long doubles.
+POSTCONDITION
+  - Overwrites c with Q^T * c if transpose is TRUE, else Q * c. All the work is done by multiplyKernel.
+*/
+static void applyBlockReflector(Boolean transpose, const long double* v, size_t vRows, size_t nb, const long double* t,
+	long double* c, size_t cColumns, size_t ldc, long double* work);
+
+
+/*
+PRECONDITION
+  - a is a row-major m x n array.
+  - tau is an array of at least min(m, n) long doubles.
+POSTCONDITION
+  - Computes the blocked Householder QR factorization of a in place. R is stored on and above the diagonal,
+	the reflectors below it, and their scalar factors in tau.
+  - Returns SUCCESS, else FAILURE for any memory allocation failure.
+*/
+static Status householderQR(long double* a, size_t m, size_t n, long double* tau);
+
+
+/*
+PRECONDITION
+  - a is a row-major m x n array.
+  - tau is an array of at least min(m, n) long doubles.
+  - permutation is an array of n size_t.
+POSTCONDITION
+  - Computes the Householder QR factorization with column pivoting of a in place, stored the same way as in
+	householderQR. Column i of R corresponds to column permutation[i] of the original a.
+  - The columns are pivoted so the magnitudes of the diagonal of R are non-increasing.
+  - Returns SUCCESS, else FAILURE for any memory allocation failure.
+*/
+static Status pivotedHouseholderQR(long double* a, size_t m, size_t n, long double* tau, size_t* permutation);
+
+
+/*
+PRECONDITION
+  - a/tau hold the first k reflectors of a QR factorization of an m x n array.
+  - c is a row-major m x cColumns array.
+POSTCONDITION
+  - Overwrites c with Q^T * c if transpose is TRUE, else Q * c, applying the reflectors QR_BLOCK_SIZE at a time.
+  - Returns SUCCESS, else FAILURE for any memory allocation failure.
+*/
+static Status applyQ(Boolean transpose, const long double* a, size_t m, size_t n, const long double* tau, size_t k,
+	long double* c, size_t cColumns);
+
+
+/*
+PRECONDITION
+  - a/tau hold the QR factorization of an m x n array.
+  - phQ/phR are pointers to handles to valid matrix objects or NULL handles.
+POSTCONDITION
+  - Stores the m x min(m, n) matrix Q in the handle pointed to by phQ and the min(m, n) x n matrix R in the
+	handle pointed to by phR.
+  - Returns SUCCESS, else FAILURE for any memory allocation failure.
+*/
+static Status copyQR(const long double* a, size_t m, size_t n, const long double* tau, MATRIX* phQ, MATRIX* phR);
+
+
+/*
+PRECONDITION
+  - a holds the R factor of a column pivoted QR factorization of an m x n array.
+POSTCONDITION
+  - Returns the numerical rank, i.e. the number of diagonal entries of R that are larger than
+	max(m, n) * LDBL_EPSILON * |R(0, 0)|.
+*/
+static size_t numericalRank(const long double* a, size_t m, size_t n);
+
+
+/*
+PRECONDITION
+  - r is a row-major array with leading dimension ldr whose leading size x size block is upper triangular
+	with a nonzero diagonal.
+  - c is a row-major array with cColumns columns and at least size rows.
+POSTCONDITION
+  - Overwrites the first size rows of c with the solution x of R * x = c.
+*/
+static void backSubstitute(const long double* r, size_t ldr, size_t size, long double* c, size_t cColumns);
+
+
+/*
+PRECONDITION
+  - pMatrix is a pointer to a valid square matrix object.
+POSTCONDITION
+  - Returns TRUE if the matrix is symmetric and its diagonal is positive, else FALSE.
+  - This is the cheap test for whether it's worth attempting a Cholesky factorization. Only the factorization itself
+	can confirm the matrix is positive definite.
+*/
+static Boolean mightBePositiveDefinite(const Matrix* pMatrix);
+
+
+/*
+PRECONDITION
+  - a is a row-major n x n symmetric array. Only its lower triangle is used.
+POSTCONDITION
+  - Computes the blocked Cholesky factorization A = L * L^T in place. L is stored in the lower triangle and
+	the upper triangle is set to 0.
+  - Returns TRUE if a is positive definite, else FALSE (the contents of a are then unspecified).
+*/
+static Boolean choleskyFactor(long double* a, size_t n);
+
+
+/*
+PRECONDITION
+  - l is a row-major n x n array holding a Cholesky factor.
+  - c is a row-major n x cColumns array.
+POSTCONDITION
+  - Overwrites c with the solution x of L * L^T * x = c.
+*/
+static void choleskySolve(const long double* l, size_t n, long double* c, size_t cColumns);
+
+
+/*
+PRECONDITION
+  - a is a row-major n x n array.
+POSTCONDITION
+  - Sets the entries above the diagonal to 0.
+*/
+static void clearUpperTriangle(long double* a, size_t n);
+
+
+/*
+PRECONDITION
+  - The same as for luFactor.
+  - pNonsingular is a pointer to the Boolean that receives what luFactor returns.
+POSTCONDITION
+  - Computes the same factorization as luFactor as a graph of tile tasks run by runTaskGraph. The panel of step k
+	(all of its tile column) is one task. Its row interchanges are applied to each tile column on the right with the
+	solve for the tile of U above the update, and to the columns on the left once the graph has run.
+  - Returns SUCCESS, else FAILURE for any memory allocation failure, in which case a is unchanged.
+*/
+static Status tiledLU(long double* a, size_t n, size_t* pivots, Boolean* pNonsingular);
+
+
+/*
+PRECONDITION
+  - The same as for choleskyFactor.
+  - pPositiveDefinite is a pointer to the Boolean that receives what choleskyFactor returns.
+POSTCONDITION
+  - Computes the same factorization as choleskyFactor as a graph of tile tasks run by runTaskGraph: the diagonal tile
+	of step k, the tiles below it and the updates of the tiles of the lower triangle of the trailing matrix.
+  - Returns SUCCESS, else FAILURE for any memory allocation failure, in which case a is unchanged.
+*/
+static Status tiledCholesky(long double* a, size_t n, Boolean* pPositiveDefinite);
+
+
+/*
+PRECONDITION
+  - pGraph is a pointer to the empty task graph of a tiled factorization of a matrix of tiles x tiles tiles.
+  - lastWriter is an array of tiles * tiles task ids set to TASK_NONE.
+POSTCONDITION
+  - Adds the tasks of the factorization and their dependencies, each task depending on the last one to write any
+	tile it uses, which lastWriter keeps track of. Allocation failure is left to runTaskGraph to report.
+*/
+static void addLUTasks(TaskGraph* pGraph, size_t tiles, size_t* lastWriter);
+static void addCholeskyTasks(TaskGraph* pGraph, size_t tiles, size_t* lastWriter);
+
+
+/*
+PRECONDITION
+  - context is a pointer to the TiledFactorization of the graph, kind is the task and i/j/k are the tile row, tile
+	column and step it's run on.
+POSTCONDITION
+  - Runs the task, the same as the same step of the blocked factorization does for the tiles:
+	LU_PANEL factors tile column k from the diagonal down with partial pivoting, only swapping rows within it.
+	LU_ROWS applies the row interchanges of step k to tile column j and solves for the tile of U in row k.
+	LU_UPDATE subtracts L(i, k) * U(k, j) from tile (i, j).
+	CHOLESKY_DIAGONAL factors the diagonal tile k, CHOLESKY_PANEL solves for L(i, k) and CHOLESKY_UPDATE subtracts
+	L(i, k) * L(j, k)^T from tile (i, j).
+  - Returns FALSE if CHOLESKY_DIAGONAL finds the matrix isn't positive definite, which stops the graph, else TRUE.
+*/
+static Boolean runTileTask(void* context, int kind, size_t i, size_t j, size_t k);
+
+
+
+/*
+PRECONDITION
+  - The same as matrix_qr.
+POSTCONDITION
+  - Factors the matrix the same as matrix_qr, without measuring the call.
+*/
+static Status factorQR(MATRIX hMatrix, MATRIX* phQ, MATRIX* phR);
+
+
+/*
+PRECONDITION
+  - The same as matrix_qrPivoted.
+POSTCONDITION
+  - Factors the matrix the same as matrix_qrPivoted, without measuring the call.
+*/
+static Status factorQRPivoted(MATRIX hMatrix, MATRIX* phQ, MATRIX* phR, size_t* permutation, size_t* pRank);
+
+
+/*
+PRECONDITION
+  - The same as matrix_leastSquares.
+POSTCONDITION
+  - Solves the least squares problem the same as matrix_leastSquares, without measuring the call.
+*/
+static Status solveLeastSquares(MATRIX hA, MATRIX hB, MATRIX* phX);
+
+
+/*
+PRECONDITION
+  - The same as matrix_leastSquaresPivoted.
+POSTCONDITION
+  - Solves the least squares problem the same as matrix_leastSquaresPivoted, without measuring the call.
+*/
+static Status solveLeastSquaresPivoted(MATRIX hA, MATRIX hB, MATRIX* phX, size_t* pRank);
+
+
+/*
+PRECONDITION
+  - The same as matrix_cholesky.
+POSTCONDITION
+  - Factors the matrix the same as matrix_cholesky, without measuring the call.
+*/
+static Status factorCholesky(MATRIX hMatrix, MATRIX* phL, Boolean* pIsPositiveDefinite);
+
+
+/*
+PRECONDITION
+  - The same as matrix_solve.
+POSTCONDITION
+  - Solves the system the same as matrix_solve, without measuring the call.
+*/
+static Status solveSystem(MATRIX hA, MATRIX hB, MATRIX* phX, Boolean* pMatrixIsVertible);
+
+
+
+/***** Functions declared in Matrix.h *****/
+Status matrix_qr(MATRIX hMatrix, MATRIX* phQ, MATRIX* phR) {
+	Matrix* pMatrix = hMatrix;
+	double m = pMatrix->rows, n = pMatrix->columns, k = (m < n) ? m : n;
+	MeasuredCall call;
+
+	beginCall(&call, MATRIX_OPERATION_QR, hMatrix);
+	Status status = factorQR(hMatrix, phQ, phR);
+	endCall(&call, status ? 4 * m * n * k - 4 * k * k * k / 3 : 0);
+
+	return status;
+}
+
+
+
+Status matrix_qrPivoted(MATRIX hMatrix, MATRIX* phQ, MATRIX* phR, size_t* permutation, size_t* pRank) {
+	Matrix* pMatrix = hMatrix;
+	double m = pMatrix->rows, n = pMatrix->columns, k = (m < n) ? m : n;
+	MeasuredCall call;
+
+	beginCall(&call, MATRIX_OPERATION_QR_PIVOTED, hMatrix);
+	Status status = factorQRPivoted(hMatrix, phQ, phR, permutation, pRank);
+	endCall(&call, status ? 4 * m * n * k - 4 * k * k * k / 3 : 0);
+
+	return status;
+}
+
+
+
+Status matrix_leastSquares(MATRIX hA, MATRIX hB, MATRIX* phX) {
+	Matrix* pA = hA;
+	double m = pA->rows, n = pA->columns, k = (m < n) ? m : n, rhs = ((Matrix*)hB)->columns;
+	MeasuredCall call;
+
+	beginCall(&call, MATRIX_OPERATION_LEAST_SQUARES, hA);
+	Status status = solveLeastSquares(hA, hB, phX);
+	endCall(&call, status ? 2 * m * n * k - 2 * k * k * k / 3 + 4 * m * k * rhs : 0);
+
+	return status;
+}
+
+
+
+Status matrix_leastSquaresPivoted(MATRIX hA, MATRIX hB, MATRIX* phX, size_t* pRank) {
+	Matrix* pA = hA;
+	double m = pA->rows, n = pA->columns, k = (m < n) ? m : n, rhs = ((Matrix*)hB)->columns;
+	MeasuredCall call;
+
+	beginCall(&call, MATRIX_OPERATION_LEAST_SQUARES_PIVOTED, hA);
+	Status status = solveLeastSquaresPivoted(hA, hB, phX, pRank);
+	endCall(&call, status ? 2 * m * n * k - 2 * k * k * k / 3 + 4 * m * k * rhs : 0);
+
+	return status;
+}
+
+
+
+Status matrix_cholesky(MATRIX hMatrix, MATRIX* phL, Boolean* pIsPositiveDefinite) {
+	Matrix* pMatrix = hMatrix;
+	double n = pMatrix->rows;
+	MeasuredCall call;
+
+	beginCall(&call, MATRIX_OPERATION_CHOLESKY, hMatrix);
+	Status status = factorCholesky(hMatrix, phL, pIsPositiveDefinite);
+	endCall(&call, status ? n * n * n / 3 : 0);
+
+	return status;
+}
+
+
+
+Status matrix_solve(MATRIX hA, MATRIX hB, MATRIX* phX, Boolean* pMatrixIsVertible) {
+	Matrix* pA = hA;
+	double n = pA->rows, rhs = ((Matrix*)hB)->columns;
+	MeasuredCall call;
+
+	beginCall(&call, MATRIX_OPERATION_SOLVE, hA);
+	Status status = solveSystem(hA, hB, phX, pMatrixIsVertible);
+	endCall(&call, status ? 2 * n * n * n / 3 + 2 * n * n * rhs : 0);
+
+	return status;
+}
+
+
+
+
+/***** Helper functions shared with the other matrix implementation files - declared in MatrixInternal.h *****/
+Status determinantFromFactorization(const Matrix* pMatrix, long double* pDeterminant, Boolean* pFactored) {
+	size_t n = pMatrix->rows;
+	long double* a;                   // working copy that is factored in place
+	size_t* pivots;                   // row interchanges of the LU factorization
+	*pFactored = FALSE;
+
+	// small matrices that aren't candidates for Cholesky are left to cofactor expansion
+	Boolean tryCholesky = mightBePositiveDefinite(pMatrix);
+	if (!tryCholesky && n <= COFACTOR_MAX_SIZE)
+		return SUCCESS;
+
+	if (!(a = allocateMemory(n * n * sizeof(*a))))
+		return FAILURE;
+	if (!(pivots = allocateMemory(n * sizeof(*pivots)))) {
+		freeMemory(a);
+		return FAILURE;
+	}
+	copyToRowMajor(pMatrix, a);
+
+	// det(A) = det(L)^2 for the Cholesky factorization
+	if (tryCholesky && choleskyFactor(a, n)) {
+		long double product = 1;
+		for (size_t i = 0; i < n; ++i)
+			product *= a[i * n + i];
+		*pDeterminant = product * product;
+		*pFactored = TRUE;
+	}
+	// det(A) = +/- det(U) for the LU factorization depending on the number of row interchanges
+	else if (n > COFACTOR_MAX_SIZE) {
+		copyToRowMajor(pMatrix, a);
+		long double product = 1;
+		if (luFactor(a, n, pivots)) {
+			for (size_t i = 0; i < n; ++i) {
+				product *= a[i * n + i];
+				if (pivots[i] != i)
+					product = -product;
+			}
+		}
+		else
+			product = 0;
+		*pDeterminant = product;
+		*pFactored = TRUE;
+	}
+
+	freeMemory(a);
+	freeMemory(pivots);
+
+	return SUCCESS;
+}
+
+
+
+Status inverseFromFactorization(const Matrix* pMatrix, Matrix* pResult, Boolean* pFactored, Boolean* pMatrixIsVertible) {
+	size_t n = pMatrix->rows;
+	long double* a;                   // working copy that is factored in place
+	size_t* pivots;                   // row interchanges of the LU factorization
+	*pFactored = FALSE;
+
+	// small matrices that aren't candidates for Cholesky are left to the adjugate
+	Boolean tryCholesky = mightBePositiveDefinite(pMatrix);
+	if (!tryCholesky && n <= COFACTOR_MAX_SIZE)
+		return SUCCESS;
+
+	if (!(a = allocateMemory(n * n * sizeof(*a))))
+		return FAILURE;
+	if (!(pivots = allocateMemory(n * sizeof(*pivots)))) {
+		freeMemory(a);
+		return FAILURE;
+	}
+	copyToRowMajor(pMatrix, a);
+
+	// the inverse is the solution of A * X = I, which is solved directly in the result when it's row-major and isn't
+	// the matrix itself. A saved copy of A is kept for the LU factorization if the Cholesky factorization fails.
+	long double* x = pResult->matrix;
+	long double* saved = NULL;
+	Boolean solveInResult = (pResult->layout == MATRIX_ROW_MAJOR && pResult != pMatrix) ? TRUE : FALSE;
+	if ((!solveInResult && !(x = allocateMemory(n * n * sizeof(*x))))
+		|| (tryCholesky && n > COFACTOR_MAX_SIZE && !(saved = allocateMemory(n * n * sizeof(*saved))))) {
+		if (!solveInResult)
+			freeMemory(x);
+		freeMemory(a);
+		freeMemory(pivots);
+		return FAILURE;
+	}
+	if (saved)
+		memcpy(saved, a, n * n * sizeof(*saved));
+	for (size_t i = 0; i < n; ++i) {
+		for (size_t j = 0; j < n; ++j)
+			x[i * n + j] = (i == j) ? 1 : 0;
+	}
+	if (tryCholesky && choleskyFactor(a, n)) {
+		choleskySolve(a, n, x, n);
+		*pFactored = TRUE;
+		*pMatrixIsVertible = TRUE;
+	}
+	else if (n > COFACTOR_MAX_SIZE) {
+		if (saved)
+			memcpy(a, saved, n * n * sizeof(*a));
+		*pMatrixIsVertible = luFactor(a, n, pivots);
+		if (*pMatrixIsVertible)
+			luSolve(a, n, pivots, x, n);
+		*pFactored = TRUE;
+	}
+	if (*pFactored && *pMatrixIsVertible) {
+		if (!solveInResult)
+			copyFromRowMajor(pResult, x);
+		pResult->maxLength = 0;
+	}
+
+	if (!solveInResult)
+		freeMemory(x);
+	freeMemory(saved);
+	freeMemory(a);
+	freeMemory(pivots);
+
+	return SUCCESS;
+}
+
+
+
+Boolean luFactor(long double* a, size_t n, size_t* pivots) {
+	size_t nb = LU_BLOCK_SIZE;
+	Boolean nonsingular = TRUE;
+	TraceSpan span;
+
+	// large matrices are factored by tile tasks on several threads, unless the graph couldn't be allocated
+	if (n >= MATRIX_TASK_MIN_SIZE && taskThreads() > 1 && tiledLU(a, n, pivots, &nonsingular))
+		return nonsingular;
+
+	for (size_t j = 0; j < n; j += nb) {
+		size_t jb = (n - j < nb) ? n - j : nb;
+
+		// factor the panel - whole rows are swapped so the interchanges are applied to the rest of the matrix too
+		beginSpan(&span, "luPanel", n - j, jb);
+		for (size_t jj = j; jj < j + jb; ++jj) {
+			size_t pivot = jj;
+			for (size_t i = jj + 1; i < n; ++i) {
+				if (fabsl(a[i * n + jj]) > fabsl(a[pivot * n + jj]))
+					pivot = i;
+			}
+			pivots[jj] = pivot;
+			if (a[pivot * n + jj] == 0) {
+				nonsingular = FALSE;
+				continue;
+			}
+			if (pivot != jj) {
+				long double* rowJ = a + jj * n;
+				long double* rowPivot = a + pivot * n;
+				for (size_t column = 0; column < n; ++column) {
+					long double temp = rowJ[column];
+					rowJ[column] = rowPivot[column];
+					rowPivot[column] = temp;
+				}
+			}
+
+			const long double* rowJ = a + jj * n;
+			for (size_t i = jj + 1; i < n; ++i) {
+				long double* rowI = a + i * n;
+				rowI[jj] /= rowJ[jj];
+				for (size_t column = jj + 1; column < j + jb; ++column)
+					rowI[column] -= rowI[jj] * rowJ[column];
+			}
+		}
+		endSpan(&span);
+
+		if (j + jb < n) {
+			beginSpan(&span, "luUpdate", n - j - jb, n - j - jb);
+			// U12 = L11^-1 * A12
+			for (size_t i = j + 1; i < j + jb; ++i) {
+				long double* rowI = a + i * n;
+				for (size_t p = j; p < i; ++p) {
+					const long double* rowP = a + p * n;
+					for (size_t column = j + jb; column < n; ++column)
+						rowI[column] -= rowI[p] * rowP[column];
+				}
+			}
+
+			// A22 = A22 - L21 * U12
+			multiplyKernel(FALSE, FALSE, n - j - jb, n - j - jb, jb, -1, a + (j + jb) * n + j, n,
+				a + j * n + j + jb, n, 1, a + (j + jb) * n + j + jb, n);
+			endSpan(&span);
+		}
+	}
+
+	return nonsingular;
+}
+
+
+
+void luSolve(const long double* lu, size_t n, const size_t* pivots, long double* c, size_t cColumns) {
+	// apply the row interchanges
+	for (size_t i = 0; i < n; ++i) {
+		if (pivots[i] != i) {
+			long double* rowI = c + i * cColumns;
+			long double* rowPivot = c + pivots[i] * cColumns;
+			for (size_t column = 0; column < cColumns; ++column) {
+				long double temp = rowI[column];
+				rowI[column] = rowPivot[column];
+				rowPivot[column] = temp;
+			}
+		}
+	}
+
+	// forward substitution with the unit lower triangular L
+	for (size_t i = 1; i < n; ++i) {
+		long double* cRow = c + i * cColumns;
+		for (size_t p = 0; p < i; ++p) {
+			long double lip = lu[i * n + p];
+			const long double* solvedRow = c + p * cColumns;
+			for (size_t column = 0; column < cColumns; ++column)
+				cRow[column] -= lip * solvedRow[column];
+		}
+	}
+
+	// back substitution with U
+	backSubstitute(lu, n, n, c, cColumns);
+}
+
+
+
+/***** Helper functions used only in this file *****/
+static void generateReflector(long double* x, size_t length, size_t stride, long double* pTau) {
+	long double alpha = x[0];
+	long double sumOfSquares = 0;
+
+	for (size_t i = 1; i < length; ++i)
+		sumOfSquares += x[i * stride] * x[i * stride];
+
+	// nothing to annihilate
+	if (sumOfSquares == 0) {
+		*pTau = 0;
+		return;
+	}
+
+	long double beta = -copysignl(hypotl(alpha, sqrtl(sumOfSquares)), alpha);
+	long double scale = 1 / (alpha - beta);
+	*pTau = (beta - alpha) / beta;
+	for (size_t i = 1; i < length; ++i)
+		x[i * stride] *= scale;
+	x[0] = beta;
+}
+
+
+
+static void applyReflector(long double* a, size_t m, size_t lda, size_t reflectorColumn, size_t firstColumn, size_t numColumns,
+	long double tau, long double* work) {
+	long double* row = a + reflectorColumn * lda + firstColumn;
+
+	// work = v^T * a, walking the rows so the inner loops are contiguous
+	for (size_t j = 0; j < numColumns; ++j)
+		work[j] = row[j];
+	for (size_t i = reflectorColumn + 1; i < m; ++i) {
+		long double vi = a[i * lda + reflectorColumn];
+		row = a + i * lda + firstColumn;
+		for (size_t j = 0; j < numColumns; ++j)
+			work[j] += vi * row[j];
+	}
+	for (size_t j = 0; j < numColumns; ++j)
+		work[j] *= tau;
+
+	// a = a - v * work
+	row = a + reflectorColumn * lda + firstColumn;
+	for (size_t j = 0; j < numColumns; ++j)
+		row[j] -= work[j];
+	for (size_t i = reflectorColumn + 1; i < m; ++i) {
+		long double vi = a[i * lda + reflectorColumn];
+		row = a + i * lda + firstColumn;
+		for (size_t j = 0; j < numColumns; ++j)
+			row[j] -= vi * work[j];
+	}
+}
+
+
+
+static void factorPanel(long double* a, size_t m, size_t lda, size_t column, size_t panelColumns, long double* tau, long double* work) {
+	for (size_t j = column; j < column + panelColumns; ++j) {
+		generateReflector(a + j * lda + j, m - j, lda, &tau[j]);
+		size_t remainingColumns = column + panelColumns - (j + 1);
+		if (remainingColumns > 0 && tau[j] != 0)
+			applyReflector(a, m, lda, j, j + 1, remainingColumns, tau[j], work);
+	}
+}
+
+
+
+static void copyReflectors(const long double* a, size_t m, size_t lda, size_t column, size_t nb, long double* v) {
+	for (size_t i = 0; i < m - column; ++i) {
+		for (size_t j = 0; j < nb; ++j) {
+			if (i < j)
+				v[i * nb + j] = 0;
+			else if (i == j)
+				v[i * nb + j] = 1;
+			else
+				v[i * nb + j] = a[(column + i) * lda + column + j];
+		}
+	}
+}
+
+
+
+static void formBlockFactor(const long double* v, size_t vRows, size_t nb, const long double* tau, long double* t) {
+	for (size_t i = 0; i < nb * nb; ++i)
+		t[i] = 0;
+
+	for (size_t i = 0; i < nb; ++i) {
+		t[i * nb + i] = tau[i];
+		if (tau[i] == 0)
+			continue;
+
+		// t[0:i, i] = V[:, 0:i]^T * v_i (v_i is 0 above row i)
+		for (size_t row = i; row < vRows; ++row) {
+			long double vi = v[row * nb + i];
+			for (size_t r = 0; r < i; ++r)
+				t[r * nb + i] += v[row * nb + r] * vi;
+		}
+
+		// t[0:i, i] = -tau_i * T[0:i, 0:i] * t[0:i, i] - going down the rows only uses entries that haven't been overwritten
+		for (size_t r = 0; r < i; ++r) {
+			long double sum = 0;
+			for (size_t s = r; s < i; ++s)
+				sum += t[r * nb + s] * t[s * nb + i];
+			t[r * nb + i] = -tau[i] * sum;
+		}
+	}
+}
+
+
+
+static void applyBlockReflector(Boolean transpose, const long double* v, size_t vRows, size_t nb, const long double* t,
+	long double* c, size_t cColumns, size_t ldc, long double* work) {
+	long double* w1 = work;                                   // V^T * c
+	long double* w2 = work + nb * cColumns;                   // op(T) * V^T * c
+
+	multiplyKernel(TRUE, FALSE, nb, cColumns, vRows, 1, v, nb, c, ldc, 0, w1, cColumns);
+	multiplyKernel(transpose, FALSE, nb, cColumns, nb, 1, t, nb, w1, cColumns, 0, w2, cColumns);
+	multiplyKernel(FALSE, FALSE, vRows, cColumns, nb, -1, v, nb, w2, cColumns, 1, c, ldc);
+}
+
+
+
+static Status householderQR(long double* a, size_t m, size_t n, long double* tau) {
+	size_t k = (m < n) ? m : n;
+	size_t nb = QR_BLOCK_SIZE;
+	long double* v;              // dense copy of the reflectors of the current panel
+	long double* t;              // triangular factor of the current panel
+	long double* work;           // scratch space for the panel and the trailing update
+	TraceSpan span;
+
+	if (!(v = allocateMemory(m * nb * sizeof(*v))))
+		return FAILURE;
+	if (!(t = allocateMemory(nb * nb * sizeof(*t)))) {
+		freeMemory(v);
+		return FAILURE;
+	}
+	if (!(work = allocateMemory(2 * nb * n * sizeof(*work)))) {
+		freeMemory(v);
+		freeMemory(t);
+		return FAILURE;
+	}
+
+	for (size_t j = 0; j < k; j += nb) {
+		size_t jb = (k - j < nb) ? k - j : nb;
+
+		// factor the panel, then update the trailing columns with the compact WY form of the panel
+		beginSpan(&span, "qrPanel", m - j, jb);
+		factorPanel(a, m, n, j, jb, tau, work);
+		endSpan(&span);
+		if (j + jb < n) {
+			beginSpan(&span, "qrUpdate", m - j, n - j - jb);
+			copyReflectors(a, m, n, j, jb, v);
+			formBlockFactor(v, m - j, jb, tau + j, t);
+			applyBlockReflector(TRUE, v, m - j, jb, t, a + j * n + j + jb, n - j - jb, n, work);
+			endSpan(&span);
+		}
+	}
+
+	freeMemory(v);
+	freeMemory(t);
+	freeMemory(work);
+
+	return SUCCESS;
+}
+
+
+
+static Status pivotedHouseholderQR(long double* a, size_t m, size_t n, long double* tau, size_t* permutation) {
+	size_t k = (m < n) ? m : n;
+	long double tolerance = sqrtl(LDBL_EPSILON);        // when a downdated norm has lost too much accuracy it is recomputed
+	long double* norms;                                 // norms of the trailing part of each column
+	long double* originalNorms;                         // norms at the last time they were computed directly
+	long double* work;                                  // scratch space for applying the reflectors
+
+	if (!(norms = allocateMemory(n * sizeof(*norms))))
+		return FAILURE;
+	if (!(originalNorms = allocateMemory(n * sizeof(*originalNorms)))) {
+		freeMemory(norms);
+		return FAILURE;
+	}
+	if (!(work = allocateMemory(n * sizeof(*work)))) {
+		freeMemory(norms);
+		freeMemory(originalNorms);
+		return FAILURE;
+	}
+
+	for (size_t j = 0; j < n; ++j) {
+		permutation[j] = j;
+		norms[j] = 0;
+	}
+	for (size_t i = 0; i < m; ++i) {
+		for (size_t j = 0; j < n; ++j)
+			norms[j] += a[i * n + j] * a[i * n + j];
+	}
+	for (size_t j = 0; j < n; ++j) {
+		norms[j] = sqrtl(norms[j]);
+		originalNorms[j] = norms[j];
+	}
+
+	for (size_t j = 0; j < k; ++j) {
+		// move the column with the largest remaining norm into position j
+		size_t pivot = j;
+		for (size_t column = j + 1; column < n; ++column) {
+			if (norms[column] > norms[pivot])
+				pivot = column;
+		}
+		if (pivot != j) {
+			for (size_t i = 0; i < m; ++i) {
+				long double temp = a[i * n + j];
+				a[i * n + j] = a[i * n + pivot];
+				a[i * n + pivot] = temp;
+			}
+			size_t tempIndex = permutation[j];
+			permutation[j] = permutation[pivot];
+			permutation[pivot] = tempIndex;
+			norms[pivot] = norms[j];
+			originalNorms[pivot] = originalNorms[j];
+		}
+
+		generateReflector(a + j * n + j, m - j, n, &tau[j]);
+		if (j + 1 < n && tau[j] != 0)
+			applyReflector(a, m, n, j, j + 1, n - j - 1, tau[j], work);
+
+		// downdate the trailing column norms
+		for (size_t column = j + 1; column < n; ++column) {
+			if (norms[column] == 0)
+				continue;
+			long double ratio = fabsl(a[j * n + column]) / norms[column];
+			long double temp = 1 - ratio * ratio;
+			if (temp < 0)
+				temp = 0;
+			ratio = norms[column] / originalNorms[column];
+			if (temp * ratio * ratio <= tolerance) {
+				long double sumOfSquares = 0;
+				for (size_t i = j + 1; i < m; ++i)
+					sumOfSquares += a[i * n + column] * a[i * n + column];
+				norms[column] = sqrtl(sumOfSquares);
+				originalNorms[column] = norms[column];
+			}
+			else
+				norms[column] *= sqrtl(temp);
+		}
+	}
+
+	freeMemory(norms);
+	freeMemory(originalNorms);
+	freeMemory(work);
+
+	return SUCCESS;
+}
+
+
+
+static Status applyQ(Boolean transpose, const long double* a, size_t m, size_t n, const long double* tau, size_t k,
+	long double* c, size_t cColumns) {
+	size_t nb = QR_BLOCK_SIZE;
+	long double* v;              // dense copy of the reflectors of the current block
+	long double* t;              // triangular factor of the current block
+	long double* work;           // scratch space for applyBlockReflector
+
+	if (k == 0)
+		return SUCCESS;
+	if (!(v = allocateMemory(m * nb * sizeof(*v))))
+		return FAILURE;
+	if (!(t = allocateMemory(nb * nb * sizeof(*t)))) {
+		freeMemory(v);
+		return FAILURE;
+	}
+	if (!(work = allocateMemory(2 * nb * cColumns * sizeof(*work)))) {
+		freeMemory(v);
+		freeMemory(t);
+		return FAILURE;
+	}
+
+	// Q^T = H(k) * ... * H(1) applies the blocks first to last, Q = H(1) * ... * H(k) applies them last to first
+	size_t numBlocks = (k + nb - 1) / nb;
+	for (size_t block = 0; block < numBlocks; ++block) {
+		size_t j = (transpose ? block : numBlocks - 1 - block) * nb;
+		size_t jb = (k - j < nb) ? k - j : nb;
+		copyReflectors(a, m, n, j, jb, v);
+		formBlockFactor(v, m - j, jb, tau + j, t);
+		applyBlockReflector(transpose, v, m - j, jb, t, c + j * cColumns, cColumns, cColumns, work);
+	}
+
+	freeMemory(v);
+	freeMemory(t);
+	freeMemory(work);
+
+	return SUCCESS;
+}
+
+
+
+static Status copyQR(const long double* a, size_t m, size_t n, const long double* tau, MATRIX* phQ, MATRIX* phR) {
+	size_t k = (m < n) ? m : n;
+
+	// R is the upper triangle of the factored array
+	if (!adjustMatrixDimensions((Matrix**)phR, k, n))
+		return FAILURE;
+	Matrix* pR = *phR;
+	for (size_t i = 0; i < k; ++i) {
+		for (size_t j = 0; j < n; ++j)
+			pR->matrix[matrixIndex(pR, i, j)] = (j < i) ? 0 : a[i * n + j];
+	}
+	pR->maxLength = 0;
+
+	// Q is the first k columns of the identity with the reflectors applied to them.
+	// it's formed directly in the result when the result is row-major.
+	if (!adjustMatrixDimensions((Matrix**)phQ, m, k))
+		return FAILURE;
+	Matrix* pQ = *phQ;
+	long double* q = pQ->matrix;
+	if (pQ->layout != MATRIX_ROW_MAJOR && !(q = allocateMemory(m * k * sizeof(*q))))
+		return FAILURE;
+	for (size_t i = 0; i < m; ++i) {
+		for (size_t j = 0; j < k; ++j)
+			q[i * k + j] = (i == j) ? 1 : 0;
+	}
+	Status status = applyQ(FALSE, a, m, n, tau, k, q, k);
+	if (q != pQ->matrix) {
+		if (status)
+			copyFromRowMajor(pQ, q);
+		freeMemory(q);
+	}
+	if (status)
+		pQ->maxLength = 0;
+
+	return status;
+}
+
+
+
+static size_t numericalRank(const long double* a, size_t m, size_t n) {
+	size_t k = (m < n) ? m : n;
+	long double tolerance = ((m > n) ? m : n) * LDBL_EPSILON * fabsl(a[0]);
+	size_t rank = 0;
+
+	while (rank < k && fabsl(a[rank * n + rank]) > tolerance)
+		++rank;
+
+	return rank;
+}
+
+
+
+static void backSubstitute(const long double* r, size_t ldr, size_t size, long double* c, size_t cColumns) {
+	for (size_t i = size; i-- > 0;) {
+		long double* cRow = c + i * cColumns;
+		for (size_t j = i + 1; j < size; ++j) {
+			long double rij = r[i * ldr + j];
+			const long double* solvedRow = c + j * cColumns;
+			for (size_t column = 0; column < cColumns; ++column)
+				cRow[column] -= rij * solvedRow[column];
+		}
+		for (size_t column = 0; column < cColumns; ++column)
+			cRow[column] /= r[i * ldr + i];
+	}
+}
+
+
+
+
+static Boolean mightBePositiveDefinite(const Matrix* pMatrix) {
+	size_t n = pMatrix->rows;
+
+	if (n != pMatrix->columns)
+		return FALSE;
+	for (size_t i = 0; i < n; ++i) {
+		if (!(pMatrix->matrix[matrixIndex(pMatrix, i, i)] > 0))
+			return FALSE;
+		for (size_t j = 0; j < i; ++j) {
+			if (pMatrix->matrix[matrixIndex(pMatrix, i, j)] != pMatrix->matrix[matrixIndex(pMatrix, j, i)])
+				return FALSE;
+		}
+	}
+
+	return TRUE;
+}
+
+
+
+static Boolean choleskyFactor(long double* a, size_t n) {
+	size_t nb = CHOLESKY_BLOCK_SIZE;
+	TraceSpan span;
+
+	if (n >= MATRIX_TASK_MIN_SIZE && taskThreads() > 1) {
+		Boolean positiveDefinite;
+		if (tiledCholesky(a, n, &positiveDefinite))
+			return positiveDefinite;
+	}
+
+	for (size_t j = 0; j < n; j += nb) {
+		size_t jb = (n - j < nb) ? n - j : nb;
+
+		// factor the diagonal block - the earlier panels have already been subtracted from it
+		beginSpan(&span, "choleskyPanel", n - j, jb);
+		for (size_t jj = j; jj < j + jb; ++jj) {
+			long double* rowJ = a + jj * n;
+			long double diagonal = rowJ[jj];
+			for (size_t p = j; p < jj; ++p)
+				diagonal -= rowJ[p] * rowJ[p];
+			if (!(diagonal > 0)) {
+				endSpan(&span);
+				return FALSE;        // not positive definite
+			}
+			rowJ[jj] = sqrtl(diagonal);
+			// solve for the rest of column jj of the panel, including the rows below the diagonal block
+			for (size_t i = jj + 1; i < n; ++i) {
+				long double* rowI = a + i * n;
+				long double entry = rowI[jj];
+				for (size_t p = j; p < jj; ++p)
+					entry -= rowI[p] * rowJ[p];
+				rowI[jj] = entry / rowJ[jj];
+			}
+		}
+		endSpan(&span);
+
+		// update the lower triangle of the trailing matrix with the panel, one block row at a time
+		beginSpan(&span, "choleskyUpdate", n - j - jb, n - j - jb);
+		for (size_t i = j + jb; i < n; i += nb) {
+			size_t ib = (n - i < nb) ? n - i : nb;
+			multiplyKernel(FALSE, TRUE, ib, i + ib - (j + jb), jb, -1, a + i * n + j, n,
+				a + (j + jb) * n + j, n, 1, a + i * n + j + jb, n);
+		}
+		endSpan(&span);
+	}
+
+	// clear the upper triangle so the array holds exactly L
+	clearUpperTriangle(a, n);
+
+	return TRUE;
+}
+
+
+
+static void choleskySolve(const long double* l, size_t n, long double* c, size_t cColumns) {
+	// forward substitution with L
+	for (size_t i = 0; i < n; ++i) {
+		long double* cRow = c + i * cColumns;
+		for (size_t p = 0; p < i; ++p) {
+			long double lip = l[i * n + p];
+			const long double* solvedRow = c + p * cColumns;
+			for (size_t column = 0; column < cColumns; ++column)
+				cRow[column] -= lip * solvedRow[column];
+		}
+		for (size_t column = 0; column < cColumns; ++column)
+			cRow[column] /= l[i * n + i];
+	}
+
+	// back substitution with L^T - row i of L is column i of L^T, so each solved row is subtracted from the ones above it
+	for (size_t i = n; i-- > 0;) {
+		long double* cRow = c + i * cColumns;
+		for (size_t column = 0; column < cColumns; ++column)
+			cRow[column] /= l[i * n + i];
+		for (size_t p = 0; p < i; ++p) {
+			long double lip = l[i * n + p];
+			long double* unsolvedRow = c + p * cColumns;
+			for (size_t column = 0; column < cColumns; ++column)
+				unsolvedRow[column] -= lip * cRow[column];
+		}
+	}
+}
+
+
+
+static void clearUpperTriangle(long double* a, size_t n) {
+	for (size_t i = 0; i < n; ++i) {
+		for (size_t j = i + 1; j < n; ++j)
+			a[i * n + j] = 0;
+	}
+}
+
+
+
+static Status tiledLU(long double* a, size_t n, size_t* pivots, Boolean* pNonsingular) {
+	TiledFactorization factorization = { a, n, LU_BLOCK_SIZE, pivots, TRUE, TRUE };
+	size_t tiles = (n + LU_BLOCK_SIZE - 1) / LU_BLOCK_SIZE;
+	size_t* lastWriter;               // the last task to write each tile while the graph is built
+
+	TaskGraph* pGraph = createTaskGraph(runTileTask, &factorization, tiles);
+	if (!pGraph)
+		return FAILURE;
+	if (!(lastWriter = allocateMemory(tiles * tiles * sizeof(*lastWriter)))) {
+		freeTaskGraph(pGraph);
+		return FAILURE;
+	}
+	for (size_t t = 0; t < tiles * tiles; ++t)
+		lastWriter[t] = TASK_NONE;
+	addLUTasks(pGraph, tiles, lastWriter);
+	freeMemory(lastWriter);
+	distributeMemory(a, n * n * sizeof(*a), FALSE);
+
+	Status status = runTaskGraph(pGraph);
+	freeTaskGraph(pGraph);
+	if (!status)
+		return FAILURE;
+
+	// the row interchanges of each step are applied to the columns of L on its left, which the tasks of the later
+	// steps still read
+	for (size_t j = LU_BLOCK_SIZE; j < n; j += LU_BLOCK_SIZE) {
+		size_t jb = (n - j < LU_BLOCK_SIZE) ? n - j : LU_BLOCK_SIZE;
+		for (size_t jj = j; jj < j + jb; ++jj) {
+			if (pivots[jj] != jj) {
+				long double* rowJ = a + jj * n;
+				long double* rowPivot = a + pivots[jj] * n;
+				for (size_t column = 0; column < j; ++column) {
+					long double temp = rowJ[column];
+					rowJ[column] = rowPivot[column];
+					rowPivot[column] = temp;
+				}
+			}
+		}
+	}
+	*pNonsingular = factorization.nonsingular;
+
+	return SUCCESS;
+}
+
+
+
+static Status tiledCholesky(long double* a, size_t n, Boolean* pPositiveDefinite) {
+	TiledFactorization factorization = { a, n, CHOLESKY_BLOCK_SIZE, NULL, TRUE, TRUE };
+	size_t tiles = (n + CHOLESKY_BLOCK_SIZE - 1) / CHOLESKY_BLOCK_SIZE;
+	size_t* lastWriter;               // the last task to write each tile while the graph is built
+
+	TaskGraph* pGraph = createTaskGraph(runTileTask, &factorization, tiles);
+	if (!pGraph)
+		return FAILURE;
+	if (!(lastWriter = allocateMemory(tiles * tiles * sizeof(*lastWriter)))) {
+		freeTaskGraph(pGraph);
+		return FAILURE;
+	}
+	for (size_t t = 0; t < tiles * tiles; ++t)
+		lastWriter[t] = TASK_NONE;
+	addCholeskyTasks(pGraph, tiles, lastWriter);
+	freeMemory(lastWriter);
+	distributeMemory(a, n * n * sizeof(*a), FALSE);
+
+	Status status = runTaskGraph(pGraph);
+	freeTaskGraph(pGraph);
+	if (!status)
+		return FAILURE;
+
+	if (factorization.positiveDefinite)
+		clearUpperTriangle(a, n);
+	*pPositiveDefinite = factorization.positiveDefinite;
+
+	return SUCCESS;
+}
+
+
+
+static void addLUTasks(TaskGraph* pGraph, size_t tiles, size_t* lastWriter) {
+	for (size_t k = 0; k < tiles; ++k) {
+		// the panel reads and writes its whole tile column from the diagonal down
+		size_t panel = addTask(pGraph, LU_PANEL, k, k, k);
+		for (size_t i = k; i < tiles; ++i) {
+			addDependency(pGraph, lastWriter[i * tiles + k], panel);
+			lastWriter[i * tiles + k] = panel;
+		}
+
+		// the interchanges can swap any row of a tile column from the diagonal down, so the solve for the tile of U
+		// waits for all its updates from the step before. The updates of the step only wait for it, since it waits
+		// for the panel. The first tile column on the right is added first, since the next panel waits for it.
+		for (size_t j = k + 1; j < tiles; ++j) {
+			size_t rows = addTask(pGraph, LU_ROWS, k, j, k);
+			addDependency(pGraph, panel, rows);
+			for (size_t i = k; i < tiles; ++i) {
+				addDependency(pGraph, lastWriter[i * tiles + j], rows);
+				lastWriter[i * tiles + j] = rows;
+			}
+			for (size_t i = k + 1; i < tiles; ++i) {
+				size_t update = addTask(pGraph, LU_UPDATE, i, j, k);
+				addDependency(pGraph, rows, update);
+				lastWriter[i * tiles + j] = update;
+			}
+		}
+	}
+}
+
+
+
+static void addCholeskyTasks(TaskGraph* pGraph, size_t tiles, size_t* lastWriter) {
+	for (size_t k = 0; k < tiles; ++k) {
+		size_t diagonal = addTask(pGraph, CHOLESKY_DIAGONAL, k, k, k);
+		addDependency(pGraph, lastWriter[k * tiles + k], diagonal);
+		lastWriter[k * tiles + k] = diagonal;
+
+		for (size_t i = k + 1; i < tiles; ++i) {
+			size_t panel = addTask(pGraph, CHOLESKY_PANEL, i, k, k);
+			addDependency(pGraph, diagonal, panel);
+			addDependency(pGraph, lastWriter[i * tiles + k], panel);
+			lastWriter[i * tiles + k] = panel;
+		}
+
+		// only the lower triangle of the trailing matrix is updated, starting with the next diagonal tile
+		for (size_t i = k + 1; i < tiles; ++i) {
+			for (size_t j = k + 1; j <= i; ++j) {
+				size_t update = addTask(pGraph, CHOLESKY_UPDATE, i, j, k);
+				addDependency(pGraph, lastWriter[i * tiles + k], update);
+				if (j != i)
+					addDependency(pGraph, lastWriter[j * tiles + k], update);
+				addDependency(pGraph, lastWriter[i * tiles + j], update);
+				lastWriter[i * tiles + j] = update;
+			}
+		}
+	}
+}
+
+
+
+static Boolean runTileTask(void* context, int kind, size_t i, size_t j, size_t k) {
+	TiledFactorization* pFactorization = context;
+	long double* a = pFactorization->a;
+	size_t n = pFactorization->n;
+	size_t nb = pFactorization->nb;
+	size_t i0 = i * nb, j0 = j * nb, k0 = k * nb;        // first row/column of the tiles
+	size_t ib = (n - i0 < nb) ? n - i0 : nb;
+	size_t jb = (n - j0 < nb) ? n - j0 : nb;
+	size_t kb = (n - k0 < nb) ? n - k0 : nb;
+	TraceSpan span;
+
+	switch (kind) {
+	case LU_PANEL:
+		beginSpan(&span, "luPanel", n - k0, kb);
+		for (size_t jj = k0; jj < k0 + kb; ++jj) {
+			size_t pivot = jj;
+			for (size_t row = jj + 1; row < n; ++row) {
+				if (fabsl(a[row * n + jj]) > fabsl(a[pivot * n + jj]))
+					pivot = row;
+			}
+			pFactorization->pivots[jj] = pivot;
+			if (a[pivot * n + jj] == 0) {
+				pFactorization->nonsingular = FALSE;
+				continue;
+			}
+			if (pivot != jj) {
+				for (size_t column = k0; column < k0 + kb; ++column) {
+					long double temp = a[jj * n + column];
+					a[jj * n + column] = a[pivot * n + column];
+					a[pivot * n + column] = temp;
+				}
+			}
+
+			const long double* rowJ = a + jj * n;
+			for (size_t row = jj + 1; row < n; ++row) {
+				long double* rowI = a + row * n;
+				rowI[jj] /= rowJ[jj];
+				for (size_t column = jj + 1; column < k0 + kb; ++column)
+					rowI[column] -= rowI[jj] * rowJ[column];
+			}
+		}
+		endSpan(&span);
+		break;
+
+	case LU_ROWS:
+		beginSpan(&span, "luUpdate", kb, jb);
+		for (size_t jj = k0; jj < k0 + kb; ++jj) {
+			size_t pivot = pFactorization->pivots[jj];
+			if (pivot != jj) {
+				for (size_t column = j0; column < j0 + jb; ++column) {
+					long double temp = a[jj * n + column];
+					a[jj * n + column] = a[pivot * n + column];
+					a[pivot * n + column] = temp;
+				}
+			}
+		}
+		// U(k, j) = L(k, k)^-1 * A(k, j)
+		for (size_t row = k0 + 1; row < k0 + kb; ++row) {
+			long double* rowI = a + row * n;
+			for (size_t p = k0; p < row; ++p) {
+				const long double* rowP = a + p * n;
+				for (size_t column = j0; column < j0 + jb; ++column)
+					rowI[column] -= rowI[p] * rowP[column];
+			}
+		}
+		endSpan(&span);
+		break;
+
+	case LU_UPDATE:
+		beginSpan(&span, "luUpdate", ib, jb);
+		multiplyKernel(FALSE, FALSE, ib, jb, kb, -1, a + i0 * n + k0, n, a + k0 * n + j0, n, 1, a + i0 * n + j0, n);
+		endSpan(&span);
+		break;
+
+	case CHOLESKY_DIAGONAL:
+		beginSpan(&span, "choleskyPanel", kb, kb);
+		for (size_t jj = k0; jj < k0 + kb; ++jj) {
+			long double* rowJ = a + jj * n;
+			long double diagonal = rowJ[jj];
+			for (size_t p = k0; p < jj; ++p)
+				diagonal -= rowJ[p] * rowJ[p];
+			if (!(diagonal > 0)) {
+				pFactorization->positiveDefinite = FALSE;
+				endSpan(&span);
+				return FALSE;        // not positive definite, so the rest of the graph is skipped
+			}
+			rowJ[jj] = sqrtl(diagonal);
+			for (size_t row = jj + 1; row < k0 + kb; ++row) {
+				long double* rowI = a + row * n;
+				long double entry = rowI[jj];
+				for (size_t p = k0; p < jj; ++p)
+					entry -= rowI[p] * rowJ[p];
+				rowI[jj] = entry / rowJ[jj];
+			}
+		}
+		endSpan(&span);
+		break;
+
+	case CHOLESKY_PANEL:
+		beginSpan(&span, "choleskyPanel", ib, kb);
+		for (size_t row = i0; row < i0 + ib; ++row) {
+			long double* rowI = a + row * n;
+			for (size_t jj = k0; jj < k0 + kb; ++jj) {
+				const long double* rowJ = a + jj * n;
+				long double entry = rowI[jj];
+				for (size_t p = k0; p < jj; ++p)
+					entry -= rowI[p] * rowJ[p];
+				rowI[jj] = entry / rowJ[jj];
+			}
+		}
+		endSpan(&span);
+		break;
+
+	case CHOLESKY_UPDATE:
+		beginSpan(&span, "choleskyUpdate", ib, jb);
+		multiplyKernel(FALSE, TRUE, ib, jb, kb, -1, a + i0 * n + k0, n, a + j0 * n + k0, n, 1, a + i0 * n + j0, n);
+		endSpan(&span);
+		break;
+	}
+
+	return TRUE;
+}
+
+
+
+static Status factorQR(MATRIX hMatrix, MATRIX* phQ, MATRIX* phR) {
+	Matrix* pMatrix = hMatrix;        // the matrix being factored
+	size_t m = pMatrix->rows;
+	size_t n = pMatrix->columns;
+	size_t k = (m < n) ? m : n;
+	long double* a;                   // working copy that is factored in place
+	long double* tau;                 // scalar factors of the reflectors
+
+	if (!(a = allocateMemory(m * n * sizeof(*a))))
+		return FAILURE;
+	if (!(tau = allocateMemory(k * sizeof(*tau)))) {
+		freeMemory(a);
+		return FAILURE;
+	}
+	copyToRowMajor(pMatrix, a);
+
+	if (!householderQR(a, m, n, tau) || !copyQR(a, m, n, tau, phQ, phR)) {
+		freeMemory(a);
+		freeMemory(tau);
+		return FAILURE;
+	}
+
+	freeMemory(a);
+	freeMemory(tau);
+
+	return SUCCESS;
+}
+
+
+
+static Status factorQRPivoted(MATRIX hMatrix, MATRIX* phQ, MATRIX* phR, size_t* permutation, size_t* pRank) {
+	Matrix* pMatrix = hMatrix;        // the matrix being factored
+	size_t m = pMatrix->rows;
+	size_t n = pMatrix->columns;
+	size_t k = (m < n) ? m : n;
+	long double* a;                   // working copy that is factored in place
+	long double* tau;                 // scalar factors of the reflectors
+
+	if (!(a = allocateMemory(m * n * sizeof(*a))))
+		return FAILURE;
+	if (!(tau = allocateMemory(k * sizeof(*tau)))) {
+		freeMemory(a);
+		return FAILURE;
+	}
+	copyToRowMajor(pMatrix, a);
+
+	if (!pivotedHouseholderQR(a, m, n, tau, permutation) || !copyQR(a, m, n, tau, phQ, phR)) {
+		freeMemory(a);
+		freeMemory(tau);
+		return FAILURE;
+	}
+	*pRank = numericalRank(a, m, n);
+
+	freeMemory(a);
+	freeMemory(tau);
+
+	return SUCCESS;
+}
+
+
+
+static Status solveLeastSquares(MATRIX hA, MATRIX hB, MATRIX* phX) {
+	Matrix* pA = hA;                  // coefficient matrix
+	Matrix* pB = hB;                  // right hand sides
+	size_t m = pA->rows;
+	size_t n = pA->columns;
+	size_t rhs = pB->columns;
+	long double* a;                   // working copy of A that is factored in place
+	long double* tau;                 // scalar factors of the reflectors
+	long double* c;                   // working copy of B that becomes Q^T * B and then X
+
+	if (!(a = allocateMemory(m * n * sizeof(*a))))
+		return FAILURE;
+	if (!(tau = allocateMemory(n * sizeof(*tau)))) {
+		freeMemory(a);
+		return FAILURE;
+	}
+	if (!(c = allocateMemory(m * rhs * sizeof(*c)))) {
+		freeMemory(a);
+		freeMemory(tau);
+		return FAILURE;
+	}
+	copyToRowMajor(pA, a);
+	copyToRowMajor(pB, c);
+
+	// factor A, then the solution of R * X = Q^T * B is the least squares solution
+	Status status = householderQR(a, m, n, tau);
+	long double largestDiagonal = 0;
+	for (size_t i = 0; i < n; ++i) {
+		if (fabsl(a[i * n + i]) > largestDiagonal)
+			largestDiagonal = fabsl(a[i * n + i]);
+	}
+	for (size_t i = 0; status && i < n; ++i) {
+		if (fabsl(a[i * n + i]) <= m * LDBL_EPSILON * largestDiagonal)
+			status = FAILURE;        // rank deficient - R is numerically singular
+	}
+	if (status)
+		status = applyQ(TRUE, a, m, n, tau, n, c, rhs);
+	if (status) {
+		backSubstitute(a, n, n, c, rhs);
+		status = adjustMatrixDimensions((Matrix**)phX, n, rhs);
+	}
+	if (status) {
+		Matrix* pX = *phX;
+		copyFromRowMajor(pX, c);
+		pX->maxLength = 0;
+	}
+
+	freeMemory(a);
+	freeMemory(tau);
+	freeMemory(c);
+
+	return status;
+}
+
+
+
+static Status solveLeastSquaresPivoted(MATRIX hA, MATRIX hB, MATRIX* phX, size_t* pRank) {
+	Matrix* pA = hA;                  // coefficient matrix
+	Matrix* pB = hB;                  // right hand sides
+	size_t m = pA->rows;
+	size_t n = pA->columns;
+	size_t k = (m < n) ? m : n;
+	size_t rhs = pB->columns;
+	size_t rank;                      // numerical rank of A
+	long double* a;                   // working copy of A that is factored in place
+	long double* tau;                 // scalar factors of the reflectors
+	long double* c;                   // working copy of B that becomes Q^T * B and then the leading rows of X
+	size_t* permutation;              // column permutation of A
+
+	if (!(a = allocateMemory(m * n * sizeof(*a))))
+		return FAILURE;
+	if (!(tau = allocateMemory(k * sizeof(*tau)))) {
+		freeMemory(a);
+		return FAILURE;
+	}
+	if (!(c = allocateMemory(m * rhs * sizeof(*c)))) {
+		freeMemory(a);
+		freeMemory(tau);
+		return FAILURE;
+	}
+	if (!(permutation = allocateMemory(n * sizeof(*permutation)))) {
+		freeMemory(a);
+		freeMemory(tau);
+		freeMemory(c);
+		return FAILURE;
+	}
+	copyToRowMajor(pA, a);
+	copyToRowMajor(pB, c);
+
+	// factor A * P = Q * R, solve with the leading rank x rank block of R and set the remaining unknowns to 0
+	Status status = pivotedHouseholderQR(a, m, n, tau, permutation);
+	if (status) {
+		rank = numericalRank(a, m, n);
+		*pRank = rank;
+		status = applyQ(TRUE, a, m, n, tau, k, c, rhs);
+	}
+	if (status) {
+		backSubstitute(a, n, rank, c, rhs);
+		status = adjustMatrixDimensions((Matrix**)phX, n, rhs);
+	}
+	if (status) {
+		Matrix* pX = *phX;
+		for (size_t i = 0; i < n; ++i) {
+			for (size_t j = 0; j < rhs; ++j)
+				pX->matrix[matrixIndex(pX, i, j)] = 0;
+		}
+		for (size_t i = 0; i < rank; ++i) {
+			for (size_t j = 0; j < rhs; ++j)
+				pX->matrix[matrixIndex(pX, permutation[i], j)] = c[i * rhs + j];
+		}
+		pX->maxLength = 0;
+	}
+
+	freeMemory(a);
+	freeMemory(tau);
+	freeMemory(c);
+	freeMemory(permutation);
+
+	return status;
+}
+
+
+
+static Status factorCholesky(MATRIX hMatrix, MATRIX* phL, Boolean* pIsPositiveDefinite) {
+	Matrix* pMatrix = hMatrix;        // the matrix being factored
+	size_t n = pMatrix->rows;
+	long double* a;                   // working copy that is factored in place
+	*pIsPositiveDefinite = FALSE;
+
+	// cheap test before any work is done
+	if (!mightBePositiveDefinite(pMatrix))
+		return FAILURE;
+
+	*pIsPositiveDefinite = TRUE;      // assume it's positive definite until the factorization fails
+	if (!(a = allocateMemory(n * n * sizeof(*a))))
+		return FAILURE;
+	copyToRowMajor(pMatrix, a);
+
+	if (!choleskyFactor(a, n)) {
+		*pIsPositiveDefinite = FALSE;
+		freeMemory(a);
+		return FAILURE;
+	}
+
+	// recreate the result matrix if its dimensions aren't appropriate for the factorization or it's NULL
+	if (!adjustMatrixDimensions((Matrix**)phL, n, n)) {
+		freeMemory(a);
+		return FAILURE;
+	}
+	Matrix* pL = *phL;                // the Cholesky factor
+	copyFromRowMajor(pL, a);
+	pL->maxLength = 0;
+
+	freeMemory(a);
+
+	return SUCCESS;
+}
+
+
+
+static Status solveSystem(MATRIX hA, MATRIX hB, MATRIX* phX, Boolean* pMatrixIsVertible) {
+	Matrix* pA = hA;                  // coefficient matrix
+	Matrix* pB = hB;                  // right hand sides
+	size_t n = pA->rows;
+	size_t rhs = pB->columns;
+	long double* a;                   // working copy of A that is factored in place, followed by pivots
+	long double* c;                   // working copy of B that becomes X
+	size_t* pivots;                   // row interchanges of the LU factorization
+	size_t factorBytes = n * n * sizeof(*a) + n * sizeof(*pivots);
+	*pMatrixIsVertible = TRUE;        // assume the matrix is vertible
+
+	// the factorization and its pivots are one block so they can be cached together
+	if (!(a = allocateMemory(factorBytes)))
+		return FAILURE;
+	if (!(c = allocateMemory(n * rhs * sizeof(*c)))) {
+		freeMemory(a);
+		return FAILURE;
+	}
+	pivots = (size_t*)(a + n * n);
+	copyToRowMajor(pB, c);
+
+	// symmetric positive definite matrices use the Cholesky factorization, everything else (including a failed
+	// Cholesky factorization) falls back to LU with partial pivoting. The factorization of a matrix with the same
+	// entries is reused while the cache is on.
+	CacheKey key;
+	long double factorization;
+	Boolean cached = cacheKey(pA, CACHE_FACTORIZATION, 0, &key);
+	if (!cached || !cacheFind(&key, a, factorBytes, &factorization)) {
+		copyToRowMajor(pA, a);
+		if (mightBePositiveDefinite(pA) && choleskyFactor(a, n))
+			factorization = FACTORIZATION_CHOLESKY;
+		else {
+			copyToRowMajor(pA, a);
+			factorization = luFactor(a, n, pivots) ? FACTORIZATION_LU : FACTORIZATION_SINGULAR;
+		}
+		if (cached)
+			cacheStore(&key, a, (factorization != FACTORIZATION_SINGULAR) ? factorBytes : 0, factorization);
+	}
+
+	Status status = SUCCESS;
+	if (factorization == FACTORIZATION_CHOLESKY)
+		choleskySolve(a, n, c, rhs);
+	else if (factorization == FACTORIZATION_LU)
+		luSolve(a, n, pivots, c, rhs);
+	else {
+		*pMatrixIsVertible = FALSE;
+		status = FAILURE;
+	}
+
+	if (status)
+		status = adjustMatrixDimensions((Matrix**)phX, n, rhs);
+	if (status) {
+		Matrix* pX = *phX;
+		copyFromRowMajor(pX, c);
+		pX->maxLength = 0;
+	}
+
+	freeMemory(a);
+	freeMemory(c);
+
+	return status;
+}
@@ -9,13 +9,49 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "Menu.h"
+#include "Batch.h"
+#include "Daemon.h"
+#include "Distributed.h"
 
 
 
 
-int main(void) {
-	
+/***** Helper functions used only in this file *****/
+/*
+PRECONDITION
+  - none.
+POSTCONDITION
+  - Reports on stderr the environment variables of the matrix interface that couldn't be acted on (a NUMA policy it
+    doesn't know, statistics or a trace it couldn't open the file for), since the library doesn't print anything.
+  - Registers stopping the trace at exit, so a trace that couldn't be written is reported too.
+*/
+static void checkEnvironment(void);
+
+
+/*
+PRECONDITION
+  - none.
+POSTCONDITION
+  - Stops the trace if it's still running and reports if it couldn't be written, for atexit.
+*/
+static void stopTraceAtExit(void);
+
+
+
+
+int main(int argc, char* argv[]) {
+	checkEnvironment();
+
+	// any arguments run jobs without the menu
+	if (argc > 1 && (!strcmp(argv[1], "--daemon") || !strcmp(argv[1], "--client")))
+		return daemon_run(argc, argv);
+	if (argc > 1 && !strcmp(argv[1], "--distributed"))
+		return distributed_run(argc, argv);
+	if (argc > 1)
+		return batch_run(argc, argv);
+
 	int userChoice;
 	do {
 		menu_displayMenu();
@@ -71,3 +107,31 @@ int main(void) {
 	
 	return 0;
 }
+
+
+
+
+/***** Helper functions used only in this file *****/
+static void checkEnvironment(void) {
+	const char* numa = getenv("MATRIX_NUMA");
+	if (numa && *numa && strcmp(numa, "off") && matrix_getNumaPolicy() == MATRIX_NUMA_OFF)
+		fprintf(stderr, "Error - unknown MATRIX_NUMA policy %s\n", numa);
+
+	const char* stats = getenv("MATRIX_STATS");
+	if (stats && *stats && strcmp(stats, "0") && !matrix_statsAreEnabled())
+		fprintf(stderr, "Error - could not write the matrix statistics to %s\n", stats);
+
+	// checking the trace reads the environment, so the library registers its own handler first and this one, which
+	// runs before it, is the one that writes the trace
+	const char* trace = getenv("MATRIX_TRACE");
+	if (trace && *trace && !matrix_traceIsStarted())
+		fprintf(stderr, "Error - could not write the matrix trace to %s\n", trace);
+	atexit(stopTraceAtExit);
+}
+
+
+
+static void stopTraceAtExit(void) {
+	if (matrix_traceIsStarted() && !matrix_stopTrace())
+		fprintf(stderr, "Error - could not write the matrix trace\n");
+}
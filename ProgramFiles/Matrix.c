@@ -11,47 +11,14 @@
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
-#include <ctype.h>
-#include "Matrix.h"
-
-
-/***** Global variables and structures *****/
-typedef struct matrix {
-	long double* matrix;        // 2D array
-	int rows;                   // total rows
-	int columns;                // total columns
-	int maxLength;              // max width of a number out of the entire array i.e -425.73 has a width of 7 (5 numbers, '.', and '-')
-} Matrix;
-
-// The various matrix operations that can be performed
-const char* operations[] = { "multiplication", "addition", "subtraction", "power", "transpose", "determinant",  "inverse" };
-const int operationsSize = sizeof(operations) / sizeof(*operations);
+#include <stdint.h>
+#include "MatrixInternal.h"
 
 
+#define MULTIPLY_BLOCK_SIZE 64        // rows/columns of the cache blocks used by multiplyKernel
 
 
 /***** Helper functions used only in this file *****/
-/*
-PRECONDITION
-  - n is any double
-POSTCONDITION
-  - Calculates the total number of characters comprising the number.
-	If it's an integer this will just be the length of the integer (i.e. 1024 = length 4).
-	If it's floating point, then it will not include trailing zeros.
-*/
-static int calcNumLength(long double n);
-
-
-/*
-PRECONDITION
-  - numString is a string containing the string representation of a number.
-POSTCONDITION
-  - Removes trailing zeroes from the string representation of a number.
-	For example, the string "24.1720000" becomes "24.172".
-*/
-static void removeTrailingZeroes(char* numString);
-
-
 /*
 PRECONDITION
   - None
@@ -91,26 +58,22 @@ static Status calculateAdjugateMatrix(Matrix* pMatrix, Matrix** ppResult);
 
 /*
 PRECONDITION
-  - line is a string containing any amount of potentially valid floating point numbers.
-  - expectedNumbers is the expected amount of floating point numbers to be found in the line.
+  - The same as matrix_power.
 POSTCONDITION
-  - Returns TRUE if the input is valid, else FALSE.
-  - Valid input is all valid floating point numbers, and the amount of numbers entered matches expectedNumbers.
+  - Calculates the power the same as matrix_power, without the result cache.
 */
-static Boolean inputIsValidDouble(const char* line, int expectedNumbers);
+static Status calculatePower(MATRIX hMatrix, int power, MATRIX* phResult);
 
 
 /*
 PRECONDITION
-  - line is a string containing only floating point numbers.
-  - aSize is an array of doubles.
-  - size is the size of the array a.
+  - The same as matrix_inverse.
 POSTCONDITION
-  - The numbers in line are stored as doubles in a and returns SUCCESS.
-  - Returns FAILURE if the index of the array goes out of bounds in the case where the amount
-	of numbers in line is greater than size.
+  - Calculates the inverse the same as matrix_inverse, without the result cache.
 */
-static Status linestringToArray(const char* line, long double* a, int aSize);
+static Status calculateInverse(MATRIX hMatrix, MATRIX* phResult, Boolean* pMatrixIsVertible);
+
+
 
 
 /*
@@ -122,74 +85,138 @@ POSTCONDITION
   - Since the 2D matrix is implemented as a 1D array, returns the actual index in the 1D array using the row-column coordinates
 	of the conceptual 2D array.
   - In bounds - Returns the index and sets the Boolean pointed to by pOutOfBounds to FALSE.
-  - Out of bounds - Returns OUT_OF_BOUNDS and sets the Boolean pointed to by pOutOfBounds to TRUE.
+  - Out of bounds - Returns 0 (a valid index, so the result can always be used to index the array safely) and sets the
+	Boolean pointed to by pOutOfBounds to TRUE.
   - If pOutOfBounds is NULL, then it is ignored. This is for cases where it's known it won't be out of bounds which happens
 	consistently in this program. The checking for out of bounds is just an additional optional feature.
 */
-static int at(MATRIX hMatrix, int row, int column, Boolean* pOutOfBounds);
+static size_t at(MATRIX hMatrix, size_t row, size_t column, Boolean* pOutOfBounds);
 
 
 /*
 PRECONDITION
-  - ppMatrix is a pointer to a pointer to a valid matrix object or a pointer that's NULL.
-  - rows/columns are the new dimensions the matrix should be adjusted to.
-POSTCONDITION:
-  - If the matrix object does not exist, a new matrix object with the correct dimensions is created.
-  - If the matrix exists, its dimensions are checked. If its dimensions are incorrect, a new matrix array
-	is created to adjust it to the proper dimensions.
-  - Returns SUCCESS, else FAILURE for any memory allocation failure.
+  - pMatrix is a pointer to a valid matrix object.
+  - row/column are in bounds and are multiples of MATRIX_TILE_SIZE.
+  - pLeadingDimension/pTransposed are pointers to the variables that receive the description of the block.
+POSTCONDITION
+  - Returns a pointer to the entry at row/column and describes the MATRIX_TILE_SIZE x MATRIX_TILE_SIZE block that starts
+    there the way multiplyKernel expects: row-major with the leading dimension stored in the integer pointed to by
+    pLeadingDimension. Since a column-major block is the row-major storage of its transpose, the Boolean pointed to by
+    pTransposed is set to TRUE for column-major matrices, else FALSE.
+*/
+static const long double* blockView(const Matrix* pMatrix, size_t row, size_t column, size_t* pLeadingDimension, Boolean* pTransposed);
+
+
+/*
+PRECONDITION
+  - hMatrices is an array of hMatricesSize handles to valid matrix objects with the same dimensions as pResult.
+  - pResult is a pointer to a valid matrix object.
+POSTCONDITION
+  - Returns TRUE if all the matrices and the result have the same layout, i.e. the same entry is at the same index of each
+    storage array, else FALSE.
+*/
+static Boolean sameLayout(MATRIX* hMatrices, int hMatricesSize, const Matrix* pResult);
+
+
+/*
+PRECONDITION
+  - pMatrix1/pMatrix2/pResult are pointers to valid matrix objects with the dimensions of a multiplication.
+  - row/column/inner are the first row, column and inner index of the tiles and are multiples of MATRIX_TILE_SIZE.
+POSTCONDITION
+  - Multiplies tile (row, inner) of pMatrix1 with tile (inner, column) of pMatrix2 and adds it to tile (row, column)
+	of pResult. The result tile is overwritten instead when inner is 0.
 */
-static Status adjustMatrixDimensions(Matrix** ppMatrix, int rows, int columns);
+static void multiplyTile(const Matrix* pMatrix1, const Matrix* pMatrix2, Matrix* pResult, size_t row, size_t column, size_t inner);
 
 
+/*
+PRECONDITION
+  - pMatrix is a pointer to a valid matrix object.
+  - first/end are the range [first, end) of storage indices.
+POSTCONDITION
+  - Returns the max width of the numbers stored in the range (at least 1).
+*/
+static int maxLengthOfSpan(const Matrix* pMatrix, size_t first, size_t end);
+
+
+/*
+PRECONDITION
+  - hMatrices is an array of hMatricesSize handles to valid matrix objects and pResult is a pointer to a valid matrix
+	object, all with the same dimensions.
+  - first/end are the range [first, end) of storage indices or firstRow/endRow are the range [firstRow, endRow) of rows.
+POSTCONDITION
+  - Calls releaseSpan/releaseRows for all of the matrices.
+*/
+static void releaseSpanOfAll(MATRIX* hMatrices, int hMatricesSize, const Matrix* pResult, size_t first, size_t end);
+static void releaseRowsOfAll(MATRIX* hMatrices, int hMatricesSize, const Matrix* pResult, size_t firstRow, size_t endRow);
+
+
+/*
+PRECONDITION
+  - The same as matrix_multiply.
+POSTCONDITION
+  - Multiplies the matrices the same as matrix_multiply, without measuring the call.
+*/
+static Status multiplyMatrices(MATRIX hMatrix1, MATRIX hMatrix2, MATRIX* phResult);
 
 
-/***** Helper functions used in this file and Menu.c - definitions are in this file *****/
 /*
 PRECONDITION
-  - n is any integer
-  - append is the character array to hold the append string. It has a capacity of 3 with a null terminator
-	at index 2.
+  - The same as matrix_add.
 POSTCONDITION
-  - Based on what n is, append now holds the append string.
-	For example, if n is 21 the append string is "st" for 21st.
+  - Adds the matrices the same as matrix_add, without measuring the call.
 */
-void numberAppender(int n, char* append);
+static Status addMatrices(MATRIX* hMatrices, int hMatricesSize, MATRIX* phResult);
 
 
 /*
 PRECONDITION
-  - line is a string containing any amount of potentially valid positive integers.
-  - expectedNumbers is the expected amount of positive integers to be found in the line.
+  - The same as matrix_subtract.
 POSTCONDITION
-  - Returns TRUE if the input is valid, else FALSE.
-  - Valid input is integers > 0, and the amount of integers entered matches expectedNumbers.
+  - Subtracts the matrices the same as matrix_subtract, without measuring the call.
 */
-Boolean inputIsValidPositiveInt(const char* line, int expectedNumbers);
+static Status subtractMatrices(MATRIX* hMatrices, int hMatricesSize, MATRIX* phResult);
 
 
 /*
 PRECONDITION
-  - line is a string containing any amount of potentially valid unsigned integers.
-  - expectedNumbers is the expected amount of unsigned integers to be found in the line.
+  - The same as matrix_transpose.
 POSTCONDITION
-  - Returns TRUE if the input is valid, else FALSE.
-  - Valid input is integers >= 0, and the amount of integers entered matches expectedNumbers.
+  - Transposes the matrix the same as matrix_transpose, without measuring the call.
 */
-Boolean inputIsValidUnsignedInt(const char* line, int expectedNumbers);
+static Status transposeMatrix(MATRIX hMatrix, MATRIX* phResult);
+
+
+/*
+PRECONDITION
+  - The same as matrix_determinant.
+POSTCONDITION
+  - Finds the determinant the same as matrix_determinant, without measuring the call.
+*/
+static long double findDeterminant(MATRIX hMatrix, Status* pMemoryAllocation);
 
 
 
 
 /***** Functions declared in Matrix.h *****/
-MATRIX matrix_init(int rows, int columns) {
-	Matrix* pMatrix = malloc(sizeof(*pMatrix));
+MATRIX matrix_init(size_t rows, size_t columns) {
+	return matrix_initLayout(rows, columns, MATRIX_ROW_MAJOR);
+}
+
+
+
+MATRIX matrix_initLayout(size_t rows, size_t columns, MatrixLayout layout) {
+	Matrix* pMatrix = allocateMemory(sizeof(*pMatrix));
 	if (pMatrix) {
 		pMatrix->rows = rows;
 		pMatrix->columns = columns;
 		pMatrix->maxLength = 1;
-		if (!(pMatrix->matrix = calloc(rows * columns, sizeof(*(pMatrix->matrix))))) {
-			free(pMatrix);
+		pMatrix->layout = layout;
+		pMatrix->fd = -1;
+		pMatrix->mapping = NULL;
+		pMatrix->mappingBytes = 0;
+		if (!(pMatrix->matrix = allocateStorage(rows, columns, layout))) {
+			freeMemory(pMatrix);
 			return NULL;
 		}
 	}
@@ -199,401 +226,209 @@ MATRIX matrix_init(int rows, int columns) {
 
 
 
-Status matrix_getDimensions(int* pRows, int* pColumns, int n, const char* operation) {
-	char append[3] = { '\0' };        // holds "st" for 1st, "nd" for 2nd etc.
-	char line[500];                   // buffer for line of user input
-
-	// prompt the user to enter the dimensions for the correct matrix
-	printf("Enter the desired rows and columns for the ");
-	if (n == -1)
-		printf("matrix ");
-	else if (n == 0)
-		printf("matrices ");
-	else {
-		numberAppender(n, append);
-		printf("%d%s matrix ", n, append);
-	}
-	printf("separated by a space.\n");
-
-	if (!strcmp(operation, operations[3])) {
-		printf("For the matrix %s operation, the rows must equal the columns.\n"
-			"For example, enter \"3 3\" to create a 3 x 3 matrix.\n", operations[3]);
-	}
-	else if (!strcmp(operation, operations[5])) {
-		printf("For the matrix %s operation, the rows must equal the columns.\n"
-			"For example, enter \"3 3\" to create a 3 x 3 matrix.\n", operations[5]);
-	}
-	else if (!strcmp(operation, operations[6])) {
-		printf("For the matrix %s operation, the rows must equal the columns.\n"
-			"For example, enter \"3 3\" to create a 3 x 3 matrix.\n", operations[6]);
-	}
-	else {
-		printf("For example, enter \"3 5\" to create a 3 x 5 matrix.\n");
-	}
-
-	// get and validate user input for the dimensions
-	fgets(line, 500, stdin);
-	line[strlen(line) - 1] = '\0';
-	if (!inputIsValidPositiveInt(line, 2)) {
-		*pRows = -1;
-		*pColumns = -1;
-		return FAILURE;
+MATRIX matrix_initFromArray(size_t rows, size_t columns, MatrixLayout layout, const long double* entries) {
+	Matrix* pMatrix = matrix_initLayout(rows, columns, layout);
+	if (pMatrix) {
+		memcpy(pMatrix->matrix, entries, storageSize(rows, columns, layout) * sizeof(*entries));
+		pMatrix->maxLength = 0;
 	}
-	sscanf(line, "%d%d", pRows, pColumns);
 
-	return SUCCESS;
+	return pMatrix;
 }
 
 
 
-Status matrix_getNumMatrices(const char* operation, int* pNumMatrices) {
-	char line[500];        // holds line of user input
-
-	// get and validate user input for the number of matrices
-	printf("Enter the number of matrices to %s. Must be an integer that is at least 2.\n", operation);
-	fgets(line, 500, stdin);
-	line[strlen(line) - 1] = '\0';
-	if (!inputIsValidPositiveInt(line, 1) || atoi(line) < 2) {
-		*pNumMatrices = 0;
-		return FAILURE;
-	}
-	sscanf(line, "%d", pNumMatrices);
-
-	return SUCCESS;
+MatrixLayout matrix_getLayout(MATRIX hMatrix) {
+	Matrix* pMatrix = hMatrix;
+	return pMatrix->layout;
 }
 
 
 
-Boolean matrix_canBeMultipliedD(int columns1, int rows2) {
-	return columns1 == rows2;
+size_t matrix_getRows(MATRIX hMatrix) {
+	Matrix* pMatrix = hMatrix;
+	return pMatrix->rows;
 }
 
 
 
-Boolean matrix_canBeMultipliedM(MATRIX hMatrix1, MATRIX hMatrix2) {
-	Matrix* pMatrix1 = hMatrix1;
-	Matrix* pMatrix2 = hMatrix2;
-	return pMatrix1->columns == pMatrix2->rows;
+size_t matrix_getColumns(MATRIX hMatrix) {
+	Matrix* pMatrix = hMatrix;
+	return pMatrix->columns;
 }
 
 
 
-Status matrix_fillInput(MATRIX hMatrix, Status* pMemoryAllocation) {
+Status matrix_setLayout(MATRIX hMatrix, MatrixLayout layout) {
 	Matrix* pMatrix = hMatrix;
-	long double* inputRow;               // array to hold the numbers the user enters for any given row
-	long double* oldArrayCopy;           // stores a copy of the old matrix entries
-	int maxLength = 1;                   // max length of the numbers found
-	int numLength;                       // length of a single number
-	char line[500];                      // buffer to hold user input
-	*pMemoryAllocation = SUCCESS;        // no memory allocation failure yet
-
-	// create the array for a single row
-	if (!(inputRow = malloc(pMatrix->columns * sizeof(*inputRow)))) {
-		*pMemoryAllocation = FAILURE;
+	Matrix converted = *pMatrix;        // the matrix with its new storage
+
+	if (pMatrix->layout == layout)
+		return SUCCESS;
+	// the file of a mapped matrix can't hold both layouts at once
+	if (isMapped(pMatrix))
 		return FAILURE;
-	}
 
-	// copy the old array so the matrix can be preserved if input validation fails
-	if (!(oldArrayCopy = malloc(pMatrix->rows * pMatrix->columns * sizeof(*oldArrayCopy)))) {
-		*pMemoryAllocation = FAILURE;
-		free(inputRow);
+	converted.layout = layout;
+	if (!(converted.matrix = allocateStorage(pMatrix->rows, pMatrix->columns, layout)))
 		return FAILURE;
-	}
 
-	for (int i = 0; i < pMatrix->rows * pMatrix->columns; ++i)
-		oldArrayCopy[i] = pMatrix->matrix[i];
-
-	// get and validate user input for the entries of the matrix
-	for (int i = 0; i < pMatrix->rows; ++i) {
-		fgets(line, 500, stdin);
-		line[strlen(line) - 1] = '\0';
-		if (!inputIsValidDouble(line, pMatrix->columns)) {
-			free(pMatrix->matrix);
-			pMatrix->matrix = oldArrayCopy;
-			free(inputRow);
-			return FAILURE;
-		}
-		linestringToArray(line, inputRow, pMatrix->columns);
-		for (int j = 0; j < pMatrix->columns; ++j) {
-			pMatrix->matrix[at(hMatrix, i, j, NULL)] = inputRow[j];
-			numLength = calcNumLength(inputRow[j]);
-			if (i == 0 && j == 0)
-				maxLength = numLength;
-			else if (numLength > maxLength)
-				maxLength = numLength;
+	// copy one tile at a time so neither the old nor the new storage is walked with a large stride for long
+	for (size_t rowTile = 0; rowTile < pMatrix->rows; rowTile += MATRIX_TILE_SIZE) {
+		size_t rowEnd = (rowTile + MATRIX_TILE_SIZE < pMatrix->rows) ? rowTile + MATRIX_TILE_SIZE : pMatrix->rows;
+		for (size_t columnTile = 0; columnTile < pMatrix->columns; columnTile += MATRIX_TILE_SIZE) {
+			size_t columnEnd = (columnTile + MATRIX_TILE_SIZE < pMatrix->columns) ? columnTile + MATRIX_TILE_SIZE : pMatrix->columns;
+			for (size_t i = rowTile; i < rowEnd; ++i) {
+				for (size_t j = columnTile; j < columnEnd; ++j)
+					converted.matrix[matrixIndex(&converted, i, j)] = pMatrix->matrix[matrixIndex(pMatrix, i, j)];
+			}
 		}
 	}
-	pMatrix->maxLength = maxLength;
 
-	free(inputRow);
-	free(oldArrayCopy);
-	printf("\n");
+	freeStorage(pMatrix);
+	converted.mapping = NULL;
+	converted.mappingBytes = 0;
+	*pMatrix = converted;
 
 	return SUCCESS;
 }
 
 
 
-void matrix_fillPrompt(MATRIX hMatrix, int matrixNumber) {
-	Matrix* pMatrix = hMatrix;
-	char append[3] = { '\0' };
-
-	printf("Enter values for the ");
-	if (matrixNumber) {
-		numberAppender(matrixNumber, append);
-		printf("%d%s ", matrixNumber, append);
-	}
-	printf("%d x %d matrix with each row separated by a newline.\n", pMatrix->rows, pMatrix->columns);
+Boolean matrix_canBeMultipliedD(size_t columns1, size_t rows2) {
+	return columns1 == rows2;
 }
 
 
 
-Status matrix_multiply(MATRIX hMatrix1, MATRIX hMatrix2, MATRIX* phResult) {
-	Matrix* pMatrix1 = hMatrix1;        // matrix 1 being multiplied
-	Matrix* pMatrix2 = hMatrix2;        // matrix 2 being multiplied
+Boolean matrix_canBeMultipliedM(MATRIX hMatrix1, MATRIX hMatrix2) {
+	Matrix* pMatrix1 = hMatrix1;
+	Matrix* pMatrix2 = hMatrix2;
+	return pMatrix1->columns == pMatrix2->rows;
+}
 
-	// recreate the result matrix if its dimensions aren't appropriate for the multiplication or it's NULL
-	if (!adjustMatrixDimensions((Matrix**)phResult, pMatrix1->rows, pMatrix2->columns))
-		return FAILURE;
-	Matrix* pResult = *phResult;       // result of multiplication
 
-	long double sum = 0;               // the sum for each new entry in the result matrix
-	int newRow = 0;                    // index tracker of the new matrix's row
-	int newColumn = 0;                 // index tracker of the new matrix's column
-	int maxLength = 1;                 // max length of the new matrix (same as in the matrix structure).
-	int numLength;                     // gets the length of each number to be compared to max length
-	Boolean firstNewNum = TRUE;        // TRUE = first number being calculated in the whole result matrix
 
-	// perform the multiplication
-	for (int m1row = 0; m1row < pMatrix1->rows; ++m1row) {
-		newColumn = 0;
-		for (int m2column = 0; m2column < pMatrix2->columns; ++m2column) {
-			sum = 0;
-			for (int m1column = 0, m2row = 0; m1column < pMatrix1->columns; ++m1column, ++m2row)
-				sum += pMatrix1->matrix[at(hMatrix1, m1row, m1column, NULL)] * pMatrix2->matrix[at(hMatrix2, m2row, m2column, NULL)];
-			numLength = calcNumLength(sum);
-			if (firstNewNum) {
-				maxLength = numLength;
-				firstNewNum = FALSE;
-			}
-			else if (numLength > maxLength)
-				maxLength = numLength;
-			pResult->matrix[at((MATRIX)pResult, newRow, newColumn, NULL)] = sum;
-			++newColumn;
-		}
-		++newRow;
-	}
-	pResult->maxLength = maxLength;
+Status matrix_multiply(MATRIX hMatrix1, MATRIX hMatrix2, MATRIX* phResult) {
+	Matrix* pMatrix1 = hMatrix1;
+	Matrix* pMatrix2 = hMatrix2;
+	double flops = 2.0 * pMatrix1->rows * pMatrix1->columns * pMatrix2->columns;
+	MeasuredCall call;
 
-	return SUCCESS;
+	beginCall(&call, MATRIX_OPERATION_MULTIPLY, hMatrix1);
+	Status status = multiplyMatrices(hMatrix1, hMatrix2, phResult);
+	endCall(&call, status ? flops : 0);
+
+	return status;
 }
 
 
 
 Status matrix_add(MATRIX* hMatrices, int hMatricesSize, MATRIX* phResult) {
-	Matrix* pMatrixToAdd = hMatrices[0];        // first matrix being added
-
-	// recreate the result matrix if its dimensions aren't appropriate for the addition or it's NULL
-	if (!adjustMatrixDimensions((Matrix**)phResult, pMatrixToAdd->rows, pMatrixToAdd->columns))
-		return FAILURE;
-	Matrix* pResult = *phResult;       // result of addition
+	Matrix* pMatrix = hMatrices[0];
+	double flops = (hMatricesSize - 1.0) * pMatrix->rows * pMatrix->columns;
+	MeasuredCall call;
 
-	long double sum = 0;               // sum for each new individual term
-	int maxLength = 1;                 // max length of the new matrix (same as in the matrix structure).
-	int numLength;                     // gets the length of each number to be compared to max length
-	Boolean firstNewNum = TRUE;        // TRUE = first number being calculated in the whole result matrix
-
-	// perform the addition
-	// outer 2 loops for result matrix
-	for (int resultRow = 0; resultRow < pMatrixToAdd->rows; ++resultRow) {
-		for (int resultColumn = 0; resultColumn < pMatrixToAdd->columns; ++resultColumn) {
-			// inner loop to get the sum
-			sum = 0;
-			for (int i = 0; i < hMatricesSize; ++i) {
-				pMatrixToAdd = hMatrices[i];
-				sum += pMatrixToAdd->matrix[at(hMatrices[i], resultRow, resultColumn, NULL)];
-			}
-			numLength = calcNumLength(sum);
-			if (firstNewNum) {
-				maxLength = numLength;
-				firstNewNum = FALSE;
-			}
-			else if (numLength > maxLength)
-				maxLength = numLength;
-			pResult->matrix[at((MATRIX)pResult, resultRow, resultColumn, NULL)] = sum;
-		}
-	}
-	pResult->maxLength = maxLength;
+	beginCall(&call, MATRIX_OPERATION_ADD, hMatrices[0]);
+	Status status = addMatrices(hMatrices, hMatricesSize, phResult);
+	endCall(&call, status ? flops : 0);
 
-	return SUCCESS;
+	return status;
 }
 
 
 
 Status matrix_subtract(MATRIX* hMatrices, int hMatricesSize, MATRIX* phResult) {
-	Matrix* pMatrixToSubtract = hMatrices[0];        // 1st matrix, the matrix being subtracted from
-
-	// recreate the result matrix if its dimensions aren't appropriate for the subtraction or it's NULL
-	if (!adjustMatrixDimensions((Matrix**)phResult, pMatrixToSubtract->rows, pMatrixToSubtract->columns))
-		return FAILURE;
-	Matrix* pResult = *phResult;       // result of subtraction
-
-	long double sum = 0;               // sum for each new individual term
-	int maxLength = 1;                 // max length of the new matrix (same as in the matrix structure).
-	int numLength;                     // gets the length of each number to be compared to max length
-	Boolean firstNewNum = TRUE;        // TRUE = first number being calculated in the whole result matrix
+	Matrix* pMatrix = hMatrices[0];
+	double flops = (hMatricesSize - 1.0) * pMatrix->rows * pMatrix->columns;
+	MeasuredCall call;
 
-	// perform the subtraction
-	// outer 2 loops for result matrix
-	for (int resultRow = 0; resultRow < pMatrixToSubtract->rows; ++resultRow) {
-		for (int resultColumn = 0; resultColumn < pMatrixToSubtract->columns; ++resultColumn) {
-			// inner loop to get the sum
-			sum = 0;
-			for (int i = 0; i < hMatricesSize; ++i) {
-				pMatrixToSubtract = hMatrices[i];
-				if (i == 0)
-					sum += pMatrixToSubtract->matrix[at(hMatrices[i], resultRow, resultColumn, NULL)];
-				else
-					sum -= pMatrixToSubtract->matrix[at(hMatrices[i], resultRow, resultColumn, NULL)];
-			}
-			numLength = calcNumLength(sum);
-			if (firstNewNum) {
-				maxLength = numLength;
-				firstNewNum = FALSE;
-			}
-			else if (numLength > maxLength)
-				maxLength = numLength;
-			pResult->matrix[at((MATRIX)pResult, resultRow, resultColumn, NULL)] = sum;
-		}
-	}
-	pResult->maxLength = maxLength;
+	beginCall(&call, MATRIX_OPERATION_SUBTRACT, hMatrices[0]);
+	Status status = subtractMatrices(hMatrices, hMatricesSize, phResult);
+	endCall(&call, status ? flops : 0);
 
-	return SUCCESS;
+	return status;
 }
 
 
 
 Status matrix_power(MATRIX hMatrix, int power, MATRIX* phResult) {
-	MATRIX hToMultiply = NULL;        // handles used for power operation
-	MATRIX hTempResult = NULL;
-
-	// case power = 1
-	if (power == 1) {
-		if (!matrix_assignment(hMatrix, phResult))
-			return FAILURE;
-		return SUCCESS;
-	}
-	// case power = 2
-	else if (power == 2) {
-		if (!matrix_multiply(hMatrix, hMatrix, phResult))
-			return FAILURE;
+	double n = ((Matrix*)hMatrix)->rows;
+	CacheKey key;
+	long double ignored;
+	MeasuredCall call;
+
+	beginCall(&call, MATRIX_OPERATION_POWER, hMatrix);
+	// powers of a matrix with the same entries are reused while the cache is on
+	Boolean cached = power > 1 && cacheKey(hMatrix, CACHE_POWER, power, &key);
+	if (cached && cacheFindMatrix(&key, (Matrix**)phResult, &ignored)) {
+		endCall(&call, 0);
 		return SUCCESS;
 	}
 
-	// all other cases
-	// do the first multiplication in the power operation
-	if (!matrix_multiply(hMatrix, hMatrix, &hToMultiply))
-		return FAILURE;
-	// do all other multiplications thereafter
-	for (int i = 3; i <= power; ++i) {
-		if (!matrix_multiply(hMatrix, hToMultiply, &hTempResult)) {
-			matrix_destroy(&hToMultiply);
-			return FAILURE;
-		}
-		matrix_destroy(&hToMultiply);
-		hToMultiply = hTempResult;
-		hTempResult = NULL;
-	}
-
-	Matrix* pResult = *phResult;
-	if (pResult) {
-		free(pResult->matrix);
-		free(pResult);
-	}
-	*phResult = hToMultiply;
+	Status status = calculatePower(hMatrix, power, phResult);
+	if (cached && status)
+		cacheStoreMatrix(&key, *phResult, 0);
+	endCall(&call, (status && power > 1) ? 2 * (power - 1) * n * n * n : 0);
 
-	return SUCCESS;
+	return status;
 }
 
 
 
 Status matrix_transpose(MATRIX hMatrix, MATRIX* phResult) {
-	Matrix* pMatrix = hMatrix;        // the matrix being transposed
-
-	// recreate the result matrix if its dimensions aren't appropriate for the transpose or it's NULL
-	if (!adjustMatrixDimensions((Matrix**)phResult, pMatrix->columns, pMatrix->rows))
-		return FAILURE;
-	Matrix* pResult = *phResult;        // result of the transpose operation
+	MeasuredCall call;
 
-	// calculate the transpose
-	for (int i = 0; i < pMatrix->rows; ++i) {
-		for (int j = 0; j < pMatrix->columns; ++j)
-			pResult->matrix[at((MATRIX)pResult, j, i, NULL)] = pMatrix->matrix[at((MATRIX)pMatrix, i, j, NULL)];
-	}
-	pResult->maxLength = pMatrix->maxLength;
+	beginCall(&call, MATRIX_OPERATION_TRANSPOSE, hMatrix);
+	Status status = transposeMatrix(hMatrix, phResult);
+	endCall(&call, 0);
 
-	return SUCCESS;
+	return status;
 }
 
 
 
 long double matrix_determinant(MATRIX hMatrix, Status* pMemoryAllocation) {
 	Matrix* pMatrix = hMatrix;
-	*pMemoryAllocation = SUCCESS;
+	double flops = 2.0 * pMatrix->rows * pMatrix->rows * pMatrix->rows / 3;
+	MeasuredCall call;
 
-	// the determinant of a 1 x 1 matrix is just the single number in the matrix
-	if (pMatrix->rows == 1 && pMatrix->columns == 1)
-		return pMatrix->matrix[0];
+	beginCall(&call, MATRIX_OPERATION_DETERMINANT, hMatrix);
+	long double determinant = findDeterminant(hMatrix, pMemoryAllocation);
+	endCall(&call, *pMemoryAllocation ? flops : 0);
 
-	// all other matrices - 2 x 2, 3 x 3 etc.
-	return calculateDeterminate(pMatrix, pMemoryAllocation);
+	return determinant;
 }
 
 
 
 Status matrix_inverse(MATRIX hMatrix, MATRIX* phResult, Boolean* pMatrixIsVertible) {
-	Matrix* pMatrix = hMatrix;                 // the matrix to be inverted
-	Status memoryAllocation;                   // checks for memory allocation failure
-	long double determinant;                   // the result of the determinant operation
-	*pMatrixIsVertible = TRUE;                 // assume the matrix is vertible
-
-	// recreate the result matrix if its dimensions aren't appropriate for the inverse operation or it's NULL
-	if (!adjustMatrixDimensions((Matrix**)phResult, pMatrix->rows, pMatrix->columns))
-		return FAILURE;
-	Matrix* pResult = *phResult;        // result of the inverse operation
-
-	// implement the determinant operation and check for memory allocation failure/determinant doesn't exist
-	determinant = matrix_determinant(hMatrix, &memoryAllocation);
-	if (!memoryAllocation)
-		return FAILURE;
-	else if (determinant == 0) {
-		*pMatrixIsVertible = FALSE;
+	double n = ((Matrix*)hMatrix)->rows;
+	CacheKey key;
+	long double isVertible;
+	MeasuredCall call;
+
+	beginCall(&call, MATRIX_OPERATION_INVERSE, hMatrix);
+	// inverses of a matrix with the same entries are reused while the cache is on, and so is finding it's singular
+	Boolean cached = cacheKey(hMatrix, CACHE_INVERSE, 0, &key);
+	if (cached && cacheFindMatrix(&key, (Matrix**)phResult, &isVertible)) {
+		endCall(&call, 0);
+		*pMatrixIsVertible = TRUE;
+		if (isVertible != 0)
+			return SUCCESS;
+		// a singular matrix still leaves the result with its dimensions, the same as calculateInverse
+		Matrix* pMatrix = hMatrix;
+		if (adjustMatrixDimensions((Matrix**)phResult, pMatrix->rows, pMatrix->columns))
+			*pMatrixIsVertible = FALSE;
 		return FAILURE;
 	}
 
-	if (!calculateAdjugateMatrix(pMatrix, &pResult))
-		return FAILURE;
+	Status status = calculateInverse(hMatrix, phResult, pMatrixIsVertible);
+	if (cached && (status || !*pMatrixIsVertible))
+		cacheStoreMatrix(&key, status ? *phResult : NULL, status ? 1 : 0);
+	endCall(&call, status ? 2 * n * n * n : 0);
 
-	// multiply every term in the adjugate matrix by 1 / determinant - the result of this is the inverse.
-	Boolean firstNewNum = TRUE;        // TRUE = first number being calculated in the whole result matrix
-	long double newTerm;               // each new term after multiply by 1 / determinant
-	int maxLength = 1;                 // max length of the new matrix (same as in the matrix structure).
-	int numLength;                     // gets the length of each number to be compared to max length
-
-	for (int i = 0; i < pResult->rows * pResult->columns; ++i) {
-		newTerm = pResult->matrix[i] / determinant;
-		numLength = calcNumLength(newTerm);
-		if (firstNewNum) {
-			maxLength = numLength;
-			firstNewNum = FALSE;
-		}
-		else if (numLength > maxLength)
-			maxLength = numLength;
-		pResult->matrix[i] = newTerm;
-	}
-	pResult->maxLength = maxLength;
-
-	return SUCCESS;
+	return status;
 }
 
 
@@ -608,64 +443,36 @@ Boolean matrix_canBeAdded(MATRIX hMatrix1, MATRIX hMatrix2) {
 
 void matrix_print(MATRIX hMatrix) {
 	Matrix* pMatrix = hMatrix;
-	char numString[500];                              // buffer to hold each number as a string
-	int extraSpaces;                                  // will count how many extra spaces to print for each number
-	int spacesPerNum = pMatrix->maxLength + 2;        // each number occupies the same fixed space
-
-	// the total spaces horizontally the matrix takes up so it's known how many dashes to print
-	int totalSpaces = spacesPerNum * pMatrix->columns + pMatrix->columns + 1;
-
-	// print the matrix
-	for (int i = 0; i < totalSpaces; ++i)
-		printf("-");
-	printf("\n");
-
-	for (int i = 0; i < pMatrix->rows; ++i) {
-		for (int j = 0; j < pMatrix->columns; ++j) {
-			long double num = pMatrix->matrix[at(hMatrix, i, j, NULL)];
-			sprintf(numString, "%Lf", num);
-			removeTrailingZeroes(numString);
-			printf("|");
-			printf("%s", numString);
-			extraSpaces = pMatrix->maxLength - strlen(numString);
-
-			while (extraSpaces > 0) {
-				printf(" ");
-				--extraSpaces;
-			}
-			printf("  ");
-			if (j == pMatrix->columns - 1)
-				printf("|");
-		}
-		printf("\n");
-		for (int i = 0; i < totalSpaces; ++i)
-			printf("-");
-		printf("\n");
-	}
+	TraceSpan span;
+
+	beginSpan(&span, "print", pMatrix->rows, pMatrix->columns);
+	matrix_writeText(hMatrix, stdout, MATRIX_TEXT_BOXED);
 	printf("\n\n");
+	endSpan(&span);
 }
 
 
 
-long double matrix_getEntry(MATRIX hMatrix, int row, int column, Boolean* pOutOfBounds) {
+long double matrix_getEntry(MATRIX hMatrix, size_t row, size_t column, Boolean* pOutOfBounds) {
 	Matrix* pMatrix = hMatrix;
 
 	long double entry = pMatrix->matrix[at(hMatrix, row, column, pOutOfBounds)];
 
-	return (*pOutOfBounds) ? OUT_OF_BOUNDS : entry;
+	return (*pOutOfBounds) ? 0 : entry;
 }
 
 
 
-Status matrix_setEntry(MATRIX hMatrix, long double newEntry, int row, int column) {
+Status matrix_setEntry(MATRIX hMatrix, long double newEntry, size_t row, size_t column) {
 	Matrix* pMatrix = hMatrix;
 
 	// out of bounds
 	if (row >= pMatrix->rows || column >= pMatrix->columns)
 		return FAILURE;
 
-	// in bounds
+	// in bounds - the max length is worked out again the next time the matrix is printed
 	pMatrix->matrix[at(hMatrix, row, column, NULL)] = newEntry;
+	pMatrix->maxLength = 0;
 
 	return SUCCESS;
 }
@@ -676,29 +483,22 @@ Status matrix_assignment(MATRIX hMatrix, MATRIX* phResult) {
 	Matrix* pMatrix = hMatrix;
 	Matrix* pResult = *phResult;
 	MATRIX hNewMatrix = NULL;
-	long double* matrix;
 
 	// the matrix object doesn't exist
 	if (!pResult) {
-		if (!(hNewMatrix = matrix_init(pMatrix->rows, pMatrix->columns)))
+		if (!(hNewMatrix = matrix_initLayout(pMatrix->rows, pMatrix->columns, pMatrix->layout)))
 			return FAILURE;
 		*phResult = hNewMatrix;
 		pResult = *phResult;
 	}
-	// the matrix object exists but its dimensions are incorrect
-	else if (pResult->rows != pMatrix->rows || pResult->columns != pMatrix->columns) {
-		if (!(matrix = calloc(pMatrix->rows * pMatrix->columns, sizeof(*matrix))))
+	// the matrix object exists but its dimensions or layout are incorrect
+	else if (pResult->rows != pMatrix->rows || pResult->columns != pMatrix->columns || pResult->layout != pMatrix->layout) {
+		if (!resizeStorage(pResult, pMatrix->rows, pMatrix->columns, pMatrix->layout))
 			return FAILURE;
-		free(pResult->matrix);
-		pResult->matrix = matrix;
-		pResult->rows = pMatrix->rows;
-		pResult->columns = pMatrix->columns;
 	}
 
 	// copy the matrix entries
-	int matrixSize = pMatrix->rows * pMatrix->columns;
-	for (int i = 0; i < matrixSize; ++i)
-		pResult->matrix[i] = pMatrix->matrix[i];
+	copyStorage(pResult, pMatrix);
 	pResult->maxLength = pMatrix->maxLength;
 
 	return SUCCESS;
@@ -709,8 +509,8 @@ Status matrix_assignment(MATRIX hMatrix, MATRIX* phResult) {
 void matrix_destroy(MATRIX* phMatrix) {
 	Matrix* pMatrix = *phMatrix;
 	if (pMatrix) {
-		free(pMatrix->matrix);
-		free(pMatrix);
+		freeStorage(pMatrix);
+		freeMemory(pMatrix);
 		*phMatrix = NULL;
 	}
 }
@@ -719,40 +519,6 @@ void matrix_destroy(MATRIX* phMatrix) {
 
 
 /***** Helper functions used only in this file *****/
-static int calcNumLength(long double n) {
-	char numString[50];
-	int nInt = (int)floor(n);
-
-	if (nInt == n) {
-		sprintf(numString, "%d", nInt);
-		return strlen(numString);
-	}
-	else
-		sprintf(numString, "%Lf", n);
-	int totalChars = strlen(numString);
-	for (int i = strlen(numString) - 1; numString[i] == '0' || numString[i] == '.'; --i)
-		--totalChars;
-
-	return totalChars;
-}
-
-
-
-static void removeTrailingZeroes(char* numString) {
-	int i;
-	Boolean reachedDecimalPoint = FALSE;
-
-	for (i = strlen(numString) - 1; i >= 0 && (numString[i] == '0' || numString[i] == '.'); --i) {
-		if (reachedDecimalPoint == TRUE)
-			break;
-		if (numString[i] == '.')
-			reachedDecimalPoint = TRUE;
-		numString[i] = '\0';
-	}
-}
-
-
-
 static long double calculate2x2determinate(long double a11, long double a12, long double a21, long double a22) {
 	return a11 * a22 - a21 * a12;
 }
@@ -771,7 +537,7 @@ static long double calculateDeterminate(Matrix* pMatrix, Status* pMemoryAllocati
 
 	// all other cases: recursive calculation
 	long double sum = 0;
-	for (int column = 0; column < pMatrix->columns; ++column) {
+	for (size_t column = 0; column < pMatrix->columns; ++column) {
 		// create the recursive submatrix
 		MATRIX hSubMatrix = matrix_init(pMatrix->rows - 1, pMatrix->columns - 1);
 		if (!hSubMatrix) {
@@ -783,12 +549,12 @@ static long double calculateDeterminate(Matrix* pMatrix, Status* pMemoryAllocati
 		// get one part of the recursive sum
 		// get the a_1_jth entry
 		long double entry = pMatrix->matrix[at((MATRIX)pMatrix, 0, column, NULL)];
-		int subMatrix_row = 0;
-		int subMatrix_column = 0;
+		size_t subMatrix_row = 0;
+		size_t subMatrix_column = 0;
 		// get the recursive submatrix
-		for (int row = 1; row < pMatrix->rows; ++row) {
+		for (size_t row = 1; row < pMatrix->rows; ++row) {
 			subMatrix_column = 0;
-			for (int _column = 0; _column < pMatrix->columns; ++_column) {
+			for (size_t _column = 0; _column < pMatrix->columns; ++_column) {
 				if (_column == column)
 					continue;
 				pSubMatrix->matrix[at(hSubMatrix, subMatrix_row, subMatrix_column, NULL)] = pMatrix->matrix[at((MATRIX)pMatrix, row, _column, NULL)];
@@ -826,8 +592,10 @@ static Status calculateAdjugateMatrix(Matrix* pMatrix, Matrix** ppResult) {
 	}
 	// special case for a 2 x 2 matrix
 	else if (pResult->rows == 2 && pResult->columns == 2) {
-		for (int i = 0; i < pResult->rows * pResult->columns; ++i)
-			pResult->matrix[i] = pMatrix->matrix[i];
+		for (size_t i = 0; i < 2; ++i) {
+			for (size_t j = 0; j < 2; ++j)
+				pResult->matrix[at((MATRIX)pResult, i, j, NULL)] = pMatrix->matrix[at((MATRIX)pMatrix, i, j, NULL)];
+		}
 		pResult->matrix[at((MATRIX)pResult, 0, 1, NULL)] *= -1;
 		pResult->matrix[at((MATRIX)pResult, 1, 0, NULL)] *= -1;
 		long double temp = pResult->matrix[at((MATRIX)pResult, 0, 0, NULL)];
@@ -861,8 +629,8 @@ static Status calculateAdjugateMatrix(Matrix* pMatrix, Matrix** ppResult) {
 	Boolean firstNewNum = TRUE;        // TRUE = first number being calculated in the whole result matrix
 	long double newTerm;               // each new term after multiplying by 1 / determinant
 
-	for (int row = 0; row < pMatrix->rows; ++row) {
-		for (int column = 0; column < pMatrix->columns; ++column) {
+	for (size_t row = 0; row < pMatrix->rows; ++row) {
+		for (size_t column = 0; column < pMatrix->columns; ++column) {
 			// create the recursive submatrix
 			MATRIX hSubMatrix = matrix_init(pMatrix->rows - 1, pMatrix->columns - 1);
 			if (!hSubMatrix) {
@@ -872,13 +640,13 @@ static Status calculateAdjugateMatrix(Matrix* pMatrix, Matrix** ppResult) {
 			Matrix* pSubMatrix = hSubMatrix;
 
 			// get the submatrix
-			int subMatrix_row = 0;
-			int subMatrix_column = 0;
-			for (int _row = 0; _row < pMatrix->rows; ++_row) {
+			size_t subMatrix_row = 0;
+			size_t subMatrix_column = 0;
+			for (size_t _row = 0; _row < pMatrix->rows; ++_row) {
 				if (_row == row)
 					continue;
 				subMatrix_column = 0;
-				for (int _column = 0; _column < pMatrix->columns; ++_column) {
+				for (size_t _column = 0; _column < pMatrix->columns; ++_column) {
 					if (_column == column)
 						continue;
 					pSubMatrix->matrix[at(hSubMatrix, subMatrix_row, subMatrix_column, NULL)] = pMatrix->matrix[at((MATRIX)pMatrix, _row, _column, NULL)];
@@ -927,270 +695,599 @@ static Status calculateAdjugateMatrix(Matrix* pMatrix, Matrix** ppResult) {
 
 
 
-static Boolean inputIsValidDouble(const char* line, int expectedNumbers) {
-	Boolean negativeAlreadyExists = FALSE;
-	Boolean decimalPointAlreadyExists = FALSE;
+static Status calculatePower(MATRIX hMatrix, int power, MATRIX* phResult) {
+	MATRIX hToMultiply = NULL;        // handles used for power operation
+	MATRIX hTempResult = NULL;
 
-	// user only pressed "enter" or whitespace followed by "enter" - space is the only valid whitespace character
-	int i = 0;
-	while (isspace(line[i])) {
-		if (line[i] != ' ')
-			return FALSE;
-		++i;
+	// case power = 1
+	if (power == 1) {
+		if (!matrix_assignment(hMatrix, phResult))
+			return FAILURE;
+		return SUCCESS;
+	}
+	// case power = 2
+	else if (power == 2) {
+		if (!matrix_multiply(hMatrix, hMatrix, phResult))
+			return FAILURE;
+		return SUCCESS;
 	}
-	if (line[i] == '\0')
-		return FALSE;
-
-	// validate it's all numbers in the correct format
-	while (line[i] != '\0') {
-		// something other than a digit, negative sign, decimal point, or space
-		if (!isdigit(line[i]) && line[i] != ' ' && line[i] != '-' && line[i] != '.')
-			return FALSE;
 
-		// repeat decimals points/negative signs are ok if they're in separate numbers
-		else if (line[i] == ' ') {
-			negativeAlreadyExists = FALSE;
-			decimalPointAlreadyExists = FALSE;
+	// all other cases
+	// do the first multiplication in the power operation
+	if (!matrix_multiply(hMatrix, hMatrix, &hToMultiply))
+		return FAILURE;
+	// do all other multiplications thereafter
+	for (int i = 3; i <= power; ++i) {
+		if (!matrix_multiply(hMatrix, hToMultiply, &hTempResult)) {
+			matrix_destroy(&hToMultiply);
+			return FAILURE;
 		}
+		matrix_destroy(&hToMultiply);
+		hToMultiply = hTempResult;
+		hTempResult = NULL;
+	}
 
-		// negative character
-		else if (line[i] == '-') {
-			// Multiple negatives are invalid
-			if (negativeAlreadyExists)
-				return FALSE;
-			else
-				negativeAlreadyExists = TRUE;
-
-			// negative is the first character
-			if (i == 0) {
-				// invalid if the next character isn't a digit or decimal point
-				if (!isdigit(line[i + 1]) && line[i + 1] != '.')
-					return FALSE;
-			}
-			// negative that's not the first character
-			else {
-				// invalid if the previous character isn't a space, or the next character isn't a digit or decimal point.
-				if (line[i - 1] != ' ' || (!isdigit(line[i + 1]) && line[i + 1] != '.'))
-					return FALSE;
-			}
+	// the result keeps the layout of the matrix object it's stored in
+	Matrix* pResult = *phResult;
+	if (pResult) {
+		if (!matrix_setLayout(hToMultiply, pResult->layout)) {
+			matrix_destroy(&hToMultiply);
+			return FAILURE;
 		}
-
-		// decimal point
-		else if (line[i] == '.') {
-			// Multiple decimal points are invalid.
-			if (decimalPointAlreadyExists)
-				return FALSE;
-			else
-				decimalPointAlreadyExists = TRUE;
-
-			// decimal is the first character
-			if (i == 0) {
-				// invalid if next character isn't a digit
-				if (!isdigit(line[i + 1]))
-					return FALSE;
-			}
-			// decimal is not the first character
-			else {
-				// invalid if the previous character isn't a space, negative sign, or number, or if the next character isn't a number
-				if ((!isdigit(line[i - 1]) && line[i - 1] != ' ' && line[i - 1] != '-') || !isdigit(line[i + 1]))
-					return FALSE;
-			}
+		// a mapped result keeps its file, so the power is copied into it
+		if (isMapped(pResult)) {
+			Status status = matrix_assignment(hToMultiply, phResult);
+			matrix_destroy(&hToMultiply);
+			return status;
 		}
-
-		++i;
-	}
-
-
-	// input has been validated - now verify an appropriate amount of numbers has been entered
-	i = 0;
-	int totalNumbers = 0;
-	while (line[i] != '\0') {
-		while (line[i] != ' ' && line[i] != '\0')
-			++i;
-		++totalNumbers;
-		if (line[i] != '\0')
-			++i;
+		matrix_destroy(phResult);
 	}
+	*phResult = hToMultiply;
 
-	return totalNumbers == expectedNumbers;
+	return SUCCESS;
 }
 
 
 
-static Status linestringToArray(const char* line, long double* a, int aSize) {
-	char singleNum[50];        // buffer to hold a single number from the line
-	int i = 0;                 // index for line
-	int j = 0;                 // index for singleNum
-	int k = 0;                 // index for a
+static Status calculateInverse(MATRIX hMatrix, MATRIX* phResult, Boolean* pMatrixIsVertible) {
+	Matrix* pMatrix = hMatrix;                 // the matrix to be inverted
+	Status memoryAllocation;                   // checks for memory allocation failure
+	long double determinant;                   // the result of the determinant operation
+	*pMatrixIsVertible = TRUE;                 // assume the matrix is vertible
 
-	while (line[i] != '\0') {
-		while (line[i] != ' ' && line[i] != '\0')
-			singleNum[j++] = line[i++];
-		singleNum[j] = '\0';
-		if (k >= aSize)
+	// recreate the result matrix if its dimensions aren't appropriate for the inverse operation or it's NULL
+	if (!adjustMatrixDimensions((Matrix**)phResult, pMatrix->rows, pMatrix->columns))
+		return FAILURE;
+	Matrix* pResult = *phResult;        // result of the inverse operation
+
+	// symmetric positive definite matrices use the Cholesky factorization and large matrices use the LU factorization
+	if (pMatrix->rows > 1) {
+		Boolean factored;
+		if (!inverseFromFactorization(pMatrix, pResult, &factored, pMatrixIsVertible))
 			return FAILURE;
-		a[k++] = (long double)strtod(singleNum, NULL);
-		if (line[i] != '\0') {
-			++i;
-			j = 0;
+		if (factored)
+			return (*pMatrixIsVertible) ? SUCCESS : FAILURE;
+	}
+
+	// implement the determinant operation and check for memory allocation failure/determinant doesn't exist
+	determinant = matrix_determinant(hMatrix, &memoryAllocation);
+	if (!memoryAllocation)
+		return FAILURE;
+	else if (determinant == 0) {
+		*pMatrixIsVertible = FALSE;
+		return FAILURE;
+	}
+
+	if (!calculateAdjugateMatrix(pMatrix, &pResult))
+		return FAILURE;
+
+	// multiply every term in the adjugate matrix by 1 / determinant - the result of this is the inverse.
+	Boolean firstNewNum = TRUE;        // TRUE = first number being calculated in the whole result matrix
+	long double newTerm;               // each new term after multiply by 1 / determinant
+	int maxLength = 1;                 // max length of the new matrix (same as in the matrix structure).
+	int numLength;                     // gets the length of each number to be compared to max length
+
+	size_t matrixSize = storageSize(pResult->rows, pResult->columns, pResult->layout);
+	for (size_t i = 0; i < matrixSize; ++i) {
+		newTerm = pResult->matrix[i] / determinant;
+		numLength = calcNumLength(newTerm);
+		if (firstNewNum) {
+			maxLength = numLength;
+			firstNewNum = FALSE;
 		}
+		else if (numLength > maxLength)
+			maxLength = numLength;
+		pResult->matrix[i] = newTerm;
 	}
+	pResult->maxLength = maxLength;
+
 	return SUCCESS;
 }
 
 
 
-static int at(MATRIX hMatrix, int row, int column, Boolean* pOutOfBounds) {
+static size_t at(MATRIX hMatrix, size_t row, size_t column, Boolean* pOutOfBounds) {
 	Matrix* pMatrix = hMatrix;
 
 	// out of bounds
 	if (row >= pMatrix->rows || column >= pMatrix->columns) {
 		if (pOutOfBounds)
 			*pOutOfBounds = TRUE;
-		return OUT_OF_BOUNDS;
+		return 0;
 	}
 
 	// in bounds
 	if (pOutOfBounds)
 		*pOutOfBounds = FALSE;
 
-	return row * pMatrix->columns + column;
+	return matrixIndex(pMatrix, row, column);
 }
 
 
 
-static Status adjustMatrixDimensions(Matrix** ppMatrix, int rows, int columns) {
-	Matrix* pMatrix = *ppMatrix;
-	MATRIX hNewMatrix;
-	long double* matrix;
 
-	// the matrix object doesn't exist
-	if (!pMatrix) {
-		if (!(hNewMatrix = matrix_init(rows, columns)))
-			return FAILURE;
-		*ppMatrix = hNewMatrix;
+static const long double* blockView(const Matrix* pMatrix, size_t row, size_t column, size_t* pLeadingDimension, Boolean* pTransposed) {
+	switch (pMatrix->layout) {
+	case MATRIX_COLUMN_MAJOR:
+		*pLeadingDimension = pMatrix->rows;
+		*pTransposed = TRUE;
+		break;
+	case MATRIX_TILED:
+		*pLeadingDimension = MATRIX_TILE_SIZE;
+		*pTransposed = FALSE;
+		break;
+	default:
+		*pLeadingDimension = pMatrix->columns;
+		*pTransposed = FALSE;
+		break;
 	}
-	// the matrix object exists but its dimensions are incorrect
-	else if (pMatrix->rows != rows || pMatrix->columns != columns) {
-		if (!(matrix = calloc(rows * columns, sizeof(*matrix))))
-			return FAILURE;
-		free(pMatrix->matrix);
-		pMatrix->matrix = matrix;
-		pMatrix->rows = rows;
-		pMatrix->columns = columns;
-		pMatrix->maxLength = 1;
+
+	return pMatrix->matrix + matrixIndex(pMatrix, row, column);
+}
+
+
+
+static Boolean sameLayout(MATRIX* hMatrices, int hMatricesSize, const Matrix* pResult) {
+	for (int i = 0; i < hMatricesSize; ++i) {
+		Matrix* pMatrix = hMatrices[i];
+		if (pMatrix->layout != pResult->layout)
+			return FALSE;
+	}
+
+	return TRUE;
+}
+
+
+
+static void multiplyTile(const Matrix* pMatrix1, const Matrix* pMatrix2, Matrix* pResult, size_t row, size_t column, size_t inner) {
+	size_t ib = (pMatrix1->rows - row < MATRIX_TILE_SIZE) ? pMatrix1->rows - row : MATRIX_TILE_SIZE;
+	size_t jb = (pMatrix2->columns - column < MATRIX_TILE_SIZE) ? pMatrix2->columns - column : MATRIX_TILE_SIZE;
+	size_t pb = (pMatrix1->columns - inner < MATRIX_TILE_SIZE) ? pMatrix1->columns - inner : MATRIX_TILE_SIZE;
+	size_t lda, ldb, ldc;
+	Boolean aTransposed, bTransposed, cTransposed;
+	const long double* a = blockView(pMatrix1, row, inner, &lda, &aTransposed);
+	const long double* b = blockView(pMatrix2, inner, column, &ldb, &bTransposed);
+	long double* c = (long double*)blockView(pResult, row, column, &ldc, &cTransposed);
+	long double beta = (inner == 0) ? 0 : 1;
+
+	// a transposed result tile is computed as C^T = B^T * A^T
+	if (!cTransposed)
+		multiplyKernel(aTransposed, bTransposed, ib, jb, pb, 1, a, lda, b, ldb, beta, c, ldc);
+	else
+		multiplyKernel(!bTransposed, !aTransposed, jb, ib, pb, 1, b, ldb, a, lda, beta, c, ldc);
+}
+
+
+
+static int maxLengthOfSpan(const Matrix* pMatrix, size_t first, size_t end) {
+	int maxLength = 1;
+	int numLength;
+
+	for (size_t i = first; i < end; ++i) {
+		numLength = calcNumLength(pMatrix->matrix[i]);
+		if (numLength > maxLength)
+			maxLength = numLength;
 	}
 
+	return maxLength;
+}
+
+
+
+static void releaseSpanOfAll(MATRIX* hMatrices, int hMatricesSize, const Matrix* pResult, size_t first, size_t end) {
+	for (int i = 0; i < hMatricesSize; ++i)
+		releaseSpan(hMatrices[i], first, end);
+	releaseSpan(pResult, first, end);
+}
+
+
+
+static void releaseRowsOfAll(MATRIX* hMatrices, int hMatricesSize, const Matrix* pResult, size_t firstRow, size_t endRow) {
+	for (int i = 0; i < hMatricesSize; ++i)
+		releaseRows(hMatrices[i], firstRow, endRow);
+	releaseRows(pResult, firstRow, endRow);
+}
+
+
+
+static Status multiplyMatrices(MATRIX hMatrix1, MATRIX hMatrix2, MATRIX* phResult) {
+	Matrix* pMatrix1 = hMatrix1;        // matrix 1 being multiplied
+	Matrix* pMatrix2 = hMatrix2;        // matrix 2 being multiplied
+
+	// recreate the result matrix if its dimensions aren't appropriate for the multiplication or it's NULL
+	if (!adjustMatrixDimensions((Matrix**)phResult, pMatrix1->rows, pMatrix2->columns))
+		return FAILURE;
+	Matrix* pResult = *phResult;       // result of multiplication
+
+	// perform the multiplication one row panel of tiles of the result at a time.
+	// each tile of each matrix is handed to multiplyKernel directly in its own layout (see blockView).
+	size_t m = pMatrix1->rows;
+	size_t n = pMatrix2->columns;
+	size_t k = pMatrix1->columns;
+	Boolean streamed = isMapped(pMatrix1) || isMapped(pMatrix2) || isMapped(pResult);
+	for (size_t i = 0; i < m; i += MATRIX_TILE_SIZE) {
+		size_t iEnd = (m - i < MATRIX_TILE_SIZE) ? m : i + MATRIX_TILE_SIZE;
+		// in memory, each result tile is finished before moving on so it stays in the cache.
+		// mapped matrices go through each row panel of the second matrix once for the whole row panel of the result
+		// instead, so only a panel of each matrix has to be in memory at a time.
+		if (!streamed) {
+			for (size_t j = 0; j < n; j += MATRIX_TILE_SIZE) {
+				for (size_t p = 0; p < k; p += MATRIX_TILE_SIZE)
+					multiplyTile(pMatrix1, pMatrix2, pResult, i, j, p);
+			}
+		}
+		else {
+			prefetchRows(pMatrix1, iEnd, (m - iEnd < MATRIX_TILE_SIZE) ? m : iEnd + MATRIX_TILE_SIZE);
+			for (size_t p = 0; p < k; p += MATRIX_TILE_SIZE) {
+				size_t pEnd = (k - p < MATRIX_TILE_SIZE) ? k : p + MATRIX_TILE_SIZE;
+				prefetchRows(pMatrix2, pEnd, (k - pEnd < MATRIX_TILE_SIZE) ? k : pEnd + MATRIX_TILE_SIZE);
+				for (size_t j = 0; j < n; j += MATRIX_TILE_SIZE)
+					multiplyTile(pMatrix1, pMatrix2, pResult, i, j, p);
+				releaseRows(pMatrix2, p, pEnd);
+			}
+		}
+		releaseRows(pMatrix1, i, iEnd);
+		releaseRows(pResult, i, iEnd);
+	}
+	// the width of the entries is only worked out if the result is printed
+	pResult->maxLength = 0;
+
 	return SUCCESS;
 }
 
 
 
+static Status addMatrices(MATRIX* hMatrices, int hMatricesSize, MATRIX* phResult) {
+	Matrix* pMatrixToAdd = hMatrices[0];        // first matrix being added
 
-/***** Helper functions used in this file and Menu.c *****/
-void numberAppender(int n, char* append) {
-	// special case
-	if (n >= 4 && n <= 20) {
-		append[0] = 't';
-		append[1] = 'h';
+	// recreate the result matrix if its dimensions aren't appropriate for the addition or it's NULL
+	if (!adjustMatrixDimensions((Matrix**)phResult, pMatrixToAdd->rows, pMatrixToAdd->columns))
+		return FAILURE;
+	Matrix* pResult = *phResult;       // result of addition
+
+	long double sum = 0;               // sum for each new individual term
+
+	// perform the addition
+	// when every matrix has the same layout, the entries line up in storage and can be added in one pass over the arrays
+	// (a chunk at a time, so mapped matrices are streamed)
+	if (sameLayout(hMatrices, hMatricesSize, pResult)) {
+		size_t matrixSize = storageSize(pResult->rows, pResult->columns, pResult->layout);
+		for (size_t chunk = 0; chunk < matrixSize; chunk += STREAM_CHUNK_SIZE) {
+			size_t chunkEnd = (matrixSize - chunk < STREAM_CHUNK_SIZE) ? matrixSize : chunk + STREAM_CHUNK_SIZE;
+			for (size_t index = chunk; index < chunkEnd; ++index) {
+				sum = 0;
+				for (int i = 0; i < hMatricesSize; ++i) {
+					pMatrixToAdd = hMatrices[i];
+					sum += pMatrixToAdd->matrix[index];
+				}
+				pResult->matrix[index] = sum;
+			}
+			releaseSpanOfAll(hMatrices, hMatricesSize, pResult, chunk, chunkEnd);
+		}
+		pResult->maxLength = 0;
+		return SUCCESS;
 	}
-	// st i.e. 21st
-	else if ((n - 1) % 10 == 0) {
-		append[0] = 's';
-		append[1] = 't';
+
+	// outer 2 loops for result matrix
+	for (size_t resultRow = 0; resultRow < pMatrixToAdd->rows; ++resultRow) {
+		for (size_t resultColumn = 0; resultColumn < pMatrixToAdd->columns; ++resultColumn) {
+			// inner loop to get the sum
+			sum = 0;
+			for (int i = 0; i < hMatricesSize; ++i) {
+				pMatrixToAdd = hMatrices[i];
+				sum += pMatrixToAdd->matrix[matrixIndex(pMatrixToAdd, resultRow, resultColumn)];
+			}
+			pResult->matrix[matrixIndex(pResult, resultRow, resultColumn)] = sum;
+		}
+		if ((resultRow + 1) % MATRIX_TILE_SIZE == 0)
+			releaseRowsOfAll(hMatrices, hMatricesSize, pResult, resultRow + 1 - MATRIX_TILE_SIZE, resultRow + 1);
 	}
-	// nd i.e. 22nd
-	else if ((n - 2) % 10 == 0) {
-		append[0] = 'n';
-		append[1] = 'd';
+	pResult->maxLength = 0;
+
+	return SUCCESS;
+}
+
+
+
+static Status subtractMatrices(MATRIX* hMatrices, int hMatricesSize, MATRIX* phResult) {
+	Matrix* pMatrixToSubtract = hMatrices[0];        // 1st matrix, the matrix being subtracted from
+
+	// recreate the result matrix if its dimensions aren't appropriate for the subtraction or it's NULL
+	if (!adjustMatrixDimensions((Matrix**)phResult, pMatrixToSubtract->rows, pMatrixToSubtract->columns))
+		return FAILURE;
+	Matrix* pResult = *phResult;       // result of subtraction
+
+	long double sum = 0;               // sum for each new individual term
+
+	// perform the subtraction
+	// when every matrix has the same layout, the entries line up in storage and can be subtracted in one pass over the arrays
+	// (a chunk at a time, so mapped matrices are streamed)
+	if (sameLayout(hMatrices, hMatricesSize, pResult)) {
+		size_t matrixSize = storageSize(pResult->rows, pResult->columns, pResult->layout);
+		for (size_t chunk = 0; chunk < matrixSize; chunk += STREAM_CHUNK_SIZE) {
+			size_t chunkEnd = (matrixSize - chunk < STREAM_CHUNK_SIZE) ? matrixSize : chunk + STREAM_CHUNK_SIZE;
+			for (size_t index = chunk; index < chunkEnd; ++index) {
+				pMatrixToSubtract = hMatrices[0];
+				sum = pMatrixToSubtract->matrix[index];
+				for (int i = 1; i < hMatricesSize; ++i) {
+					pMatrixToSubtract = hMatrices[i];
+					sum -= pMatrixToSubtract->matrix[index];
+				}
+				pResult->matrix[index] = sum;
+			}
+			releaseSpanOfAll(hMatrices, hMatricesSize, pResult, chunk, chunkEnd);
+		}
+		pResult->maxLength = 0;
+		return SUCCESS;
 	}
-	// rd i.e 23rd
-	else if ((n - 3) % 10 == 0) {
-		append[0] = 'r';
-		append[1] = 'd';
+
+	// outer 2 loops for result matrix
+	for (size_t resultRow = 0; resultRow < pMatrixToSubtract->rows; ++resultRow) {
+		for (size_t resultColumn = 0; resultColumn < pMatrixToSubtract->columns; ++resultColumn) {
+			// inner loop to get the sum
+			sum = 0;
+			for (int i = 0; i < hMatricesSize; ++i) {
+				pMatrixToSubtract = hMatrices[i];
+				if (i == 0)
+					sum += pMatrixToSubtract->matrix[matrixIndex(pMatrixToSubtract, resultRow, resultColumn)];
+				else
+					sum -= pMatrixToSubtract->matrix[matrixIndex(pMatrixToSubtract, resultRow, resultColumn)];
+			}
+			pResult->matrix[matrixIndex(pResult, resultRow, resultColumn)] = sum;
+		}
+		if ((resultRow + 1) % MATRIX_TILE_SIZE == 0)
+			releaseRowsOfAll(hMatrices, hMatricesSize, pResult, resultRow + 1 - MATRIX_TILE_SIZE, resultRow + 1);
 	}
-	// th i.e. 20th, 24th, 25th, 26th etc.
-	else {
-		append[0] = 't';
-		append[1] = 'h';
+	pResult->maxLength = 0;
+
+	return SUCCESS;
+}
+
+
+
+static Status transposeMatrix(MATRIX hMatrix, MATRIX* phResult) {
+	Matrix* pMatrix = hMatrix;        // the matrix being transposed
+
+	// recreate the result matrix if its dimensions aren't appropriate for the transpose or it's NULL
+	if (!adjustMatrixDimensions((Matrix**)phResult, pMatrix->columns, pMatrix->rows))
+		return FAILURE;
+	Matrix* pResult = *phResult;        // result of the transpose operation
+
+	// row-major storage of a matrix is column-major storage of its transpose and vice versa, so no entries move
+	if ((pMatrix->layout == MATRIX_ROW_MAJOR && pResult->layout == MATRIX_COLUMN_MAJOR)
+		|| (pMatrix->layout == MATRIX_COLUMN_MAJOR && pResult->layout == MATRIX_ROW_MAJOR)) {
+		copyStorage(pResult, pMatrix);
+		pResult->maxLength = pMatrix->maxLength;
+		return SUCCESS;
+	}
+
+	// calculate the transpose one tile at a time so both matrices are only walked with a large stride within a tile
+	for (size_t rowTile = 0; rowTile < pMatrix->rows; rowTile += MATRIX_TILE_SIZE) {
+		size_t rowEnd = (rowTile + MATRIX_TILE_SIZE < pMatrix->rows) ? rowTile + MATRIX_TILE_SIZE : pMatrix->rows;
+		for (size_t columnTile = 0; columnTile < pMatrix->columns; columnTile += MATRIX_TILE_SIZE) {
+			size_t columnEnd = (columnTile + MATRIX_TILE_SIZE < pMatrix->columns) ? columnTile + MATRIX_TILE_SIZE : pMatrix->columns;
+			for (size_t i = rowTile; i < rowEnd; ++i) {
+				for (size_t j = columnTile; j < columnEnd; ++j)
+					pResult->matrix[matrixIndex(pResult, j, i)] = pMatrix->matrix[matrixIndex(pMatrix, i, j)];
+			}
+		}
+		// the row panel of a mapped matrix is done and so is the column panel of a mapped result
+		releaseRows(pMatrix, rowTile, rowEnd);
+		releaseColumns(pResult, rowTile, rowEnd);
 	}
+	pResult->maxLength = pMatrix->maxLength;
+
+	return SUCCESS;
 }
 
 
 
-Boolean inputIsValidPositiveInt(const char* line, int expectedNumbers) {
-	// user only pressed "enter" or whitespace followed by "enter" - space is the only valid whitespace character
-	int i = 0;
-	while (isspace(line[i])) {
-		if (line[i] != ' ')
-			return FALSE;
-		++i;
+static long double findDeterminant(MATRIX hMatrix, Status* pMemoryAllocation) {
+	Matrix* pMatrix = hMatrix;
+	*pMemoryAllocation = SUCCESS;
+
+	// the determinant of a 1 x 1 matrix is just the single number in the matrix
+	if (pMatrix->rows == 1 && pMatrix->columns == 1)
+		return pMatrix->matrix[0];
+
+	// determinants of a matrix with the same entries are reused while the cache is on
+	long double determinant;
+	CacheKey key;
+	Boolean cached = cacheKey(pMatrix, CACHE_DETERMINANT, 0, &key);
+	if (cached && cacheFind(&key, NULL, 0, &determinant))
+		return determinant;
+
+	// symmetric positive definite matrices use the Cholesky factorization and large matrices use the LU factorization
+	Boolean factored;
+	if (!determinantFromFactorization(pMatrix, &determinant, &factored)) {
+		*pMemoryAllocation = FAILURE;
+		return 0;
 	}
-	if (line[i] == '\0')
-		return FALSE;
 
-	// validate it's all numbers or spaces
-	while (line[i] != '\0') {
-		// something other than a digit or space
-		if (!isdigit(line[i]) && line[i] != ' ')
-			return FALSE;
-		++i;
+	// all other matrices - 2 x 2, 3 x 3 etc.
+	if (!factored) {
+		determinant = calculateDeterminate(pMatrix, pMemoryAllocation);
+		if (!*pMemoryAllocation)
+			return determinant;
 	}
+	if (cached)
+		cacheStore(&key, NULL, 0, determinant);
 
+	return determinant;
+}
 
-	// input has been validated - now verify an appropriate amount of numbers has been entered and that none of the numbers are 0.
-	char singleNumStr[50];
-	int singleNumInt;
-	int idx = 0;
-	int totalNumbers = 0;
-	i = 0;
-	while (line[i] != '\0') {
-		while (line[i] != ' ' && line[i] != '\0')
-			singleNumStr[idx++] = line[i++];
-		singleNumStr[idx] = '\0';
-		idx = 0;
-		singleNumInt = atoi(singleNumStr);
-		if (singleNumInt == 0)
-			return FALSE;
-		++totalNumbers;
-		if (line[i] != '\0')
-			++i;
+
+
+/***** Helper functions shared with the other matrix implementation files - declared in MatrixInternal.h *****/
+size_t storageSize(size_t rows, size_t columns, MatrixLayout layout) {
+	size_t maxEntries = SIZE_MAX / sizeof(long double);        // the most entries whose size in bytes fits in a size_t
+
+	// the tiled layout is padded to whole tiles
+	if (layout == MATRIX_TILED) {
+		if (rows > SIZE_MAX - MATRIX_TILE_SIZE || columns > SIZE_MAX - MATRIX_TILE_SIZE)
+			return 0;
+		rows = (rows + MATRIX_TILE_SIZE - 1) / MATRIX_TILE_SIZE * MATRIX_TILE_SIZE;
+		columns = (columns + MATRIX_TILE_SIZE - 1) / MATRIX_TILE_SIZE * MATRIX_TILE_SIZE;
 	}
 
-	return totalNumbers == expectedNumbers;
+	if (rows == 0 || columns == 0 || rows > maxEntries / columns)
+		return 0;
+
+	return rows * columns;
 }
 
 
 
-Boolean inputIsValidUnsignedInt(const char* line, int expectedNumbers) {
-	// user only pressed "enter" or whitespace followed by "enter" - space is the only valid whitespace character
-	int i = 0;
-	while (isspace(line[i])) {
-		if (line[i] != ' ')
-			return FALSE;
-		++i;
+void copyToRowMajor(const Matrix* pMatrix, long double* a) {
+	if (pMatrix->layout == MATRIX_ROW_MAJOR) {
+		memcpy(a, pMatrix->matrix, pMatrix->rows * pMatrix->columns * sizeof(*a));
+		return;
 	}
-	if (line[i] == '\0')
-		return FALSE;
 
-	// validate it's all numbers in the correct format
-	while (line[i] != '\0') {
-		// something other than a digit or space
-		if (!isdigit(line[i]) && line[i] != ' ')
-			return FALSE;
-		++i;
+	for (size_t i = 0; i < pMatrix->rows; ++i) {
+		for (size_t j = 0; j < pMatrix->columns; ++j)
+			a[i * pMatrix->columns + j] = pMatrix->matrix[matrixIndex(pMatrix, i, j)];
+	}
+}
+
+
+
+void copyFromRowMajor(Matrix* pMatrix, const long double* a) {
+	if (pMatrix->layout == MATRIX_ROW_MAJOR) {
+		memcpy(pMatrix->matrix, a, pMatrix->rows * pMatrix->columns * sizeof(*a));
+		return;
+	}
+
+	for (size_t i = 0; i < pMatrix->rows; ++i) {
+		for (size_t j = 0; j < pMatrix->columns; ++j)
+			pMatrix->matrix[matrixIndex(pMatrix, i, j)] = a[i * pMatrix->columns + j];
+	}
+}
+
+
+
+int calcNumLength(long double n) {
+	char numString[NUMBER_STRING_SIZE];
+	return formatFixed(n, numString);
+}
+
+
+
+void updateMaxLength(Matrix* pMatrix) {
+	int maxLength = 1;                                      // max length of the matrix (same as in the matrix structure)
+	int chunkLength;                                        // max length of each chunk to be compared to max length
+	size_t matrixSize = storageSize(pMatrix->rows, pMatrix->columns, pMatrix->layout);
+
+	// a chunk at a time so a mapped matrix is streamed
+	for (size_t chunk = 0; chunk < matrixSize; chunk += STREAM_CHUNK_SIZE) {
+		size_t chunkEnd = (matrixSize - chunk < STREAM_CHUNK_SIZE) ? matrixSize : chunk + STREAM_CHUNK_SIZE;
+		chunkLength = maxLengthOfSpan(pMatrix, chunk, chunkEnd);
+		if (chunkLength > maxLength)
+			maxLength = chunkLength;
+		releaseSpan(pMatrix, chunk, chunkEnd);
+	}
+	pMatrix->maxLength = maxLength;
+}
+
+
+
+void copyStorage(Matrix* pDestination, const Matrix* pSource) {
+	size_t matrixSize = storageSize(pSource->rows, pSource->columns, pSource->layout);
+
+	for (size_t chunk = 0; chunk < matrixSize; chunk += STREAM_CHUNK_SIZE) {
+		size_t chunkEnd = (matrixSize - chunk < STREAM_CHUNK_SIZE) ? matrixSize : chunk + STREAM_CHUNK_SIZE;
+		memcpy(pDestination->matrix + chunk, pSource->matrix + chunk, (chunkEnd - chunk) * sizeof(*pSource->matrix));
+		releaseSpan(pSource, chunk, chunkEnd);
+		releaseSpan(pDestination, chunk, chunkEnd);
 	}
+}
+
+
+
+Status adjustMatrixDimensions(Matrix** ppMatrix, size_t rows, size_t columns) {
+	Matrix* pMatrix = *ppMatrix;
+	MATRIX hNewMatrix;
 
-	// input has been validated - now verify an appropriate amount of numbers has been entered
-	int totalNumbers = 0;
-	i = 0;
-	while (line[i] != '\0') {
-		while (line[i] != ' ' && line[i] != '\0')
-			++i;
-		++totalNumbers;
-		if (line[i] != '\0')
-			++i;
+	// the matrix object doesn't exist
+	if (!pMatrix) {
+		if (!(hNewMatrix = matrix_init(rows, columns)))
+			return FAILURE;
+		*ppMatrix = hNewMatrix;
+	}
+	// the matrix object exists but its dimensions are incorrect
+	else if (pMatrix->rows != rows || pMatrix->columns != columns) {
+		if (!resizeStorage(pMatrix, rows, columns, pMatrix->layout))
+			return FAILURE;
 	}
 
-	return totalNumbers == expectedNumbers;
+	return SUCCESS;
+}
+
+
+
+void multiplyKernel(Boolean transposeA, Boolean transposeB, size_t m, size_t n, size_t k,
+	long double alpha, const long double* a, size_t lda, const long double* b, size_t ldb,
+	long double beta, long double* c, size_t ldc) {
+	// scale c by beta first so the products can be accumulated directly into it
+	for (size_t i = 0; i < m; ++i) {
+		long double* cRow = c + i * ldc;
+		for (size_t j = 0; j < n; ++j)
+			cRow[j] = (beta == 0) ? 0 : beta * cRow[j];
+	}
+	if (alpha == 0 || k == 0)
+		return;
+
+	// the loops are blocked so each block of a, b and c stays in cache while it's being used.
+	// the blocks of k are visited in order so every entry of c accumulates its products in the same order as the textbook loop.
+	for (size_t iBlock = 0; iBlock < m; iBlock += MULTIPLY_BLOCK_SIZE) {
+		size_t iEnd = (iBlock + MULTIPLY_BLOCK_SIZE < m) ? iBlock + MULTIPLY_BLOCK_SIZE : m;
+		for (size_t pBlock = 0; pBlock < k; pBlock += MULTIPLY_BLOCK_SIZE) {
+			size_t pEnd = (pBlock + MULTIPLY_BLOCK_SIZE < k) ? pBlock + MULTIPLY_BLOCK_SIZE : k;
+			for (size_t jBlock = 0; jBlock < n; jBlock += MULTIPLY_BLOCK_SIZE) {
+				size_t jEnd = (jBlock + MULTIPLY_BLOCK_SIZE < n) ? jBlock + MULTIPLY_BLOCK_SIZE : n;
+				for (size_t i = iBlock; i < iEnd; ++i) {
+					long double* cRow = c + i * ldc;
+					// b is not transposed - walk along the rows of b so the innermost loop is contiguous
+					if (!transposeB) {
+						for (size_t p = pBlock; p < pEnd; ++p) {
+							long double aEntry = alpha * (transposeA ? a[p * lda + i] : a[i * lda + p]);
+							const long double* bRow = b + p * ldb;
+							for (size_t j = jBlock; j < jEnd; ++j)
+								cRow[j] += aEntry * bRow[j];
+						}
+					}
+					// b is transposed - each entry is a dot product along a row of b
+					else {
+						for (size_t j = jBlock; j < jEnd; ++j) {
+							const long double* bRow = b + j * ldb;
+							long double sum = 0;
+							for (size_t p = pBlock; p < pEnd; ++p)
+								sum += (transposeA ? a[p * lda + i] : a[i * lda + p]) * bRow[p];
+							cRow[j] += alpha * sum;
+						}
+					}
+				}
+			}
+		}
+	}
 }
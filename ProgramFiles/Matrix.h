@@ -11,15 +11,137 @@
 #define MATRIX_H
 
 
+#include <stdio.h>
+#include <stddef.h>
 #include "Status.h"
 
 
 /***** Global variables, macros, and opaque object handle *****/
 typedef void* MATRIX;                // opaque object handle for matrix objects
-#define OUT_OF_BOUNDS -909090        // error code for going out of bounds of a matrix object's array
+#define MATRIX_TILE_SIZE 64          // rows/columns of each tile in the tiled layout
+#define MATRIX_TASK_MIN_SIZE 512     // smallest matrix factored as a graph of tile tasks on several threads
+#define MATRIX_DEFAULT_ALIGNMENT 64  // alignment of allocations with the default allocator, a cache line
 
-extern const char* operations[];     // the various matrix operations that can be performed
-extern const int operationsSize;
+// The orders the entries of a matrix object can be stored in
+// - MATRIX_ROW_MAJOR: each row is contiguous (the default)
+// - MATRIX_COLUMN_MAJOR: each column is contiguous, i.e. Fortran order
+// - MATRIX_TILED: the matrix is split into MATRIX_TILE_SIZE x MATRIX_TILE_SIZE tiles that are each contiguous and row-major,
+//   stored one row of tiles after another. The last row/column of tiles is padded with zeroes.
+// The result of an operation keeps the layout of the matrix object it's stored in. NULL result handles become row-major.
+typedef enum matrixLayout { MATRIX_ROW_MAJOR, MATRIX_COLUMN_MAJOR, MATRIX_TILED } MatrixLayout;
+
+// The ways a matrix object can be written as text (see matrix_writeText)
+// - MATRIX_TEXT_BOXED: each entry rounded to 6 decimal places in a grid of boxes, as displayed by matrix_print
+// - MATRIX_TEXT_PLAIN: each row on a line with its entries separated by spaces, the format read by matrix_readText
+// - MATRIX_TEXT_CSV/MATRIX_TEXT_TSV: the same with the entries separated by commas/tabs
+typedef enum matrixTextFormat { MATRIX_TEXT_BOXED, MATRIX_TEXT_PLAIN, MATRIX_TEXT_CSV, MATRIX_TEXT_TSV } MatrixTextFormat;
+
+// The ways the entries of a Matrix Market file can be stored (see matrix_writeMatrixMarket)
+// - MATRIX_MARKET_ARRAY: every entry in column-major order
+// - MATRIX_MARKET_COORDINATE: the row, column and value of each nonzero entry
+typedef enum matrixMarketFormat { MATRIX_MARKET_ARRAY, MATRIX_MARKET_COORDINATE } MatrixMarketFormat;
+
+// The element types a matrix object can be saved as in a NumPy .npy file (see matrix_saveNpy)
+// - MATRIX_NPY_FLOAT64: numpy.float64, rounding each entry to a double
+// - MATRIX_NPY_LONG_DOUBLE: numpy.longdouble, the entries exactly as they're stored
+typedef enum matrixNpyType { MATRIX_NPY_FLOAT64, MATRIX_NPY_LONG_DOUBLE } MatrixNpyType;
+
+// Where the storage arrays of large matrices and the threads factoring them are placed on machines with several NUMA
+// nodes (see matrix_setNumaPolicy)
+// - MATRIX_NUMA_OFF: wherever the kernel puts them, usually the node of the thread that first touches each page
+// - MATRIX_NUMA_INTERLEAVE: the pages of each array are spread over the nodes in turn
+// - MATRIX_NUMA_FIRST_TOUCH: each node gets an even share of the rows of each array, zeroed by a thread running on the
+//   node so it's the first to touch its pages, and the tasks of the factorizations run on the node holding their rows
+typedef enum matrixNumaPolicy { MATRIX_NUMA_OFF, MATRIX_NUMA_INTERLEAVE, MATRIX_NUMA_FIRST_TOUCH } MatrixNumaPolicy;
+
+// Counters of the result cache (see matrix_getCacheStats)
+typedef struct matrixCacheStats {
+    unsigned long long hits;         // lookups that found a cached result
+    unsigned long long misses;       // lookups that didn't, so the result was calculated
+    unsigned long long evictions;    // results thrown out to make room for others
+    size_t entries;                  // results cached
+    size_t bytes;                    // bytes they take up
+    size_t capacity;                 // most bytes they may take up, 0 if the cache is off
+} MatrixCacheStats;
+
+// The allocator every allocation of the matrix interface is made by (see matrix_setAllocator)
+// - allocate returns at least bytes bytes, ideally aligned to alignment, else NULL
+// - reallocate resizes memory from allocate from oldBytes to bytes the same as realloc, keeping the first oldBytes
+//   (or bytes if it's smaller) bytes, else returns NULL and leaves it alone. It may be NULL, in which case memory is
+//   moved to a new allocation instead
+// - free frees memory from allocate or reallocate, given its size
+typedef struct matrixAllocator {
+    void* (*allocate)(size_t bytes, size_t alignment, void* context);
+    void* (*reallocate)(void* memory, size_t oldBytes, size_t bytes, size_t alignment, void* context);
+    void (*free)(void* memory, size_t bytes, void* context);
+    size_t alignment;                // alignment of every allocation, a power of two, 0 for MATRIX_DEFAULT_ALIGNMENT
+    void* context;                   // passed to the hooks, i.e. an arena or an account to charge
+} MatrixAllocator;
+
+// The operations the statistics are kept for (see matrix_enableStats)
+typedef enum matrixOperation {
+    MATRIX_OPERATION_MULTIPLY, MATRIX_OPERATION_ADD, MATRIX_OPERATION_SUBTRACT, MATRIX_OPERATION_POWER,
+    MATRIX_OPERATION_TRANSPOSE, MATRIX_OPERATION_DETERMINANT, MATRIX_OPERATION_INVERSE, MATRIX_OPERATION_QR,
+    MATRIX_OPERATION_QR_PIVOTED, MATRIX_OPERATION_LEAST_SQUARES, MATRIX_OPERATION_LEAST_SQUARES_PIVOTED,
+    MATRIX_OPERATION_CHOLESKY, MATRIX_OPERATION_SOLVE, MATRIX_OPERATION_UPDATE_INVERSE, MATRIX_OPERATION_UPDATE_ENTRY,
+    MATRIX_OPERATION_UPDATE_ROW, MATRIX_OPERATION_UPDATE_COLUMN, MATRIX_OPERATION_SAVE, MATRIX_OPERATION_LOAD,
+    MATRIX_OPERATION_SAVE_NPY, MATRIX_OPERATION_LOAD_NPY, MATRIX_OPERATION_READ_TEXT, MATRIX_OPERATION_WRITE_TEXT,
+    MATRIX_OPERATION_READ_MATRIX_MARKET, MATRIX_OPERATION_WRITE_MATRIX_MARKET, MATRIX_OPERATION_LOAD_CSV,
+    MATRIX_OPERATION_SAVE_CSV, MATRIX_OPERATION_MULTIPLY_DISTRIBUTED,
+    MATRIX_OPERATIONS                // number of operations
+} MatrixOperation;
+
+// The hardware and software counters read around each operation while they're on (see matrix_enableCounters)
+// - MATRIX_COUNTER_CACHE_REFERENCES/MATRIX_COUNTER_CACHE_MISSES: accesses to/misses of the last level cache
+// - MATRIX_COUNTER_TLB_MISSES: data TLB misses of loads
+// - MATRIX_COUNTER_PAGE_FAULTS: page faults, i.e. first touches of new memory (a software counter)
+typedef enum matrixCounter {
+    MATRIX_COUNTER_CYCLES, MATRIX_COUNTER_INSTRUCTIONS, MATRIX_COUNTER_CACHE_REFERENCES, MATRIX_COUNTER_CACHE_MISSES,
+    MATRIX_COUNTER_TLB_MISSES, MATRIX_COUNTER_PAGE_FAULTS,
+    MATRIX_COUNTERS                  // number of counters
+} MatrixCounter;
+
+// Statistics of an operation (see matrix_getStats)
+typedef struct matrixOperationStats {
+    unsigned long long calls;
+    double seconds;                  // wall time of all the calls
+    double maxSeconds;               // wall time of the longest call
+    double flops;                    // floating point operations, estimated from the dimensions of each call
+    unsigned long long allocatedBytes;       // memory allocated by all the calls
+    unsigned long long peakScratchBytes;     // most memory one call had allocated at once, including its result
+    unsigned long long countedCalls;         // calls the counters were read for
+    double counters[MATRIX_COUNTERS];        // counts of those calls, 0 for a counter that isn't available
+} MatrixOperationStats;
+
+typedef void* MATRIX_JOB;            // opaque object handle for asynchronous jobs (see matrix_multiplyAsync)
+
+// The states of an asynchronous job (see matrix_jobPoll)
+// - MATRIX_JOB_PENDING/MATRIX_JOB_RUNNING: the job is waiting for a worker thread/being run
+// - MATRIX_JOB_SUCCEEDED/MATRIX_JOB_FAILED: the blocking function of the operation returned SUCCESS/FAILURE
+// - MATRIX_JOB_CANCELLED: the job was cancelled before it started, so its results were never touched
+typedef enum matrixJobState {
+    MATRIX_JOB_PENDING, MATRIX_JOB_RUNNING, MATRIX_JOB_SUCCEEDED, MATRIX_JOB_FAILED, MATRIX_JOB_CANCELLED
+} MatrixJobState;
+
+// Called when a job finishes with its final state and the context it was submitted with (see matrix_multiplyAsync)
+typedef void (*MatrixJobCallback)(MATRIX_JOB hJob, MatrixJobState state, void* pContext);
+
+typedef void* MATRIX_DISTRIBUTED;    // opaque object handle for matrices split over several processes (see matrix_distribute)
+
+// How the processes working on distributed matrices send each other their entries (see matrix_openSharedMemoryTransport)
+// - send sends bytes bytes of data to process to, and receive receives bytes bytes from process from into data, each
+//   blocking until it's done. The bytes one process sends another arrive in order as a stream, so a receive may take
+//   the bytes of several sends or part of one. Both return SUCCESS, else FAILURE if the other process has closed its
+//   transport or can't be reached
+// - close releases the transport (see matrix_closeTransport). It may be NULL
+typedef struct matrixTransport {
+    Status (*send)(int to, const void* data, size_t bytes, void* context);
+    Status (*receive)(int from, void* data, size_t bytes, void* context);
+    void (*close)(void* context);
+    int rank;                        // this process, from 0 to processes - 1
+    int processes;                   // processes connected by the transport
+    void* context;                   // passed to the hooks, i.e. the connections to the other processes
+} MatrixTransport;
 
 
 
@@ -30,88 +152,86 @@ PRECONDITION
   - rows/columns are the desired dimensions of the new matrix and are >= 1.
 POSTCONDITION
   - Returns a handle to a matrix object with the given amount of rows and columns, else NULL for any
-    memory allocation failure.
+    memory allocation failure or if the size of the matrix in bytes doesn't fit in a size_t.
 */
-MATRIX matrix_init(int rows, int columns);
+MATRIX matrix_init(size_t rows, size_t columns);
 
 
 /*
 PRECONDITION
-  - pRows/pColumns are pointers to the integers to store the dimenions.
-  - n dicates what the prompt looks like (described in the POSTCONDITION) and is in range [-1, ...).
-  - operation is a string that will be printed indicating which matrix operation is being performed.
+  - rows/columns are the desired dimensions of the new matrix and are >= 1.
+  - layout is the order the entries will be stored in.
 POSTCONDITION
-  - Prompts the user to enter the dimensions of the matrix. If n == -1, prints 'matrix' in the prompt.
-    If n == 0, prints 'matrices' in the prompt. If n is anything else like 1 for example, it would print
-    "1st" matrix.
-  - Valid input - Stores the desired rows and columns in the variables pointed to by pRows and pColumns
-    and returns SUCCESS.
-  - Invalid input - Stores -1 in the variables pointed to by pRows/pColumns and returns FAILURE.
-  - Valid input is two integers >= 1.
+  - Returns a handle to a matrix object with the given amount of rows and columns and the given layout,
+    else NULL for any memory allocation failure or if the size of the matrix in bytes doesn't fit in a size_t.
 */
-Status matrix_getDimensions(int* pRows, int* pColumns, int n, const char* operation);
+MATRIX matrix_initLayout(size_t rows, size_t columns, MatrixLayout layout);
 
 
 /*
 PRECONDITION
-  - operation is a string that will print indicating whether the function call is for addition or subtraction.
-  - pNumMatrices is a pointer to the integer that the number of matrices will be stored in.
+  - rows/columns are the desired dimensions of the new matrix and are >= 1.
+  - layout is the order the entries are stored in in the array entries.
+  - entries is an array holding all the entries of the matrix in that layout. For MATRIX_TILED, it holds whole
+    padded tiles.
 POSTCONDITION
-  - Prompts the user to enter the number of matrices to be added or subtracted.
-  - Valid input - Stores the desired number of matrices to add/subtract in the integer pointed to by
-    pNumMatrices and returns SUCCESS.
-  - Invalid input - Stores 0 in the variable pointed to by pNumMatrices and returns FAILURE.
-  - Valid input is a single integer >= 2.
+  - Returns a handle to a matrix object with the given layout holding a copy of entries, else NULL for any memory
+    allocation failure. No conversion is done, so column-major data can be used without transposing it.
 */
-Status matrix_getNumMatrices(const char* operation, int* pNumMatrices);
+MATRIX matrix_initFromArray(size_t rows, size_t columns, MatrixLayout layout, const long double* entries);
 
 
 /*
 PRECONDITION
-  - columns1/rows2 are the partial dimensions of two matrices respectively
-    (this is all that is needed to see if the two matrices can be multiplied)
+  - hMatrix is a handle to a valid matrix object.
 POSTCONDITION
-  - Returns TRUE if the two matrices can be multiplied, else FALSE.
-  - In order for them to be capable of multiplying, columns1 must equal rows2 i.e. 2 x 3 and 3 x 4.
+  - Returns the layout of the matrix.
 */
-Boolean matrix_canBeMultipliedD(int columns1, int rows2);
+MatrixLayout matrix_getLayout(MATRIX hMatrix);
 
 
 /*
 PRECONDITION
-  - hMatrix1 and hMatrix2 are handles to valid matrix objects.
+  - hMatrix is a handle to a valid matrix object.
 POSTCONDITION
-  - Returns TRUE if two matrices can be multiplied, else FALSE.
-  - In order for them to be capable of multiplying, the columns of hMatrix1 must equal the rows of hMatrix2
-    i.e. 2 x 3 and 3 x 4.
+  - Returns the number of rows/columns of the matrix.
 */
-Boolean matrix_canBeMultipliedM(MATRIX hMatrix1, MATRIX hMatrix2);
+size_t matrix_getRows(MATRIX hMatrix);
+size_t matrix_getColumns(MATRIX hMatrix);
 
 
 /*
 PRECONDITION
   - hMatrix is a handle to a valid matrix object.
-  - pMemoryAllocation is a pointer to a status to check for memory allocation failure.
+  - layout is the new order the entries should be stored in.
 POSTCONDITION
-  - Fills up the rows of the matrix by prompting the user for input.
-  - Returns SUCCESS, else FAILURE for any invalid input or memory allocation failure.
-  - The status pointed to by pMemoryAllocationFailure is used to differentiate between the two situations.
-    If it is input failure, the variable pointed to by pMemoryAllocationFailure is set to SUCCESS.
-    If it is memory allocation failure, it is set to FAILURE.
+  - Converts the storage of the matrix to the given layout. Nothing is done if it's already in that layout.
+  - Returns SUCCESS, else FAILURE for any memory allocation failure (the matrix is left unchanged).
 */
-Status matrix_fillInput(MATRIX hMatrix, Status* pMemoryAllocation);
+Status matrix_setLayout(MATRIX hMatrix, MatrixLayout layout);
+
 
 
 /*
 PRECONDITION
-  - hMatrix is a handle to a valid matrix object.
-  - matrixNumber indicates the matrix for which numbers are being inputted (for example, the 4th matrix in a series
-    of 5 matrices being added). It is in range [0, ...).
+  - columns1/rows2 are the partial dimensions of two matrices respectively
+    (this is all that is needed to see if the two matrices can be multiplied)
 POSTCONDITION
-  - Prompts the user to enter values for the matrix based on the dimensions of the matrix.
-  - If matrixNumber is 0, it is ignored. If it is 1, 2... it will print "1st" matrix, "2nd" matrix etc.
+  - Returns TRUE if the two matrices can be multiplied, else FALSE.
+  - In order for them to be capable of multiplying, columns1 must equal rows2 i.e. 2 x 3 and 3 x 4.
 */
-void matrix_fillPrompt(MATRIX hMatrix, int matrixNumber);
+Boolean matrix_canBeMultipliedD(size_t columns1, size_t rows2);
+
+
+/*
+PRECONDITION
+  - hMatrix1 and hMatrix2 are handles to valid matrix objects.
+POSTCONDITION
+  - Returns TRUE if two matrices can be multiplied, else FALSE.
+  - In order for them to be capable of multiplying, the columns of hMatrix1 must equal the rows of hMatrix2
+    i.e. 2 x 3 and 3 x 4.
+*/
+Boolean matrix_canBeMultipliedM(MATRIX hMatrix1, MATRIX hMatrix2);
 
 
 /*
@@ -120,6 +240,8 @@ PRECONDITION
   - phResult is a pointer to a handle to a valid matrix object or a NULL handle.
 POSTCONDITION
   - The resulting matrix from the multiplication is stored in the handle pointed to by phResult.
+  - The matrices can have any combination of layouts. The multiplication is done one tile at a time directly on each
+    matrix's storage, so no conversions are done.
   - Returns SUCCESS, else FAILURE for any memory allocation failure.
 */
 Status matrix_multiply(MATRIX hMatrix1, MATRIX hMatrix2, MATRIX* phResult);
@@ -211,7 +333,7 @@ Boolean matrix_canBeAdded(MATRIX hMatrix1, MATRIX hMatrix2);
 PRECONDITION
   - hMatrix1 is a handle to a valid matrix object.
 POSTCONDITION
-  - Prints out the matrix to stdout.
+  - Prints out the matrix to stdout in the boxed format (see matrix_writeText).
 */
 void matrix_print(MATRIX hMatrix);
 
@@ -223,9 +345,9 @@ PRECONDITION
   - pOutOfBounds is a pointer to a Boolean to check for out of bounds in the array.
 POSTCONDITION
   - In bounds - Returns the entry stored at the given row/column and sets the Boolean pointed to by pOutOfBounds to FALSE.
-  - Out of bounds - Returns OUT_OF_BOUNDS and sets the variable pointed to by pOutOfBounds to TRUE.
+  - Out of bounds - Returns 0 and sets the variable pointed to by pOutOfBounds to TRUE.
 */
-long double matrix_getEntry(MATRIX hMatrix, int row, int column, Boolean* pOutOfBounds);
+long double matrix_getEntry(MATRIX hMatrix, size_t row, size_t column, Boolean* pOutOfBounds);
 
 
 /*
@@ -237,7 +359,7 @@ POSTCONDITION
   - In bounds - sets the entry stored at the given row/column and returns SUCCESS.
   - Out of bounds - does nothing with the entry and returns FAILURE.
 */
-Status matrix_setEntry(MATRIX hMatrix, long double newEntry, int row, int column);
+Status matrix_setEntry(MATRIX hMatrix, long double newEntry, size_t row, size_t column);
 
 
 /*
@@ -245,7 +367,7 @@ PRECONDITION
   - hMatrix is a handle to a valid matrix object.
   - phResult is a pointer to a handle to a valid matrix object or a NULL handle.
 POSTCONDITION
-  - Stores a deep copy of hMatrix in the handle pointed to by phResult and returns SUCCESS.
+  - Stores a deep copy of hMatrix (including its layout) in the handle pointed to by phResult and returns SUCCESS.
   - Returns FAILURE for any memory allocation failure.
 */
 Status matrix_assignment(MATRIX hMatrix, MATRIX* phResult);
@@ -261,4 +383,867 @@ POSTCONDITION
 void matrix_destroy(MATRIX* phMatrix);
 
 
+
+
+/***** Functions defined in Factorization.c *****/
+/*
+PRECONDITION
+  - hMatrix is a handle to a valid m x n matrix object.
+  - phQ/phR are pointers to handles to valid matrix objects or NULL handles.
+POSTCONDITION
+  - Computes the QR factorization hMatrix = Q * R with blocked Householder reflections.
+    With k = min(m, n), Q is m x k with orthonormal columns and R is k x n upper triangular.
+  - Stores Q in the handle pointed to by phQ and R in the handle pointed to by phR.
+  - Returns SUCCESS, else FAILURE for any memory allocation failure.
+*/
+Status matrix_qr(MATRIX hMatrix, MATRIX* phQ, MATRIX* phR);
+
+
+/*
+PRECONDITION
+  - hMatrix is a handle to a valid m x n matrix object.
+  - phQ/phR are pointers to handles to valid matrix objects or NULL handles.
+  - permutation is an array of n size_t.
+  - pRank is a pointer to a size_t.
+POSTCONDITION
+  - Computes the QR factorization with column pivoting hMatrix * P = Q * R. Q and R are stored the same way
+    as in matrix_qr and the magnitudes of the diagonal entries of R are non-increasing.
+  - Column j of hMatrix * P is column permutation[j] of hMatrix.
+  - Stores the numerical rank of hMatrix in the size_t pointed to by pRank.
+  - Returns SUCCESS, else FAILURE for any memory allocation failure.
+*/
+Status matrix_qrPivoted(MATRIX hMatrix, MATRIX* phQ, MATRIX* phR, size_t* permutation, size_t* pRank);
+
+
+/*
+PRECONDITION
+  - hA is a handle to a valid m x n matrix object with m >= n.
+  - hB is a handle to a valid m x p matrix object.
+  - phX is a pointer to a handle to a valid matrix object or a NULL handle.
+POSTCONDITION
+  - Stores the n x p matrix X that minimizes the norm of A * X - B in the handle pointed to by phX.
+    If m == n, this is the solution of A * X = B.
+  - Returns SUCCESS, else FAILURE for any memory allocation failure or if A does not have full column rank.
+    Use matrix_leastSquaresPivoted for matrices that could be rank deficient.
+*/
+Status matrix_leastSquares(MATRIX hA, MATRIX hB, MATRIX* phX);
+
+
+/*
+PRECONDITION
+  - hA is a handle to a valid m x n matrix object. It can have any dimensions and any rank.
+  - hB is a handle to a valid m x p matrix object.
+  - phX is a pointer to a handle to a valid matrix object or a NULL handle.
+  - pRank is a pointer to a size_t.
+POSTCONDITION
+  - Uses the column pivoted QR factorization to store a basic n x p least squares solution X in the handle pointed
+    to by phX. The unknowns for the columns that are not part of the numerical rank are set to 0.
+  - Stores the numerical rank of hA in the size_t pointed to by pRank.
+  - Returns SUCCESS, else FAILURE for any memory allocation failure.
+*/
+Status matrix_leastSquaresPivoted(MATRIX hA, MATRIX hB, MATRIX* phX, size_t* pRank);
+
+
+
+/*
+PRECONDITION
+  - hMatrix is a handle to a valid square matrix object.
+  - phL is a pointer to a handle to a valid matrix object or a NULL handle.
+  - pIsPositiveDefinite is a pointer to a Boolean to indicate if the matrix is symmetric positive definite.
+POSTCONDITION
+  - Symmetric positive definite matrix - Stores the lower triangular L of the blocked Cholesky factorization
+    hMatrix = L * L^T in the handle pointed to by phL and sets the Boolean pointed to by pIsPositiveDefinite to TRUE.
+    Returns SUCCESS.
+  - Not symmetric positive definite - Sets the Boolean pointed to by pIsPositiveDefinite to FALSE. Returns FAILURE.
+  - Memory allocation failure - Sets the Boolean pointed to by pIsPositiveDefinite to TRUE. Returns FAILURE.
+*/
+Status matrix_cholesky(MATRIX hMatrix, MATRIX* phL, Boolean* pIsPositiveDefinite);
+
+
+/*
+PRECONDITION
+  - hA is a handle to a valid n x n matrix object.
+  - hB is a handle to a valid n x p matrix object.
+  - phX is a pointer to a handle to a valid matrix object or a NULL handle.
+  - pMatrixIsVertible is a pointer to a Boolean to indicate if hA is vertible or not.
+POSTCONDITION
+  - Solves A * X = B with the Cholesky factorization if A is symmetric positive definite, else with the LU factorization
+    with partial pivoting.
+  - Vertible Matrix - Stores X in the handle pointed to by phX and sets the Boolean pointed to by pMatrixIsVertible to TRUE.
+    Returns SUCCESS.
+  - Invertible Matrix - Sets the Boolean pointed to by pMatrixIsVertible to FALSE. Returns FAILURE.
+  - Memory allocation failure - Sets the Boolean pointed to by pMatrixIsVertible to TRUE. Returns FAILURE.
+*/
+Status matrix_solve(MATRIX hA, MATRIX hB, MATRIX* phX, Boolean* pMatrixIsVertible);
+
+
+
+
+
+/***** Functions defined in Storage.c *****/
+/*
+PRECONDITION
+  - path is the name of the file that will hold the entries of the matrix.
+  - rows/columns are the desired dimensions of the new matrix and are >= 1.
+  - layout is the order the entries are stored in in the file.
+POSTCONDITION
+  - Returns a handle to a matrix object whose entries are stored in the file instead of memory, else NULL if the file
+    couldn't be opened or mapped or for any memory allocation failure.
+  - A file that doesn't exist or is empty is extended to hold a zero matrix. A file that is already the size of the
+    matrix's storage is reused, so its entries are the entries of the matrix. A file of any other size is rejected.
+  - The handle works with every other matrix function. matrix_multiply, matrix_transpose, matrix_add and
+    matrix_subtract stream mapped operands and results a panel of tiles at a time, so matrices larger than physical
+    memory can be used (the tiled layout streams best). Storing a result in a mapped handle writes it to the file.
+  - Mapped matrices keep the layout they're created with: matrix_setLayout fails for them.
+  - Changes reach the file on their own, matrix_sync waits for them and matrix_destroy unmaps and closes the file.
+*/
+MATRIX matrix_initMapped(const char* path, size_t rows, size_t columns, MatrixLayout layout);
+
+
+/*
+PRECONDITION
+  - fd is a file descriptor open for reading and writing, i.e. of a memfd_create or shm_open segment.
+  - rows/columns are the desired dimensions of the new matrix and are >= 1.
+  - layout is the order the entries are stored in in the file, the same as the storage array (see matrix_initFromArray).
+POSTCONDITION
+  - Returns a handle to a mapped matrix object whose entries are stored in the file of fd, the same as
+    matrix_initMapped, else NULL without closing fd. The matrix takes over fd and closes it when it's destroyed.
+  - The file is mapped shared, so processes mapping the same segment see the same entries without copying them.
+*/
+MATRIX matrix_initFromFd(int fd, size_t rows, size_t columns, MatrixLayout layout);
+
+
+/*
+PRECONDITION
+  - hMatrix is a handle to a valid matrix object.
+POSTCONDITION
+  - Returns TRUE if the entries of the matrix are stored in a file (see matrix_initMapped and matrix_initFromFd), else
+    FALSE.
+*/
+Boolean matrix_isMapped(MATRIX hMatrix);
+
+
+/*
+PRECONDITION
+  - hMatrix is a handle to a valid matrix object.
+POSTCONDITION
+  - Writes any changes to the entries of a mapped matrix to its file and waits for them to complete.
+  - Returns SUCCESS (nothing is done for a matrix that isn't mapped), else FAILURE if the file couldn't be written.
+*/
+Status matrix_sync(MATRIX hMatrix);
+
+
+
+
+/***** Functions defined in MatrixFile.c *****/
+/*
+PRECONDITION
+  - hMatrix is a handle to a valid matrix object.
+  - path is the name of the file to save the matrix to.
+POSTCONDITION
+  - Saves the matrix in the native binary format: a header with the dimensions, element type, layout and a checksum,
+    followed by the storage array exactly as it is in memory (no conversion), aligned to a page.
+  - The file is written under a temporary name and renamed to path once it's complete, so an existing file is only
+    replaced by a complete one (this includes the file the matrix was loaded from).
+  - Returns SUCCESS, else FAILURE if the file couldn't be written or for any memory allocation failure.
+*/
+Status matrix_save(MATRIX hMatrix, const char* path);
+
+
+/*
+PRECONDITION
+  - path is the name of a file saved by matrix_save.
+  - verifyChecksum is TRUE if the entries should be checked against the checksum in the header.
+POSTCONDITION
+  - Returns a handle to a matrix object whose storage array is the file mapped into memory, else NULL if the file
+    couldn't be opened or mapped, isn't a matrix file saved on a machine with the same long double format, fails the
+    checksum or for any memory allocation failure.
+  - Nothing is parsed or copied: entries are read in from the file as they're used. Verifying the checksum reads the
+    whole file once up front.
+  - The mapping is private, so changes to the matrix are never written back to the file (use matrix_save, or
+    matrix_initMapped for a matrix that lives in a file). The matrix keeps the file's layout.
+*/
+MATRIX matrix_load(const char* path, Boolean verifyChecksum);
+
+
+/*
+PRECONDITION
+  - hMatrix is a handle to a valid matrix object.
+  - path is the name of the file to save the matrix to.
+  - type is the element type of the array.
+POSTCONDITION
+  - Saves the matrix as a 2-D NumPy .npy file that numpy.load reads as a rows x columns array. Column-major matrices
+    are saved in Fortran order and everything else in C order, so the storage array is written without reordering.
+  - The file is written under a temporary name and renamed to path once it's complete, the same as matrix_save.
+  - Returns SUCCESS, else FAILURE if the file couldn't be written or for any memory allocation failure.
+*/
+Status matrix_saveNpy(MATRIX hMatrix, const char* path, MatrixNpyType type);
+
+
+/*
+PRECONDITION
+  - path is the name of a NumPy .npy file.
+POSTCONDITION
+  - Returns a handle to a matrix object holding the array in the file, else NULL if the file couldn't be read, isn't a
+    .npy file of float32, float64 or numpy.longdouble in this machine's byte order with at most 2 dimensions and no
+    dimension of size 0, or for any memory allocation failure. A 1-D array becomes a column and a 0-D array a 1 x 1 matrix.
+  - Arrays in C order become row-major matrix objects and arrays in Fortran order column-major ones.
+  - numpy.longdouble arrays are privately mapped without copying, the same as matrix_load. Other arrays are
+    converted to long doubles a chunk at a time as they're read.
+*/
+MATRIX matrix_loadNpy(const char* path);
+
+
+
+
+/***** Functions defined in MatrixText.c *****/
+/*
+PRECONDITION
+  - hMatrix is a handle to a valid matrix object.
+  - fp is a file open for reading.
+  - pMemoryAllocation is a pointer to a status to check for memory allocation failure.
+POSTCONDITION
+  - Reads the entries of the matrix from the file, one line per row with the entries separated by spaces or tabs.
+    Entries are decimal numbers such as -12, 3.5, .25 or 6.02e23, and rows can be any length.
+  - The text is parsed in a single pass straight into a new storage array, which replaces the old one once every row
+    has been read. The file is read a line at a time, so nothing after the last row is taken from it.
+  - Returns SUCCESS, else FAILURE for any invalid input or memory allocation failure. On invalid input the rest of the
+    offending line is skipped and the matrix is left unchanged.
+  - The status pointed to by pMemoryAllocation is set to FAILURE for memory allocation failure, else SUCCESS.
+*/
+Status matrix_readText(MATRIX hMatrix, FILE* fp, Status* pMemoryAllocation);
+
+
+/*
+PRECONDITION
+  - hMatrix is a handle to a valid matrix object.
+  - text is an array of length characters. It doesn't have to be NUL terminated.
+  - pMemoryAllocation is a pointer to a status to check for memory allocation failure.
+POSTCONDITION
+  - Same as matrix_readText for text that's already in memory. Any text after the last row is ignored.
+*/
+Status matrix_readTextBuffer(MATRIX hMatrix, const char* text, size_t length, Status* pMemoryAllocation);
+
+
+/*
+PRECONDITION
+  - fp is a file open for reading.
+POSTCONDITION
+  - Reads a matrix in the format of matrix_readText to the end of the file, working out its dimensions from the text:
+    every line that isn't blank is a row and every row must have the same number of entries.
+  - Returns a handle to a new row-major matrix object, else NULL for any invalid input, an empty file or any memory
+    allocation failure.
+*/
+MATRIX matrix_initFromText(FILE* fp);
+
+
+/*
+PRECONDITION
+  - text is an array of length characters. It doesn't have to be NUL terminated.
+POSTCONDITION
+  - Same as matrix_initFromText for text that's already in memory.
+*/
+MATRIX matrix_initFromTextBuffer(const char* text, size_t length);
+
+
+/*
+PRECONDITION
+  - hMatrix is a handle to a valid matrix object.
+  - fp is a file open for writing.
+  - format is the way the matrix is written.
+POSTCONDITION
+  - Writes the matrix in the given format. Except for MATRIX_TEXT_BOXED, each entry is written with the fewest digits
+    that read back as the same long double, i.e. 0.1 rather than 0.100000000000000000001.
+  - The text is built in a large buffer and handed to the file a block at a time.
+  - Returns SUCCESS, else FAILURE if the file couldn't be written.
+*/
+Status matrix_writeText(MATRIX hMatrix, FILE* fp, MatrixTextFormat format);
+
+
+
+
+/***** Functions defined in MatrixMarket.c *****/
+/*
+PRECONDITION
+  - fp is a file open for reading, positioned at the start of a Matrix Market (.mtx) file.
+POSTCONDITION
+  - Reads a real, integer or pattern matrix in the array or coordinate format with general, symmetric or skew-symmetric
+    symmetry. Complex and hermitian matrices aren't supported.
+  - The file is streamed straight into the matrix: each entry is stored as soon as it's read, without holding the file
+    or a list of the entries in memory. Array files become column-major matrix objects, the order their values are in,
+    and coordinate files become row-major matrix objects filled with zeroes except for the entries in the file.
+  - Entries of a coordinate file given more than once are added together, the stored triangle of symmetric and
+    skew-symmetric files is mirrored and every entry of a pattern file is 1.
+  - Returns a handle to a new matrix object, else NULL for any invalid input (including indices out of bounds and a
+    number of entries that doesn't match the size line) or any memory allocation failure.
+*/
+MATRIX matrix_initFromMatrixMarket(FILE* fp);
+
+
+/*
+PRECONDITION
+  - hMatrix is a handle to a valid matrix object.
+  - fp is a file open for writing.
+  - format is the way the entries are stored.
+  - symmetric is TRUE if only the lower triangle should be written, with symmetric in the banner.
+POSTCONDITION
+  - Writes the matrix as a real Matrix Market file, each value with the fewest digits that read back as the same
+    long double. The coordinate format only writes the nonzero entries.
+  - Returns SUCCESS, else FAILURE if the file couldn't be written or symmetric is TRUE and the matrix isn't square and
+    equal to its transpose (nothing is written).
+*/
+Status matrix_writeMatrixMarket(MATRIX hMatrix, FILE* fp, MatrixMarketFormat format, Boolean symmetric);
+
+
+
+
+/***** Functions defined in MatrixCsv.c *****/
+/*
+PRECONDITION
+  - path is the name of a CSV file: one row per line with the entries separated by commas (blanks around them are
+    ignored). Blank lines and lines starting with '#' are skipped.
+  - threads is the number of threads to parse the file with, <= 0 for one per processor.
+POSTCONDITION
+  - Returns a handle to a new row-major matrix object holding the file, else NULL if it couldn't be read, has no rows,
+    has rows of different lengths or an entry that isn't a number, or for any memory allocation failure.
+  - The file is mapped and split into chunks of whole lines that are parsed at the same time, each straight into its
+    own rows of the storage array. Small files use fewer threads.
+*/
+MATRIX matrix_loadCsv(const char* path, int threads);
+
+
+/*
+PRECONDITION
+  - hMatrix is a handle to a valid matrix object.
+  - path is the name of the file to save the matrix to.
+  - threads is the number of threads to format the entries with, <= 0 for one per processor.
+POSTCONDITION
+  - Writes the matrix in the format of matrix_writeText's MATRIX_TEXT_CSV, formatting blocks of rows at the same time
+    and writing them in order.
+  - Returns SUCCESS, else FAILURE if the file couldn't be written or for any memory allocation failure.
+*/
+Status matrix_saveCsv(MATRIX hMatrix, const char* path, int threads);
+
+
+
+
+
+/***** Functions defined in MatrixJob.c *****/
+/*
+PRECONDITION
+  - The operands, result handles and other pointers are the same as for the blocking function of the operation
+    (matrix_multiply, matrix_add, ...) and stay valid until the job finishes. An operand can be used by several jobs
+    at once, but it can't be changed or destroyed, or be the result of another job, until they finish.
+  - callback is the function to call when the job finishes, else NULL.
+  - pContext is passed to the callback.
+POSTCONDITION
+  - Queues the operation to be run by a worker thread and returns a handle to the job right away, else NULL for any
+    memory allocation failure. The worker threads (one per processor) are started by the first job, jobs are started
+    oldest first and independent jobs are run at the same time. If no worker can be started, the job is run before
+    returning.
+  - The job runs the blocking function, so the results are the same. Its Status is the state of the job.
+  - The callback is called on the worker thread with MATRIX_JOB_SUCCEEDED or MATRIX_JOB_FAILED once the results are
+    stored, or on the thread that cancels the job with MATRIX_JOB_CANCELLED. It may submit jobs and poll, but must not
+    wait for or destroy its own job, which doesn't reach its final state until the callback returns. An event loop can
+    be woken up from it, i.e. by writing to an eventfd or pipe.
+  - The handle has to be destroyed by matrix_jobDestroy.
+*/
+MATRIX_JOB matrix_multiplyAsync(MATRIX hMatrix1, MATRIX hMatrix2, MATRIX* phResult, MatrixJobCallback callback, void* pContext);
+MATRIX_JOB matrix_addAsync(MATRIX* hMatrices, int hMatricesSize, MATRIX* phResult, MatrixJobCallback callback, void* pContext);
+MATRIX_JOB matrix_subtractAsync(MATRIX* hMatrices, int hMatricesSize, MATRIX* phResult, MatrixJobCallback callback, void* pContext);
+MATRIX_JOB matrix_powerAsync(MATRIX hMatrix, int power, MATRIX* phResult, MatrixJobCallback callback, void* pContext);
+MATRIX_JOB matrix_transposeAsync(MATRIX hMatrix, MATRIX* phResult, MatrixJobCallback callback, void* pContext);
+MATRIX_JOB matrix_determinantAsync(MATRIX hMatrix, long double* pDeterminant, MatrixJobCallback callback, void* pContext);
+MATRIX_JOB matrix_inverseAsync(MATRIX hMatrix, MATRIX* phResult, Boolean* pMatrixIsVertible, MatrixJobCallback callback,
+    void* pContext);
+MATRIX_JOB matrix_solveAsync(MATRIX hA, MATRIX hB, MATRIX* phX, Boolean* pMatrixIsVertible, MatrixJobCallback callback,
+    void* pContext);
+MATRIX_JOB matrix_leastSquaresAsync(MATRIX hA, MATRIX hB, MATRIX* phX, MatrixJobCallback callback, void* pContext);
+MATRIX_JOB matrix_choleskyAsync(MATRIX hMatrix, MATRIX* phL, Boolean* pIsPositiveDefinite, MatrixJobCallback callback,
+    void* pContext);
+
+
+/*
+PRECONDITION
+  - hJob is a handle to a valid job.
+POSTCONDITION
+  - Returns the state of the job without waiting.
+*/
+MatrixJobState matrix_jobPoll(MATRIX_JOB hJob);
+
+
+/*
+PRECONDITION
+  - hJob is a handle to a valid job.
+POSTCONDITION
+  - Waits for the job to finish (including its callback) and returns its final state.
+*/
+MatrixJobState matrix_jobWait(MATRIX_JOB hJob);
+
+
+/*
+PRECONDITION
+  - hJob is a handle to a valid job.
+POSTCONDITION
+  - Returns SUCCESS if the job was cancelled before it started (its callback is called before returning), else FAILURE
+    if it's running or finished. A running job can't be stopped partway.
+*/
+Status matrix_jobCancel(MATRIX_JOB hJob);
+
+
+/*
+PRECONDITION
+  - phJob is a pointer to a handle to a valid job.
+POSTCONDITION
+  - Cancels the job if it hasn't started, else waits for it to finish, then frees it and sets the handle to NULL.
+*/
+void matrix_jobDestroy(MATRIX_JOB* phJob);
+
+
+
+
+
+/***** Functions defined in MatrixCache.c *****/
+/*
+PRECONDITION
+  - bytes is the most memory the result cache may use, 0 to turn it off (the default).
+POSTCONDITION
+  - Sets the capacity of the cache, evicting the least recently used results that no longer fit.
+  - While the cache is on, matrix_determinant, matrix_inverse and matrix_power reuse the results, and matrix_solve the
+    factorization of its coefficient matrix, of earlier calls on a matrix with the same dimensions, layout and entries.
+    Results are found by a 128-bit hash of the entries, so changing a matrix in any way (matrix_setEntry, storing a
+    result in it, writing its file) means its old results are never used for it again. Matrices with fewer than 64
+    entries aren't cached.
+  - Each lookup hashes every entry of the operand once.
+*/
+void matrix_setCacheCapacity(size_t bytes);
+
+
+/*
+PRECONDITION
+  - none.
+POSTCONDITION
+  - Throws out every cached result. The counters are kept.
+*/
+void matrix_clearCache(void);
+
+
+/*
+PRECONDITION
+  - pStats is a pointer to the variable that receives the counters.
+POSTCONDITION
+  - Stores the counters of the cache since the program started.
+*/
+void matrix_getCacheStats(MatrixCacheStats* pStats);
+
+
+
+
+
+/***** Functions defined in MatrixUpdate.c *****/
+/*
+PRECONDITION
+  - hMatrix is a handle to a valid matrix object A that is a square matrix (i.e. dimensions are n x n).
+  - hU/hV are handles to valid n x k matrix objects U and V (k >= 1, usually much smaller than n).
+  - hInverse is a handle to a valid n x n matrix object holding the inverse of A, i.e. from matrix_inverse.
+  - pDeterminant is a pointer to the determinant of A, or NULL if it isn't being kept up to date.
+  - pMatrixIsVertible is a pointer to a Boolean to indicate if the updated matrix is vertible or not.
+POSTCONDITION
+  - Adds U * V^T to A and updates the inverse with the Sherman-Morrison-Woodbury formula and the determinant with the
+    matrix determinant lemma in O(n^2 k) time. If the update would be inaccurate (the matrix is nearly singular or
+    rounding errors of earlier updates have built up in the inverse) they're recalculated from A instead.
+  - Vertible Matrix - Sets the Boolean pointed to by pMatrixIsVertible to TRUE. Returns SUCCESS.
+  - Invertible Matrix - A is updated and the determinant is set to 0, but the inverse is left as it was, so it has to
+    be recalculated once A is vertible again. Sets the Boolean pointed to by pMatrixIsVertible to FALSE. Returns FAILURE.
+  - Memory allocation failure - Sets the Boolean pointed to by pMatrixIsVertible to TRUE. Returns FAILURE. A may have
+    been updated without the inverse and determinant.
+*/
+Status matrix_updateInverse(MATRIX hMatrix, MATRIX hU, MATRIX hV, MATRIX hInverse, long double* pDeterminant,
+    Boolean* pMatrixIsVertible);
+
+
+/*
+PRECONDITION
+  - hMatrix/hInverse/pDeterminant/pMatrixIsVertible are the same as for matrix_updateInverse.
+  - row/column are the indices of an entry of the matrix.
+POSTCONDITION
+  - Same as matrix_setEntry followed by a rank one matrix_updateInverse, in O(n^2) time. The entry is set exactly.
+  - Out of bounds - Nothing is changed. Sets the Boolean pointed to by pMatrixIsVertible to TRUE. Returns FAILURE.
+*/
+Status matrix_updateEntry(MATRIX hMatrix, long double newEntry, size_t row, size_t column, MATRIX hInverse,
+    long double* pDeterminant, Boolean* pMatrixIsVertible);
+
+
+/*
+PRECONDITION
+  - hMatrix/hInverse/pDeterminant/pMatrixIsVertible are the same as for matrix_updateInverse.
+  - hRow is a handle to a valid 1 x n matrix object holding the new entries of the row (hColumn n x 1 for the column).
+POSTCONDITION
+  - Replaces the row (column) of the matrix and updates its inverse and determinant the same as matrix_updateEntry.
+*/
+Status matrix_updateRow(MATRIX hMatrix, MATRIX hRow, size_t row, MATRIX hInverse, long double* pDeterminant,
+    Boolean* pMatrixIsVertible);
+Status matrix_updateColumn(MATRIX hMatrix, MATRIX hColumn, size_t column, MATRIX hInverse, long double* pDeterminant,
+    Boolean* pMatrixIsVertible);
+
+
+
+
+/***** Functions defined in MatrixStats.c *****/
+/*
+PRECONDITION
+  - enabled is TRUE to keep statistics of the operations, FALSE to stop.
+POSTCONDITION
+  - Turns the statistics on or off. They're off unless the environment variable MATRIX_STATS is set to anything but
+    "" or "0", which also writes them out when the program exits: to stderr for "1", else to the file it names.
+  - While they're on, every call of an operation listed in MatrixOperation adds its wall time, floating point
+    operations and memory allocations to the statistics of the operation. Operations called by other operations
+    (i.e. the multiplications of matrix_power) are part of the outer operation. Counting is per thread, so the
+    helper threads of matrix_loadCsv and matrix_saveCsv aren't included. While they're off an operation only checks
+    that they're off.
+*/
+void matrix_enableStats(Boolean enabled);
+
+
+/*
+PRECONDITION
+  - enabled is TRUE to read the counters around the operations, FALSE to stop.
+POSTCONDITION
+  - Turns the counters (see MatrixCounter) on or off, turning the statistics on with them. They're off unless the
+    environment variable MATRIX_COUNTERS is set to anything but "" or "0".
+  - While they're on, the outermost measured call of an operation (see matrix_enableStats) also adds the counts of
+    the thread it runs on to the statistics of the operation. The counters are opened with perf_event_open on each
+    thread the first time it needs them and only count user space, scaled up if the kernel had to share them between
+    events. Counters the processor, kernel or its perf_event_paranoid setting don't allow are left out.
+  - Returns SUCCESS if the cycle and instruction counters could be opened on this thread, else FAILURE with the
+    statistics kept without them (the other counters are still read if they're available).
+*/
+Status matrix_enableCounters(Boolean enabled);
+
+
+/*
+PRECONDITION
+  - counter is a counter.
+POSTCONDITION
+  - Returns TRUE if the counter could be opened on this thread, else FALSE. Counters are only opened once they're on.
+*/
+Boolean matrix_counterIsAvailable(MatrixCounter counter);
+
+
+/*
+PRECONDITION
+  - counter is a counter.
+POSTCONDITION
+  - Returns the name of the counter, i.e. "cycles" or "cacheMisses".
+*/
+const char* matrix_getCounterName(MatrixCounter counter);
+
+
+/*
+PRECONDITION
+  - operation is an operation and pStats is a pointer to the variable that receives its statistics.
+POSTCONDITION
+  - Stores the statistics of the operation since the program started or they were last reset.
+*/
+void matrix_getStats(MatrixOperation operation, MatrixOperationStats* pStats);
+
+
+/*
+PRECONDITION
+  - none.
+POSTCONDITION
+  - Sets the statistics of every operation to 0.
+*/
+void matrix_resetStats(void);
+
+
+/*
+PRECONDITION
+  - operation is an operation.
+POSTCONDITION
+  - Returns the name of the operation, i.e. "multiply" or "leastSquares".
+*/
+const char* matrix_getOperationName(MatrixOperation operation);
+
+
+/*
+PRECONDITION
+  - fp is a file open for writing.
+POSTCONDITION
+  - Writes a table of the statistics of the operations that have been called, followed by one of the counters per
+    call (instructions per cycle, floating point operations per cycle, cache miss rate, ...) if any were read.
+  - Returns SUCCESS, else FAILURE if writing to the file failed.
+*/
+Status matrix_writeStats(FILE* fp);
+
+
+/*
+PRECONDITION
+  - none.
+POSTCONDITION
+  - Returns TRUE if the statistics are on, else FALSE. Setting MATRIX_STATS to a file that can't be opened for
+    writing leaves them off.
+*/
+Boolean matrix_statsAreEnabled(void);
+
+
+
+
+
+/***** Functions defined in MatrixMemory.c *****/
+/*
+PRECONDITION
+  - pAllocator is a pointer to an allocator whose hooks are safe to call from any thread, or NULL for the default.
+POSTCONDITION
+  - Makes every allocation of the matrix interface from now on (the storage arrays of matrix objects, results,
+    scratch space of the operations, the result cache, jobs, ...) with a copy of the allocator. Memory allocated
+    earlier is still freed by the allocator that allocated it. Storage arrays mapped from files don't use it.
+  - Allocations are aligned to the alignment of the allocator, at least that of max_align_t. The default allocator
+    uses malloc, calloc, realloc and free, aligning to MATRIX_DEFAULT_ALIGNMENT.
+  - Returns SUCCESS, else FAILURE if the allocator is invalid (a missing hook or an alignment that isn't a power of
+    two) or memory allocation failed, in which case the allocator isn't changed.
+*/
+Status matrix_setAllocator(const MatrixAllocator* pAllocator);
+
+
+/*
+PRECONDITION
+  - pAllocator is a pointer to the variable that receives the allocator.
+POSTCONDITION
+  - Stores the allocator being used, with its alignment filled in.
+*/
+void matrix_getAllocator(MatrixAllocator* pAllocator);
+
+
+
+
+/***** Functions defined in MatrixTrace.c *****/
+/*
+PRECONDITION
+  - path is the path of the file to write the trace to.
+POSTCONDITION
+  - Starts tracing the operations listed in MatrixOperation and the main phases of the longer ones (i.e. the panel
+    and update steps of the LU, QR and Cholesky factorizations, allocating storage arrays and matrix_print), with
+    the thread that ran them and the dimensions of their matrices.
+    Tracing is also started by setting the environment variable MATRIX_TRACE to a path, which writes the trace there
+    when the program exits.
+  - Returns SUCCESS, else FAILURE if a trace has already been started or the file couldn't be opened.
+*/
+Status matrix_startTrace(const char* path);
+
+
+/*
+PRECONDITION
+  - No other thread is calling functions of the matrix interface.
+POSTCONDITION
+  - Stops tracing and writes the trace as Chrome trace event JSON, which Perfetto (ui.perfetto.dev) and
+    chrome://tracing open.
+  - Returns SUCCESS, else FAILURE if no trace was started or writing the file failed.
+*/
+Status matrix_stopTrace(void);
+
+
+/*
+PRECONDITION
+  - none.
+POSTCONDITION
+  - Returns TRUE while a trace is running, else FALSE. Setting MATRIX_TRACE to a file that can't be opened for
+    writing doesn't start one.
+*/
+Boolean matrix_traceIsStarted(void);
+
+
+
+
+/***** Functions defined in MatrixTasks.c *****/
+/*
+PRECONDITION
+  - threads is the number of threads to factor large matrices with, <= 0 for one per processor (the default).
+POSTCONDITION
+  - The LU and Cholesky factorizations of matrices of at least MATRIX_TASK_MIN_SIZE rows (and so the determinant,
+    inverse and solve operations built on them) are split into tiles and run as a graph of tile tasks on this many
+    threads, which steal tasks from each other. The panel of each step is factored while the updates of the step
+    before are still running. Smaller matrices, and all of them when this is 1, are factored on the calling thread.
+  - Like the helper threads of matrix_loadCsv, the threads aren't included in the statistics of the operation.
+*/
+void matrix_setFactorizationThreads(int threads);
+
+
+/*
+PRECONDITION
+  - none.
+POSTCONDITION
+  - Returns the number of threads large matrices are factored with, working out one per processor if it wasn't set.
+*/
+int matrix_getFactorizationThreads(void);
+
+
+
+
+/***** Functions defined in MatrixNuma.c *****/
+/*
+PRECONDITION
+  - policy is one of the values of MatrixNumaPolicy.
+POSTCONDITION
+  - Places the storage arrays of at least 4 MiB allocated from now on, and the working copies of the factorizations
+    run as tile tasks (see matrix_setFactorizationThreads), by the policy. With a policy other than MATRIX_NUMA_OFF
+    the threads the factorizations start are pinned to the processors of a node, an even share of them on each, and
+    a task is first given to a thread on the node holding the rows it works on. The calling thread isn't pinned.
+  - The policy is also set by the environment variable MATRIX_NUMA (off, interleave or first-touch). Any other
+    value leaves it off.
+  - Nothing changes on a machine with a single node, or if the nodes couldn't be read from /sys.
+  - Returns SUCCESS, else FAILURE if policy isn't valid.
+*/
+Status matrix_setNumaPolicy(MatrixNumaPolicy policy);
+
+
+/*
+PRECONDITION
+  - none.
+POSTCONDITION
+  - Returns the policy being used.
+*/
+MatrixNumaPolicy matrix_getNumaPolicy(void);
+
+
+/*
+PRECONDITION
+  - none.
+POSTCONDITION
+  - Returns the number of NUMA nodes with processors the policy spreads over, 1 if the machine has one.
+*/
+int matrix_getNumaNodes(void);
+
+
+
+
+/***** Functions defined in MatrixTransport.c *****/
+/*
+PRECONDITION
+  - name is the name of a POSIX shared memory object ("/" followed by up to 200 characters) that no other group of
+    processes is using, i.e. made from the process id of the one that started them.
+  - processes >= 1 processes on this machine call this with the same name and processes, each with its own rank from
+    0 to processes - 1.
+  - pTransport is a pointer to the transport to open.
+POSTCONDITION
+  - Connects the processes through a shared memory object holding a ring buffer for each ordered pair of them.
+    Process 0 creates it and the others wait for it, all of them for at most 30 seconds, and it's unlinked once they've
+    all attached, so nothing is left behind. A send or receive that's waiting on a process that exits without
+    closing its transport fails within a second.
+  - Returns SUCCESS, else FAILURE if the processes couldn't all attach in time or for any memory allocation failure.
+*/
+Status matrix_openSharedMemoryTransport(const char* name, int rank, int processes, MatrixTransport* pTransport);
+
+
+/*
+PRECONDITION
+  - addresses is an array of processes >= 1 addresses ("host:port", i.e. "10.0.0.2:7000"), the one of each process.
+  - Every process calls this with the same addresses and its own rank from 0 to processes - 1.
+  - pTransport is a pointer to the transport to open.
+POSTCONDITION
+  - Connects each pair of the processes with a TCP connection. Each process listens on the port of its address, then
+    connects to the processes before it, retrying while they start, and accepts the connections of the ones after
+    it, all within 30 seconds.
+  - Returns SUCCESS, else FAILURE if the connections couldn't all be made in time or for any memory allocation failure.
+*/
+Status matrix_openSocketTransport(const char* const* addresses, int rank, int processes, MatrixTransport* pTransport);
+
+
+/*
+PRECONDITION
+  - pTransport is a pointer to a transport opened by one of the functions above or filled in by the caller.
+POSTCONDITION
+  - Closes the transport with its close hook. The sends to and receives from this process the others are waiting on
+    fail, so they don't wait forever for a process that gave up.
+*/
+void matrix_closeTransport(MatrixTransport* pTransport);
+
+
+
+
+/***** Functions defined in MatrixDistributed.c *****/
+/*
+PRECONDITION
+  - pTransport is a pointer to an open transport that outlives the distributed matrix object.
+  - rows/columns are the dimensions of the matrix and are >= 1, and blockSize >= 1 is the rows/columns of its blocks.
+  - Every process of the transport calls this with the same dimensions and block size.
+POSTCONDITION
+  - Splits a rows x columns matrix of zeroes into blockSize x blockSize blocks dealt out 2D block-cyclically over a
+    grid of the processes, as close to square as their number allows: block (i, j) is held by the process in grid row
+    i % gridRows and grid column j % gridColumns, and process p is in grid row p / gridColumns and grid column
+    p % gridColumns. Each process allocates only the blocks it holds.
+  - Returns a handle to this process's part of the new distributed matrix object, else NULL for any memory
+    allocation failure.
+*/
+MATRIX_DISTRIBUTED matrix_initDistributed(const MatrixTransport* pTransport, size_t rows, size_t columns, size_t blockSize);
+
+
+/*
+PRECONDITION
+  - pTransport is a pointer to an open transport that outlives the distributed matrix object.
+  - Every process of the transport calls this with the same root, a process of the transport. On the root, hMatrix
+    is a handle to a valid matrix object and blockSize >= 1, and on the others both are ignored.
+  - The processes run on machines with the same long double format, since entries are sent as they're stored.
+POSTCONDITION
+  - Sends each process the blocks of the root's matrix it holds, split the same as by matrix_initDistributed.
+  - Returns a handle to this process's part of the new distributed matrix object, else NULL for any memory allocation
+    failure or if the transport fails.
+  - When a collective function (this, matrix_collect or matrix_multiplyDistributed) fails on one process, the process
+    should close its transport, so the others fail too rather than waiting for it.
+*/
+MATRIX_DISTRIBUTED matrix_distribute(const MatrixTransport* pTransport, MATRIX hMatrix, int root, size_t blockSize);
+
+
+/*
+PRECONDITION
+  - hDistributed is a handle to a valid distributed matrix object.
+  - entry returns the entry at row/column of the matrix and pContext is passed to it.
+POSTCONDITION
+  - Sets the entries of the blocks this process holds, so large matrices can be made where they're held, without
+    ever being in one process. Nothing is sent.
+*/
+void matrix_fillDistributed(MATRIX_DISTRIBUTED hDistributed, long double (*entry)(size_t row, size_t column, void* pContext),
+    void* pContext);
+
+
+/*
+PRECONDITION
+  - hDistributed is a handle to a valid distributed matrix object, and every process of its transport calls this with
+    its part of it and the same root.
+  - On the root, phResult is a pointer to the variable holding NULL or a handle to a valid matrix object. It's ignored
+    on the others.
+POSTCONDITION
+  - Sends the root the blocks of the other processes and stores the whole matrix in the matrix object the variable
+    pointed to by phResult holds on the root (a new one if it was NULL, see matrix_multiply).
+  - Returns SUCCESS, else FAILURE for any memory allocation failure or if the transport fails.
+*/
+Status matrix_collect(MATRIX_DISTRIBUTED hDistributed, int root, MATRIX* phResult);
+
+
+/*
+PRECONDITION
+  - hA/hB are handles to valid distributed matrix objects on the same transport with the same block size, and every
+    process of the transport calls this with its parts of them.
+  - phResult is a pointer to the variable that receives the product, holding NULL or a handle to a valid distributed
+    matrix object, which is destroyed and replaced by the product (it may be hA or hB).
+POSTCONDITION
+  - Multiplies the matrices with SUMMA: for each column of blocks of A, the processes holding it send their blocks
+    of it along their grid row and the processes holding the same row of blocks of B send theirs along their grid
+    column, and each process adds the product of what it got to the blocks of the product it holds, with the same
+    kernel as matrix_multiply. The product is split the same way as A and B.
+  - Returns SUCCESS, else FAILURE for any memory allocation failure, if the transport fails or if the matrices can't
+    be multiplied (the same on every process, so nothing is sent).
+*/
+Status matrix_multiplyDistributed(MATRIX_DISTRIBUTED hA, MATRIX_DISTRIBUTED hB, MATRIX_DISTRIBUTED* phResult);
+
+
+/*
+PRECONDITION
+  - phDistributed is a pointer to a handle to a valid distributed matrix object or a handle that's NULL.
+POSTCONDITION
+  - Frees this process's part of the distributed matrix object and sets the handle to NULL. Nothing is sent.
+*/
+void matrix_destroyDistributed(MATRIX_DISTRIBUTED* phDistributed);
+
+
 #endif
@@ -0,0 +1,476 @@
+/*
+  Author: Benjamin G. Friedman
+  Date: 10/18/2026
+  File: MatrixCache.c
+  Description:
+	  - Implementation file for the result cache of the matrix interface. Results are keyed by a 128-bit hash of the
+		operation, its parameter and the dimensions, layout and entries of the operand, so a matrix that's changed in
+		any way (matrix_setEntry, being the result of an operation, a write to its file) no longer finds the results of
+		its old entries. Those age out of the cache like any other entry.
+	  - Entries are kept in a hash table and a list from most to least recently used, and the least recently used ones
+		are evicted to stay within the capacity. One lock guards the entries, so asynchronous jobs can share the cache,
+		while the capacity is atomic so checking whether the cache is on doesn't take the lock.
+	  - The lock is only held to find, add and remove entries. A matrix result is copied out of its entry after the lock
+		is released, with a reference keeping the entry from being freed if it's evicted meanwhile.
+*/
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "MatrixInternal.h"
+
+
+#define CACHE_MIN_ENTRIES 64           // matrices with fewer entries are quicker to recalculate than to look up
+#define CACHE_MIN_BUCKETS 64
+#define CACHE_ENTRY_BYTES (sizeof(long double) == 16 && LDBL_MANT_DIG == 64 ? 10 : sizeof(long double))  // bytes of a long double that hold its value, not padding
+
+
+
+
+/***** Structures *****/
+typedef struct cacheEntry {
+	CacheKey key;
+	long double number;                // result that's a number, or a flag of the result
+	size_t rows;                       // dimensions of a matrix result
+	size_t columns;
+	size_t bytes;                      // bytes of data, 0 for none
+	int references;                    // one for being in the cache and one for each lookup copying the data
+	struct cacheEntry* pNewer;         // neighbors in the list from most to least recently used
+	struct cacheEntry* pOlder;
+	struct cacheEntry* pNextInBucket;
+	long double data[];                // the result, i.e. a matrix in row-major order
+} CacheEntry;
+
+
+
+
+/***** Global variables *****/
+static pthread_mutex_t cacheLock = PTHREAD_MUTEX_INITIALIZER;
+static atomic_size_t capacity;                 // most bytes of entries, 0 if the cache is off. Changed under the lock,
+                                               // read without it to check the cache is on
+static MatrixCacheStats stats;
+static CacheEntry** buckets;                   // hash table of the entries
+static size_t bucketsSize;
+static CacheEntry* pNewest;                    // list from most to least recently used
+static CacheEntry* pOldest;
+
+
+
+
+/***** Helper functions used only in this file *****/
+/*
+PRECONDITION
+  - hash is an array of 2 words holding the hash so far.
+  - entries is an array of count long doubles.
+POSTCONDITION
+  - Mixes the values of the entries (not the padding bytes of a long double) into both words of the hash.
+*/
+static void hashEntries(uint64_t hash[2], const long double* entries, size_t count);
+
+
+/*
+PRECONDITION
+  - hash is an array of 2 words holding the hash so far.
+  - value is a value to add to the hash.
+POSTCONDITION
+  - Mixes the value into both words of the hash.
+*/
+static void hashValue(uint64_t hash[2], uint64_t value);
+
+
+/*
+PRECONDITION
+  - x is any 64-bit word.
+POSTCONDITION
+  - Returns x with every bit affecting every other bit (the finalizer of splitmix64).
+*/
+static uint64_t finalizeHash(uint64_t x);
+
+
+/*
+PRECONDITION
+  - cacheLock is held.
+  - pKey is a pointer to a key.
+POSTCONDITION
+  - Returns the entry for the key made the most recently used, else NULL. Counts the hit or miss.
+*/
+static CacheEntry* findEntry(const CacheKey* pKey);
+
+
+/*
+PRECONDITION
+  - cacheLock is held.
+  - pEntry is a pointer to an entry that isn't in the cache.
+POSTCONDITION
+  - Adds the entry as the most recently used, replacing any entry with the same key and evicting the least recently
+    used entries to make room for it. Frees it if it can't be added.
+*/
+static void addEntry(CacheEntry* pEntry);
+
+
+/*
+PRECONDITION
+  - cacheLock is held.
+  - pEntry is a pointer to an entry in the cache.
+POSTCONDITION
+  - Takes the entry out of the cache and releases the cache's reference to it.
+*/
+static void removeEntry(CacheEntry* pEntry);
+
+
+/*
+PRECONDITION
+  - cacheLock is held.
+  - pEntry is a pointer to an entry with a reference that's no longer needed.
+POSTCONDITION
+  - Drops the reference, freeing the entry once nothing references it.
+*/
+static void releaseEntry(CacheEntry* pEntry);
+
+
+/*
+PRECONDITION
+  - cacheLock is held.
+  - bytes is the most bytes the entries may take up.
+POSTCONDITION
+  - Evicts the least recently used entries until the rest take up at most bytes.
+*/
+static void evictEntries(size_t bytes);
+
+
+/*
+PRECONDITION
+  - pKey is a pointer to a key.
+  - bytes is the bytes of data of the entry.
+POSTCONDITION
+  - Returns a new entry for the key with room for the data, or NULL if it's too large for the cache or for any
+    memory allocation failure.
+*/
+static CacheEntry* newEntry(const CacheKey* pKey, size_t bytes);
+
+
+
+
+/***** Functions defined in Matrix.h *****/
+void matrix_setCacheCapacity(size_t bytes) {
+	pthread_mutex_lock(&cacheLock);
+	atomic_store_explicit(&capacity, bytes, memory_order_relaxed);
+	evictEntries(bytes);
+	if (bytes == 0) {
+		freeMemory(buckets);
+		buckets = NULL;
+		bucketsSize = 0;
+	}
+	pthread_mutex_unlock(&cacheLock);
+}
+
+
+
+void matrix_clearCache(void) {
+	pthread_mutex_lock(&cacheLock);
+	while (pOldest)
+		removeEntry(pOldest);
+	pthread_mutex_unlock(&cacheLock);
+}
+
+
+
+void matrix_getCacheStats(MatrixCacheStats* pStats) {
+	pthread_mutex_lock(&cacheLock);
+	*pStats = stats;
+	pStats->capacity = atomic_load_explicit(&capacity, memory_order_relaxed);
+	pthread_mutex_unlock(&cacheLock);
+}
+
+
+
+
+/***** Helper functions shared with the other matrix implementation files - declared in MatrixInternal.h *****/
+Boolean cacheKey(const Matrix* pMatrix, CacheOperation operation, long long parameter, CacheKey* pKey) {
+	// the cache is off unless it's been given a capacity, which is checked without the lock
+	if (atomic_load_explicit(&capacity, memory_order_relaxed) == 0)
+		return FALSE;
+	if (pMatrix->rows * pMatrix->columns < CACHE_MIN_ENTRIES)
+		return FALSE;
+
+	// the tiles are hashed with their padding, which is always zero
+	uint64_t hash[2] = { 0x243F6A8885A308D3ull, 0x13198A2E03707344ull };
+	hashValue(hash, (uint64_t)operation);
+	hashValue(hash, (uint64_t)parameter);
+	hashValue(hash, pMatrix->rows);
+	hashValue(hash, pMatrix->columns);
+	hashValue(hash, (uint64_t)pMatrix->layout);
+	size_t matrixSize = storageSize(pMatrix->rows, pMatrix->columns, pMatrix->layout);
+	for (size_t first = 0; first < matrixSize; first += STREAM_CHUNK_SIZE) {
+		size_t end = (matrixSize - first < STREAM_CHUNK_SIZE) ? matrixSize : first + STREAM_CHUNK_SIZE;
+		hashEntries(hash, pMatrix->matrix + first, end - first);
+		releaseSpan(pMatrix, first, end);
+	}
+	pKey->hash[0] = finalizeHash(hash[0]);
+	pKey->hash[1] = finalizeHash(hash[1] ^ hash[0]);
+
+	return TRUE;
+}
+
+
+
+Boolean cacheFind(const CacheKey* pKey, void* data, size_t bytes, long double* pNumber) {
+	pthread_mutex_lock(&cacheLock);
+	CacheEntry* pEntry = findEntry(pKey);
+	if (pEntry) {
+		if (pEntry->bytes == bytes && bytes > 0)
+			memcpy(data, pEntry->data, bytes);
+		*pNumber = pEntry->number;
+	}
+	pthread_mutex_unlock(&cacheLock);
+
+	return pEntry ? TRUE : FALSE;
+}
+
+
+
+void cacheStore(const CacheKey* pKey, const void* data, size_t bytes, long double number) {
+	CacheEntry* pEntry = newEntry(pKey, bytes);
+
+	if (!pEntry)
+		return;
+	if (bytes > 0)
+		memcpy(pEntry->data, data, bytes);
+	pEntry->number = number;
+
+	pthread_mutex_lock(&cacheLock);
+	addEntry(pEntry);
+	pthread_mutex_unlock(&cacheLock);
+}
+
+
+
+Boolean cacheFindMatrix(const CacheKey* pKey, Matrix** ppResult, long double* pNumber) {
+	pthread_mutex_lock(&cacheLock);
+	CacheEntry* pEntry = findEntry(pKey);
+	if (pEntry) {
+		*pNumber = pEntry->number;
+		++pEntry->references;
+	}
+	pthread_mutex_unlock(&cacheLock);
+	if (!pEntry)
+		return FALSE;
+
+	// the entry's data never changes, so it's copied without the lock while the reference keeps it from being freed
+	Boolean found = TRUE;
+	if (pEntry->bytes > 0) {
+		if (adjustMatrixDimensions(ppResult, pEntry->rows, pEntry->columns)) {
+			copyFromRowMajor(*ppResult, pEntry->data);
+			(*ppResult)->maxLength = 0;
+		}
+		else
+			found = FALSE;
+	}
+	pthread_mutex_lock(&cacheLock);
+	releaseEntry(pEntry);
+	pthread_mutex_unlock(&cacheLock);
+
+	return found;
+}
+
+
+
+void cacheStoreMatrix(const CacheKey* pKey, const Matrix* pResult, long double number) {
+	size_t bytes = pResult ? pResult->rows * pResult->columns * sizeof(long double) : 0;
+	CacheEntry* pEntry = newEntry(pKey, bytes);
+
+	if (!pEntry)
+		return;
+	if (pResult) {
+		copyToRowMajor(pResult, pEntry->data);
+		pEntry->rows = pResult->rows;
+		pEntry->columns = pResult->columns;
+	}
+	pEntry->number = number;
+
+	pthread_mutex_lock(&cacheLock);
+	addEntry(pEntry);
+	pthread_mutex_unlock(&cacheLock);
+}
+
+
+
+
+/***** Helper functions used only in this file *****/
+static void hashEntries(uint64_t hash[2], const long double* entries, size_t count) {
+	uint64_t hash0 = hash[0];
+	uint64_t hash1 = hash[1];
+
+	for (size_t i = 0; i < count; ++i) {
+		uint64_t words[2] = { 0, 0 };
+		memcpy(words, &entries[i], CACHE_ENTRY_BYTES);
+		hash0 = ((hash0 ^ words[0]) * 0x9E3779B97F4A7C15ull) ^ words[1];
+		hash0 = (hash0 << 31) | (hash0 >> 33);
+		hash1 = ((hash1 ^ words[1]) + words[0]) * 0xC2B2AE3D27D4EB4Full;
+		hash1 = (hash1 << 29) | (hash1 >> 35);
+	}
+	hash[0] = hash0;
+	hash[1] = hash1;
+}
+
+
+
+static void hashValue(uint64_t hash[2], uint64_t value) {
+	hash[0] = finalizeHash(hash[0] ^ value);
+	hash[1] = finalizeHash(hash[1] + value * 0x9E3779B97F4A7C15ull);
+}
+
+
+
+static uint64_t finalizeHash(uint64_t x) {
+	x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+	x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+	return x ^ (x >> 31);
+}
+
+
+
+static CacheEntry* findEntry(const CacheKey* pKey) {
+	CacheEntry* pEntry = NULL;
+
+	if (buckets) {
+		pEntry = buckets[pKey->hash[0] & (bucketsSize - 1)];
+		while (pEntry && (pEntry->key.hash[0] != pKey->hash[0] || pEntry->key.hash[1] != pKey->hash[1]))
+			pEntry = pEntry->pNextInBucket;
+	}
+	if (!pEntry) {
+		++stats.misses;
+		return NULL;
+	}
+	++stats.hits;
+
+	// move it to the front of the list
+	if (pEntry != pNewest) {
+		pEntry->pNewer->pOlder = pEntry->pOlder;
+		if (pEntry->pOlder)
+			pEntry->pOlder->pNewer = pEntry->pNewer;
+		else
+			pOldest = pEntry->pNewer;
+		pEntry->pNewer = NULL;
+		pEntry->pOlder = pNewest;
+		pNewest->pNewer = pEntry;
+		pNewest = pEntry;
+	}
+
+	return pEntry;
+}
+
+
+
+static void addEntry(CacheEntry* pEntry) {
+	size_t entryBytes = sizeof(*pEntry) + pEntry->bytes;
+
+	// the capacity may have been lowered since the entry was made
+	size_t limit = atomic_load_explicit(&capacity, memory_order_relaxed);
+	if (entryBytes > limit) {
+		freeMemory(pEntry);
+		return;
+	}
+
+	// the table doubles once it has as many entries as buckets
+	if (!buckets || stats.entries >= bucketsSize) {
+		size_t newSize = buckets ? bucketsSize * 2 : CACHE_MIN_BUCKETS;
+		CacheEntry** newBuckets = allocateZeroedMemory(newSize, sizeof(*newBuckets));
+		if (newBuckets) {
+			for (size_t i = 0; i < bucketsSize; ++i) {
+				while (buckets[i]) {
+					CacheEntry* pMoved = buckets[i];
+					buckets[i] = pMoved->pNextInBucket;
+					pMoved->pNextInBucket = newBuckets[pMoved->key.hash[0] & (newSize - 1)];
+					newBuckets[pMoved->key.hash[0] & (newSize - 1)] = pMoved;
+				}
+			}
+			freeMemory(buckets);
+			buckets = newBuckets;
+			bucketsSize = newSize;
+		}
+		else if (!buckets) {
+			freeMemory(pEntry);
+			return;
+		}
+	}
+
+	// another thread may have stored the same result while this one was calculating it
+	for (CacheEntry* pOther = buckets[pEntry->key.hash[0] & (bucketsSize - 1)]; pOther; pOther = pOther->pNextInBucket) {
+		if (pOther->key.hash[0] == pEntry->key.hash[0] && pOther->key.hash[1] == pEntry->key.hash[1]) {
+			removeEntry(pOther);
+			break;
+		}
+	}
+	evictEntries(limit - entryBytes);
+
+	CacheEntry** pBucket = &buckets[pEntry->key.hash[0] & (bucketsSize - 1)];
+	pEntry->pNextInBucket = *pBucket;
+	*pBucket = pEntry;
+	pEntry->pNewer = NULL;
+	pEntry->pOlder = pNewest;
+	if (pNewest)
+		pNewest->pNewer = pEntry;
+	else
+		pOldest = pEntry;
+	pNewest = pEntry;
+	++stats.entries;
+	stats.bytes += entryBytes;
+}
+
+
+
+static void removeEntry(CacheEntry* pEntry) {
+	CacheEntry** pLink = &buckets[pEntry->key.hash[0] & (bucketsSize - 1)];
+
+	while (*pLink != pEntry)
+		pLink = &(*pLink)->pNextInBucket;
+	*pLink = pEntry->pNextInBucket;
+	if (pEntry->pNewer)
+		pEntry->pNewer->pOlder = pEntry->pOlder;
+	else
+		pNewest = pEntry->pOlder;
+	if (pEntry->pOlder)
+		pEntry->pOlder->pNewer = pEntry->pNewer;
+	else
+		pOldest = pEntry->pNewer;
+	--stats.entries;
+	stats.bytes -= sizeof(*pEntry) + pEntry->bytes;
+	releaseEntry(pEntry);
+}
+
+
+
+static void releaseEntry(CacheEntry* pEntry) {
+	if (--pEntry->references == 0)
+		freeMemory(pEntry);
+}
+
+
+
+static void evictEntries(size_t bytes) {
+	while (pOldest && stats.bytes > bytes) {
+		removeEntry(pOldest);
+		++stats.evictions;
+	}
+}
+
+
+
+static CacheEntry* newEntry(const CacheKey* pKey, size_t bytes) {
+	size_t limit = atomic_load_explicit(&capacity, memory_order_relaxed);
+	Boolean fits = bytes <= limit && sizeof(CacheEntry) + bytes <= limit;
+
+	CacheEntry* pEntry = fits ? allocateMemory(sizeof(*pEntry) + bytes) : NULL;
+	if (pEntry) {
+		pEntry->key = *pKey;
+		pEntry->rows = 0;
+		pEntry->columns = 0;
+		pEntry->bytes = bytes;
+		pEntry->references = 1;
+	}
+
+	return pEntry;
+}
@@ -0,0 +1,460 @@
+/*
+  Author: Benjamin G. Friedman
+  Date: 10/18/2026
+  File: MatrixCsv.c
+  Description:
+	  - Implementation file for loading and saving matrix objects as CSV files with several threads.
+	  - Loading maps the file and splits it into one chunk of whole lines per thread. Each thread counts the rows in its
+		chunk, which gives every chunk the row it starts at, then parses its chunk straight into that part of the storage array.
+	  - Saving formats blocks of rows on every thread at once and writes the blocks in order, one round at a time, so only
+		a few blocks of text are held in memory however large the matrix is.
+*/
+
+
+#define _DEFAULT_SOURCE        // sysconf and madvise
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "MatrixInternal.h"
+
+
+#define CSV_MAX_THREADS 64             // most threads used for a file
+#define CSV_MIN_CHUNK (1 << 20)        // bytes of text each thread is given at least, so small files use fewer threads
+
+
+
+
+/***** Structures *****/
+// The part of a file parsed by one thread
+typedef struct csvChunk {
+	const char* text;                  // whole lines of the file
+	size_t length;                     // characters in text
+	size_t rows;                       // rows in the chunk
+	size_t firstRow;                   // rows in the chunks before this one
+	Matrix* pMatrix;                   // matrix the rows are stored in
+	Boolean failed;                    // a row is invalid
+} CsvChunk;
+
+
+// The rows formatted by one thread in a round of saving
+typedef struct csvBlock {
+	const Matrix* pMatrix;
+	size_t firstRow;
+	size_t endRow;                     // the block is the rows [firstRow, endRow)
+	char* text;                        // the rows as CSV
+	size_t length;                     // characters in text
+	size_t capacity;                   // characters text has room for
+	Boolean failed;                    // memory allocation failure
+} CsvBlock;
+
+
+
+
+/***** Helper functions used only in this file *****/
+/*
+PRECONDITION
+  - threads is the number of threads asked for, <= 0 for one per processor.
+  - bytes is the size of the text to be worked on.
+POSTCONDITION
+  - Returns the number of threads to use, from 1 to CSV_MAX_THREADS, with at least CSV_MIN_CHUNK bytes for each.
+*/
+static int threadCount(int threads, size_t bytes);
+
+
+/*
+PRECONDITION
+  - work is the function each thread runs.
+  - arguments is an array of count arguments of argumentSize bytes each, count is from 1 to CSV_MAX_THREADS.
+POSTCONDITION
+  - Runs work on each argument, all but the first on new threads, and returns once they have all finished.
+    An argument whose thread can't be created is worked on by the calling thread instead.
+*/
+static void runThreads(void* (*work)(void*), void* arguments, size_t argumentSize, int count);
+
+
+/*
+PRECONDITION
+  - line is the start of a line of text of at most length characters.
+POSTCONDITION
+  - Returns TRUE if the line holds a row, else FALSE if it's blank or a comment starting with '#'.
+*/
+static Boolean isRow(const char* line, size_t length);
+
+
+/*
+PRECONDITION
+  - pArgument is a pointer to a chunk whose text and length are set.
+POSTCONDITION
+  - Counts the rows in the chunk. Returns NULL.
+*/
+static void* countRows(void* pArgument);
+
+
+/*
+PRECONDITION
+  - pArgument is a pointer to a chunk whose fields are all set.
+POSTCONDITION
+  - Parses the rows of the chunk into the matrix starting at its first row, and sets the chunk's failed flag if a row
+    doesn't have exactly as many entries as the matrix has columns or an entry is invalid. Returns NULL.
+*/
+static void* parseRows(void* pArgument);
+
+
+/*
+PRECONDITION
+  - text is an array of length characters.
+POSTCONDITION
+  - Returns the number of entries in the first row of the text, else 0 if it has no rows or the first is invalid.
+*/
+static size_t countColumns(const char* text, size_t length);
+
+
+/*
+PRECONDITION
+  - pArgument is a pointer to a block whose matrix and rows are set.
+POSTCONDITION
+  - Replaces the text of the block with its rows, one per line with the entries separated by commas, each in the
+    shortest form that reads back the same. Sets the block's failed flag for any memory allocation failure. Returns NULL.
+*/
+static void* formatRows(void* pArgument);
+
+
+/*
+PRECONDITION
+  - pBlock is a pointer to a block.
+  - characters is an array of length characters.
+POSTCONDITION
+  - Adds the characters to the text of the block, growing it if needed. Returns SUCCESS, else FAILURE for any memory
+    allocation failure.
+*/
+static Status appendText(CsvBlock* pBlock, const char* characters, size_t length);
+
+
+
+/*
+PRECONDITION
+  - The same as matrix_loadCsv.
+POSTCONDITION
+  - Loads the matrix the same as matrix_loadCsv, without measuring the call.
+*/
+static MATRIX loadCsv(const char* path, int threads);
+
+
+/*
+PRECONDITION
+  - The same as matrix_saveCsv.
+POSTCONDITION
+  - Saves the matrix the same as matrix_saveCsv, without measuring the call.
+*/
+static Status saveCsv(MATRIX hMatrix, const char* path, int threads);
+
+
+
+/***** Functions defined in Matrix.h *****/
+MATRIX matrix_loadCsv(const char* path, int threads) {
+	MeasuredCall call;
+
+	beginCall(&call, MATRIX_OPERATION_LOAD_CSV, NULL);
+	MATRIX hMatrix = loadCsv(path, threads);
+	endCall(&call, 0);
+
+	return hMatrix;
+}
+
+
+
+
+Status matrix_saveCsv(MATRIX hMatrix, const char* path, int threads) {
+	MeasuredCall call;
+
+	beginCall(&call, MATRIX_OPERATION_SAVE_CSV, hMatrix);
+	Status status = saveCsv(hMatrix, path, threads);
+	endCall(&call, 0);
+
+	return status;
+}
+
+
+
+
+/***** Helper functions used only in this file *****/
+static int threadCount(int threads, size_t bytes) {
+	if (threads <= 0) {
+		long processors = sysconf(_SC_NPROCESSORS_ONLN);
+		threads = (processors > 0 && processors < CSV_MAX_THREADS) ? (int)processors : CSV_MAX_THREADS;
+	}
+	if (threads > CSV_MAX_THREADS)
+		threads = CSV_MAX_THREADS;
+	if ((size_t)threads > bytes / CSV_MIN_CHUNK)
+		threads = (bytes / CSV_MIN_CHUNK > 0) ? (int)(bytes / CSV_MIN_CHUNK) : 1;
+
+	return threads;
+}
+
+
+
+static void runThreads(void* (*work)(void*), void* arguments, size_t argumentSize, int count) {
+	pthread_t threads[CSV_MAX_THREADS];
+	Boolean started[CSV_MAX_THREADS];
+
+	for (int i = 1; i < count; ++i)
+		started[i] = pthread_create(&threads[i], NULL, work, (char*)arguments + i * argumentSize) ? FALSE : TRUE;
+	work(arguments);
+	for (int i = 1; i < count; ++i) {
+		if (started[i])
+			pthread_join(threads[i], NULL);
+		else
+			work((char*)arguments + i * argumentSize);
+	}
+}
+
+
+
+static Boolean isRow(const char* line, size_t length) {
+	for (size_t i = 0; i < length; ++i) {
+		if (line[i] != ' ' && line[i] != '\t' && line[i] != '\r')
+			return line[i] != '\n' && line[i] != '#';
+	}
+
+	return FALSE;
+}
+
+
+
+static void* countRows(void* pArgument) {
+	CsvChunk* pChunk = pArgument;
+	const char* line = pChunk->text;
+	const char* end = pChunk->text + pChunk->length;
+
+	pChunk->rows = 0;
+	while (line < end) {
+		const char* newline = memchr(line, '\n', (size_t)(end - line));
+		const char* next = newline ? newline + 1 : end;
+		if (isRow(line, (size_t)(next - line)))
+			++pChunk->rows;
+		line = next;
+	}
+
+	return NULL;
+}
+
+
+
+static void* parseRows(void* pArgument) {
+	CsvChunk* pChunk = pArgument;
+	Matrix* pMatrix = pChunk->pMatrix;
+	long double* pEntry = pMatrix->matrix + pChunk->firstRow * pMatrix->columns;
+	TextReader reader;
+
+	initTextReaderBuffer(&reader, pChunk->text, pChunk->length);
+	for (size_t row = 0; row < pChunk->rows; ++row) {
+		// blank lines and comments were skipped by countRows as well
+		for (;;) {
+			skipBlanks(&reader);
+			int c = peekCharacter(&reader);
+			if (c == EOF) {
+				pChunk->failed = TRUE;
+				return NULL;
+			}
+			if (c == '#')
+				skipLine(&reader);
+			else if (!readEndOfLine(&reader))
+				break;
+		}
+
+		for (size_t column = 0; column < pMatrix->columns; ++column) {
+			if ((column > 0 && !readSeparator(&reader, ',')) || !readNumber(&reader, pEntry++)) {
+				pChunk->failed = TRUE;
+				return NULL;
+			}
+		}
+		if (!readEndOfLine(&reader)) {
+			pChunk->failed = TRUE;
+			return NULL;
+		}
+	}
+
+	return NULL;
+}
+
+
+
+static size_t countColumns(const char* text, size_t length) {
+	const char* end = text + length;
+	TextReader reader;
+	long double n;
+
+	// the first row
+	while (text < end) {
+		const char* newline = memchr(text, '\n', (size_t)(end - text));
+		const char* next = newline ? newline + 1 : end;
+		if (isRow(text, (size_t)(next - text)))
+			break;
+		text = next;
+	}
+
+	initTextReaderBuffer(&reader, text, (size_t)(end - text));
+	size_t columns = 0;
+	do {
+		if (!readNumber(&reader, &n))
+			return 0;
+		++columns;
+	} while (readSeparator(&reader, ','));
+
+	return readEndOfLine(&reader) ? columns : 0;
+}
+
+
+
+static void* formatRows(void* pArgument) {
+	CsvBlock* pBlock = pArgument;
+	const Matrix* pMatrix = pBlock->pMatrix;
+	char numString[NUMBER_STRING_SIZE + 1];        // each number as a string, followed by a comma or newline
+
+	pBlock->length = 0;
+	for (size_t i = pBlock->firstRow; i < pBlock->endRow; ++i) {
+		for (size_t j = 0; j < pMatrix->columns; ++j) {
+			int length = formatShortest(pMatrix->matrix[matrixIndex(pMatrix, i, j)], numString);
+			numString[length] = (j + 1 < pMatrix->columns) ? ',' : '\n';
+			if (!appendText(pBlock, numString, (size_t)length + 1)) {
+				pBlock->failed = TRUE;
+				return NULL;
+			}
+		}
+	}
+
+	return NULL;
+}
+
+
+
+static Status appendText(CsvBlock* pBlock, const char* characters, size_t length) {
+	if (pBlock->capacity - pBlock->length < length) {
+		size_t capacity = pBlock->capacity ? pBlock->capacity * 2 : CSV_MIN_CHUNK;
+		while (capacity - pBlock->length < length)
+			capacity *= 2;
+		char* text = reallocateMemory(pBlock->text, capacity);
+		if (!text)
+			return FAILURE;
+		pBlock->text = text;
+		pBlock->capacity = capacity;
+	}
+	memcpy(pBlock->text + pBlock->length, characters, length);
+	pBlock->length += length;
+
+	return SUCCESS;
+}
+
+
+
+static MATRIX loadCsv(const char* path, int threads) {
+	CsvChunk chunks[CSV_MAX_THREADS];
+	struct stat fileStatus;
+	Matrix* pMatrix = NULL;
+	int fd;
+
+	if ((fd = open(path, O_RDONLY)) < 0)
+		return NULL;
+	if (fstat(fd, &fileStatus) || fileStatus.st_size <= 0 || (uint64_t)fileStatus.st_size > SIZE_MAX) {
+		close(fd);
+		return NULL;
+	}
+	size_t length = (size_t)fileStatus.st_size;
+	const char* text = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (text == MAP_FAILED)
+		return NULL;
+	madvise((void*)text, length, MADV_SEQUENTIAL);
+
+	// each chunk ends after the first newline past its share of the file
+	int count = threadCount(threads, length);
+	size_t start = 0;
+	for (int i = 0; i < count; ++i) {
+		size_t end = length;
+		if (i < count - 1 && length / count * (i + 1) > start) {
+			const char* newline = memchr(text + length / count * (i + 1), '\n', length - length / count * (i + 1));
+			if (newline)
+				end = (size_t)(newline - text) + 1;
+		}
+		chunks[i].text = text + start;
+		chunks[i].length = end - start;
+		chunks[i].failed = FALSE;
+		start = end;
+	}
+	runThreads(countRows, chunks, sizeof(*chunks), count);
+
+	size_t rows = 0;
+	for (int i = 0; i < count; ++i) {
+		chunks[i].firstRow = rows;
+		rows += chunks[i].rows;
+	}
+	size_t columns = countColumns(text, length);
+	if (rows > 0 && columns > 0 && (pMatrix = matrix_initLayout(rows, columns, MATRIX_ROW_MAJOR))) {
+		for (int i = 0; i < count; ++i)
+			chunks[i].pMatrix = pMatrix;
+		runThreads(parseRows, chunks, sizeof(*chunks), count);
+
+		for (int i = 0; i < count; ++i) {
+			if (chunks[i].failed) {
+				freeStorage(pMatrix);
+				freeMemory(pMatrix);
+				pMatrix = NULL;
+				break;
+			}
+		}
+		if (pMatrix)
+			pMatrix->maxLength = 0;
+	}
+	munmap((void*)text, length);
+
+	return pMatrix;
+}
+
+
+
+static Status saveCsv(MATRIX hMatrix, const char* path, int threads) {
+	Matrix* pMatrix = hMatrix;
+	CsvBlock blocks[CSV_MAX_THREADS];
+	FILE* fp;
+
+	// each block is about a chunk of entries, and the text of a chunk is about CSV_MIN_CHUNK bytes
+	size_t blockRows = (pMatrix->columns < STREAM_CHUNK_SIZE) ? STREAM_CHUNK_SIZE / pMatrix->columns : 1;
+	int count = threadCount(threads, (pMatrix->rows + blockRows - 1) / blockRows * (size_t)CSV_MIN_CHUNK);
+	if (!(fp = fopen(path, "w")))
+		return FAILURE;
+	for (int i = 0; i < count; ++i) {
+		blocks[i].pMatrix = pMatrix;
+		blocks[i].text = NULL;
+		blocks[i].capacity = 0;
+		blocks[i].failed = FALSE;
+	}
+
+	Status status = SUCCESS;
+	for (size_t row = 0; status && row < pMatrix->rows; ) {
+		for (int i = 0; i < count; ++i) {
+			blocks[i].firstRow = row;
+			row = (pMatrix->rows - row < blockRows) ? pMatrix->rows : row + blockRows;
+			blocks[i].endRow = row;
+		}
+		runThreads(formatRows, blocks, sizeof(*blocks), count);
+
+		// the blocks are written in order once the whole round is formatted
+		for (int i = 0; status && i < count; ++i) {
+			if (blocks[i].failed || fwrite(blocks[i].text, 1, blocks[i].length, fp) != blocks[i].length)
+				status = FAILURE;
+		}
+		releaseRows(pMatrix, blocks[0].firstRow, row);
+	}
+	for (int i = 0; i < count; ++i)
+		freeMemory(blocks[i].text);
+	if (fclose(fp))
+		status = FAILURE;
+
+	return status;
+}
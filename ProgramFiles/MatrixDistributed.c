@@ -0,0 +1,482 @@
+/*
+  Author: Benjamin G. Friedman
+  Date: 10/18/2026
+  File: MatrixDistributed.c
+  Description:
+	  - Implementation file for distributed matrix objects, which are split 2D block-cyclically over processes connected
+		by a transport (see MatrixTransport.c), and the SUMMA multiplication of them.
+	  - Each process packs the blocks it holds into a row-major local array, its rows of blocks one after another in
+		order and its columns of blocks side by side in order. Block row i of the matrix is then local rows
+		(i / gridRows) * blockSize on, and block column j local columns (j / gridColumns) * blockSize on.
+	  - Every function that sends anything is collective: all the processes call it, and they each work out the same
+		sends and receives from the dimensions, which all of them know.
+*/
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "MatrixInternal.h"
+
+
+
+
+/***** Structures *****/
+typedef struct distributedMatrix {
+	MatrixTransport transport;         // copy of the transport of the processes
+	size_t rows;                       // dimensions of the whole matrix
+	size_t columns;
+	size_t blockSize;                  // rows/columns of each block
+	int gridRows;                      // the processes form a gridRows x gridColumns grid
+	int gridColumns;
+	int gridRow;                       // place of this process in the grid
+	int gridColumn;
+	size_t localRows;                  // dimensions of the local array
+	size_t localColumns;
+	long double* local;                // the blocks this process holds
+} DistributedMatrix;
+
+// What the root of matrix_distribute sends the others before the blocks
+typedef struct distributeHeader {
+	uint64_t rows;                     // 0 if the root has nothing to send
+	uint64_t columns;
+	uint64_t blockSize;
+} DistributeHeader;
+
+
+
+
+/***** Helper functions used only in this file *****/
+/*
+PRECONDITION
+  - pTransport is a pointer to an open transport.
+  - rows/columns/blockSize are >= 1.
+POSTCONDITION
+  - Returns a new distributed matrix of zeroes with the dimensions, else NULL for any memory allocation failure.
+*/
+static DistributedMatrix* createDistributed(const MatrixTransport* pTransport, size_t rows, size_t columns, size_t blockSize);
+
+
+/*
+PRECONDITION
+  - pA/pB are pointers to distributed matrices that can be multiplied.
+  - ppProduct is a pointer to the variable that receives the product.
+POSTCONDITION
+  - Multiplies the matrices with SUMMA (see matrix_multiplyDistributed) into a new distributed matrix.
+  - Returns SUCCESS, else FAILURE for any memory allocation failure or if the transport fails.
+*/
+static Status multiplySumma(const DistributedMatrix* pA, const DistributedMatrix* pB, DistributedMatrix** ppProduct);
+
+
+/*
+PRECONDITION
+  - pTransport is a pointer to an open transport.
+  - The processes first + i * stride for i from 0 to count - 1 call this with the same owner, one of them.
+  - data is an array of bytes bytes, holding what to send on the owner.
+POSTCONDITION
+  - The owner sends the data to the other processes, which receive it into data.
+  - Returns SUCCESS, else FAILURE if the transport fails.
+*/
+static Status broadcast(const MatrixTransport* pTransport, int owner, int first, int stride, int count, void* data,
+	size_t bytes);
+
+
+/*
+PRECONDITION
+  - processes >= 1.
+  - pRows/pColumns are pointers to the variables that receive the dimensions of the grid.
+POSTCONDITION
+  - Works out the grid of the processes, the one with the most rows that's no taller than it's wide.
+*/
+static void gridShape(int processes, int* pRows, int* pColumns);
+
+
+/*
+PRECONDITION
+  - n is the rows (or columns) of a matrix split into blocks of blockSize, dealt out to parts processes in turn.
+  - part is in the range [0, parts).
+POSTCONDITION
+  - Returns the number of rows the process part holds, which may be 0.
+*/
+static size_t localSize(size_t n, size_t blockSize, int parts, int part);
+
+
+/*
+PRECONDITION
+  - local is a local row (or column) of the process part, of blocks of blockSize dealt out to parts processes.
+POSTCONDITION
+  - Returns the row of the matrix it is.
+*/
+static size_t globalIndex(size_t local, size_t blockSize, int parts, int part);
+
+
+/*
+PRECONDITION
+  - pMatrix is a pointer to a valid matrix object and row is in bounds.
+  - entries is an array of localSize(columns, blockSize, parts, part) long doubles.
+POSTCONDITION
+  - packRow copies the entries of the row in the columns the process part holds into entries, in their local order.
+    unpackRow copies them back into the row.
+*/
+static void packRow(const Matrix* pMatrix, size_t row, size_t blockSize, int parts, int part, long double* entries);
+static void unpackRow(Matrix* pMatrix, size_t row, size_t blockSize, int parts, int part, const long double* entries);
+
+
+
+
+/***** Functions defined in Matrix.h *****/
+MATRIX_DISTRIBUTED matrix_initDistributed(const MatrixTransport* pTransport, size_t rows, size_t columns, size_t blockSize) {
+	if (!rows || !columns || !blockSize)
+		return NULL;
+
+	return createDistributed(pTransport, rows, columns, blockSize);
+}
+
+
+
+MATRIX_DISTRIBUTED matrix_distribute(const MatrixTransport* pTransport, MATRIX hMatrix, int root, size_t blockSize) {
+	Matrix* pMatrix = hMatrix;
+	int rank = pTransport->rank;
+	if (root < 0 || root >= pTransport->processes)
+		return NULL;
+
+	// the root sends the dimensions first, 0 rows if it can't send the matrix so the others give up too
+	DistributeHeader header = { 0, 0, 0 };
+	Status status = SUCCESS;
+	if (rank == root) {
+		if (pMatrix && blockSize) {
+			header.rows = pMatrix->rows;
+			header.columns = pMatrix->columns;
+			header.blockSize = blockSize;
+		}
+		for (int process = 0; status && process < pTransport->processes; ++process) {
+			if (process != root)
+				status = pTransport->send(process, &header, sizeof(header), pTransport->context);
+		}
+	}
+	else
+		status = pTransport->receive(root, &header, sizeof(header), pTransport->context);
+	if (!status || !header.rows)
+		return NULL;
+
+	DistributedMatrix* pDistributed = createDistributed(pTransport, header.rows, header.columns, header.blockSize);
+	if (!pDistributed)
+		return NULL;
+	if (rank != root) {
+		status = pTransport->receive(root, pDistributed->local,
+			pDistributed->localRows * pDistributed->localColumns * sizeof(long double), pTransport->context);
+		if (!status)
+			matrix_destroyDistributed((MATRIX_DISTRIBUTED*)&pDistributed);
+		return pDistributed;
+	}
+
+	// each process gets its local array a row at a time, packed from the matrix in any layout.
+	// grid column 0 holds the most columns.
+	int gridRows = pDistributed->gridRows;
+	int gridColumns = pDistributed->gridColumns;
+	long double* entries = allocateMemory((localSize(header.columns, blockSize, gridColumns, 0) + 1) * sizeof(long double));
+	if (!entries) {
+		matrix_destroyDistributed((MATRIX_DISTRIBUTED*)&pDistributed);
+		return NULL;
+	}
+	for (int process = 0; status && process < pTransport->processes; ++process) {
+		int gridRow = process / gridColumns;
+		int gridColumn = process % gridColumns;
+		size_t localRows = localSize(header.rows, blockSize, gridRows, gridRow);
+		size_t localColumns = localSize(header.columns, blockSize, gridColumns, gridColumn);
+		for (size_t i = 0; status && i < localRows; ++i) {
+			size_t row = globalIndex(i, blockSize, gridRows, gridRow);
+			if (process == root)
+				packRow(pMatrix, row, blockSize, gridColumns, gridColumn, pDistributed->local + i * localColumns);
+			else {
+				packRow(pMatrix, row, blockSize, gridColumns, gridColumn, entries);
+				status = pTransport->send(process, entries, localColumns * sizeof(long double), pTransport->context);
+			}
+		}
+	}
+	freeMemory(entries);
+	if (!status)
+		matrix_destroyDistributed((MATRIX_DISTRIBUTED*)&pDistributed);
+
+	return pDistributed;
+}
+
+
+
+void matrix_fillDistributed(MATRIX_DISTRIBUTED hDistributed, long double (*entry)(size_t row, size_t column, void* pContext),
+	void* pContext) {
+	DistributedMatrix* pDistributed = hDistributed;
+
+	for (size_t i = 0; i < pDistributed->localRows; ++i) {
+		size_t row = globalIndex(i, pDistributed->blockSize, pDistributed->gridRows, pDistributed->gridRow);
+		long double* localRow = pDistributed->local + i * pDistributed->localColumns;
+		for (size_t j = 0; j < pDistributed->localColumns; ++j) {
+			size_t column = globalIndex(j, pDistributed->blockSize, pDistributed->gridColumns, pDistributed->gridColumn);
+			localRow[j] = entry(row, column, pContext);
+		}
+	}
+}
+
+
+
+Status matrix_collect(MATRIX_DISTRIBUTED hDistributed, int root, MATRIX* phResult) {
+	DistributedMatrix* pDistributed = hDistributed;
+	const MatrixTransport* pTransport = &pDistributed->transport;
+	if (root < 0 || root >= pTransport->processes)
+		return FAILURE;
+
+	// the stream from each process is its whole local array, which the root takes a row at a time
+	if (pTransport->rank != root) {
+		return pTransport->send(root, pDistributed->local,
+			pDistributed->localRows * pDistributed->localColumns * sizeof(long double), pTransport->context);
+	}
+
+	if (!adjustMatrixDimensions((Matrix**)phResult, pDistributed->rows, pDistributed->columns))
+		return FAILURE;
+	Matrix* pResult = *phResult;
+	int gridRows = pDistributed->gridRows;
+	int gridColumns = pDistributed->gridColumns;
+	size_t blockSize = pDistributed->blockSize;
+	long double* entries = allocateMemory((localSize(pDistributed->columns, blockSize, gridColumns, 0) + 1) *
+		sizeof(long double));
+	if (!entries)
+		return FAILURE;
+
+	Status status = SUCCESS;
+	for (int process = 0; status && process < pTransport->processes; ++process) {
+		int gridRow = process / gridColumns;
+		int gridColumn = process % gridColumns;
+		size_t localRows = localSize(pDistributed->rows, blockSize, gridRows, gridRow);
+		size_t localColumns = localSize(pDistributed->columns, blockSize, gridColumns, gridColumn);
+		for (size_t i = 0; status && i < localRows; ++i) {
+			size_t row = globalIndex(i, blockSize, gridRows, gridRow);
+			if (process == root)
+				unpackRow(pResult, row, blockSize, gridColumns, gridColumn, pDistributed->local + i * localColumns);
+			else {
+				status = pTransport->receive(process, entries, localColumns * sizeof(long double), pTransport->context);
+				if (status)
+					unpackRow(pResult, row, blockSize, gridColumns, gridColumn, entries);
+			}
+		}
+	}
+	freeMemory(entries);
+	pResult->maxLength = 0;
+
+	return status;
+}
+
+
+
+Status matrix_multiplyDistributed(MATRIX_DISTRIBUTED hA, MATRIX_DISTRIBUTED hB, MATRIX_DISTRIBUTED* phResult) {
+	DistributedMatrix* pA = hA;
+	DistributedMatrix* pB = hB;
+	if (pA->transport.context != pB->transport.context || pA->transport.rank != pB->transport.rank ||
+		pA->blockSize != pB->blockSize || pA->columns != pB->rows)
+		return FAILURE;
+
+	// the statistics count the part of the product this process works out
+	double flops = 2.0 * pA->localRows * pB->localColumns * pA->columns;
+	DistributedMatrix* pProduct;
+	MeasuredCall call;
+
+	beginCall(&call, MATRIX_OPERATION_MULTIPLY_DISTRIBUTED, NULL);
+	Status status = multiplySumma(pA, pB, &pProduct);
+	endCall(&call, status ? flops : 0);
+	if (!status)
+		return FAILURE;
+
+	// the old result is only destroyed now, since it may be one of the operands
+	matrix_destroyDistributed(phResult);
+	*phResult = pProduct;
+
+	return SUCCESS;
+}
+
+
+
+void matrix_destroyDistributed(MATRIX_DISTRIBUTED* phDistributed) {
+	DistributedMatrix* pDistributed = *phDistributed;
+	if (!pDistributed)
+		return;
+
+	freeMemory(pDistributed->local);
+	freeMemory(pDistributed);
+	*phDistributed = NULL;
+}
+
+
+
+
+/***** Helper functions used only in this file *****/
+static DistributedMatrix* createDistributed(const MatrixTransport* pTransport, size_t rows, size_t columns, size_t blockSize) {
+	DistributedMatrix* pDistributed = allocateMemory(sizeof(*pDistributed));
+	if (!pDistributed)
+		return NULL;
+
+	pDistributed->transport = *pTransport;
+	pDistributed->rows = rows;
+	pDistributed->columns = columns;
+	pDistributed->blockSize = blockSize;
+	gridShape(pTransport->processes, &pDistributed->gridRows, &pDistributed->gridColumns);
+	pDistributed->gridRow = pTransport->rank / pDistributed->gridColumns;
+	pDistributed->gridColumn = pTransport->rank % pDistributed->gridColumns;
+	pDistributed->localRows = localSize(rows, blockSize, pDistributed->gridRows, pDistributed->gridRow);
+	pDistributed->localColumns = localSize(columns, blockSize, pDistributed->gridColumns, pDistributed->gridColumn);
+
+	// a process may hold no blocks when there are more processes than blocks, but it still gets an array
+	size_t localRows = pDistributed->localRows;
+	size_t localColumns = pDistributed->localColumns;
+	pDistributed->local = NULL;
+	if (!localColumns || localRows <= (SIZE_MAX - 1) / localColumns)
+		pDistributed->local = allocateZeroedMemory(localRows * localColumns + 1, sizeof(long double));
+	if (!pDistributed->local) {
+		freeMemory(pDistributed);
+		return NULL;
+	}
+
+	return pDistributed;
+}
+
+
+
+static Status multiplySumma(const DistributedMatrix* pA, const DistributedMatrix* pB, DistributedMatrix** ppProduct) {
+	const MatrixTransport* pTransport = &pA->transport;
+	size_t blockSize = pA->blockSize;
+	size_t m = pA->localRows;
+	size_t n = pB->localColumns;
+	int gridRow = pA->gridRow;
+	int gridColumn = pA->gridColumn;
+	int gridRows = pA->gridRows;
+	int gridColumns = pA->gridColumns;
+
+	// the panels of A and B this process gets at each step, which are at most a block wide/tall
+	DistributedMatrix* pProduct = createDistributed(pTransport, pA->rows, pB->columns, blockSize);
+	long double* panelA = allocateMemory((m * blockSize + 1) * sizeof(long double));
+	long double* panelB = allocateMemory((blockSize * n + 1) * sizeof(long double));
+	if (!pProduct || !panelA || !panelB) {
+		matrix_destroyDistributed((MATRIX_DISTRIBUTED*)&pProduct);
+		freeMemory(panelA);
+		freeMemory(panelB);
+		return FAILURE;
+	}
+
+	Status status = SUCCESS;
+	size_t steps = (pA->columns + blockSize - 1) / blockSize;
+	for (size_t k = 0; status && k < steps; ++k) {
+		size_t width = (pA->columns - k * blockSize < blockSize) ? pA->columns - k * blockSize : blockSize;
+		int ownerColumn = (int)(k % gridColumns);
+		int ownerRow = (int)(k % gridRows);
+		TraceSpan span;
+
+		// block column k of A goes along each grid row from the grid column holding it
+		beginSpan(&span, "summaBroadcast", m, n);
+		if (gridColumn == ownerColumn) {
+			const long double* columnsA = pA->local + k / gridColumns * blockSize;
+			for (size_t i = 0; i < m; ++i)
+				memcpy(panelA + i * width, columnsA + i * pA->localColumns, width * sizeof(long double));
+		}
+		status = broadcast(pTransport, gridRow * gridColumns + ownerColumn, gridRow * gridColumns, 1, gridColumns,
+			panelA, m * width * sizeof(long double));
+
+		// block row k of B goes along each grid column from the grid row holding it. Its local rows are contiguous, so
+		// the process holding it uses them where they are.
+		long double* rowsB = (gridRow == ownerRow) ? pB->local + k / gridRows * blockSize * n : panelB;
+		if (status) {
+			status = broadcast(pTransport, ownerRow * gridColumns + gridColumn, gridColumn, gridColumns, gridRows,
+				rowsB, width * n * sizeof(long double));
+		}
+		endSpan(&span);
+
+		// the steps run in order, so each entry of the product adds up its terms in the same order as matrix_multiply
+		if (status && m && n) {
+			beginSpan(&span, "summaUpdate", m, n);
+			multiplyKernel(FALSE, FALSE, m, n, width, 1, panelA, width, rowsB, n, 1, pProduct->local, n);
+			endSpan(&span);
+		}
+	}
+	freeMemory(panelA);
+	freeMemory(panelB);
+	if (!status) {
+		matrix_destroyDistributed((MATRIX_DISTRIBUTED*)&pProduct);
+		return FAILURE;
+	}
+	*ppProduct = pProduct;
+
+	return SUCCESS;
+}
+
+
+
+static Status broadcast(const MatrixTransport* pTransport, int owner, int first, int stride, int count, void* data,
+	size_t bytes) {
+	if (count == 1 || !bytes)
+		return SUCCESS;
+	if (pTransport->rank != owner)
+		return pTransport->receive(owner, data, bytes, pTransport->context);
+
+	for (int i = 0; i < count; ++i) {
+		int process = first + i * stride;
+		if (process != owner && !pTransport->send(process, data, bytes, pTransport->context))
+			return FAILURE;
+	}
+
+	return SUCCESS;
+}
+
+
+
+static void gridShape(int processes, int* pRows, int* pColumns) {
+	int rows = 1;
+
+	while ((rows + 1) * (rows + 1) <= processes)
+		++rows;
+	while (processes % rows)
+		--rows;
+	*pRows = rows;
+	*pColumns = processes / rows;
+}
+
+
+
+static size_t localSize(size_t n, size_t blockSize, int parts, int part) {
+	size_t blocks = (n + blockSize - 1) / blockSize;
+	if ((size_t)part >= blocks)
+		return 0;
+
+	// the process holds blocks part, part + parts, ..., and the last block of the matrix may be short
+	size_t size = ((blocks - 1 - part) / parts + 1) * blockSize;
+	if ((blocks - 1) % parts == (size_t)part)
+		size -= blocks * blockSize - n;
+
+	return size;
+}
+
+
+
+static size_t globalIndex(size_t local, size_t blockSize, int parts, int part) {
+	return (local / blockSize * parts + part) * blockSize + local % blockSize;
+}
+
+
+
+static void packRow(const Matrix* pMatrix, size_t row, size_t blockSize, int parts, int part, long double* entries) {
+	size_t count = 0;
+
+	for (size_t first = part * blockSize; first < pMatrix->columns; first += parts * blockSize) {
+		size_t end = (pMatrix->columns - first < blockSize) ? pMatrix->columns : first + blockSize;
+		for (size_t column = first; column < end; ++column)
+			entries[count++] = pMatrix->matrix[matrixIndex(pMatrix, row, column)];
+	}
+}
+
+
+
+static void unpackRow(Matrix* pMatrix, size_t row, size_t blockSize, int parts, int part, const long double* entries) {
+	size_t count = 0;
+
+	for (size_t first = part * blockSize; first < pMatrix->columns; first += parts * blockSize) {
+		size_t end = (pMatrix->columns - first < blockSize) ? pMatrix->columns : first + blockSize;
+		for (size_t column = first; column < end; ++column)
+			pMatrix->matrix[matrixIndex(pMatrix, row, column)] = entries[count++];
+	}
+}
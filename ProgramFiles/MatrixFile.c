@@ -0,0 +1,713 @@
+/*
+  Author: Benjamin G. Friedman
+  Date: 10/18/2026
+  File: MatrixFile.c
+  Description:
+	  - Implementation file for saving matrix objects to files and loading them back.
+	  - The native format is a FILE_HEADER_SIZE byte header followed by the storage array exactly as it is in memory,
+		starting on a page boundary, so loading maps the file instead of parsing or copying it:
+			offset  0: magic "LDMATRIX"
+			offset  8: uint32 version, byte order marker, element size, element mantissa digits, layout
+			offset 28: int32 max length of the entries
+			offset 32: uint64 rows, columns, offset of the entries, checksum of the entries
+	  - NumPy .npy files are also supported so matrices can be exchanged with Python. Arrays of long doubles in this
+		machine's format (numpy.longdouble) are mapped without copying like native files, float64 and float32 arrays are
+		converted as they're read.
+*/
+
+
+#define _DEFAULT_SOURCE        // pread/pwrite, fsync and madvise
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <float.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "MatrixInternal.h"
+
+
+#define FILE_MAGIC "LDMATRIX"          // first 8 bytes of every matrix file
+#define FILE_VERSION 1                 // version of the format written by matrix_save
+#define FILE_BYTE_ORDER 0x01020304     // reads back differently on a machine with the other byte order
+#define FILE_HEADER_SIZE 64            // bytes of the header that are used
+#define FILE_DATA_OFFSET 4096          // the entries start on a page boundary so they can be mapped directly
+#define NPY_MAGIC "\x93NUMPY"          // first 6 bytes of every .npy file
+#define NPY_PREFIX_SIZE 10             // magic, version and header length of a version 1.0 file
+#define NPY_ALIGNMENT 64               // the prefix and header are padded to a multiple of this, as NumPy does
+#define NPY_HEADER_MAX 65536           // longest header that's read, NumPy's own limit for reading untrusted files
+
+
+
+
+/***** Structures *****/
+typedef struct fileHeader {
+	char magic[8];
+	uint32_t version;
+	uint32_t byteOrder;
+	uint32_t elementSize;          // sizeof(long double) on the machine that saved the file
+	uint32_t elementDigits;        // LDBL_MANT_DIG, which tells apart long double formats of the same size
+	uint32_t layout;
+	int32_t maxLength;             // saved so loading doesn't have to look at every entry
+	uint64_t rows;
+	uint64_t columns;
+	uint64_t dataOffset;
+	uint64_t checksum;
+} FileHeader;
+
+_Static_assert(sizeof(FileHeader) == FILE_HEADER_SIZE, "the header is written to the file as is");
+
+
+typedef struct npyHeader {
+	char type;                     // 'f' for floating point, anything else isn't supported
+	size_t elementSize;            // bytes of each element
+	Boolean fortranOrder;          // the array is stored in column-major order
+	size_t rows;                   // 1-D arrays are a column and 0-D arrays a single entry
+	size_t columns;
+} NpyHeader;
+
+
+
+
+/***** Helper functions used only in this file *****/
+/*
+PRECONDITION
+  - pA/pB are pointers to the two running sums of the checksum, both 0 before the first call.
+  - data is an array of bytes bytes, a multiple of 8.
+POSTCONDITION
+  - Adds the data to the running sums of a Fletcher style checksum over 64-bit words. It only costs an add per word,
+	so computing it keeps up with the disk.
+*/
+static void updateChecksum(uint64_t* pA, uint64_t* pB, const void* data, size_t bytes);
+
+
+/*
+PRECONDITION
+  - a/b are the running sums of the checksum after all of the data has been added.
+POSTCONDITION
+  - Returns the checksum.
+*/
+static uint64_t finishChecksum(uint64_t a, uint64_t b);
+
+
+/*
+PRECONDITION
+  - fd is a file descriptor open for writing.
+  - data is an array of bytes bytes to be written at the given offset of the file.
+POSTCONDITION
+  - Writes all of the data, retrying after partial writes and interruptions, and returns SUCCESS, else FAILURE.
+*/
+static Status writeAll(int fd, const void* data, size_t bytes, off_t offset);
+
+
+/*
+PRECONDITION
+  - pHeader is a pointer to a header read from a file of fileSize bytes.
+POSTCONDITION
+  - Returns TRUE if the header is a matrix file this machine can map as the storage array of a matrix, else FALSE.
+*/
+static Boolean headerIsValid(const FileHeader* pHeader, off_t fileSize);
+
+
+/*
+PRECONDITION
+  - fd is a file descriptor open for reading.
+  - data is an array of at least bytes bytes.
+POSTCONDITION
+  - Reads bytes bytes from the given offset of the file, retrying after partial reads and interruptions, and returns
+    SUCCESS, else FAILURE (including if the file ends first).
+*/
+static Status readAll(int fd, void* data, size_t bytes, off_t offset);
+
+
+/*
+PRECONDITION
+  - none
+POSTCONDITION
+  - Returns the character NumPy uses for the byte order of this machine in a type description, '<' or '>'.
+*/
+static char npyByteOrder(void);
+
+
+/*
+PRECONDITION
+  - header is the NUL terminated header of a .npy file, a Python dictionary literal such as
+    {'descr': '<f8', 'fortran_order': False, 'shape': (3, 4), }
+  - pHeader is a pointer to the header that receives the description of the array.
+POSTCONDITION
+  - Returns TRUE, else FALSE if any of the keys is missing or its value isn't valid. The type isn't checked.
+*/
+static Boolean parseNpyHeader(const char* header, NpyHeader* pHeader);
+
+
+/*
+PRECONDITION
+  - header is the NUL terminated header of a .npy file.
+  - key is the key to look for, including its quotes.
+POSTCONDITION
+  - Returns a pointer to the first character of the key's value after the colon and any spaces, else NULL if the key
+    isn't in the header.
+*/
+static const char* npyValue(const char* header, const char* key);
+
+
+
+/*
+PRECONDITION
+  - The same as matrix_save.
+POSTCONDITION
+  - Saves the matrix the same as matrix_save, without measuring the call.
+*/
+static Status saveMatrix(MATRIX hMatrix, const char* path);
+
+
+/*
+PRECONDITION
+  - The same as matrix_load.
+POSTCONDITION
+  - Loads the matrix the same as matrix_load, without measuring the call.
+*/
+static MATRIX loadMatrix(const char* path, Boolean verifyChecksum);
+
+
+/*
+PRECONDITION
+  - The same as matrix_saveNpy.
+POSTCONDITION
+  - Saves the matrix the same as matrix_saveNpy, without measuring the call.
+*/
+static Status saveNpy(MATRIX hMatrix, const char* path, MatrixNpyType type);
+
+
+/*
+PRECONDITION
+  - The same as matrix_loadNpy.
+POSTCONDITION
+  - Loads the matrix the same as matrix_loadNpy, without measuring the call.
+*/
+static MATRIX loadNpy(const char* path);
+
+
+
+/***** Functions defined in Matrix.h *****/
+Status matrix_save(MATRIX hMatrix, const char* path) {
+	MeasuredCall call;
+
+	beginCall(&call, MATRIX_OPERATION_SAVE, hMatrix);
+	Status status = saveMatrix(hMatrix, path);
+	endCall(&call, 0);
+
+	return status;
+}
+
+
+
+MATRIX matrix_load(const char* path, Boolean verifyChecksum) {
+	MeasuredCall call;
+
+	beginCall(&call, MATRIX_OPERATION_LOAD, NULL);
+	MATRIX hMatrix = loadMatrix(path, verifyChecksum);
+	endCall(&call, 0);
+
+	return hMatrix;
+}
+
+
+
+Status matrix_saveNpy(MATRIX hMatrix, const char* path, MatrixNpyType type) {
+	MeasuredCall call;
+
+	beginCall(&call, MATRIX_OPERATION_SAVE_NPY, hMatrix);
+	Status status = saveNpy(hMatrix, path, type);
+	endCall(&call, 0);
+
+	return status;
+}
+
+
+
+MATRIX matrix_loadNpy(const char* path) {
+	MeasuredCall call;
+
+	beginCall(&call, MATRIX_OPERATION_LOAD_NPY, NULL);
+	MATRIX hMatrix = loadNpy(path);
+	endCall(&call, 0);
+
+	return hMatrix;
+}
+
+
+
+
+/***** Helper functions used only in this file *****/
+static void updateChecksum(uint64_t* pA, uint64_t* pB, const void* data, size_t bytes) {
+	const unsigned char* pByte = data;
+	uint64_t a = *pA;
+	uint64_t b = *pB;
+	uint64_t word;
+
+	for (size_t i = 0; i < bytes; i += sizeof(word)) {
+		memcpy(&word, pByte + i, sizeof(word));
+		a += word;
+		b += a;
+	}
+	*pA = a;
+	*pB = b;
+}
+
+
+
+static uint64_t finishChecksum(uint64_t a, uint64_t b) {
+	return b ^ ((a << 32) | (a >> 32));
+}
+
+
+
+static Status writeAll(int fd, const void* data, size_t bytes, off_t offset) {
+	const char* pByte = data;
+
+	while (bytes > 0) {
+		ssize_t written = pwrite(fd, pByte, bytes, offset);
+		if (written < 0) {
+			if (errno == EINTR)
+				continue;
+			return FAILURE;
+		}
+		pByte += written;
+		bytes -= (size_t)written;
+		offset += written;
+	}
+
+	return SUCCESS;
+}
+
+
+
+static Boolean headerIsValid(const FileHeader* pHeader, off_t fileSize) {
+	if (memcmp(pHeader->magic, FILE_MAGIC, sizeof(pHeader->magic)) || pHeader->version != FILE_VERSION
+		|| pHeader->byteOrder != FILE_BYTE_ORDER || pHeader->elementSize != sizeof(long double)
+		|| pHeader->elementDigits != LDBL_MANT_DIG)
+		return FALSE;
+	if (pHeader->layout > MATRIX_TILED || pHeader->maxLength < 0 || pHeader->rows == 0 || pHeader->columns == 0
+		|| (size_t)pHeader->rows != pHeader->rows || (size_t)pHeader->columns != pHeader->columns)
+		return FALSE;
+
+	// the entries have to be aligned for long double and fit in the file
+	size_t matrixSize = storageSize(pHeader->rows, pHeader->columns, pHeader->layout);
+	if (matrixSize == 0 || pHeader->dataOffset < FILE_HEADER_SIZE || pHeader->dataOffset % sizeof(long double) != 0)
+		return FALSE;
+
+	return (uint64_t)fileSize >= pHeader->dataOffset && (uint64_t)fileSize - pHeader->dataOffset >= matrixSize * sizeof(long double);
+}
+
+
+
+
+static Status readAll(int fd, void* data, size_t bytes, off_t offset) {
+	char* pByte = data;
+
+	while (bytes > 0) {
+		ssize_t bytesRead = pread(fd, pByte, bytes, offset);
+		if (bytesRead <= 0) {
+			if (bytesRead < 0 && errno == EINTR)
+				continue;
+			return FAILURE;
+		}
+		pByte += bytesRead;
+		bytes -= (size_t)bytesRead;
+		offset += bytesRead;
+	}
+
+	return SUCCESS;
+}
+
+
+
+static char npyByteOrder(void) {
+	const uint16_t one = 1;
+
+	return *(const unsigned char*)&one ? '<' : '>';
+}
+
+
+
+static Boolean parseNpyHeader(const char* header, NpyHeader* pHeader) {
+	const char* pValue;
+	size_t shape[2] = { 1, 1 };
+	int dimensions = 0;
+
+	// 'descr': '<f8' - the byte order has to be this machine's, or '|' / '=' which don't depend on it
+	if (!(pValue = npyValue(header, "'descr'")) || (*pValue != '\'' && *pValue != '"'))
+		return FALSE;
+	++pValue;
+	if (*pValue != npyByteOrder() && *pValue != '|' && *pValue != '=')
+		return FALSE;
+	pHeader->type = *++pValue;
+	pHeader->elementSize = 0;
+	while (*++pValue >= '0' && *pValue <= '9' && pHeader->elementSize < 1024)
+		pHeader->elementSize = pHeader->elementSize * 10 + (size_t)(*pValue - '0');
+	if (*pValue != '\'' && *pValue != '"')
+		return FALSE;
+
+	// 'fortran_order': False
+	if (!(pValue = npyValue(header, "'fortran_order'")))
+		return FALSE;
+	if (!strncmp(pValue, "True", 4))
+		pHeader->fortranOrder = TRUE;
+	else if (!strncmp(pValue, "False", 5))
+		pHeader->fortranOrder = FALSE;
+	else
+		return FALSE;
+
+	// 'shape': (3, 4) - a tuple of up to 2 positive sizes
+	if (!(pValue = npyValue(header, "'shape'")) || *pValue++ != '(')
+		return FALSE;
+	for (;;) {
+		while (*pValue == ' ')
+			++pValue;
+		if (*pValue == ')')
+			break;
+		if (dimensions == 2 || *pValue < '0' || *pValue > '9')
+			return FALSE;
+		size_t size = 0;
+		for (; *pValue >= '0' && *pValue <= '9'; ++pValue) {
+			if (size > (SIZE_MAX - 9) / 10)
+				return FALSE;
+			size = size * 10 + (size_t)(*pValue - '0');
+		}
+		if (size == 0)
+			return FALSE;
+		shape[dimensions++] = size;
+		while (*pValue == ' ')
+			++pValue;
+		if (*pValue == ',')
+			++pValue;
+		else if (*pValue != ')')
+			return FALSE;
+	}
+	pHeader->rows = shape[0];
+	pHeader->columns = shape[1];
+
+	return TRUE;
+}
+
+
+
+static const char* npyValue(const char* header, const char* key) {
+	const char* pValue = strstr(header, key);
+
+	if (!pValue)
+		return NULL;
+	pValue += strlen(key);
+	while (*pValue == ' ')
+		++pValue;
+	if (*pValue++ != ':')
+		return NULL;
+	while (*pValue == ' ')
+		++pValue;
+
+	return pValue;
+}
+
+
+
+static Status saveMatrix(MATRIX hMatrix, const char* path) {
+	Matrix* pMatrix = hMatrix;
+	size_t matrixSize = storageSize(pMatrix->rows, pMatrix->columns, pMatrix->layout);
+	uint64_t a = 0, b = 0;             // running sums of the checksum
+	FileHeader header;
+	char* tempPath;                    // the file is written next to its final path and renamed over it when it's complete
+	int fd;
+
+	if (!(tempPath = allocateMemory(strlen(path) + sizeof(".tmp"))))
+		return FAILURE;
+	sprintf(tempPath, "%s.tmp", path);
+	if ((fd = open(tempPath, O_WRONLY | O_CREAT | O_TRUNC, 0644)) < 0) {
+		freeMemory(tempPath);
+		return FAILURE;
+	}
+
+	// write the entries a chunk at a time, checksumming each chunk while it's still in the cache
+	Status status = SUCCESS;
+	for (size_t chunk = 0; status && chunk < matrixSize; chunk += STREAM_CHUNK_SIZE) {
+		size_t chunkEnd = (matrixSize - chunk < STREAM_CHUNK_SIZE) ? matrixSize : chunk + STREAM_CHUNK_SIZE;
+		size_t bytes = (chunkEnd - chunk) * sizeof(*pMatrix->matrix);
+		updateChecksum(&a, &b, pMatrix->matrix + chunk, bytes);
+		status = writeAll(fd, pMatrix->matrix + chunk, bytes, (off_t)(FILE_DATA_OFFSET + chunk * sizeof(*pMatrix->matrix)));
+		releaseSpan(pMatrix, chunk, chunkEnd);
+	}
+
+	// the header goes in last, once the checksum is known
+	if (status) {
+		memset(&header, 0, sizeof(header));
+		memcpy(header.magic, FILE_MAGIC, sizeof(header.magic));
+		header.version = FILE_VERSION;
+		header.byteOrder = FILE_BYTE_ORDER;
+		header.elementSize = sizeof(long double);
+		header.elementDigits = LDBL_MANT_DIG;
+		header.layout = pMatrix->layout;
+		header.maxLength = pMatrix->maxLength;
+		header.rows = pMatrix->rows;
+		header.columns = pMatrix->columns;
+		header.dataOffset = FILE_DATA_OFFSET;
+		header.checksum = finishChecksum(a, b);
+		status = writeAll(fd, &header, sizeof(header), 0);
+	}
+	if (status && fsync(fd))
+		status = FAILURE;
+	if (close(fd))
+		status = FAILURE;
+	if (status && rename(tempPath, path))
+		status = FAILURE;
+	if (!status)
+		unlink(tempPath);
+	freeMemory(tempPath);
+
+	return status;
+}
+
+
+
+static MATRIX loadMatrix(const char* path, Boolean verifyChecksum) {
+	FileHeader header;
+	struct stat fileStatus;
+	Matrix* pMatrix;
+	int fd;
+
+	if ((fd = open(path, O_RDONLY)) < 0)
+		return NULL;
+	if (fstat(fd, &fileStatus) || pread(fd, &header, sizeof(header), 0) != sizeof(header)
+		|| !headerIsValid(&header, fileStatus.st_size)) {
+		close(fd);
+		return NULL;
+	}
+
+	// a private mapping of the whole file - changes to the matrix stay in memory and never reach the file
+	size_t mappingBytes = header.dataOffset + storageSize(header.rows, header.columns, header.layout) * sizeof(long double);
+	void* mapping = mmap(NULL, mappingBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (mapping == MAP_FAILED)
+		return NULL;
+
+	if (!(pMatrix = allocateMemory(sizeof(*pMatrix)))) {
+		munmap(mapping, mappingBytes);
+		return NULL;
+	}
+	pMatrix->matrix = (long double*)((char*)mapping + header.dataOffset);
+	pMatrix->rows = header.rows;
+	pMatrix->columns = header.columns;
+	pMatrix->maxLength = header.maxLength;
+	pMatrix->layout = header.layout;
+	pMatrix->fd = -1;
+	pMatrix->mapping = mapping;
+	pMatrix->mappingBytes = mappingBytes;
+
+	// checking the checksum reads the whole file once, so the kernel is told to read ahead aggressively while it does
+	if (verifyChecksum) {
+		uint64_t a = 0, b = 0;
+		madvise(mapping, mappingBytes, MADV_SEQUENTIAL);
+		updateChecksum(&a, &b, pMatrix->matrix, mappingBytes - header.dataOffset);
+		madvise(mapping, mappingBytes, MADV_NORMAL);
+		if (finishChecksum(a, b) != header.checksum) {
+			freeStorage(pMatrix);
+			freeMemory(pMatrix);
+			return NULL;
+		}
+	}
+
+	return pMatrix;
+}
+
+
+
+static Status saveNpy(MATRIX hMatrix, const char* path, MatrixNpyType type) {
+	Matrix* pMatrix = hMatrix;
+	size_t matrixSize = pMatrix->rows * pMatrix->columns;
+	size_t elementSize = (type == MATRIX_NPY_LONG_DOUBLE) ? sizeof(long double) : sizeof(double);
+	char header[NPY_PREFIX_SIZE + 256];
+	char* tempPath;
+	int fd;
+
+	// the dictionary is padded with spaces so the entries start on a multiple of NPY_ALIGNMENT
+	int length = sprintf(header + NPY_PREFIX_SIZE, "{'descr': '%cf%zu', 'fortran_order': %s, 'shape': (%zu, %zu), }",
+		npyByteOrder(), elementSize, (pMatrix->layout == MATRIX_COLUMN_MAJOR) ? "True" : "False", pMatrix->rows, pMatrix->columns);
+	size_t headerSize = (NPY_PREFIX_SIZE + (size_t)length + 1 + NPY_ALIGNMENT - 1) / NPY_ALIGNMENT * NPY_ALIGNMENT;
+	memset(header + NPY_PREFIX_SIZE + length, ' ', headerSize - NPY_PREFIX_SIZE - (size_t)length - 1);
+	header[headerSize - 1] = '\n';
+	memcpy(header, NPY_MAGIC, 6);
+	header[6] = 1;
+	header[7] = 0;
+	header[8] = (char)((headerSize - NPY_PREFIX_SIZE) & 0xFF);
+	header[9] = (char)((headerSize - NPY_PREFIX_SIZE) >> 8);
+
+	if (!(tempPath = allocateMemory(strlen(path) + sizeof(".tmp"))))
+		return FAILURE;
+	sprintf(tempPath, "%s.tmp", path);
+	if ((fd = open(tempPath, O_WRONLY | O_CREAT | O_TRUNC, 0644)) < 0) {
+		freeMemory(tempPath);
+		return FAILURE;
+	}
+	Status status = writeAll(fd, header, headerSize, 0);
+
+	if (type == MATRIX_NPY_LONG_DOUBLE && pMatrix->layout != MATRIX_TILED) {
+		// the storage array is already in the file's order
+		for (size_t chunk = 0; status && chunk < matrixSize; chunk += STREAM_CHUNK_SIZE) {
+			size_t chunkEnd = (matrixSize - chunk < STREAM_CHUNK_SIZE) ? matrixSize : chunk + STREAM_CHUNK_SIZE;
+			status = writeAll(fd, pMatrix->matrix + chunk, (chunkEnd - chunk) * elementSize,
+				(off_t)(headerSize + chunk * elementSize));
+			releaseSpan(pMatrix, chunk, chunkEnd);
+		}
+	}
+	else {
+		// the entries are converted a chunk at a time in the storage order, or row-major order for the tiled layout
+		char* buffer = allocateZeroedMemory(STREAM_CHUNK_SIZE, elementSize);
+		size_t row = 0, column = 0;
+		if (!buffer)
+			status = FAILURE;
+		for (size_t chunk = 0; status && chunk < matrixSize; chunk += STREAM_CHUNK_SIZE) {
+			size_t chunkEnd = (matrixSize - chunk < STREAM_CHUNK_SIZE) ? matrixSize : chunk + STREAM_CHUNK_SIZE;
+			for (size_t i = chunk; i < chunkEnd; ++i) {
+				long double n;
+				if (pMatrix->layout == MATRIX_TILED) {
+					n = pMatrix->matrix[matrixIndex(pMatrix, row, column)];
+					if (++column == pMatrix->columns) {
+						column = 0;
+						++row;
+					}
+				}
+				else
+					n = pMatrix->matrix[i];
+				if (type == MATRIX_NPY_LONG_DOUBLE)
+					((long double*)buffer)[i - chunk] = n;
+				else
+					((double*)buffer)[i - chunk] = (double)n;
+			}
+			status = writeAll(fd, buffer, (chunkEnd - chunk) * elementSize, (off_t)(headerSize + chunk * elementSize));
+			if (pMatrix->layout != MATRIX_TILED)
+				releaseSpan(pMatrix, chunk, chunkEnd);
+		}
+		freeMemory(buffer);
+	}
+
+	if (status && fsync(fd))
+		status = FAILURE;
+	if (close(fd))
+		status = FAILURE;
+	if (status && rename(tempPath, path))
+		status = FAILURE;
+	if (!status)
+		unlink(tempPath);
+	freeMemory(tempPath);
+
+	return status;
+}
+
+
+
+static MATRIX loadNpy(const char* path) {
+	unsigned char prefix[NPY_PREFIX_SIZE + 2];
+	struct stat fileStatus;
+	NpyHeader header;
+	Matrix* pMatrix = NULL;
+	char* headerText;
+	size_t headerSize;
+	size_t prefixSize;
+	int fd;
+
+	if ((fd = open(path, O_RDONLY)) < 0)
+		return NULL;
+	if (fstat(fd, &fileStatus) || !readAll(fd, prefix, sizeof(prefix), 0) || memcmp(prefix, NPY_MAGIC, 6)) {
+		close(fd);
+		return NULL;
+	}
+
+	// version 1.0 has a 2 byte header length, versions 2.0 and 3.0 a 4 byte one
+	if (prefix[6] == 1) {
+		prefixSize = NPY_PREFIX_SIZE;
+		headerSize = prefix[8] | (size_t)prefix[9] << 8;
+	}
+	else if (prefix[6] == 2 || prefix[6] == 3) {
+		prefixSize = NPY_PREFIX_SIZE + 2;
+		headerSize = prefix[8] | (size_t)prefix[9] << 8 | (size_t)prefix[10] << 16 | (size_t)prefix[11] << 24;
+	}
+	else
+		headerSize = NPY_HEADER_MAX + 1;
+	if (headerSize > NPY_HEADER_MAX || !(headerText = allocateMemory(headerSize + 1))) {
+		close(fd);
+		return NULL;
+	}
+	Boolean valid = readAll(fd, headerText, headerSize, (off_t)prefixSize) ? TRUE : FALSE;
+	headerText[headerSize] = '\0';
+	valid = valid && parseNpyHeader(headerText, &header);
+	freeMemory(headerText);
+	if (!valid) {
+		close(fd);
+		return NULL;
+	}
+
+	// only floating point arrays in this machine's byte order are supported, and they have to fit in the file
+	size_t dataOffset = prefixSize + headerSize;
+	size_t matrixSize = header.rows * header.columns;
+	if (header.type != 'f' || (header.elementSize != sizeof(long double) && header.elementSize != sizeof(double)
+		&& header.elementSize != sizeof(float)) || matrixSize / header.columns != header.rows
+		|| matrixSize > SIZE_MAX / header.elementSize || (uint64_t)fileStatus.st_size < dataOffset
+		|| (uint64_t)fileStatus.st_size - dataOffset < matrixSize * header.elementSize) {
+		close(fd);
+		return NULL;
+	}
+	MatrixLayout layout = header.fortranOrder ? MATRIX_COLUMN_MAJOR : MATRIX_ROW_MAJOR;
+
+	if (header.elementSize == sizeof(long double) && dataOffset % _Alignof(long double) == 0) {
+		// long doubles are privately mapped the same as the files of matrix_load
+		size_t mappingBytes = dataOffset + matrixSize * sizeof(long double);
+		void* mapping = mmap(NULL, mappingBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+		close(fd);
+		if (mapping == MAP_FAILED)
+			return NULL;
+		if (!(pMatrix = allocateMemory(sizeof(*pMatrix)))) {
+			munmap(mapping, mappingBytes);
+			return NULL;
+		}
+		pMatrix->matrix = (long double*)((char*)mapping + dataOffset);
+		pMatrix->rows = header.rows;
+		pMatrix->columns = header.columns;
+		pMatrix->maxLength = 0;
+		pMatrix->layout = layout;
+		pMatrix->fd = -1;
+		pMatrix->mapping = mapping;
+		pMatrix->mappingBytes = mappingBytes;
+
+		return pMatrix;
+	}
+
+	// anything else is converted into a heap matrix a chunk at a time, in the order it's stored
+	char* buffer = allocateMemory(STREAM_CHUNK_SIZE * header.elementSize);
+	if (buffer && (pMatrix = matrix_initLayout(header.rows, header.columns, layout))) {
+		for (size_t chunk = 0; chunk < matrixSize; chunk += STREAM_CHUNK_SIZE) {
+			size_t chunkEnd = (matrixSize - chunk < STREAM_CHUNK_SIZE) ? matrixSize : chunk + STREAM_CHUNK_SIZE;
+			if (!readAll(fd, buffer, (chunkEnd - chunk) * header.elementSize, (off_t)(dataOffset + chunk * header.elementSize))) {
+				freeStorage(pMatrix);
+				freeMemory(pMatrix);
+				pMatrix = NULL;
+				break;
+			}
+			for (size_t i = chunk; i < chunkEnd; ++i) {
+				if (header.elementSize == sizeof(long double))
+					pMatrix->matrix[i] = ((long double*)buffer)[i - chunk];
+				else if (header.elementSize == sizeof(double))
+					pMatrix->matrix[i] = ((double*)buffer)[i - chunk];
+				else
+					pMatrix->matrix[i] = ((float*)buffer)[i - chunk];
+			}
+		}
+		if (pMatrix)
+			pMatrix->maxLength = 0;
+	}
+	freeMemory(buffer);
+	close(fd);
+
+	return pMatrix;
+}
@@ -0,0 +1,772 @@
+/*
+  Author: Benjamin G. Friedman
+  Date: 10/18/2026
+  File: MatrixInternal.h
+  Description:
+      - Private header shared by the translation units that implement the matrix interface.
+        It is not part of the public interface and should not be included by clients of Matrix.h.
+*/
+
+
+#ifndef MATRIX_INTERNAL_H
+#define MATRIX_INTERNAL_H
+
+
+#include <stdint.h>
+#include <float.h>
+#include "Matrix.h"
+
+
+/***** Macros *****/
+#define TASK_NONE SIZE_MAX             // id of no task, which dependencies on are ignored (see addDependency)
+#define STREAM_CHUNK_SIZE 65536        // entries walked between hints to the kernel in the loops that stream over mapped matrices
+#define TEXT_BUFFER_SIZE 65536         // characters of a file a text reader holds at once, which also bounds the length of a number
+#define NUMBER_STRING_SIZE (LDBL_MAX_10_EXP + 64)        // enough for any long double written with 6 decimal places
+
+
+
+
+/***** Structures *****/
+typedef struct matrix {
+    long double* matrix;        // 2D array stored according to layout
+    size_t rows;                // total rows
+    size_t columns;             // total columns
+    int maxLength;              // max width of a number out of the entire array i.e -425.73 has a width of 7 (5 numbers, '.', and '-'),
+                                // 0 if it hasn't been worked out yet (see matrix_print)
+    MatrixLayout layout;        // order the entries are stored in
+    int fd;                     // file the storage array is shared with, -1 if changes to it don't go to a file
+    void* mapping;              // file mapping holding the storage array, NULL if it's allocated on the heap
+    size_t mappingBytes;        // length of the mapping
+} Matrix;
+
+
+typedef struct textReader {
+    FILE* fp;                   // file the text is read from, NULL when it's read from memory
+    char* buffer;               // holds the part of the file that has been read but not used yet
+    const char* text;           // the buffer, or the caller's memory when there is no file
+    size_t length;              // characters available in text
+    size_t position;            // index in text of the next character
+    Boolean endOfFile;          // nothing more can be read into the buffer
+} TextReader;
+
+
+typedef struct textWriter {
+    FILE* fp;                           // file the text is written to
+    char buffer[TEXT_BUFFER_SIZE];      // text that hasn't been written to the file yet
+    size_t length;                      // characters in the buffer
+    Boolean failed;                     // a write to the file failed
+} TextWriter;
+
+
+// The results kept by the result cache (see matrix_setCacheCapacity)
+typedef enum cacheOperation { CACHE_DETERMINANT, CACHE_INVERSE, CACHE_POWER, CACHE_FACTORIZATION } CacheOperation;
+
+typedef struct cacheKey {
+    uint64_t hash[2];           // hash of the operation, its parameter and the dimensions, layout and entries of the operand
+} CacheKey;
+
+
+// An operation or a phase of one being traced (see beginSpan)
+typedef struct traceSpan {
+    const char* name;           // string literal naming it, NULL if tracing was off when it began
+    double start;               // time it began on the monotonic clock
+    size_t rows;                // dimensions of the matrix it works on, for the trace
+    size_t columns;
+} TraceSpan;
+
+
+// A call of an operation of the interface being measured for the statistics (see beginCall)
+typedef struct measuredCall {
+    MatrixOperation operation;
+    Boolean counted;            // the statistics were on when the call began
+    double start;               // time it began on the monotonic clock, if it's the outermost measured call
+    TraceSpan span;             // the call in the trace
+} MeasuredCall;
+
+
+// A graph of tasks run by runTaskGraph, each task once all the tasks it depends on have finished
+typedef struct taskGraph TaskGraph;
+
+// Runs the task of the given kind on tiles i, j and k of the graph's data. Returning FALSE stops the graph, so the
+// tasks that haven't started are skipped.
+typedef Boolean (*TaskFunction)(void* context, int kind, size_t i, size_t j, size_t k);
+
+
+
+
+/***** Inline helper functions *****/
+/*
+PRECONDITION
+  - pMatrix is a pointer to a valid matrix object.
+POSTCONDITION
+  - Returns TRUE if the storage array of the matrix is mapped from a file that receives the changes to it (see
+    matrix_initMapped), else FALSE. Matrices loaded with matrix_load are privately mapped and are not included.
+*/
+static inline Boolean isMapped(const Matrix* pMatrix) {
+    return pMatrix->fd >= 0;
+}
+
+
+/*
+PRECONDITION
+  - pMatrix is a pointer to a valid matrix object.
+  - row/column are in bounds.
+POSTCONDITION
+  - Returns the index of the entry at row/column in the storage array of the matrix for its layout.
+    This is the unchecked version of at() for the loops that already know they're in bounds.
+*/
+static inline size_t matrixIndex(const Matrix* pMatrix, size_t row, size_t column) {
+    switch (pMatrix->layout) {
+    case MATRIX_COLUMN_MAJOR:
+        return column * pMatrix->rows + row;
+    case MATRIX_TILED: {
+        size_t tilesAcross = (pMatrix->columns + MATRIX_TILE_SIZE - 1) / MATRIX_TILE_SIZE;
+        size_t tile = row / MATRIX_TILE_SIZE * tilesAcross + column / MATRIX_TILE_SIZE;
+        return tile * MATRIX_TILE_SIZE * MATRIX_TILE_SIZE + (row % MATRIX_TILE_SIZE) * MATRIX_TILE_SIZE + column % MATRIX_TILE_SIZE;
+    }
+    default:
+        return row * pMatrix->columns + column;
+    }
+}
+
+
+
+
+/***** Helper functions defined in Matrix.c *****/
+/*
+PRECONDITION
+  - n is any double
+POSTCONDITION
+  - Calculates the total number of characters comprising the number.
+    If it's an integer this will just be the length of the integer (i.e. 1024 = length 4).
+    If it's floating point, then it will not include trailing zeros.
+  - This is the length of the number as it's displayed by matrix_print (see formatFixed).
+*/
+int calcNumLength(long double n);
+
+
+/*
+PRECONDITION
+  - rows/columns are >= 1.
+POSTCONDITION
+  - Returns the number of entries that have to be allocated to store a rows x columns matrix in the given layout.
+    The tiled layout pads the matrix to whole tiles.
+  - Returns 0 if the size of the storage array in bytes doesn't fit in a size_t.
+*/
+size_t storageSize(size_t rows, size_t columns, MatrixLayout layout);
+
+
+/*
+PRECONDITION
+  - pMatrix is a pointer to a valid matrix object.
+  - a is an array of at least rows * columns long doubles.
+POSTCONDITION
+  - Copies the entries of the matrix into a in row-major order, converting from the matrix's layout if needed.
+*/
+void copyToRowMajor(const Matrix* pMatrix, long double* a);
+
+
+/*
+PRECONDITION
+  - pMatrix is a pointer to a valid matrix object.
+  - a is an array of rows * columns long doubles in row-major order.
+POSTCONDITION
+  - Copies the entries of a into the matrix, converting to the matrix's layout if needed.
+*/
+void copyFromRowMajor(Matrix* pMatrix, const long double* a);
+
+
+/*
+PRECONDITION
+  - pMatrix is a pointer to a valid matrix object.
+POSTCONDITION
+  - Recalculates the maxLength of pMatrix from all of its entries.
+*/
+void updateMaxLength(Matrix* pMatrix);
+
+
+/*
+PRECONDITION
+  - pDestination/pSource are pointers to valid matrix objects with the same dimensions and layout.
+POSTCONDITION
+  - Copies the storage array of pSource into that of pDestination a chunk at a time, releasing each chunk of a mapped
+    matrix after it's copied. The max length is not copied.
+*/
+void copyStorage(Matrix* pDestination, const Matrix* pSource);
+
+
+/*
+PRECONDITION
+  - ppMatrix is a pointer to a pointer to a valid matrix object or a pointer that's NULL.
+  - rows/columns are the new dimensions the matrix should be adjusted to.
+POSTCONDITION:
+  - If the matrix object does not exist, a new matrix object with the correct dimensions is created.
+  - If the matrix exists, its dimensions are checked. If its dimensions are incorrect, a new matrix array
+    is created to adjust it to the proper dimensions. The matrix keeps its layout, new matrix objects are row-major.
+  - Returns SUCCESS, else FAILURE for any memory allocation failure.
+*/
+Status adjustMatrixDimensions(Matrix** ppMatrix, size_t rows, size_t columns);
+
+
+/*
+PRECONDITION
+  - a, b and c are row-major arrays with leading dimensions (distance between the starts of consecutive rows)
+    lda, ldb and ldc respectively. c does not overlap a or b.
+  - op(a) is a if transposeA is FALSE, else the transpose of a. op(b) is defined the same way.
+  - op(a) is m x k, op(b) is k x n and c is m x n.
+POSTCONDITION
+  - Computes c = alpha * op(a) * op(b) + beta * c. If beta is 0, c does not need to be initialized.
+  - This is the multiplication kernel shared by matrix_multiply and the blocked factorizations.
+*/
+void multiplyKernel(Boolean transposeA, Boolean transposeB, size_t m, size_t n, size_t k,
+    long double alpha, const long double* a, size_t lda, const long double* b, size_t ldb,
+    long double beta, long double* c, size_t ldc);
+
+
+
+
+/***** Helper functions defined in Factorization.c *****/
+/*
+PRECONDITION
+  - pMatrix is a pointer to a valid square matrix object.
+  - pDeterminant/pFactored are pointers to the variables that receive the results.
+POSTCONDITION
+  - Symmetric positive definite matrices get their determinant from the Cholesky factorization and matrices larger than
+    the cofactor expansion limit get it from the LU factorization. In both cases the determinant is stored in the variable
+    pointed to by pDeterminant and the Boolean pointed to by pFactored is set to TRUE.
+  - Otherwise (including a failed Cholesky factorization of a small matrix), sets the Boolean pointed to by pFactored
+    to FALSE so the caller falls back to cofactor expansion.
+  - Returns SUCCESS, else FAILURE for any memory allocation failure.
+*/
+Status determinantFromFactorization(const Matrix* pMatrix, long double* pDeterminant, Boolean* pFactored);
+
+
+/*
+PRECONDITION
+  - pMatrix is a pointer to a valid square matrix object.
+  - pResult is a pointer to a valid matrix object with the same dimensions as pMatrix.
+  - pFactored/pMatrixIsVertible are pointers to the Booleans that receive the results.
+POSTCONDITION
+  - Inverts the same matrices determinantFromFactorization handles and sets the Boolean pointed to by pFactored to TRUE.
+    The Boolean pointed to by pMatrixIsVertible is set to FALSE if the LU factorization finds the matrix is singular.
+  - Otherwise sets the Boolean pointed to by pFactored to FALSE so the caller falls back to the adjugate.
+  - Returns SUCCESS, else FAILURE for any memory allocation failure.
+*/
+Status inverseFromFactorization(const Matrix* pMatrix, Matrix* pResult, Boolean* pFactored, Boolean* pMatrixIsVertible);
+
+
+/*
+PRECONDITION
+  - a is a row-major n x n array.
+  - pivots is an array of n size_t.
+POSTCONDITION
+  - Computes the blocked LU factorization with partial pivoting P * A = L * U in place. U is stored on and above
+    the diagonal and the unit lower triangular L below it. Row i was swapped with row pivots[i] at step i.
+  - Returns FALSE if U has a zero on the diagonal (a is singular), else TRUE.
+*/
+Boolean luFactor(long double* a, size_t n, size_t* pivots);
+
+
+/*
+PRECONDITION
+  - lu/pivots hold the LU factorization of a nonsingular n x n array created by luFactor.
+  - c is a row-major n x cColumns array.
+POSTCONDITION
+  - Overwrites c with the solution x of A * x = c.
+*/
+void luSolve(const long double* lu, size_t n, const size_t* pivots, long double* c, size_t cColumns);
+
+
+
+
+/***** Helper functions defined in Storage.c *****/
+/*
+PRECONDITION
+  - rows/columns/layout describe the matrix the storage is for.
+POSTCONDITION
+  - Returns a zero initialized heap storage array for the matrix, else NULL for any memory allocation failure or if the
+    size of the array in bytes doesn't fit in a size_t.
+*/
+long double* allocateStorage(size_t rows, size_t columns, MatrixLayout layout);
+
+
+/*
+PRECONDITION
+  - pMatrix is a pointer to a valid matrix object.
+  - rows/columns/layout are the new dimensions and layout of the matrix.
+POSTCONDITION
+  - Replaces the storage array of the matrix with a zero initialized one for the new dimensions and layout and updates
+    the matrix to match. Heap and loaded matrices get a new heap array and mapped matrices get their file resized and remapped.
+  - Returns SUCCESS, else FAILURE for any memory allocation or file failure (the matrix is left unchanged, except that the
+    entries of a mapped matrix may be zeroed if its file couldn't be resized).
+*/
+Status resizeStorage(Matrix* pMatrix, size_t rows, size_t columns, MatrixLayout layout);
+
+
+/*
+PRECONDITION
+  - pMatrix is a pointer to a valid matrix object.
+POSTCONDITION
+  - Frees the heap storage array of the matrix or unmaps it and closes its file.
+*/
+void freeStorage(Matrix* pMatrix);
+
+
+/*
+PRECONDITION
+  - pMatrix is a pointer to a valid matrix object.
+  - first/end are the range [first, end) of storage indices that won't be used again soon.
+POSTCONDITION
+  - For a mapped matrix, lets the kernel drop the pages holding the range from the process so the memory in use stays
+    bounded while streaming. The entries are still in the file (and page cache), so this never loses data.
+  - Nothing is done for heap matrices.
+*/
+void releaseSpan(const Matrix* pMatrix, size_t first, size_t end);
+
+
+/*
+PRECONDITION
+  - pMatrix is a pointer to a valid matrix object.
+  - firstRow/endRow are the range [firstRow, endRow) of rows and are in bounds.
+POSTCONDITION
+  - Same as releaseSpan for the storage holding the rows. Nothing is done if the rows aren't contiguous in the layout.
+*/
+void releaseRows(const Matrix* pMatrix, size_t firstRow, size_t endRow);
+
+
+/*
+PRECONDITION
+  - pMatrix is a pointer to a valid matrix object.
+  - firstColumn/endColumn are the range [firstColumn, endColumn) of columns and are in bounds.
+POSTCONDITION
+  - Same as releaseSpan for the storage holding the columns (the whole tiles holding them for the tiled layout).
+    Nothing is done for the row-major layout, where the columns aren't contiguous.
+*/
+void releaseColumns(const Matrix* pMatrix, size_t firstColumn, size_t endColumn);
+
+
+/*
+PRECONDITION
+  - pMatrix is a pointer to a valid matrix object.
+  - firstRow/endRow are the range [firstRow, endRow) of rows and are in bounds.
+POSTCONDITION
+  - For a mapped matrix, asks the kernel to start reading the rows in from the file ahead of their use.
+  - Nothing is done for heap matrices or if the rows aren't contiguous in the layout.
+*/
+void prefetchRows(const Matrix* pMatrix, size_t firstRow, size_t endRow);
+
+
+
+
+/***** Helper functions defined in MatrixText.c *****/
+/*
+PRECONDITION
+  - n is any long double.
+  - numString is an array of at least NUMBER_STRING_SIZE characters.
+POSTCONDITION
+  - Writes n to numString the same as printf's "%Lf" (rounded to 6 decimal places) without the trailing zeroes of the
+    decimal places or a decimal point that isn't followed by any digits, i.e. 24.1720000 becomes 24.172 and 5.000000 becomes 5.
+  - Returns the length of the string.
+*/
+int formatFixed(long double n, char* numString);
+
+
+/*
+PRECONDITION
+  - pReader is a pointer to the reader to initialize.
+  - fp is a file open for reading.
+POSTCONDITION
+  - Sets up the reader to read the text of the file from its current position. The file is read a line at a time
+    (at most TEXT_BUFFER_SIZE characters), so nothing past the line being parsed is taken from an interactive stream.
+  - Returns SUCCESS, else FAILURE for any memory allocation failure.
+*/
+Status initTextReaderFile(TextReader* pReader, FILE* fp);
+
+
+/*
+PRECONDITION
+  - pReader is a pointer to the reader to initialize.
+  - text is an array of length characters that outlives the reader. It doesn't have to be NUL terminated.
+POSTCONDITION
+  - Sets up the reader to read the text directly, without copying it.
+*/
+void initTextReaderBuffer(TextReader* pReader, const char* text, size_t length);
+
+
+/*
+PRECONDITION
+  - pReader is a pointer to an initialized reader.
+POSTCONDITION
+  - Frees the buffer of the reader. The file is not closed.
+*/
+void freeTextReader(TextReader* pReader);
+
+
+/*
+PRECONDITION
+  - pReader is a pointer to an initialized reader.
+POSTCONDITION
+  - Returns the next character without using it, else EOF at the end of the text.
+*/
+int peekCharacter(TextReader* pReader);
+
+
+/*
+PRECONDITION
+  - pReader is a pointer to an initialized reader.
+POSTCONDITION
+  - Skips the spaces, tabs and carriage returns at the reader's position. Newlines are not skipped.
+*/
+void skipBlanks(TextReader* pReader);
+
+
+/*
+PRECONDITION
+  - pReader is a pointer to an initialized reader.
+  - pNumber is a pointer to the variable that receives the number.
+POSTCONDITION
+  - Skips blanks and reads a decimal floating point number, i.e. -12, 3.5, .25 or 6.02e23, that ends at a blank,
+    comma, newline or the end of the text.
+  - Returns TRUE, else FALSE if there is no number at the position, it's malformed or it overflows a long double.
+    The position is unspecified after a failure.
+*/
+Boolean readNumber(TextReader* pReader, long double* pNumber);
+
+
+/*
+PRECONDITION
+  - pReader is a pointer to an initialized reader.
+POSTCONDITION
+  - Skips blanks and returns TRUE if the line ends there (the newline is used) or the text ends there, else FALSE.
+*/
+Boolean readEndOfLine(TextReader* pReader);
+
+
+/*
+PRECONDITION
+  - pReader is a pointer to an initialized reader.
+POSTCONDITION
+  - Skips everything up to and including the next newline, or to the end of the text.
+*/
+void skipLine(TextReader* pReader);
+
+
+/*
+PRECONDITION
+  - pReader is a pointer to an initialized reader.
+  - separator is the character expected between two entries, i.e. ',' for CSV.
+POSTCONDITION
+  - Skips blanks and returns TRUE if the separator is there (it's used), else FALSE.
+*/
+Boolean readSeparator(TextReader* pReader, char separator);
+
+
+/*
+PRECONDITION
+  - pReader is a pointer to an initialized reader.
+  - word is an array of size characters.
+POSTCONDITION
+  - Skips blanks and reads the characters up to the next blank, newline or the end of the text into word as a string.
+  - Returns TRUE, else FALSE if there is no word at the position or it doesn't fit in word.
+*/
+Boolean readWord(TextReader* pReader, char* word, size_t size);
+
+
+/*
+PRECONDITION
+  - pWriter is a pointer to the writer to initialize.
+  - fp is a file open for writing.
+POSTCONDITION
+  - Sets up the writer with an empty buffer to write text to the file.
+*/
+void initTextWriter(TextWriter* pWriter, FILE* fp);
+
+
+/*
+PRECONDITION
+  - pWriter is a pointer to a writer.
+  - characters is an array of length characters.
+POSTCONDITION
+  - Adds the characters to the writer's buffer, writing the buffer to the file whenever it fills up.
+*/
+void writeCharacters(TextWriter* pWriter, const char* characters, size_t length);
+
+
+/*
+PRECONDITION
+  - pWriter is a pointer to a writer.
+POSTCONDITION
+  - Writes the buffer to the file with a single fwrite and empties it.
+*/
+void flushWriter(TextWriter* pWriter);
+
+
+/*
+PRECONDITION
+  - numString is an array of at least 20 characters.
+POSTCONDITION
+  - Writes the decimal digits of n without a NUL terminator and returns how many there are.
+*/
+int writeUnsigned(uint64_t n, char* numString);
+
+
+
+/*
+PRECONDITION
+  - n is any long double.
+  - numString is an array of at least NUMBER_STRING_SIZE characters.
+POSTCONDITION
+  - Writes the shortest decimal string that strtold converts back to n, in fixed notation for powers of ten from -5
+    up to 20 and in scientific notation otherwise, i.e. 0.1, -2.5, 1e+30 or 1.25e-07.
+  - Returns the length of the string.
+*/
+int formatShortest(long double n, char* numString);
+
+
+
+
+
+/***** Helper functions defined in MatrixCache.c *****/
+/*
+PRECONDITION
+  - pMatrix is a pointer to a valid matrix object, the operand of the operation.
+  - operation is the operation and parameter is its parameter, i.e. the power (0 if it has none).
+  - pKey is a pointer to the key that receives the hash.
+POSTCONDITION
+  - Returns TRUE with the key of the result in the variable pointed to by pKey, else FALSE if the cache is off or the
+    matrix is small enough that looking it up would take longer than the operation.
+*/
+Boolean cacheKey(const Matrix* pMatrix, CacheOperation operation, long long parameter, CacheKey* pKey);
+
+
+/*
+PRECONDITION
+  - pKey is a pointer to a key made by cacheKey.
+  - data is an array of bytes bytes that receives the data of the entry, or NULL if bytes is 0.
+  - pNumber is a pointer to the variable that receives the number of the entry.
+POSTCONDITION
+  - Returns TRUE if an entry for the key is cached, copying its number and, if it has bytes bytes of data, its data.
+    Else returns FALSE.
+*/
+Boolean cacheFind(const CacheKey* pKey, void* data, size_t bytes, long double* pNumber);
+
+
+/*
+PRECONDITION
+  - pKey is a pointer to a key made by cacheKey.
+  - data is an array of bytes bytes to cache, or NULL if bytes is 0.
+  - number is a number to cache with it, i.e. a result that's a number or a flag of the result.
+POSTCONDITION
+  - Caches a copy of the data and the number under the key, evicting the least recently used entries to make room.
+    Nothing is cached if the entry is larger than the cache or for any memory allocation failure.
+*/
+void cacheStore(const CacheKey* pKey, const void* data, size_t bytes, long double number);
+
+
+/*
+PRECONDITION
+  - pKey is a pointer to a key made by cacheKey.
+  - ppResult is a pointer to a pointer to a valid matrix object or a pointer that's NULL.
+  - pNumber is a pointer to the variable that receives the number of the entry.
+POSTCONDITION
+  - Returns TRUE if an entry for the key is cached, copying its number and, if it holds a matrix, storing the matrix
+    in the result the same as an operation would (see adjustMatrixDimensions). Else returns FALSE.
+*/
+Boolean cacheFindMatrix(const CacheKey* pKey, Matrix** ppResult, long double* pNumber);
+
+
+/*
+PRECONDITION
+  - pKey is a pointer to a key made by cacheKey.
+  - pResult is a pointer to a valid matrix object to cache, or NULL for an entry that's only a number.
+  - number is a number to cache with it.
+POSTCONDITION
+  - Caches a copy of the entries of the matrix and the number under the key, the same as cacheStore.
+*/
+void cacheStoreMatrix(const CacheKey* pKey, const Matrix* pResult, long double number);
+
+
+
+
+/***** Helper functions defined in MatrixStats.c *****/
+/*
+PRECONDITION
+  - pCall is a pointer to the measurement of a call of the operation, started before it does anything.
+  - hOperand is the first matrix object the operation works on, or NULL if it makes its matrix object (i.e. loads).
+POSTCONDITION
+  - While the statistics are on, starts measuring the call. Only the outermost measured call on a thread is recorded,
+    the ones it makes are part of it. While they're off, does nothing.
+  - Begins a span of the call, with the dimensions of the operand, while tracing is on (see beginSpan).
+  - Every beginCall must be followed by an endCall for the same measurement on the same thread.
+*/
+void beginCall(MeasuredCall* pCall, MatrixOperation operation, MATRIX hOperand);
+
+
+/*
+PRECONDITION
+  - pCall is a pointer to a measurement started by beginCall.
+  - flops is the number of floating point operations the call did, estimated from its dimensions, or 0 if it failed
+    (how much of the work it got through isn't known) or took its result from the cache.
+POSTCONDITION
+  - Adds the time, floating point operations, memory and counters of the outermost measured call to the statistics of
+    its operation.
+*/
+void endCall(MeasuredCall* pCall, double flops);
+
+
+/*
+PRECONDITION
+  - allocatedBytes is the number of bytes just allocated and inUseChange the change in the bytes in use, negative for
+    memory that was freed.
+POSTCONDITION
+  - Counts the memory for the outermost measured call running on this thread, if there is one.
+*/
+void countMemory(size_t allocatedBytes, long long inUseChange);
+
+
+
+
+/***** Helper functions defined in MatrixMemory.c *****/
+/*
+PRECONDITION
+  - bytes/count/size are the size of the memory the same as for malloc/calloc/realloc.
+  - memory is NULL or memory returned by these functions that hasn't been freed.
+POSTCONDITION
+  - The same as malloc, calloc, realloc and free, but with the allocator set by matrix_setAllocator and the alignment
+    it asks for, and counting the memory for the statistics. Every allocation of the implementation files is made by
+    these, and memory from them must only be freed by freeMemory.
+*/
+void* allocateMemory(size_t bytes);
+void* allocateZeroedMemory(size_t count, size_t size);
+void* reallocateMemory(void* memory, size_t bytes);
+void freeMemory(void* memory);
+
+
+
+
+/***** Helper functions defined in MatrixTrace.c *****/
+/*
+PRECONDITION
+  - pSpan is a pointer to the span of an operation or a phase of one, begun before it does anything.
+  - name is a string literal naming it and rows/columns are the dimensions of the matrix it works on.
+POSTCONDITION
+  - While tracing is on, records the time the span began. While it's off, only checks that it's off.
+  - Every beginSpan must be followed by an endSpan for the same span on the same thread. Spans nest.
+*/
+void beginSpan(TraceSpan* pSpan, const char* name, size_t rows, size_t columns);
+
+
+/*
+PRECONDITION
+  - pSpan is a pointer to a span begun by beginSpan.
+POSTCONDITION
+  - Adds the span to the trace buffer of this thread if it was begun while tracing was on.
+*/
+void endSpan(TraceSpan* pSpan);
+
+
+
+
+/***** Helper functions defined in MatrixTasks.c *****/
+/*
+PRECONDITION
+  - function is the function that runs the tasks and context is passed to it.
+  - tiles is the number of tile rows of the data the tasks work on, split into even shares of rows the same way as
+    arrays placed by distributeMemory, so a task on tile row i is given to a thread on the node holding it.
+POSTCONDITION
+  - Returns a new empty task graph, else NULL for any memory allocation failure.
+*/
+TaskGraph* createTaskGraph(TaskFunction function, void* context, size_t tiles);
+
+
+/*
+PRECONDITION
+  - pGraph is a pointer to a task graph that hasn't been run.
+  - kind, i, j and k are passed to its function to run the task.
+POSTCONDITION
+  - Adds the task to the graph and returns its id, else TASK_NONE for any memory allocation failure, which makes
+    runTaskGraph fail without running anything.
+*/
+size_t addTask(TaskGraph* pGraph, int kind, size_t i, size_t j, size_t k);
+
+
+/*
+PRECONDITION
+  - pGraph is a pointer to a task graph that hasn't been run.
+  - before/after are ids of tasks of the graph, or TASK_NONE.
+POSTCONDITION
+  - Makes the task after wait for the task before to finish. Nothing is done if either is TASK_NONE.
+  - The tasks a task is depended on by are made ready in the order the dependencies were added, with the first
+    one run next by the same thread, so the graph should add the ones on its critical path first.
+  - Memory allocation failure makes runTaskGraph fail without running anything.
+*/
+void addDependency(TaskGraph* pGraph, size_t before, size_t after);
+
+
+/*
+PRECONDITION
+  - pGraph is a pointer to a task graph that hasn't been run. Its dependencies don't form a cycle.
+POSTCONDITION
+  - Runs the tasks on the calling thread and up to taskThreads() - 1 new ones, each with its own deque of the tasks
+    that are ready, taking the newest task from its own deque and stealing the oldest from another thread's when it
+    runs out. Returns once every task has run or been skipped.
+  - Returns SUCCESS, else FAILURE for any memory allocation failure while the graph was built or run, in which case
+    no task was run.
+*/
+Status runTaskGraph(TaskGraph* pGraph);
+
+
+/*
+PRECONDITION
+  - pGraph is a pointer to a task graph or NULL.
+POSTCONDITION
+  - Frees the graph.
+*/
+void freeTaskGraph(TaskGraph* pGraph);
+
+
+/*
+PRECONDITION
+  - none.
+POSTCONDITION
+  - Returns the number of threads task graphs are run on (see matrix_setFactorizationThreads), at least 1.
+*/
+int taskThreads(void);
+
+
+
+
+/***** Helper functions defined in MatrixNuma.c *****/
+/*
+PRECONDITION
+  - none.
+POSTCONDITION
+  - Returns the number of shares work and memory are split into by the NUMA policy (see matrix_setNumaPolicy), one
+    per node, or 1 if the policy is off or the machine has one node.
+*/
+int numaShares(void);
+
+
+/*
+PRECONDITION
+  - memory is an array of bytes bytes.
+  - zero is TRUE if the array is new and should be zeroed, FALSE if it holds entries to keep.
+POSTCONDITION
+  - Places the pages of the array by the NUMA policy if it's at least 4 MiB: spread over the nodes for
+    MATRIX_NUMA_INTERLEAVE, or each share on its node for MATRIX_NUMA_FIRST_TOUCH, zeroed by a thread pinned to it.
+    Pages already touched are moved.
+  - Zeroes the array if zero is TRUE, whether or not it's placed.
+*/
+void distributeMemory(void* memory, size_t bytes, Boolean zero);
+
+
+/*
+PRECONDITION
+  - share is in the range [0, numaShares()).
+POSTCONDITION
+  - Pins the calling thread to the processors of the node of the share. Nothing is done if numaShares() is 1.
+*/
+void pinThread(int share);
+
+
+#endif
@@ -0,0 +1,386 @@
+/*
+  Author: Benjamin G. Friedman
+  Date: 10/18/2026
+  File: MatrixJob.c
+  Description:
+	  - Implementation file for the asynchronous jobs of the matrix interface. Jobs wait in one queue, oldest first,
+		for a pool of worker threads (one per processor) that's started by the first job submitted.
+	  - Each job runs the blocking function of its operation, so it gets the same results.
+*/
+
+
+#define _DEFAULT_SOURCE        // sysconf(_SC_NPROCESSORS_ONLN)
+#include <stdlib.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "MatrixInternal.h"
+
+
+
+
+/***** Structures *****/
+typedef enum jobOperation {
+	JOB_MULTIPLY, JOB_ADD, JOB_SUBTRACT, JOB_POWER, JOB_TRANSPOSE, JOB_DETERMINANT, JOB_INVERSE, JOB_SOLVE,
+	JOB_LEAST_SQUARES, JOB_CHOLESKY
+} JobOperation;
+
+typedef struct matrixJob {
+	JobOperation operation;
+	MATRIX hMatrix1;                   // operands (hMatrices for add/subtract)
+	MATRIX hMatrix2;
+	MATRIX* hMatrices;
+	int hMatricesSize;
+	int power;
+	MATRIX* phResult;                  // where the results go, the same as for the blocking function
+	long double* pNumber;
+	Boolean* pFlag;                    // pMatrixIsVertible or pIsPositiveDefinite
+	MatrixJobCallback callback;
+	void* pContext;
+	MatrixJobState state;              // the rest is guarded by jobsLock
+	Boolean queued;                    // the job is in the queue, so it can still be cancelled
+	pthread_cond_t finished;           // broadcast when the state is final
+	struct matrixJob* pNext;           // next job in the queue
+} MatrixJob;
+
+
+
+
+/***** Global variables *****/
+static pthread_once_t workersStarted = PTHREAD_ONCE_INIT;
+static int workersSize;                        // worker threads running jobs, 0 if none could be started
+static pthread_mutex_t jobsLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t jobsQueued = PTHREAD_COND_INITIALIZER;
+static MatrixJob* pQueueFirst;                 // jobs waiting for a worker, oldest first
+static MatrixJob* pQueueLast;
+
+
+
+
+/***** Helper functions used only in this file *****/
+/*
+PRECONDITION
+  - job holds the operation, operands, results and callback of a new job.
+POSTCONDITION
+  - Queues a copy of the job for the workers (or runs it now if no worker could be started) and returns its handle,
+    else NULL for any memory allocation failure.
+*/
+static MATRIX_JOB submitJob(MatrixJob job);
+
+
+/*
+PRECONDITION
+  - none.
+POSTCONDITION
+  - Starts a worker thread per processor, setting workersSize to how many were started.
+*/
+static void startWorkers(void);
+
+
+/*
+PRECONDITION
+  - pArgument is unused.
+POSTCONDITION
+  - Runs the jobs in the queue for the life of the program.
+*/
+static void* runJobs(void* pArgument);
+
+
+/*
+PRECONDITION
+  - pJob is a pointer to a job that's been taken out of the queue.
+POSTCONDITION
+  - Runs the operation of the job, calls its callback and makes its final state visible to waiting threads.
+*/
+static void runJob(MatrixJob* pJob);
+
+
+/*
+PRECONDITION
+  - pJob is a pointer to a job that's been taken out of the queue.
+  - state is its final state.
+POSTCONDITION
+  - Calls the callback of the job, then sets its state and wakes up the threads waiting for it.
+*/
+static void finishJob(MatrixJob* pJob, MatrixJobState state);
+
+
+
+
+/***** Functions defined in Matrix.h *****/
+MATRIX_JOB matrix_multiplyAsync(MATRIX hMatrix1, MATRIX hMatrix2, MATRIX* phResult, MatrixJobCallback callback, void* pContext) {
+	MatrixJob job = { .operation = JOB_MULTIPLY, .hMatrix1 = hMatrix1, .hMatrix2 = hMatrix2, .phResult = phResult,
+		.callback = callback, .pContext = pContext };
+	return submitJob(job);
+}
+
+
+
+MATRIX_JOB matrix_addAsync(MATRIX* hMatrices, int hMatricesSize, MATRIX* phResult, MatrixJobCallback callback, void* pContext) {
+	MatrixJob job = { .operation = JOB_ADD, .hMatrices = hMatrices, .hMatricesSize = hMatricesSize, .phResult = phResult,
+		.callback = callback, .pContext = pContext };
+	return submitJob(job);
+}
+
+
+
+MATRIX_JOB matrix_subtractAsync(MATRIX* hMatrices, int hMatricesSize, MATRIX* phResult, MatrixJobCallback callback, void* pContext) {
+	MatrixJob job = { .operation = JOB_SUBTRACT, .hMatrices = hMatrices, .hMatricesSize = hMatricesSize,
+		.phResult = phResult, .callback = callback, .pContext = pContext };
+	return submitJob(job);
+}
+
+
+
+MATRIX_JOB matrix_powerAsync(MATRIX hMatrix, int power, MATRIX* phResult, MatrixJobCallback callback, void* pContext) {
+	MatrixJob job = { .operation = JOB_POWER, .hMatrix1 = hMatrix, .power = power, .phResult = phResult,
+		.callback = callback, .pContext = pContext };
+	return submitJob(job);
+}
+
+
+
+MATRIX_JOB matrix_transposeAsync(MATRIX hMatrix, MATRIX* phResult, MatrixJobCallback callback, void* pContext) {
+	MatrixJob job = { .operation = JOB_TRANSPOSE, .hMatrix1 = hMatrix, .phResult = phResult, .callback = callback,
+		.pContext = pContext };
+	return submitJob(job);
+}
+
+
+
+MATRIX_JOB matrix_determinantAsync(MATRIX hMatrix, long double* pDeterminant, MatrixJobCallback callback, void* pContext) {
+	MatrixJob job = { .operation = JOB_DETERMINANT, .hMatrix1 = hMatrix, .pNumber = pDeterminant, .callback = callback,
+		.pContext = pContext };
+	return submitJob(job);
+}
+
+
+
+MATRIX_JOB matrix_inverseAsync(MATRIX hMatrix, MATRIX* phResult, Boolean* pMatrixIsVertible, MatrixJobCallback callback,
+	void* pContext) {
+	MatrixJob job = { .operation = JOB_INVERSE, .hMatrix1 = hMatrix, .phResult = phResult, .pFlag = pMatrixIsVertible,
+		.callback = callback, .pContext = pContext };
+	return submitJob(job);
+}
+
+
+
+MATRIX_JOB matrix_solveAsync(MATRIX hA, MATRIX hB, MATRIX* phX, Boolean* pMatrixIsVertible, MatrixJobCallback callback,
+	void* pContext) {
+	MatrixJob job = { .operation = JOB_SOLVE, .hMatrix1 = hA, .hMatrix2 = hB, .phResult = phX, .pFlag = pMatrixIsVertible,
+		.callback = callback, .pContext = pContext };
+	return submitJob(job);
+}
+
+
+
+MATRIX_JOB matrix_leastSquaresAsync(MATRIX hA, MATRIX hB, MATRIX* phX, MatrixJobCallback callback, void* pContext) {
+	MatrixJob job = { .operation = JOB_LEAST_SQUARES, .hMatrix1 = hA, .hMatrix2 = hB, .phResult = phX,
+		.callback = callback, .pContext = pContext };
+	return submitJob(job);
+}
+
+
+
+MATRIX_JOB matrix_choleskyAsync(MATRIX hMatrix, MATRIX* phL, Boolean* pIsPositiveDefinite, MatrixJobCallback callback,
+	void* pContext) {
+	MatrixJob job = { .operation = JOB_CHOLESKY, .hMatrix1 = hMatrix, .phResult = phL, .pFlag = pIsPositiveDefinite,
+		.callback = callback, .pContext = pContext };
+	return submitJob(job);
+}
+
+
+
+MatrixJobState matrix_jobPoll(MATRIX_JOB hJob) {
+	MatrixJob* pJob = hJob;
+
+	pthread_mutex_lock(&jobsLock);
+	MatrixJobState state = pJob->state;
+	pthread_mutex_unlock(&jobsLock);
+
+	return state;
+}
+
+
+
+MatrixJobState matrix_jobWait(MATRIX_JOB hJob) {
+	MatrixJob* pJob = hJob;
+
+	pthread_mutex_lock(&jobsLock);
+	while (pJob->state == MATRIX_JOB_PENDING || pJob->state == MATRIX_JOB_RUNNING)
+		pthread_cond_wait(&pJob->finished, &jobsLock);
+	MatrixJobState state = pJob->state;
+	pthread_mutex_unlock(&jobsLock);
+
+	return state;
+}
+
+
+
+Status matrix_jobCancel(MATRIX_JOB hJob) {
+	MatrixJob* pJob = hJob;
+
+	pthread_mutex_lock(&jobsLock);
+	if (!pJob->queued) {
+		pthread_mutex_unlock(&jobsLock);
+		return FAILURE;
+	}
+
+	// take the job out of the queue
+	MatrixJob* pPrevious = NULL;
+	for (MatrixJob* pQueued = pQueueFirst; pQueued != pJob; pQueued = pQueued->pNext)
+		pPrevious = pQueued;
+	if (pPrevious)
+		pPrevious->pNext = pJob->pNext;
+	else
+		pQueueFirst = pJob->pNext;
+	if (pQueueLast == pJob)
+		pQueueLast = pPrevious;
+	pJob->queued = FALSE;
+	pthread_mutex_unlock(&jobsLock);
+
+	finishJob(pJob, MATRIX_JOB_CANCELLED);
+
+	return SUCCESS;
+}
+
+
+
+void matrix_jobDestroy(MATRIX_JOB* phJob) {
+	MatrixJob* pJob = *phJob;
+
+	matrix_jobCancel(pJob);
+	matrix_jobWait(pJob);
+	pthread_cond_destroy(&pJob->finished);
+	freeMemory(pJob);
+	*phJob = NULL;
+}
+
+
+
+
+/***** Helper functions used only in this file *****/
+static MATRIX_JOB submitJob(MatrixJob job) {
+	MatrixJob* pJob = allocateMemory(sizeof(*pJob));
+
+	if (!pJob)
+		return NULL;
+	*pJob = job;
+	pJob->state = MATRIX_JOB_PENDING;
+	pJob->pNext = NULL;
+	if (pthread_cond_init(&pJob->finished, NULL)) {
+		freeMemory(pJob);
+		return NULL;
+	}
+
+	// without workers the job is run now, the same as the blocking function
+	pthread_once(&workersStarted, startWorkers);
+	if (workersSize == 0) {
+		pJob->queued = FALSE;
+		runJob(pJob);
+		return pJob;
+	}
+
+	pthread_mutex_lock(&jobsLock);
+	pJob->queued = TRUE;
+	if (pQueueLast)
+		pQueueLast->pNext = pJob;
+	else
+		pQueueFirst = pJob;
+	pQueueLast = pJob;
+	pthread_cond_signal(&jobsQueued);
+	pthread_mutex_unlock(&jobsLock);
+
+	return pJob;
+}
+
+
+
+static void startWorkers(void) {
+	long processors = sysconf(_SC_NPROCESSORS_ONLN);
+	int workers = (processors > 0 && processors < 1024) ? (int)processors : 1;
+	pthread_attr_t attributes;
+	pthread_t thread;
+
+	// the workers run for the life of the program, so nothing waits for them
+	pthread_attr_init(&attributes);
+	pthread_attr_setdetachstate(&attributes, PTHREAD_CREATE_DETACHED);
+	while (workersSize < workers && !pthread_create(&thread, &attributes, runJobs, NULL))
+		++workersSize;
+	pthread_attr_destroy(&attributes);
+}
+
+
+
+static void* runJobs(void* pArgument) {
+	(void)pArgument;
+
+	for (;;) {
+		pthread_mutex_lock(&jobsLock);
+		while (!pQueueFirst)
+			pthread_cond_wait(&jobsQueued, &jobsLock);
+		MatrixJob* pJob = pQueueFirst;
+		if (!(pQueueFirst = pJob->pNext))
+			pQueueLast = NULL;
+		pJob->queued = FALSE;
+		pJob->state = MATRIX_JOB_RUNNING;
+		pthread_mutex_unlock(&jobsLock);
+
+		runJob(pJob);
+	}
+
+	return NULL;
+}
+
+
+
+static void runJob(MatrixJob* pJob) {
+	Status status = SUCCESS;
+
+	switch (pJob->operation) {
+	case JOB_MULTIPLY:
+		status = matrix_multiply(pJob->hMatrix1, pJob->hMatrix2, pJob->phResult);
+		break;
+	case JOB_ADD:
+		status = matrix_add(pJob->hMatrices, pJob->hMatricesSize, pJob->phResult);
+		break;
+	case JOB_SUBTRACT:
+		status = matrix_subtract(pJob->hMatrices, pJob->hMatricesSize, pJob->phResult);
+		break;
+	case JOB_POWER:
+		status = matrix_power(pJob->hMatrix1, pJob->power, pJob->phResult);
+		break;
+	case JOB_TRANSPOSE:
+		status = matrix_transpose(pJob->hMatrix1, pJob->phResult);
+		break;
+	case JOB_DETERMINANT:
+		*pJob->pNumber = matrix_determinant(pJob->hMatrix1, &status);
+		break;
+	case JOB_INVERSE:
+		status = matrix_inverse(pJob->hMatrix1, pJob->phResult, pJob->pFlag);
+		break;
+	case JOB_SOLVE:
+		status = matrix_solve(pJob->hMatrix1, pJob->hMatrix2, pJob->phResult, pJob->pFlag);
+		break;
+	case JOB_LEAST_SQUARES:
+		status = matrix_leastSquares(pJob->hMatrix1, pJob->hMatrix2, pJob->phResult);
+		break;
+	case JOB_CHOLESKY:
+		status = matrix_cholesky(pJob->hMatrix1, pJob->phResult, pJob->pFlag);
+		break;
+	}
+
+	finishJob(pJob, status ? MATRIX_JOB_SUCCEEDED : MATRIX_JOB_FAILED);
+}
+
+
+
+static void finishJob(MatrixJob* pJob, MatrixJobState state) {
+	// the state is only made final after the callback returns, so a job waited for isn't destroyed under its callback
+	if (pJob->callback)
+		pJob->callback(pJob, state, pJob->pContext);
+
+	pthread_mutex_lock(&jobsLock);
+	pJob->state = state;
+	pthread_cond_broadcast(&pJob->finished);
+	pthread_mutex_unlock(&jobsLock);
+}
@@ -0,0 +1,475 @@
+/*
+  Author: Benjamin G. Friedman
+  Date: 10/18/2026
+  File: MatrixMarket.c
+  Description:
+	  - Implementation file for reading and writing matrix objects as Matrix Market (.mtx) files.
+	  - A file starts with a banner line, "%%MatrixMarket matrix <format> <field> <symmetry>", followed by comment lines
+		starting with '%', a size line and the entries:
+			array:       "rows columns", then one value per line in column-major order
+			coordinate:  "rows columns entries", then one "row column value" line per stored entry (1-based indices)
+	  - Symmetric and skew-symmetric files only store the lower triangle (the strict lower triangle for skew-symmetric).
+	  - Files are read and written through the text reader/writer of MatrixText.c, so each entry is converted and stored
+		as soon as it's read and nothing but the buffer is held besides the matrix itself.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include "MatrixInternal.h"
+
+
+#define MARKET_BANNER "%%MatrixMarket"        // first word of every Matrix Market file
+#define MARKET_WORD_SIZE 32                   // longest word of the banner that's read, including the NUL
+
+
+
+
+/***** Structures *****/
+// The symmetry of a Matrix Market file, which determines the entries it stores
+typedef enum marketSymmetry { MARKET_GENERAL, MARKET_SYMMETRIC, MARKET_SKEW_SYMMETRIC } MarketSymmetry;
+
+typedef struct marketHeader {
+	MatrixMarketFormat format;        // array or coordinate
+	Boolean pattern;                  // the entries have no values, every stored entry is 1
+	MarketSymmetry symmetry;
+	size_t rows;
+	size_t columns;
+	size_t entries;                   // number of entry lines that follow the size line (coordinate only)
+} MarketHeader;
+
+
+
+
+/***** Helper functions used only in this file *****/
+/*
+PRECONDITION
+  - word/expected are strings.
+POSTCONDITION
+  - Returns TRUE if the strings are the same ignoring the case of ASCII letters, else FALSE.
+*/
+static Boolean wordEquals(const char* word, const char* expected);
+
+
+/*
+PRECONDITION
+  - pReader is a pointer to an initialized reader.
+  - minimum/maximum are the bounds of the count.
+  - pCount is a pointer to the variable that receives the count.
+POSTCONDITION
+  - Reads a number with readNumber and stores it in the variable pointed to by pCount.
+  - Returns TRUE, else FALSE if there is no number or it isn't a whole number from minimum to maximum.
+*/
+static Boolean readCount(TextReader* pReader, size_t minimum, size_t maximum, size_t* pCount);
+
+
+/*
+PRECONDITION
+  - pReader is a pointer to an initialized reader positioned at the start of the file.
+  - pHeader is a pointer to the header that receives the description of the file.
+POSTCONDITION
+  - Reads the banner line, skips the comment and blank lines after it and reads the size line.
+  - Returns TRUE, else FALSE if the banner isn't for a real, integer or pattern matrix, the size line is invalid or a
+    symmetric file isn't square.
+*/
+static Boolean readHeader(TextReader* pReader, MarketHeader* pHeader);
+
+
+/*
+PRECONDITION
+  - pReader is a pointer to an initialized reader.
+POSTCONDITION
+  - Skips blanks and blank lines and returns TRUE if the text ends there, else FALSE.
+*/
+static Boolean skipBlankLines(TextReader* pReader);
+
+
+/*
+PRECONDITION
+  - pMatrix is a pointer to a valid column-major matrix object with the dimensions in the header, filled with zeroes.
+  - pReader is a pointer to the reader positioned after the size line.
+  - pHeader is a pointer to the header of an array file.
+POSTCONDITION
+  - Reads the values into the matrix, mirroring the lower triangle of symmetric and skew-symmetric files.
+  - Returns TRUE, else FALSE if a value is missing or invalid or anything follows the last value.
+*/
+static Boolean readArray(Matrix* pMatrix, TextReader* pReader, const MarketHeader* pHeader);
+
+
+/*
+PRECONDITION
+  - pMatrix is a pointer to a valid row-major matrix object with the dimensions in the header, filled with zeroes.
+  - pReader is a pointer to the reader positioned after the size line.
+  - pHeader is a pointer to the header of a coordinate file.
+POSTCONDITION
+  - Reads the entry lines into the matrix. Entries given more than once are added together and the entries of
+    symmetric and skew-symmetric files are mirrored.
+  - Returns TRUE, else FALSE if an entry line is invalid, an index is out of bounds, a skew-symmetric file has a
+    diagonal entry or the file doesn't have exactly the number of entries in the size line.
+*/
+static Boolean readCoordinate(Matrix* pMatrix, TextReader* pReader, const MarketHeader* pHeader);
+
+
+/*
+PRECONDITION
+  - pMatrix is a pointer to a valid matrix object.
+POSTCONDITION
+  - Returns TRUE if the matrix is square and equal to its transpose, else FALSE.
+*/
+static Boolean isSymmetric(const Matrix* pMatrix);
+
+
+/*
+PRECONDITION
+  - pWriter is a pointer to a writer.
+  - n is the number to write.
+  - end is the character written after it.
+POSTCONDITION
+  - Writes n with formatShortest followed by end.
+*/
+static void writeValue(TextWriter* pWriter, long double n, char end);
+
+
+/*
+PRECONDITION
+  - pWriter is a pointer to a writer.
+  - n is the index to write.
+  - end is the character written after it.
+POSTCONDITION
+  - Writes n in decimal followed by end.
+*/
+static void writeIndex(TextWriter* pWriter, size_t n, char end);
+
+
+
+/*
+PRECONDITION
+  - The same as matrix_initFromMatrixMarket.
+POSTCONDITION
+  - Reads the matrix the same as matrix_initFromMatrixMarket, without measuring the call.
+*/
+static MATRIX readMatrixMarket(FILE* fp);
+
+
+/*
+PRECONDITION
+  - The same as matrix_writeMatrixMarket.
+POSTCONDITION
+  - Writes the matrix the same as matrix_writeMatrixMarket, without measuring the call.
+*/
+static Status writeMatrixMarket(MATRIX hMatrix, FILE* fp, MatrixMarketFormat format, Boolean symmetric);
+
+
+
+/***** Functions defined in Matrix.h *****/
+MATRIX matrix_initFromMatrixMarket(FILE* fp) {
+	MeasuredCall call;
+
+	beginCall(&call, MATRIX_OPERATION_READ_MATRIX_MARKET, NULL);
+	MATRIX hMatrix = readMatrixMarket(fp);
+	endCall(&call, 0);
+
+	return hMatrix;
+}
+
+
+
+
+Status matrix_writeMatrixMarket(MATRIX hMatrix, FILE* fp, MatrixMarketFormat format, Boolean symmetric) {
+	MeasuredCall call;
+
+	beginCall(&call, MATRIX_OPERATION_WRITE_MATRIX_MARKET, hMatrix);
+	Status status = writeMatrixMarket(hMatrix, fp, format, symmetric);
+	endCall(&call, 0);
+
+	return status;
+}
+
+
+
+
+/***** Helper functions used only in this file *****/
+static Boolean wordEquals(const char* word, const char* expected) {
+	for (; *word && *expected; ++word, ++expected) {
+		char c = (*word >= 'A' && *word <= 'Z') ? (char)(*word - 'A' + 'a') : *word;
+		char e = (*expected >= 'A' && *expected <= 'Z') ? (char)(*expected - 'A' + 'a') : *expected;
+		if (c != e)
+			return FALSE;
+	}
+
+	return *word == *expected;
+}
+
+
+
+
+static Boolean readCount(TextReader* pReader, size_t minimum, size_t maximum, size_t* pCount) {
+	long double n;
+
+	if (!readNumber(pReader, &n) || n != floorl(n) || n < (long double)minimum || n > (long double)maximum)
+		return FALSE;
+	*pCount = (size_t)n;
+
+	return TRUE;
+}
+
+
+
+
+static Boolean readHeader(TextReader* pReader, MarketHeader* pHeader) {
+	char word[MARKET_WORD_SIZE];
+
+	// banner
+	if (!readWord(pReader, word, sizeof(word)) || !wordEquals(word, MARKET_BANNER)
+		|| !readWord(pReader, word, sizeof(word)) || !wordEquals(word, "matrix")
+		|| !readWord(pReader, word, sizeof(word)))
+		return FALSE;
+	if (wordEquals(word, "array"))
+		pHeader->format = MATRIX_MARKET_ARRAY;
+	else if (wordEquals(word, "coordinate"))
+		pHeader->format = MATRIX_MARKET_COORDINATE;
+	else
+		return FALSE;
+
+	if (!readWord(pReader, word, sizeof(word)))
+		return FALSE;
+	pHeader->pattern = wordEquals(word, "pattern");
+	if (!pHeader->pattern && !wordEquals(word, "real") && !wordEquals(word, "integer"))
+		return FALSE;
+	if (pHeader->pattern && pHeader->format == MATRIX_MARKET_ARRAY)
+		return FALSE;
+
+	if (!readWord(pReader, word, sizeof(word)))
+		return FALSE;
+	if (wordEquals(word, "general"))
+		pHeader->symmetry = MARKET_GENERAL;
+	else if (wordEquals(word, "symmetric"))
+		pHeader->symmetry = MARKET_SYMMETRIC;
+	else if (wordEquals(word, "skew-symmetric"))
+		pHeader->symmetry = MARKET_SKEW_SYMMETRIC;
+	else
+		return FALSE;
+	if (!readEndOfLine(pReader))
+		return FALSE;
+
+	// comments
+	for (;;) {
+		skipBlanks(pReader);
+		if (peekCharacter(pReader) == '%')
+			skipLine(pReader);
+		else if (peekCharacter(pReader) == EOF || !readEndOfLine(pReader))
+			break;
+	}
+
+	// size line
+	if (!readCount(pReader, 1, SIZE_MAX, &pHeader->rows) || !readCount(pReader, 1, SIZE_MAX, &pHeader->columns))
+		return FALSE;
+	pHeader->entries = 0;
+	if (pHeader->format == MATRIX_MARKET_COORDINATE && !readCount(pReader, 0, SIZE_MAX, &pHeader->entries))
+		return FALSE;
+
+	return readEndOfLine(pReader) && (pHeader->symmetry == MARKET_GENERAL || pHeader->rows == pHeader->columns);
+}
+
+
+
+
+static Boolean skipBlankLines(TextReader* pReader) {
+	while (peekCharacter(pReader) != EOF)
+		if (!readEndOfLine(pReader))
+			return FALSE;
+
+	return TRUE;
+}
+
+
+
+
+static Boolean readArray(Matrix* pMatrix, TextReader* pReader, const MarketHeader* pHeader) {
+	for (size_t column = 0; column < pMatrix->columns; ++column) {
+		size_t first = column;
+		if (pHeader->symmetry == MARKET_GENERAL)
+			first = 0;
+		else if (pHeader->symmetry == MARKET_SKEW_SYMMETRIC)
+			first = column + 1;
+
+		for (size_t row = first; row < pMatrix->rows; ++row) {
+			long double n;
+			// values are separated by any amount of blanks and newlines
+			while (readEndOfLine(pReader))
+				if (peekCharacter(pReader) == EOF)
+					return FALSE;
+			if (!readNumber(pReader, &n))
+				return FALSE;
+
+			pMatrix->matrix[column * pMatrix->rows + row] = n;
+			if (row != column && pHeader->symmetry != MARKET_GENERAL)
+				pMatrix->matrix[row * pMatrix->rows + column] = (pHeader->symmetry == MARKET_SYMMETRIC) ? n : -n;
+		}
+	}
+
+	return skipBlankLines(pReader);
+}
+
+
+
+
+static Boolean readCoordinate(Matrix* pMatrix, TextReader* pReader, const MarketHeader* pHeader) {
+	for (size_t entry = 0; entry < pHeader->entries; ++entry) {
+		size_t row;
+		size_t column;
+		long double n = 1;
+
+		while (readEndOfLine(pReader))
+			if (peekCharacter(pReader) == EOF)
+				return FALSE;
+		if (!readCount(pReader, 1, pMatrix->rows, &row) || !readCount(pReader, 1, pMatrix->columns, &column)
+			|| (!pHeader->pattern && !readNumber(pReader, &n)) || !readEndOfLine(pReader))
+			return FALSE;
+		--row;
+		--column;
+		if (row == column && pHeader->symmetry == MARKET_SKEW_SYMMETRIC)
+			return FALSE;
+
+		pMatrix->matrix[row * pMatrix->columns + column] += n;
+		if (row != column && pHeader->symmetry == MARKET_SYMMETRIC)
+			pMatrix->matrix[column * pMatrix->columns + row] += n;
+		else if (pHeader->symmetry == MARKET_SKEW_SYMMETRIC)
+			pMatrix->matrix[column * pMatrix->columns + row] -= n;
+	}
+
+	return skipBlankLines(pReader);
+}
+
+
+
+
+static Boolean isSymmetric(const Matrix* pMatrix) {
+	if (pMatrix->rows != pMatrix->columns)
+		return FALSE;
+	for (size_t row = 1; row < pMatrix->rows; ++row)
+		for (size_t column = 0; column < row; ++column)
+			if (pMatrix->matrix[matrixIndex(pMatrix, row, column)] != pMatrix->matrix[matrixIndex(pMatrix, column, row)])
+				return FALSE;
+
+	return TRUE;
+}
+
+
+
+
+static void writeValue(TextWriter* pWriter, long double n, char end) {
+	char numString[NUMBER_STRING_SIZE];
+	int length = formatShortest(n, numString);
+
+	numString[length] = end;
+	writeCharacters(pWriter, numString, (size_t)length + 1);
+}
+
+
+
+
+static void writeIndex(TextWriter* pWriter, size_t n, char end) {
+	char numString[21];
+	int length = writeUnsigned(n, numString);
+
+	numString[length] = end;
+	writeCharacters(pWriter, numString, (size_t)length + 1);
+}
+
+
+
+static MATRIX readMatrixMarket(FILE* fp) {
+	TextReader reader;
+	MarketHeader header;
+	Matrix* pMatrix = NULL;
+	Boolean valid;
+
+	if (!initTextReaderFile(&reader, fp))
+		return NULL;
+	if (readHeader(&reader, &header)) {
+		// array files are stored column by column, so they're read straight into a column-major matrix
+		if (header.format == MATRIX_MARKET_ARRAY) {
+			pMatrix = matrix_initLayout(header.rows, header.columns, MATRIX_COLUMN_MAJOR);
+			valid = pMatrix && readArray(pMatrix, &reader, &header);
+		}
+		else {
+			pMatrix = matrix_initLayout(header.rows, header.columns, MATRIX_ROW_MAJOR);
+			valid = pMatrix && readCoordinate(pMatrix, &reader, &header);
+		}
+		if (valid)
+			pMatrix->maxLength = 0;
+		else if (pMatrix) {
+			freeStorage(pMatrix);
+			freeMemory(pMatrix);
+			pMatrix = NULL;
+		}
+	}
+	freeTextReader(&reader);
+
+	return pMatrix;
+}
+
+
+
+static Status writeMatrixMarket(MATRIX hMatrix, FILE* fp, MatrixMarketFormat format, Boolean symmetric) {
+	Matrix* pMatrix = hMatrix;
+	TextWriter writer;
+
+	if (symmetric && !isSymmetric(pMatrix))
+		return FAILURE;
+
+	initTextWriter(&writer, fp);
+	writeCharacters(&writer, MARKET_BANNER " matrix ", sizeof(MARKET_BANNER " matrix ") - 1);
+	if (format == MATRIX_MARKET_ARRAY)
+		writeCharacters(&writer, "array real ", 11);
+	else
+		writeCharacters(&writer, "coordinate real ", 16);
+	if (symmetric)
+		writeCharacters(&writer, "symmetric\n", 10);
+	else
+		writeCharacters(&writer, "general\n", 8);
+	writeIndex(&writer, pMatrix->rows, ' ');
+
+	if (format == MATRIX_MARKET_ARRAY) {
+		writeIndex(&writer, pMatrix->columns, '\n');
+		for (size_t column = 0; column < pMatrix->columns; ++column) {
+			for (size_t row = symmetric ? column : 0; row < pMatrix->rows; ++row)
+				writeValue(&writer, pMatrix->matrix[matrixIndex(pMatrix, row, column)], '\n');
+			if ((column + 1) % MATRIX_TILE_SIZE == 0)
+				releaseColumns(pMatrix, column + 1 - MATRIX_TILE_SIZE, column + 1);
+		}
+	}
+	else {
+		// the number of entries comes before them, so the nonzeros are counted first
+		size_t entries = 0;
+		for (size_t row = 0; row < pMatrix->rows; ++row) {
+			size_t end = symmetric ? row + 1 : pMatrix->columns;
+			for (size_t column = 0; column < end; ++column)
+				if (pMatrix->matrix[matrixIndex(pMatrix, row, column)] != 0)
+					++entries;
+		}
+		writeIndex(&writer, pMatrix->columns, ' ');
+		writeIndex(&writer, entries, '\n');
+
+		for (size_t row = 0; row < pMatrix->rows; ++row) {
+			size_t end = symmetric ? row + 1 : pMatrix->columns;
+			for (size_t column = 0; column < end; ++column) {
+				long double n = pMatrix->matrix[matrixIndex(pMatrix, row, column)];
+				if (n != 0) {
+					writeIndex(&writer, row + 1, ' ');
+					writeIndex(&writer, column + 1, ' ');
+					writeValue(&writer, n, '\n');
+				}
+			}
+			if ((row + 1) % MATRIX_TILE_SIZE == 0)
+				releaseRows(pMatrix, row + 1 - MATRIX_TILE_SIZE, row + 1);
+		}
+	}
+	flushWriter(&writer);
+
+	return (writer.failed || ferror(fp)) ? FAILURE : SUCCESS;
+}
@@ -0,0 +1,293 @@
+/*
+  Author: Benjamin G. Friedman
+  Date: 10/18/2026
+  File: MatrixMemory.c
+  Description:
+	  - Implementation file for the allocator of the matrix interface and the memory allocation functions every other
+		implementation file uses.
+	  - Each allocation has a header just before the memory it returns, holding the block the allocator returned, the
+		allocator and the size. The memory is aligned within the block, so the alignment doesn't rely on the
+		allocator, and it's always freed by the allocator that allocated it, even after the allocator is changed.
+*/
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include "MatrixInternal.h"
+
+
+
+
+/***** Structures *****/
+typedef struct memoryHeader {
+	void* block;                           // what the allocator returned
+	const MatrixAllocator* pAllocator;     // allocator that allocated it
+	size_t bytes;                          // size asked for
+} MemoryHeader;
+
+
+
+
+/***** Helper functions used only in this file *****/
+/*
+PRECONDITION
+  - The same as for the hooks of MatrixAllocator.
+POSTCONDITION
+  - The hooks of the default allocator, using malloc, realloc and free.
+*/
+static void* defaultAllocate(size_t bytes, size_t alignment, void* context);
+static void* defaultReallocate(void* memory, size_t oldBytes, size_t bytes, size_t alignment, void* context);
+static void defaultFree(void* memory, size_t bytes, void* context);
+
+
+/*
+PRECONDITION
+  - bytes is the size of an allocation and alignment is the alignment of its allocator.
+POSTCONDITION
+  - Returns the size of the block it needs, with room for the header and aligning the memory, else 0 if that
+    overflows.
+*/
+static size_t blockSize(size_t bytes, size_t alignment);
+
+
+/*
+PRECONDITION
+  - block is a block from an allocator and alignment is its alignment.
+POSTCONDITION
+  - Returns the first address in the block aligned to the alignment that leaves room for the header before it.
+*/
+static char* findMemory(void* block, size_t alignment);
+
+
+/*
+PRECONDITION
+  - block is a block of blockSize(bytes, alignment) bytes from the allocator.
+POSTCONDITION
+  - Writes the header of the memory before the address findMemory returns for the block.
+  - Returns the memory.
+*/
+static void* placeMemory(void* block, const MatrixAllocator* pAllocator, size_t bytes);
+
+
+/*
+PRECONDITION
+  - block is a block of blockSize(bytes, alignment) bytes from the allocator, or NULL if it couldn't be allocated.
+POSTCONDITION
+  - Places the memory in the block and counts it for the statistics.
+  - Returns the memory, else NULL if block is NULL.
+*/
+static void* newMemory(void* block, const MatrixAllocator* pAllocator, size_t bytes);
+
+
+/*
+PRECONDITION
+  - memory is memory returned by placeMemory.
+POSTCONDITION
+  - Returns a pointer to its header.
+*/
+static MemoryHeader* getHeader(void* memory);
+
+
+
+
+/***** Global variables *****/
+static const MatrixAllocator defaultAllocator = {
+	defaultAllocate, defaultReallocate, defaultFree, MATRIX_DEFAULT_ALIGNMENT, NULL
+};
+static const MatrixAllocator* _Atomic pCurrentAllocator = &defaultAllocator;
+
+
+
+
+/***** Functions defined in Matrix.h *****/
+Status matrix_setAllocator(const MatrixAllocator* pAllocator) {
+	if (!pAllocator) {
+		atomic_store(&pCurrentAllocator, &defaultAllocator);
+		return SUCCESS;
+	}
+
+	size_t alignment = pAllocator->alignment ? pAllocator->alignment : MATRIX_DEFAULT_ALIGNMENT;
+	if (!pAllocator->allocate || !pAllocator->free || (alignment & (alignment - 1)))
+		return FAILURE;
+
+	// the copy is never freed, since memory allocated with it can be freed at any time later, so it doesn't come from
+	// an allocator itself
+	MatrixAllocator* pCopy = malloc(sizeof(*pCopy));
+	if (!pCopy)
+		return FAILURE;
+	*pCopy = *pAllocator;
+	pCopy->alignment = (alignment < _Alignof(max_align_t)) ? _Alignof(max_align_t) : alignment;
+	atomic_store(&pCurrentAllocator, pCopy);
+
+	return SUCCESS;
+}
+
+
+
+void matrix_getAllocator(MatrixAllocator* pAllocator) {
+	*pAllocator = *atomic_load(&pCurrentAllocator);
+}
+
+
+
+
+/***** Helper functions shared with the other matrix implementation files - declared in MatrixInternal.h *****/
+void* allocateMemory(size_t bytes) {
+	const MatrixAllocator* pAllocator = atomic_load_explicit(&pCurrentAllocator, memory_order_acquire);
+	size_t size = blockSize(bytes, pAllocator->alignment);
+	if (!size)
+		return NULL;
+
+	return newMemory(pAllocator->allocate(size, pAllocator->alignment, pAllocator->context), pAllocator, bytes);
+}
+
+
+
+void* allocateZeroedMemory(size_t count, size_t size) {
+	const MatrixAllocator* pAllocator = atomic_load_explicit(&pCurrentAllocator, memory_order_acquire);
+	if (size && count > SIZE_MAX / size)
+		return NULL;
+	size_t bytes = count * size;
+	size_t blockBytes = blockSize(bytes, pAllocator->alignment);
+	if (!blockBytes)
+		return NULL;
+
+	// calloc rather than memset for the default allocator, so large arrays still get pages that are zeroed when
+	// they're first touched
+	if (pAllocator == &defaultAllocator)
+		return newMemory(calloc(1, blockBytes), pAllocator, bytes);
+
+	void* memory = newMemory(pAllocator->allocate(blockBytes, pAllocator->alignment, pAllocator->context), pAllocator,
+		bytes);
+	if (memory)
+		memset(memory, 0, bytes);
+
+	return memory;
+}
+
+
+
+void* reallocateMemory(void* memory, size_t bytes) {
+	if (!memory)
+		return allocateMemory(bytes);
+
+	MemoryHeader* pHeader = getHeader(memory);
+	const MatrixAllocator* pAllocator = pHeader->pAllocator;
+	size_t oldBytes = pHeader->bytes;
+	size_t keptBytes = (bytes < oldBytes) ? bytes : oldBytes;
+	size_t size = blockSize(bytes, pAllocator->alignment);
+	if (!size)
+		return NULL;
+
+	char* moved;
+	if (pAllocator->reallocate) {
+		size_t offset = (char*)memory - (char*)pHeader->block;
+		char* block = pAllocator->reallocate(pHeader->block, blockSize(oldBytes, pAllocator->alignment), size,
+			pAllocator->alignment, pAllocator->context);
+		if (!block)
+			return NULL;
+		// the block may have moved to an address with a different alignment, so the memory moves to its place in it
+		// before the header is written, which could overlap where it was
+		moved = findMemory(block, pAllocator->alignment);
+		if (moved != block + offset)
+			memmove(moved, block + offset, keptBytes);
+		placeMemory(block, pAllocator, bytes);
+	}
+	// without a reallocate hook the memory moves to a new allocation from the same allocator
+	else {
+		void* block = pAllocator->allocate(size, pAllocator->alignment, pAllocator->context);
+		if (!block)
+			return NULL;
+		moved = placeMemory(block, pAllocator, bytes);
+		memcpy(moved, memory, keptBytes);
+		pAllocator->free(pHeader->block, blockSize(oldBytes, pAllocator->alignment), pAllocator->context);
+	}
+	countMemory((bytes > oldBytes) ? bytes - oldBytes : 0, (long long)bytes - (long long)oldBytes);
+
+	return moved;
+}
+
+
+
+void freeMemory(void* memory) {
+	if (!memory)
+		return;
+
+	MemoryHeader* pHeader = getHeader(memory);
+	const MatrixAllocator* pAllocator = pHeader->pAllocator;
+	countMemory(0, -(long long)pHeader->bytes);
+	pAllocator->free(pHeader->block, blockSize(pHeader->bytes, pAllocator->alignment), pAllocator->context);
+}
+
+
+
+
+/***** Helper functions used only in this file *****/
+static void* defaultAllocate(size_t bytes, size_t alignment, void* context) {
+	(void)alignment;
+	(void)context;
+	return malloc(bytes);
+}
+
+
+
+static void* defaultReallocate(void* memory, size_t oldBytes, size_t bytes, size_t alignment, void* context) {
+	(void)oldBytes;
+	(void)alignment;
+	(void)context;
+	return realloc(memory, bytes);
+}
+
+
+
+static void defaultFree(void* memory, size_t bytes, void* context) {
+	(void)bytes;
+	(void)context;
+	free(memory);
+}
+
+
+
+static size_t blockSize(size_t bytes, size_t alignment) {
+	size_t overhead = sizeof(MemoryHeader) + alignment - 1;
+	return (bytes > SIZE_MAX - overhead) ? 0 : overhead + bytes;
+}
+
+
+
+static char* findMemory(void* block, size_t alignment) {
+	uintptr_t address = (uintptr_t)block + sizeof(MemoryHeader);
+	return (char*)((address + alignment - 1) & ~(uintptr_t)(alignment - 1));
+}
+
+
+
+static void* placeMemory(void* block, const MatrixAllocator* pAllocator, size_t bytes) {
+	char* memory = findMemory(block, pAllocator->alignment);
+
+	MemoryHeader* pHeader = getHeader(memory);
+	pHeader->block = block;
+	pHeader->pAllocator = pAllocator;
+	pHeader->bytes = bytes;
+
+	return memory;
+}
+
+
+
+static void* newMemory(void* block, const MatrixAllocator* pAllocator, size_t bytes) {
+	if (!block)
+		return NULL;
+
+	countMemory(bytes, (long long)bytes);
+	return placeMemory(block, pAllocator, bytes);
+}
+
+
+
+static MemoryHeader* getHeader(void* memory) {
+	return (MemoryHeader*)memory - 1;
+}
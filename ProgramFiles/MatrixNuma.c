@@ -0,0 +1,293 @@
+/*
+  Author: Benjamin G. Friedman
+  Date: 10/18/2026
+  File: MatrixNuma.c
+  Description:
+	  - Implementation file for the NUMA policy of the matrix interface, which places the memory of large arrays and
+		the threads of the task graphs on the nodes of the machine.
+	  - The nodes and their processors are read from /sys, and memory is placed with the mbind system call and
+		threads with their affinity, so nothing beyond the C library is needed. Placing memory is only a hint: if the
+		kernel refuses it (i.e. in a container that filters mbind), the memory is left where it is.
+	  - Each node with processors gets one share of the work, the nodes in the order of their ids. Share s of an
+		array is the s-th of as many even slices of it as there are shares, the same slices of rows the task graphs
+		place their tasks by.
+*/
+
+
+#define _GNU_SOURCE            // CPU_SET and pthread_setaffinity_np
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <stdatomic.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+#include "MatrixInternal.h"
+
+
+#define NUMA_ENVIRONMENT "MATRIX_NUMA"          // set to off, interleave or first-touch to choose the policy
+#define NUMA_NODE_PATH "/sys/devices/system/node"
+#define NUMA_MAX_NODES 64                       // nodes whose ids fit in the node mask of mbind
+#define NUMA_MIN_BYTES (4 << 20)                // smallest array that is placed by the policy
+
+
+
+
+/***** Structures *****/
+typedef struct numaNode {
+	int id;
+	cpu_set_t cpus;
+} NumaNode;
+
+// The share of an array one thread places (see distributeMemory)
+typedef struct shareWork {
+	char* memory;
+	size_t bytes;
+	int share;
+	Boolean zero;                      // zero the share once it's placed
+	Boolean pin;                       // pin the thread to the node first, FALSE for the calling thread
+} ShareWork;
+
+
+
+
+/***** Global variables *****/
+static pthread_once_t topologyOnce = PTHREAD_ONCE_INIT;
+static NumaNode nodes[NUMA_MAX_NODES];         // nodes with processors, in the order of their ids
+static int nodesSize;                          // 1 with no processors if the nodes couldn't be read
+static atomic_int numaPolicy = MATRIX_NUMA_OFF;
+
+
+
+
+/***** Helper functions used only in this file *****/
+/*
+PRECONDITION
+  - none.
+POSTCONDITION
+  - Reads the nodes of the machine and their processors, then the policy from the environment variable if it's set.
+  - Called once, before the nodes or the policy are first used.
+*/
+static void readTopology(void);
+
+
+/*
+PRECONDITION
+  - path is the path of a file in /sys holding a list of ranges such as "0-3,8,10-11".
+  - list is an array of capacity ints.
+POSTCONDITION
+  - Stores the numbers in the ranges in list, leaving out any that don't fit, and returns how many there are.
+  - Returns 0 if the file couldn't be read.
+*/
+static int readList(const char* path, int* list, int capacity);
+
+
+/*
+PRECONDITION
+  - argument is a pointer to the ShareWork of the thread.
+POSTCONDITION
+  - Places the share of the array on its node and zeroes it if asked to. Always returns NULL.
+*/
+static void* placeShare(void* argument);
+
+
+/*
+PRECONDITION
+  - memory/bytes are the memory to place, mode is MPOL_INTERLEAVE or MPOL_PREFERRED and mask has the bit of each
+    node to place it on set.
+POSTCONDITION
+  - Sets the policy of the whole pages of the memory and moves those already there that don't follow it.
+*/
+static void bindPages(void* memory, size_t bytes, int mode, unsigned long mask);
+
+
+
+
+/***** Functions defined in Matrix.h *****/
+Status matrix_setNumaPolicy(MatrixNumaPolicy policy) {
+	if (policy != MATRIX_NUMA_OFF && policy != MATRIX_NUMA_INTERLEAVE && policy != MATRIX_NUMA_FIRST_TOUCH)
+		return FAILURE;
+
+	// the environment is read first so it doesn't replace the policy later
+	pthread_once(&topologyOnce, readTopology);
+	atomic_store(&numaPolicy, policy);
+
+	return SUCCESS;
+}
+
+
+
+MatrixNumaPolicy matrix_getNumaPolicy(void) {
+	pthread_once(&topologyOnce, readTopology);
+
+	return atomic_load(&numaPolicy);
+}
+
+
+
+int matrix_getNumaNodes(void) {
+	pthread_once(&topologyOnce, readTopology);
+
+	return nodesSize;
+}
+
+
+
+
+/***** Helper functions shared with the other matrix implementation files - declared in MatrixInternal.h *****/
+int numaShares(void) {
+	pthread_once(&topologyOnce, readTopology);
+
+	return (atomic_load(&numaPolicy) != MATRIX_NUMA_OFF) ? nodesSize : 1;
+}
+
+
+
+void distributeMemory(void* memory, size_t bytes, Boolean zero) {
+	int shares = numaShares();
+
+	if (shares == 1 || bytes < NUMA_MIN_BYTES) {
+		if (zero)
+			memset(memory, 0, bytes);
+		return;
+	}
+
+	if (atomic_load(&numaPolicy) == MATRIX_NUMA_INTERLEAVE) {
+		unsigned long mask = 0;
+		for (int s = 0; s < shares; ++s)
+			mask |= 1UL << nodes[s].id;
+		bindPages(memory, bytes, MPOL_INTERLEAVE, mask);
+		if (zero)
+			memset(memory, 0, bytes);
+		return;
+	}
+
+	// a thread on each node places its share, all but the first on new threads
+	pthread_t threads[NUMA_MAX_NODES];
+	Boolean started[NUMA_MAX_NODES];
+	ShareWork work[NUMA_MAX_NODES];
+	for (int s = 0; s < shares; ++s) {
+		size_t first = bytes / shares * s;
+		size_t end = (s == shares - 1) ? bytes : bytes / shares * (s + 1);
+		work[s].memory = (char*)memory + first;
+		work[s].bytes = end - first;
+		work[s].share = s;
+		work[s].zero = zero;
+		work[s].pin = (s > 0) ? TRUE : FALSE;
+	}
+	for (int s = 1; s < shares; ++s)
+		started[s] = pthread_create(&threads[s], NULL, placeShare, &work[s]) ? FALSE : TRUE;
+	placeShare(&work[0]);
+	for (int s = 1; s < shares; ++s) {
+		if (started[s])
+			pthread_join(threads[s], NULL);
+		else {
+			work[s].pin = FALSE;
+			placeShare(&work[s]);
+		}
+	}
+}
+
+
+
+void pinThread(int share) {
+	if (numaShares() > 1 && CPU_COUNT(&nodes[share].cpus))
+		pthread_setaffinity_np(pthread_self(), sizeof(nodes[share].cpus), &nodes[share].cpus);
+}
+
+
+
+
+/***** Helper functions used only in this file *****/
+static void readTopology(void) {
+	int ids[NUMA_MAX_NODES];
+	int idsSize = readList(NUMA_NODE_PATH "/online", ids, NUMA_MAX_NODES);
+	static int cpus[CPU_SETSIZE];
+
+	for (int i = 0; i < idsSize; ++i) {
+		char path[sizeof(NUMA_NODE_PATH) + 32];
+		snprintf(path, sizeof(path), "%s/node%d/cpulist", NUMA_NODE_PATH, ids[i]);
+		int cpusSize = readList(path, cpus, CPU_SETSIZE);
+		// nodes with only memory don't get a share
+		if (!cpusSize)
+			continue;
+		NumaNode* pNode = &nodes[nodesSize++];
+		pNode->id = ids[i];
+		CPU_ZERO(&pNode->cpus);
+		for (int c = 0; c < cpusSize; ++c)
+			CPU_SET(cpus[c], &pNode->cpus);
+	}
+	if (!nodesSize) {
+		nodes[0].id = 0;
+		CPU_ZERO(&nodes[0].cpus);
+		nodesSize = 1;
+	}
+
+	const char* value = getenv(NUMA_ENVIRONMENT);
+	if (value && *value) {
+		if (!strcmp(value, "interleave"))
+			atomic_store(&numaPolicy, MATRIX_NUMA_INTERLEAVE);
+		else if (!strcmp(value, "first-touch"))
+			atomic_store(&numaPolicy, MATRIX_NUMA_FIRST_TOUCH);
+		// anything else leaves the policy off, which matrix_getNumaPolicy shows
+	}
+}
+
+
+
+static int readList(const char* path, int* list, int capacity) {
+	char text[4096];
+	FILE* fp = fopen(path, "r");
+	if (!fp)
+		return 0;
+	Boolean read = fgets(text, sizeof(text), fp) ? TRUE : FALSE;
+	fclose(fp);
+	if (!read)
+		return 0;
+
+	int size = 0;
+	char* range = text;
+	while (*range >= '0' && *range <= '9') {
+		char* end;
+		long first = strtol(range, &end, 10);
+		long last = first;
+		if (*end == '-')
+			last = strtol(end + 1, &end, 10);
+		for (long n = first; n <= last && size < capacity; ++n) {
+			if (n < capacity)
+				list[size++] = (int)n;
+		}
+		range = (*end == ',') ? end + 1 : end;
+	}
+
+	return size;
+}
+
+
+
+static void* placeShare(void* argument) {
+	ShareWork* pWork = argument;
+
+	if (pWork->pin)
+		pinThread(pWork->share);
+	bindPages(pWork->memory, pWork->bytes, MPOL_PREFERRED, 1UL << nodes[pWork->share].id);
+	// the pages of a new array are first touched here, on the node
+	if (pWork->zero)
+		memset(pWork->memory, 0, pWork->bytes);
+
+	return NULL;
+}
+
+
+
+static void bindPages(void* memory, size_t bytes, int mode, unsigned long mask) {
+	uintptr_t pageSize = (uintptr_t)sysconf(_SC_PAGESIZE);
+	uintptr_t first = ((uintptr_t)memory + pageSize - 1) & ~(pageSize - 1);
+	uintptr_t end = ((uintptr_t)memory + bytes) & ~(pageSize - 1);
+
+	// the partial pages at the ends are shared with other memory, so they're left alone
+	if (end > first)
+		syscall(SYS_mbind, first, end - first, mode, &mask, NUMA_MAX_NODES + 1, MPOL_MF_MOVE);
+}
@@ -0,0 +1,509 @@
+/*
+  Author: Benjamin G. Friedman
+  Date: 10/18/2026
+  File: MatrixStats.c
+  Description:
+	  - Implementation file for the statistics of the matrix interface.
+	  - Each operation of the interface is a measured call (see beginCall). While the statistics are off that costs
+		one relaxed load of the mode, so they can be left compiled in. Only the outermost measured call on a thread
+		is recorded, so the multiplications of matrix_power, for example, are part of the power and not counted as
+		multiplications.
+	  - Allocations are counted per thread, so the memory of an operation is what it and the operations it calls
+		allocate on the calling thread (see countMemory). Storage arrays mapped from files aren't allocations.
+	  - The counters are perf_event_open events of the thread, one file descriptor each rather than a group, so each one
+		that isn't available is simply left out. They're opened the first time a thread needs them and closed when it
+		exits.
+*/
+
+
+#define _DEFAULT_SOURCE        // clock_gettime
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include "MatrixInternal.h"
+
+
+#define STATS_ENVIRONMENT "MATRIX_STATS"        // set to 1 to write the statistics to stderr at exit, or to a path
+#define COUNTERS_ENVIRONMENT "MATRIX_COUNTERS"  // set to 1 to read the counters as well
+
+
+
+
+/***** Structures *****/
+// STATS_UNKNOWN until the environment is read by the first call that needs it
+typedef enum statsMode { STATS_UNKNOWN = -1, STATS_OFF, STATS_ON } StatsMode;
+
+// what reading a counter returns for PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING
+typedef struct counterReading {
+	uint64_t value;
+	uint64_t enabled;            // nanoseconds the counter was enabled
+	uint64_t running;            // nanoseconds it was actually counting, less if the kernel multiplexed it
+} CounterReading;
+
+typedef struct counterEvent {
+	uint32_t type;
+	uint64_t config;
+} CounterEvent;
+
+
+
+
+/***** Global variables *****/
+static atomic_int statsMode = STATS_UNKNOWN;
+static pthread_once_t environmentOnce = PTHREAD_ONCE_INIT;
+static pthread_mutex_t statsLock = PTHREAD_MUTEX_INITIALIZER;
+static FILE* statsFile;                    // file the environment variable names, opened when it's read
+static MatrixOperationStats stats[MATRIX_OPERATIONS];
+static const char* const operationNames[MATRIX_OPERATIONS] = {
+	"multiply", "add", "subtract", "power", "transpose", "determinant", "inverse", "qr", "qrPivoted", "leastSquares",
+	"leastSquaresPivoted", "cholesky", "solve", "updateInverse", "updateEntry", "updateRow", "updateColumn", "save",
+	"load", "saveNpy", "loadNpy", "readText", "writeText", "readMatrixMarket", "writeMatrixMarket", "loadCsv", "saveCsv",
+	"multiplyDistributed"
+};
+
+static atomic_int countersOn;
+static atomic_uint availableCounters;      // bit i is set once counter i has been opened on any thread
+static pthread_once_t counterKeyOnce = PTHREAD_ONCE_INIT;
+static pthread_key_t counterKey;           // closes the counters of a thread when it exits
+static const char* const counterNames[MATRIX_COUNTERS] = {
+	"cycles", "instructions", "cacheReferences", "cacheMisses", "tlbMisses", "pageFaults"
+};
+static const CounterEvent counterEvents[MATRIX_COUNTERS] = {
+	{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+	{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+	{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES },
+	{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+	{ PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+		(PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+	{ PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS }
+};
+
+// the measured calls running on this thread and the memory of the outermost one
+static _Thread_local int callDepth;
+static _Thread_local unsigned long long callAllocated;   // bytes allocated
+static _Thread_local long long callInUse;                // bytes allocated less bytes freed, negative if it freed older memory
+static _Thread_local long long callPeak;                 // most bytes in use at once
+
+// the counters of this thread and their readings when the outermost measured call began
+static _Thread_local Boolean countersOpened;
+static _Thread_local int counterFds[MATRIX_COUNTERS];     // -1 for a counter that isn't available
+static _Thread_local Boolean callCounted;
+static _Thread_local CounterReading callCounters[MATRIX_COUNTERS];
+
+
+
+
+/***** Helper functions used only in this file *****/
+/*
+PRECONDITION
+  - none.
+POSTCONDITION
+  - Turns the statistics on if the environment variable is set to anything but "" or "0" and registers writing them
+	at exit, to stderr for "1" and else to the file it names, which is opened now. Otherwise, or if the file can't be
+	opened, turns them off.
+  - Called once, before the mode is first used.
+*/
+static void readEnvironment(void);
+
+
+/*
+PRECONDITION
+  - none.
+POSTCONDITION
+  - Writes the statistics to stderr or the file the environment variable names, for atexit.
+*/
+static void writeStatsAtExit(void);
+
+
+/*
+PRECONDITION
+  - none.
+POSTCONDITION
+  - Returns the mode of the statistics, reading the environment first if it hasn't been.
+*/
+static StatsMode getMode(void);
+
+
+/*
+PRECONDITION
+  - none.
+POSTCONDITION
+  - Returns the time of the monotonic clock in seconds.
+*/
+static double now(void);
+
+
+/*
+PRECONDITION
+  - none.
+POSTCONDITION
+  - Opens the counters of this thread, setting the file descriptor of each one that isn't available to -1.
+*/
+static void openCounters(void);
+
+
+/*
+PRECONDITION
+  - fds is the array of file descriptors of the counters of a thread that's exiting.
+POSTCONDITION
+  - Closes the counters, for the destructor of counterKey.
+*/
+static void closeCounters(void* fds);
+
+
+/*
+PRECONDITION
+  - none.
+POSTCONDITION
+  - Creates counterKey.
+*/
+static void createCounterKey(void);
+
+
+/*
+PRECONDITION
+  - readings is an array of MATRIX_COUNTERS readings and the counters of this thread are open.
+POSTCONDITION
+  - Reads the counters into it, with a reading of 0 for a counter that isn't available.
+*/
+static void readCounters(CounterReading* readings);
+
+
+/*
+PRECONDITION
+  - counter is a counter.
+POSTCONDITION
+  - Returns TRUE if the counter has been opened on any thread, else FALSE.
+*/
+static Boolean isAvailable(MatrixCounter counter);
+
+
+/*
+PRECONDITION
+  - column is an array of at least 32 characters and format is a printf format for one double.
+POSTCONDITION
+  - Writes the value to the column with the format if it's known, else "-".
+*/
+static void formatCounter(char* column, const char* format, double value, Boolean known);
+
+
+
+
+/***** Functions defined in Matrix.h *****/
+void matrix_enableStats(Boolean enabled) {
+	pthread_once(&environmentOnce, readEnvironment);
+	atomic_store(&statsMode, enabled ? STATS_ON : STATS_OFF);
+}
+
+
+
+Boolean matrix_statsAreEnabled(void) {
+	return (getMode() == STATS_ON) ? TRUE : FALSE;
+}
+
+
+
+void matrix_getStats(MatrixOperation operation, MatrixOperationStats* pStats) {
+	pthread_mutex_lock(&statsLock);
+	*pStats = stats[operation];
+	pthread_mutex_unlock(&statsLock);
+}
+
+
+
+void matrix_resetStats(void) {
+	pthread_mutex_lock(&statsLock);
+	memset(stats, 0, sizeof(stats));
+	pthread_mutex_unlock(&statsLock);
+}
+
+
+
+const char* matrix_getOperationName(MatrixOperation operation) {
+	return operationNames[operation];
+}
+
+
+
+Status matrix_enableCounters(Boolean enabled) {
+	pthread_once(&environmentOnce, readEnvironment);
+	atomic_store(&countersOn, enabled);
+	if (!enabled)
+		return SUCCESS;
+
+	atomic_store(&statsMode, STATS_ON);
+	if (!countersOpened)
+		openCounters();
+
+	return (counterFds[MATRIX_COUNTER_CYCLES] >= 0 && counterFds[MATRIX_COUNTER_INSTRUCTIONS] >= 0) ? SUCCESS : FAILURE;
+}
+
+
+
+Boolean matrix_counterIsAvailable(MatrixCounter counter) {
+	return countersOpened && counterFds[counter] >= 0;
+}
+
+
+
+const char* matrix_getCounterName(MatrixCounter counter) {
+	return counterNames[counter];
+}
+
+
+
+Status matrix_writeStats(FILE* fp) {
+	MatrixOperationStats copy[MATRIX_OPERATIONS];
+	pthread_mutex_lock(&statsLock);
+	memcpy(copy, stats, sizeof(stats));
+	pthread_mutex_unlock(&statsLock);
+
+	fprintf(fp, "%-20s %10s %14s %12s %10s %16s %16s\n", "operation", "calls", "total (s)", "max (s)", "GFLOP/s",
+		"allocated (B)", "peak scratch (B)");
+	for (int i = 0; i < MATRIX_OPERATIONS; ++i) {
+		const MatrixOperationStats* pStats = &copy[i];
+		if (!pStats->calls)
+			continue;
+		double gflops = (pStats->seconds > 0) ? pStats->flops / pStats->seconds / 1e9 : 0;
+		fprintf(fp, "%-20s %10llu %14.6f %12.6f %10.3f %16llu %16llu\n", operationNames[i], pStats->calls, pStats->seconds,
+			pStats->maxSeconds, gflops, pStats->allocatedBytes, pStats->peakScratchBytes);
+	}
+
+	// counts per call, for the calls they were read for
+	Boolean anyCounted = FALSE;
+	for (int i = 0; i < MATRIX_OPERATIONS; ++i)
+		anyCounted = anyCounted || copy[i].countedCalls;
+	if (anyCounted) {
+		fprintf(fp, "\n%-20s %10s %8s %12s %14s %10s %14s %14s\n", "operation", "counted", "IPC", "flops/cycle",
+			"cache misses", "miss rate", "TLB misses", "page faults");
+		for (int i = 0; i < MATRIX_OPERATIONS; ++i) {
+			const MatrixOperationStats* pStats = &copy[i];
+			if (!pStats->countedCalls)
+				continue;
+			const double* counters = pStats->counters;
+			double calls = pStats->countedCalls;
+			double cycles = counters[MATRIX_COUNTER_CYCLES];
+			double references = counters[MATRIX_COUNTER_CACHE_REFERENCES];
+			// the floating point operations of the counted calls, assuming they're like the others
+			double flops = pStats->flops * calls / pStats->calls;
+			char columns[6][32];
+			formatCounter(columns[0], "%.3f", counters[MATRIX_COUNTER_INSTRUCTIONS] / cycles,
+				cycles && isAvailable(MATRIX_COUNTER_INSTRUCTIONS));
+			formatCounter(columns[1], "%.3f", flops / cycles, cycles);
+			formatCounter(columns[2], "%.0f", counters[MATRIX_COUNTER_CACHE_MISSES] / calls, isAvailable(MATRIX_COUNTER_CACHE_MISSES));
+			formatCounter(columns[3], "%.2f%%", 100 * counters[MATRIX_COUNTER_CACHE_MISSES] / references,
+				references && isAvailable(MATRIX_COUNTER_CACHE_MISSES));
+			formatCounter(columns[4], "%.0f", counters[MATRIX_COUNTER_TLB_MISSES] / calls, isAvailable(MATRIX_COUNTER_TLB_MISSES));
+			formatCounter(columns[5], "%.0f", counters[MATRIX_COUNTER_PAGE_FAULTS] / calls, isAvailable(MATRIX_COUNTER_PAGE_FAULTS));
+			fprintf(fp, "%-20s %10llu %8s %12s %14s %10s %14s %14s\n", operationNames[i], pStats->countedCalls, columns[0],
+				columns[1], columns[2], columns[3], columns[4], columns[5]);
+		}
+	}
+
+	return (fflush(fp) || ferror(fp)) ? FAILURE : SUCCESS;
+}
+
+
+
+
+/***** Helper functions shared with the other matrix implementation files - declared in MatrixInternal.h *****/
+void beginCall(MeasuredCall* pCall, MatrixOperation operation, MATRIX hOperand) {
+	Matrix* pOperand = hOperand;
+	beginSpan(&pCall->span, operationNames[operation], pOperand ? pOperand->rows : 0, pOperand ? pOperand->columns : 0);
+
+	pCall->counted = FALSE;
+	if (getMode() != STATS_ON)
+		return;
+
+	pCall->counted = TRUE;
+	pCall->operation = operation;
+	if (callDepth++ == 0) {
+		callAllocated = 0;
+		callInUse = 0;
+		callPeak = 0;
+		pCall->start = now();
+
+		// read last, so the counts are of the call and not of starting to measure it
+		callCounted = FALSE;
+		if (atomic_load_explicit(&countersOn, memory_order_relaxed)) {
+			if (!countersOpened)
+				openCounters();
+			for (int i = 0; i < MATRIX_COUNTERS; ++i)
+				callCounted = callCounted || counterFds[i] >= 0;
+			if (callCounted)
+				readCounters(callCounters);
+		}
+	}
+}
+
+
+
+void endCall(MeasuredCall* pCall, double flops) {
+	endSpan(&pCall->span);
+	if (!pCall->counted || --callDepth != 0)
+		return;
+
+	double counts[MATRIX_COUNTERS] = { 0 };
+	if (callCounted) {
+		CounterReading readings[MATRIX_COUNTERS];
+		readCounters(readings);
+		for (int i = 0; i < MATRIX_COUNTERS; ++i) {
+			CounterReading* pStart = &callCounters[i];
+			uint64_t running = readings[i].running - pStart->running;
+			// scaled up for the time the counter was enabled but not counting
+			if (running)
+				counts[i] = (double)(readings[i].value - pStart->value) * (readings[i].enabled - pStart->enabled) / running;
+		}
+	}
+	double seconds = now() - pCall->start;
+	pthread_mutex_lock(&statsLock);
+	MatrixOperationStats* pStats = &stats[pCall->operation];
+	++pStats->calls;
+	pStats->seconds += seconds;
+	if (seconds > pStats->maxSeconds)
+		pStats->maxSeconds = seconds;
+	pStats->flops += flops;
+	pStats->allocatedBytes += callAllocated;
+	if ((unsigned long long)callPeak > pStats->peakScratchBytes)
+		pStats->peakScratchBytes = callPeak;
+	if (callCounted) {
+		++pStats->countedCalls;
+		for (int i = 0; i < MATRIX_COUNTERS; ++i)
+			pStats->counters[i] += counts[i];
+	}
+	pthread_mutex_unlock(&statsLock);
+}
+
+
+
+void countMemory(size_t allocatedBytes, long long inUseChange) {
+	if (!callDepth)
+		return;
+
+	callAllocated += allocatedBytes;
+	callInUse += inUseChange;
+	if (callInUse > callPeak)
+		callPeak = callInUse;
+}
+
+
+
+
+/***** Helper functions used only in this file *****/
+static void readEnvironment(void) {
+	const char* value = getenv(STATS_ENVIRONMENT);
+	Boolean enabled = value && *value && strcmp(value, "0");
+	const char* counters = getenv(COUNTERS_ENVIRONMENT);
+	Boolean countersEnabled = counters && *counters && strcmp(counters, "0");
+
+	// the file is opened now so a program can tell it can't be written from the statistics being off
+	if (enabled && strcmp(value, "1") && !(statsFile = fopen(value, "w")))
+		enabled = countersEnabled = FALSE;
+	atomic_store(&countersOn, countersEnabled);
+	atomic_store(&statsMode, (enabled || countersEnabled) ? STATS_ON : STATS_OFF);
+	if (enabled || countersEnabled)
+		atexit(writeStatsAtExit);
+}
+
+
+
+static void writeStatsAtExit(void) {
+	if (!statsFile) {
+		matrix_writeStats(stderr);
+		return;
+	}
+
+	matrix_writeStats(statsFile);
+	fclose(statsFile);
+	statsFile = NULL;
+}
+
+
+
+static StatsMode getMode(void) {
+	int mode = atomic_load_explicit(&statsMode, memory_order_relaxed);
+	if (mode == STATS_UNKNOWN) {
+		pthread_once(&environmentOnce, readEnvironment);
+		mode = atomic_load(&statsMode);
+	}
+
+	return mode;
+}
+
+
+
+static double now(void) {
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+
+
+static void openCounters(void) {
+	pthread_once(&counterKeyOnce, createCounterKey);
+
+	for (int i = 0; i < MATRIX_COUNTERS; ++i) {
+		struct perf_event_attr attributes;
+		memset(&attributes, 0, sizeof(attributes));
+		attributes.size = sizeof(attributes);
+		attributes.type = counterEvents[i].type;
+		attributes.config = counterEvents[i].config;
+		attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+		// user space only, which perf_event_paranoid up to 2 allows without privileges
+		attributes.exclude_kernel = 1;
+		attributes.exclude_hv = 1;
+		counterFds[i] = (int)syscall(SYS_perf_event_open, &attributes, 0, -1, -1, PERF_FLAG_FD_CLOEXEC);
+		if (counterFds[i] >= 0)
+			atomic_fetch_or(&availableCounters, 1u << i);
+	}
+	countersOpened = TRUE;
+	pthread_setspecific(counterKey, counterFds);
+}
+
+
+
+static void closeCounters(void* fds) {
+	int* threadFds = fds;
+	for (int i = 0; i < MATRIX_COUNTERS; ++i) {
+		if (threadFds[i] >= 0)
+			close(threadFds[i]);
+	}
+}
+
+
+
+static void createCounterKey(void) {
+	pthread_key_create(&counterKey, closeCounters);
+}
+
+
+
+static void readCounters(CounterReading* readings) {
+	for (int i = 0; i < MATRIX_COUNTERS; ++i) {
+		if (counterFds[i] < 0 || read(counterFds[i], &readings[i], sizeof(readings[i])) != sizeof(readings[i]))
+			memset(&readings[i], 0, sizeof(readings[i]));
+	}
+}
+
+
+
+static Boolean isAvailable(MatrixCounter counter) {
+	return (atomic_load(&availableCounters) >> counter) & 1u;
+}
+
+
+
+static void formatCounter(char* column, const char* format, double value, Boolean known) {
+	if (known)
+		snprintf(column, 32, format, value);
+	else
+		strcpy(column, "-");
+}
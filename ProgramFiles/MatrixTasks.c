@@ -0,0 +1,461 @@
+/*
+  Author: Benjamin G. Friedman
+  Date: 10/18/2026
+  File: MatrixTasks.c
+  Description:
+	  - Implementation file for the task graphs the factorizations of large matrices are run as, and the work-stealing
+		scheduler that runs them.
+	  - Each thread has a deque of the tasks that are ready. A thread runs the newest task of its own deque, so the
+		tasks a finished task makes ready run next on the same thread while their tiles are still in its cache, and
+		steals the oldest task of another thread's deque when its own is empty. The deques are linked through the
+		tasks, so they take no memory of their own however many tasks become ready at once.
+	  - A task becomes ready when the count of the unfinished tasks it depends on reaches 0. The thread that finishes
+		the last of them pushes it to its own deque.
+	  - Under a NUMA policy the threads are split into a group per node, the threads started for the graph pinned to
+		its processors. A task whose rows are on another node is pushed to a thread of that node instead, and threads
+		steal from their own node before the others.
+*/
+
+
+#define _DEFAULT_SOURCE        // sysconf(_SC_NPROCESSORS_ONLN)
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <stdatomic.h>
+#include "MatrixInternal.h"
+
+
+#define TASK_MAX_THREADS 64           // most threads a graph is run on
+#define TASK_INITIAL_CAPACITY 64      // tasks and dependencies a graph has room for before it first grows
+
+
+
+
+/***** Structures *****/
+typedef struct task {
+	int kind;                          // passed to the function of the graph with the tiles
+	size_t i;
+	size_t j;
+	size_t k;
+	atomic_size_t dependencies;        // unfinished tasks it depends on
+	size_t firstSuccessor;             // the tasks that depend on it are successors[firstSuccessor...]
+	size_t successorsSize;
+	size_t older;                      // neighbours in the deque holding it, TASK_NONE at the ends
+	size_t newer;
+} Task;
+
+typedef struct taskDeque {
+	pthread_mutex_t lock;
+	size_t oldest;                     // TASK_NONE if it's empty
+	size_t newest;
+} TaskDeque;
+
+struct taskGraph {
+	TaskFunction function;
+	void* context;
+	size_t tiles;                      // tile rows of the data, which place a task on tile row i near its rows
+	Task* tasks;
+	size_t tasksSize;
+	size_t tasksCapacity;
+	size_t* dependencies;              // pairs of the task depended on and the task that depends on it, in order
+	size_t dependenciesSize;           // pairs
+	size_t dependenciesCapacity;
+	Boolean failed;                    // memory allocation failed while it was built
+	size_t* successors;                // the rest is set up by runTaskGraph
+	TaskDeque* deques;
+	int dequesSize;
+	int shares;                        // groups of threads, one per NUMA node if there's a policy
+	atomic_uint spread;                // turns a task pushed to another group goes to the next thread of it
+	atomic_size_t unfinished;          // tasks that haven't run or been skipped
+	atomic_bool stopped;               // a task returned FALSE
+};
+
+typedef struct taskWorker {
+	TaskGraph* pGraph;
+	int index;                         // of its deque
+} TaskWorker;
+
+
+
+
+/***** Global variables *****/
+static atomic_int requestedThreads;        // set by matrix_setFactorizationThreads, 0 for one per processor
+
+
+
+
+/***** Helper functions used only in this file *****/
+/*
+PRECONDITION
+  - argument is a pointer to the TaskWorker of the thread.
+POSTCONDITION
+  - Runs tasks of the graph until all of them have finished. Always returns NULL.
+*/
+static void* runWorker(void* argument);
+
+
+/*
+PRECONDITION
+  - pGraph is a pointer to a graph being run, id is a task taken from one of its deques and index is the deque of the
+    calling thread.
+POSTCONDITION
+  - Runs the task, unless the graph has been stopped, and pushes the tasks that were only waiting for it to the deque.
+*/
+static void runTask(TaskGraph* pGraph, size_t id, int index);
+
+
+/*
+PRECONDITION
+  - pGraph is a pointer to a graph being run and id is a ready task that isn't in a deque.
+  - index is the deque of the calling thread.
+POSTCONDITION
+  - Pushes the task to the deque if the thread is in the group of the task's rows, else to the deque of a thread of
+    that group, taking them in turn.
+*/
+static void pushReadyTask(TaskGraph* pGraph, size_t id, int index);
+
+
+/*
+PRECONDITION
+  - pGraph is a pointer to a graph being run and pDeque is a pointer to one of its deques.
+  - id is a ready task that isn't in a deque.
+POSTCONDITION
+  - Makes the task the newest of the deque.
+*/
+static void pushTask(TaskGraph* pGraph, TaskDeque* pDeque, size_t id);
+
+
+/*
+PRECONDITION
+  - pGraph is a pointer to a graph being run.
+  - index is a deque of the graph and share is a group of its threads.
+POSTCONDITION
+  - Returns the group of the thread of the deque, the first deque of the threads of the group and the deque after
+    their last one. The groups are even slices of the threads in order.
+*/
+static int shareOfWorker(const TaskGraph* pGraph, int index);
+static int firstWorkerOfShare(const TaskGraph* pGraph, int share);
+
+
+/*
+PRECONDITION
+  - pGraph is a pointer to a graph being run and pDeque is a pointer to one of its deques.
+  - newest is TRUE to take the newest task, for the deque's own thread, or FALSE to take the oldest, for stealing.
+POSTCONDITION
+  - Removes the task from the deque and returns it, else TASK_NONE if the deque is empty.
+*/
+static size_t takeTask(TaskGraph* pGraph, TaskDeque* pDeque, Boolean newest);
+
+
+/*
+PRECONDITION
+  - pArray is a pointer to an array allocated with allocateMemory or NULL, with the capacity pointed to by pCapacity.
+  - elementSize is the size of its elements and size is the number of them it needs room for.
+POSTCONDITION
+  - Doubles the capacity of the array until it has room for size elements.
+  - Returns SUCCESS, else FAILURE for any memory allocation failure, in which case the array is unchanged.
+*/
+static Status reserve(void** pArray, size_t* pCapacity, size_t elementSize, size_t size);
+
+
+
+
+/***** Functions defined in Matrix.h *****/
+void matrix_setFactorizationThreads(int threads) {
+	atomic_store(&requestedThreads, (threads > 0) ? threads : 0);
+}
+
+
+
+int matrix_getFactorizationThreads(void) {
+	return taskThreads();
+}
+
+
+
+
+/***** Helper functions shared with the other matrix implementation files - declared in MatrixInternal.h *****/
+TaskGraph* createTaskGraph(TaskFunction function, void* context, size_t tiles) {
+	TaskGraph* pGraph = allocateZeroedMemory(1, sizeof(*pGraph));
+	if (!pGraph)
+		return NULL;
+
+	pGraph->function = function;
+	pGraph->context = context;
+	pGraph->tiles = tiles ? tiles : 1;
+
+	return pGraph;
+}
+
+
+
+size_t addTask(TaskGraph* pGraph, int kind, size_t i, size_t j, size_t k) {
+	if (pGraph->failed || !reserve((void**)&pGraph->tasks, &pGraph->tasksCapacity, sizeof(*pGraph->tasks),
+		pGraph->tasksSize + 1)) {
+		pGraph->failed = TRUE;
+		return TASK_NONE;
+	}
+
+	Task* pTask = &pGraph->tasks[pGraph->tasksSize];
+	pTask->kind = kind;
+	pTask->i = i;
+	pTask->j = j;
+	pTask->k = k;
+	atomic_init(&pTask->dependencies, 0);
+	pTask->successorsSize = 0;
+
+	return pGraph->tasksSize++;
+}
+
+
+
+void addDependency(TaskGraph* pGraph, size_t before, size_t after) {
+	if (before == TASK_NONE || after == TASK_NONE || pGraph->failed)
+		return;
+	if (!reserve((void**)&pGraph->dependencies, &pGraph->dependenciesCapacity, 2 * sizeof(*pGraph->dependencies),
+		pGraph->dependenciesSize + 1)) {
+		pGraph->failed = TRUE;
+		return;
+	}
+
+	pGraph->dependencies[2 * pGraph->dependenciesSize] = before;
+	pGraph->dependencies[2 * pGraph->dependenciesSize + 1] = after;
+	++pGraph->dependenciesSize;
+}
+
+
+
+Status runTaskGraph(TaskGraph* pGraph) {
+	if (pGraph->failed)
+		return FAILURE;
+
+	int threads = taskThreads();
+	if ((size_t)threads > pGraph->tasksSize)
+		threads = pGraph->tasksSize ? (int)pGraph->tasksSize : 1;
+	if (!(pGraph->successors = allocateMemory(pGraph->dependenciesSize * sizeof(*pGraph->successors))))
+		return FAILURE;
+	if (!(pGraph->deques = allocateMemory(threads * sizeof(*pGraph->deques)))) {
+		freeMemory(pGraph->successors);
+		pGraph->successors = NULL;
+		return FAILURE;
+	}
+	pGraph->dequesSize = threads;
+	pGraph->shares = (numaShares() < threads) ? numaShares() : threads;
+	atomic_init(&pGraph->spread, 0);
+
+	// lay the tasks that depend on each task out together, keeping the order their dependencies were added in
+	for (size_t d = 0; d < pGraph->dependenciesSize; ++d) {
+		++pGraph->tasks[pGraph->dependencies[2 * d]].successorsSize;
+		atomic_fetch_add_explicit(&pGraph->tasks[pGraph->dependencies[2 * d + 1]].dependencies, 1, memory_order_relaxed);
+	}
+	size_t first = 0;
+	for (size_t t = 0; t < pGraph->tasksSize; ++t) {
+		pGraph->tasks[t].firstSuccessor = first;
+		first += pGraph->tasks[t].successorsSize;
+		pGraph->tasks[t].successorsSize = 0;
+	}
+	for (size_t d = 0; d < pGraph->dependenciesSize; ++d) {
+		Task* pBefore = &pGraph->tasks[pGraph->dependencies[2 * d]];
+		pGraph->successors[pBefore->firstSuccessor + pBefore->successorsSize++] = pGraph->dependencies[2 * d + 1];
+	}
+
+	// deal the tasks that are ready out to the deques, with the first added on top of each
+	for (int d = 0; d < threads; ++d) {
+		pthread_mutex_init(&pGraph->deques[d].lock, NULL);
+		pGraph->deques[d].oldest = pGraph->deques[d].newest = TASK_NONE;
+	}
+	size_t ready = 0;
+	for (size_t t = pGraph->tasksSize; t-- > 0;) {
+		if (!atomic_load_explicit(&pGraph->tasks[t].dependencies, memory_order_relaxed))
+			pushReadyTask(pGraph, t, (int)(ready++ % threads));
+	}
+	atomic_init(&pGraph->unfinished, pGraph->tasksSize);
+	atomic_init(&pGraph->stopped, FALSE);
+
+	// the calling thread is the first worker - a thread that can't be started leaves its tasks to be stolen
+	pthread_t workerThreads[TASK_MAX_THREADS];
+	Boolean started[TASK_MAX_THREADS];
+	TaskWorker workers[TASK_MAX_THREADS];
+	for (int w = 0; w < threads; ++w) {
+		workers[w].pGraph = pGraph;
+		workers[w].index = w;
+	}
+	for (int w = 1; w < threads; ++w)
+		started[w] = pthread_create(&workerThreads[w], NULL, runWorker, &workers[w]) ? FALSE : TRUE;
+	runWorker(&workers[0]);
+	for (int w = 1; w < threads; ++w) {
+		if (started[w])
+			pthread_join(workerThreads[w], NULL);
+	}
+
+	for (int d = 0; d < threads; ++d)
+		pthread_mutex_destroy(&pGraph->deques[d].lock);
+
+	return SUCCESS;
+}
+
+
+
+void freeTaskGraph(TaskGraph* pGraph) {
+	if (!pGraph)
+		return;
+
+	freeMemory(pGraph->tasks);
+	freeMemory(pGraph->dependencies);
+	freeMemory(pGraph->successors);
+	freeMemory(pGraph->deques);
+	freeMemory(pGraph);
+}
+
+
+
+int taskThreads(void) {
+	int threads = atomic_load(&requestedThreads);
+	if (threads <= 0) {
+		long processors = sysconf(_SC_NPROCESSORS_ONLN);
+		threads = (processors > 0 && processors < TASK_MAX_THREADS) ? (int)processors : TASK_MAX_THREADS;
+	}
+
+	return (threads < TASK_MAX_THREADS) ? threads : TASK_MAX_THREADS;
+}
+
+
+
+
+/***** Helper functions used only in this file *****/
+static void* runWorker(void* argument) {
+	TaskWorker* pWorker = argument;
+	TaskGraph* pGraph = pWorker->pGraph;
+	int share = shareOfWorker(pGraph, pWorker->index);
+
+	// the calling thread keeps its affinity
+	if (pWorker->index > 0 && pGraph->shares > 1)
+		pinThread(share);
+
+	while (atomic_load_explicit(&pGraph->unfinished, memory_order_acquire)) {
+		size_t id = takeTask(pGraph, &pGraph->deques[pWorker->index], TRUE);
+		// steal from the threads of the same node first
+		for (int remote = 0; id == TASK_NONE && remote < 2; ++remote) {
+			for (int d = 1; id == TASK_NONE && d < pGraph->dequesSize; ++d) {
+				int victim = (pWorker->index + d) % pGraph->dequesSize;
+				if ((shareOfWorker(pGraph, victim) != share) == remote)
+					id = takeTask(pGraph, &pGraph->deques[victim], FALSE);
+			}
+		}
+
+		// every ready task is being run - the rest are waiting for them
+		if (id == TASK_NONE)
+			sched_yield();
+		else
+			runTask(pGraph, id, pWorker->index);
+	}
+
+	return NULL;
+}
+
+
+
+static void runTask(TaskGraph* pGraph, size_t id, int index) {
+	Task* pTask = &pGraph->tasks[id];
+
+	if (!atomic_load_explicit(&pGraph->stopped, memory_order_relaxed)
+		&& !pGraph->function(pGraph->context, pTask->kind, pTask->i, pTask->j, pTask->k))
+		atomic_store_explicit(&pGraph->stopped, TRUE, memory_order_relaxed);
+
+	// pushed last first, so the first of them is the newest and runs next on this thread
+	for (size_t s = pTask->successorsSize; s-- > 0;) {
+		size_t successor = pGraph->successors[pTask->firstSuccessor + s];
+		if (atomic_fetch_sub_explicit(&pGraph->tasks[successor].dependencies, 1, memory_order_acq_rel) == 1)
+			pushReadyTask(pGraph, successor, index);
+	}
+	atomic_fetch_sub_explicit(&pGraph->unfinished, 1, memory_order_release);
+}
+
+
+
+static void pushReadyTask(TaskGraph* pGraph, size_t id, int index) {
+	size_t i = pGraph->tasks[id].i;
+	int home = (int)(((i < pGraph->tiles) ? i : pGraph->tiles - 1) * pGraph->shares / pGraph->tiles);
+
+	if (home != shareOfWorker(pGraph, index)) {
+		int first = firstWorkerOfShare(pGraph, home);
+		int workers = firstWorkerOfShare(pGraph, home + 1) - first;
+		index = first + (int)(atomic_fetch_add_explicit(&pGraph->spread, 1, memory_order_relaxed) % workers);
+	}
+	pushTask(pGraph, &pGraph->deques[index], id);
+}
+
+
+
+static void pushTask(TaskGraph* pGraph, TaskDeque* pDeque, size_t id) {
+	Task* pTask = &pGraph->tasks[id];
+
+	pthread_mutex_lock(&pDeque->lock);
+	pTask->older = pDeque->newest;
+	pTask->newer = TASK_NONE;
+	if (pDeque->newest != TASK_NONE)
+		pGraph->tasks[pDeque->newest].newer = id;
+	else
+		pDeque->oldest = id;
+	pDeque->newest = id;
+	pthread_mutex_unlock(&pDeque->lock);
+}
+
+
+
+static size_t takeTask(TaskGraph* pGraph, TaskDeque* pDeque, Boolean newest) {
+	pthread_mutex_lock(&pDeque->lock);
+	size_t id = newest ? pDeque->newest : pDeque->oldest;
+	if (id != TASK_NONE) {
+		Task* pTask = &pGraph->tasks[id];
+		if (newest) {
+			pDeque->newest = pTask->older;
+			if (pTask->older != TASK_NONE)
+				pGraph->tasks[pTask->older].newer = TASK_NONE;
+			else
+				pDeque->oldest = TASK_NONE;
+		}
+		else {
+			pDeque->oldest = pTask->newer;
+			if (pTask->newer != TASK_NONE)
+				pGraph->tasks[pTask->newer].older = TASK_NONE;
+			else
+				pDeque->newest = TASK_NONE;
+		}
+	}
+	pthread_mutex_unlock(&pDeque->lock);
+
+	return id;
+}
+
+
+
+static int shareOfWorker(const TaskGraph* pGraph, int index) {
+	return index * pGraph->shares / pGraph->dequesSize;
+}
+
+
+
+static int firstWorkerOfShare(const TaskGraph* pGraph, int share) {
+	return (share * pGraph->dequesSize + pGraph->shares - 1) / pGraph->shares;
+}
+
+
+
+static Status reserve(void** pArray, size_t* pCapacity, size_t elementSize, size_t size) {
+	if (size <= *pCapacity)
+		return SUCCESS;
+
+	size_t capacity = *pCapacity ? *pCapacity : TASK_INITIAL_CAPACITY;
+	while (capacity < size)
+		capacity *= 2;
+	if (capacity > SIZE_MAX / elementSize)
+		return FAILURE;
+	void* array = reallocateMemory(*pArray, capacity * elementSize);
+	if (!array)
+		return FAILURE;
+	*pArray = array;
+	*pCapacity = capacity;
+
+	return SUCCESS;
+}
@@ -0,0 +1,957 @@
+/*
+  Author: Benjamin G. Friedman
+  Date: 10/18/2026
+  File: MatrixText.c
+  Description:
+	  - Implementation file for reading and writing matrix objects as text, one line per row with the entries separated by blanks.
+	  - The text is read through a buffer a line at a time and each number is converted as soon as its end is found,
+		so validating, converting and storing the entries is a single pass over the text.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <float.h>
+#include <math.h>
+#include <errno.h>
+#include "MatrixInternal.h"
+
+
+#define TEXT_NUMBER_MAX 512            // longest number handed to strtold when it can't be converted exactly by the fast path
+#define FIXED_FAST_MAX 1e9L            // numbers below this are rounded to 6 decimal places without printf
+
+// Numbers with at most FAST_MAX_DIGITS significant digits and a power of ten up to FAST_MAX_EXPONENT are converted
+// with one multiplication or division of exact long doubles, which rounds correctly. Everything else goes to strtold.
+// Formatting searches for the fewest digits that convert back to the number the same way, so it's exact as well.
+#if LDBL_MANT_DIG >= 64
+#define FAST_MAX_DIGITS 19             // 10^19 < 2^64, so the digits fit in a uint64_t and convert exactly
+#define FAST_MAX_EXPONENT 27           // 5^27 < 2^64, so 10^27 is exact
+#else
+#define FAST_MAX_DIGITS 15             // 10^15 < 2^53
+#define FAST_MAX_EXPONENT 22           // 5^22 < 2^53
+#endif
+
+
+
+
+/***** Global variables *****/
+// The powers of ten that are exact long doubles, used by the fast paths of parsing and formatting
+static const long double powersOfTen[] = {
+	1e0L, 1e1L, 1e2L, 1e3L, 1e4L, 1e5L, 1e6L, 1e7L, 1e8L, 1e9L, 1e10L, 1e11L, 1e12L, 1e13L,
+	1e14L, 1e15L, 1e16L, 1e17L, 1e18L, 1e19L, 1e20L, 1e21L, 1e22L, 1e23L, 1e24L, 1e25L, 1e26L, 1e27L
+};
+
+
+
+
+/***** Helper functions used only in this file *****/
+/*
+PRECONDITION
+  - pReader is a pointer to an initialized reader.
+POSTCONDITION
+  - Moves the characters from the reader's position on to the start of the buffer and reads the rest of the line
+    (or as much of it as fits) in after them.
+  - Returns TRUE if any characters were read, else FALSE (the end of the file, or the buffer is full).
+*/
+static Boolean refill(TextReader* pReader);
+
+
+/*
+PRECONDITION
+  - c is any character.
+POSTCONDITION
+  - Returns TRUE if c can be part of a number, else FALSE.
+*/
+static Boolean isNumberCharacter(char c);
+
+
+/*
+PRECONDITION
+  - c is any character.
+POSTCONDITION
+  - Returns TRUE if c is a decimal digit, else FALSE. Unlike isdigit it doesn't depend on the locale.
+*/
+static Boolean isDigit(char c);
+
+
+/*
+PRECONDITION
+  - token is an array of length characters, not NUL terminated.
+  - pNumber is a pointer to the variable that receives the number.
+POSTCONDITION
+  - Converts the token if it's a decimal floating point number and returns TRUE, else returns FALSE.
+*/
+static Boolean parseNumber(const char* token, size_t length, long double* pNumber);
+
+
+/*
+PRECONDITION
+  - Same as parseNumber, for tokens the fast path can't convert exactly.
+POSTCONDITION
+  - Converts the token with strtold and returns TRUE, else FALSE if it's too long or overflows a long double.
+*/
+static Boolean parseNumberSlow(const char* token, size_t length, long double* pNumber);
+
+
+/*
+PRECONDITION
+  - pWriter is a pointer to a writer.
+POSTCONDITION
+  - Same as writeCharacters for count copies of the character c.
+*/
+static void writeRepeated(TextWriter* pWriter, char c, size_t count);
+
+
+/*
+PRECONDITION
+  - pWriter is a pointer to a writer.
+  - pMatrix is a pointer to a valid matrix object.
+POSTCONDITION
+  - Writes the matrix in the MATRIX_TEXT_BOXED format, working out its max length first if needed.
+*/
+static void writeBoxed(TextWriter* pWriter, Matrix* pMatrix);
+
+
+/*
+PRECONDITION
+  - pWriter is a pointer to a writer.
+  - pMatrix is a pointer to a valid matrix object.
+  - separator is the character between the entries of a row.
+POSTCONDITION
+  - Writes the matrix one row per line with each entry in the shortest form that reads back the same.
+*/
+static void writeSeparated(TextWriter* pWriter, const Matrix* pMatrix, char separator);
+
+
+/*
+PRECONDITION
+  - n is a positive finite long double.
+  - digits is an array of at least LDBL_DECIMAL_DIG + 1 characters.
+  - pDigitsSize/pExponent are pointers to the variables that receive the number of digits and the power of ten of the first one.
+  - pFewestDigits is a pointer to the variable that receives the fewest digits left to try if this fails.
+POSTCONDITION
+  - Stores the significant digits of the shortest decimal that converts back to n, without trailing zeroes, and returns
+    TRUE. Uses the exact conversion of the parsing fast path, so it returns FALSE for n too large or small for it, or
+    if n needs more than FAST_MAX_DIGITS digits.
+*/
+static Boolean shortestDigitsFast(long double n, char* digits, int* pDigitsSize, int* pExponent, int* pFewestDigits);
+
+
+/*
+PRECONDITION
+  - Same as shortestDigitsFast.
+  - fewestDigits is the fewest digits that could convert back to n.
+POSTCONDITION
+  - Same as shortestDigitsFast for any n, using snprintf and strtold.
+*/
+static void shortestDigitsSlow(long double n, int fewestDigits, char* digits, int* pDigitsSize, int* pExponent);
+
+
+/*
+PRECONDITION
+  - n is a positive long double, p is in [1, FAST_MAX_DIGITS] and exponent is the power of ten of n's first digit.
+  - pDigits/pScale are pointers to the variables that receive the result.
+POSTCONDITION
+  - Rounds n to p significant digits as digits * 10^-scale. Returns TRUE if that converts back to n exactly,
+    else FALSE (including if the scaling can't be done with exact powers of ten).
+*/
+static Boolean roundsTrip(long double n, int p, int exponent, uint64_t* pDigits, int* pScale);
+
+
+/*
+PRECONDITION
+  - pMatrix is a pointer to a valid matrix object.
+  - pReader is a pointer to an initialized reader.
+  - pMemoryAllocation is a pointer to a status to check for memory allocation failure.
+POSTCONDITION
+  - Implements matrix_readText for any reader.
+*/
+static Status readRows(Matrix* pMatrix, TextReader* pReader, Status* pMemoryAllocation);
+
+
+/*
+PRECONDITION
+  - pReader is a pointer to an initialized reader.
+POSTCONDITION
+  - Implements matrix_initFromText for any reader.
+*/
+static Matrix* readMatrix(TextReader* pReader);
+
+
+
+
+/***** Functions defined in Matrix.h *****/
+Status matrix_readText(MATRIX hMatrix, FILE* fp, Status* pMemoryAllocation) {
+	TextReader reader;
+	MeasuredCall call;
+	Status status = FAILURE;
+
+	beginCall(&call, MATRIX_OPERATION_READ_TEXT, hMatrix);
+	if (initTextReaderFile(&reader, fp)) {
+		status = readRows(hMatrix, &reader, pMemoryAllocation);
+		freeTextReader(&reader);
+	}
+	else
+		*pMemoryAllocation = FAILURE;
+	endCall(&call, 0);
+
+	return status;
+}
+
+
+
+Status matrix_readTextBuffer(MATRIX hMatrix, const char* text, size_t length, Status* pMemoryAllocation) {
+	TextReader reader;
+	MeasuredCall call;
+
+	beginCall(&call, MATRIX_OPERATION_READ_TEXT, hMatrix);
+	initTextReaderBuffer(&reader, text, length);
+	Status status = readRows(hMatrix, &reader, pMemoryAllocation);
+	endCall(&call, 0);
+
+	return status;
+}
+
+
+
+MATRIX matrix_initFromText(FILE* fp) {
+	TextReader reader;
+	MeasuredCall call;
+	Matrix* pMatrix = NULL;
+
+	beginCall(&call, MATRIX_OPERATION_READ_TEXT, NULL);
+	if (initTextReaderFile(&reader, fp)) {
+		pMatrix = readMatrix(&reader);
+		freeTextReader(&reader);
+	}
+	endCall(&call, 0);
+
+	return pMatrix;
+}
+
+
+
+MATRIX matrix_initFromTextBuffer(const char* text, size_t length) {
+	TextReader reader;
+	MeasuredCall call;
+
+	beginCall(&call, MATRIX_OPERATION_READ_TEXT, NULL);
+	initTextReaderBuffer(&reader, text, length);
+	Matrix* pMatrix = readMatrix(&reader);
+	endCall(&call, 0);
+
+	return pMatrix;
+}
+
+
+
+
+Status matrix_writeText(MATRIX hMatrix, FILE* fp, MatrixTextFormat format) {
+	TextWriter writer;
+	MeasuredCall call;
+
+	beginCall(&call, MATRIX_OPERATION_WRITE_TEXT, hMatrix);
+	initTextWriter(&writer, fp);
+	switch (format) {
+	case MATRIX_TEXT_BOXED:
+		writeBoxed(&writer, hMatrix);
+		break;
+	case MATRIX_TEXT_CSV:
+		writeSeparated(&writer, hMatrix, ',');
+		break;
+	case MATRIX_TEXT_TSV:
+		writeSeparated(&writer, hMatrix, '\t');
+		break;
+	default:
+		writeSeparated(&writer, hMatrix, ' ');
+		break;
+	}
+	flushWriter(&writer);
+	endCall(&call, 0);
+
+	return (writer.failed || ferror(fp)) ? FAILURE : SUCCESS;
+}
+
+
+
+
+/***** Helper functions shared with the other matrix implementation files - declared in MatrixInternal.h *****/
+int formatFixed(long double n, char* numString) {
+	char* pNext = numString;
+
+	// n * 10^6 is close enough to exact below FIXED_FAST_MAX to round it directly, unless it's almost halfway
+	long double scaled = fabsl(n) * 1e6L;
+	long double whole = floorl(scaled);
+	long double fraction = scaled - whole;
+	if (fabsl(n) < FIXED_FAST_MAX && fabsl(fraction - 0.5L) > 1e-3L) {
+		uint64_t rounded = (uint64_t)whole + (fraction > 0.5L);
+		uint32_t decimals = rounded % 1000000;
+		if (signbit(n))
+			*pNext++ = '-';
+		pNext += writeUnsigned(rounded / 1000000, pNext);
+		if (decimals != 0) {
+			*pNext++ = '.';
+			for (uint32_t place = 100000; decimals != 0; place /= 10) {
+				*pNext++ = (char)('0' + decimals / place);
+				decimals %= place;
+			}
+		}
+		*pNext = '\0';
+		return (int)(pNext - numString);
+	}
+
+	// halfway cases, huge numbers, infinity and NaN
+	int length = sprintf(numString, "%Lf", n);
+	if (strchr(numString, '.')) {
+		while (numString[length - 1] == '0')
+			--length;
+		if (numString[length - 1] == '.')
+			--length;
+		numString[length] = '\0';
+	}
+
+	return length;
+}
+
+
+
+Status initTextReaderFile(TextReader* pReader, FILE* fp) {
+	// one extra character for the NUL terminator fgets writes
+	if (!(pReader->buffer = allocateMemory(TEXT_BUFFER_SIZE + 1)))
+		return FAILURE;
+	pReader->fp = fp;
+	pReader->text = pReader->buffer;
+	pReader->length = 0;
+	pReader->position = 0;
+	pReader->endOfFile = FALSE;
+
+	return SUCCESS;
+}
+
+
+
+void initTextReaderBuffer(TextReader* pReader, const char* text, size_t length) {
+	pReader->fp = NULL;
+	pReader->buffer = NULL;
+	pReader->text = text;
+	pReader->length = length;
+	pReader->position = 0;
+	pReader->endOfFile = TRUE;
+}
+
+
+
+void freeTextReader(TextReader* pReader) {
+	freeMemory(pReader->buffer);
+	pReader->buffer = NULL;
+}
+
+
+
+int peekCharacter(TextReader* pReader) {
+	if (pReader->position == pReader->length && !refill(pReader))
+		return EOF;
+
+	return (unsigned char)pReader->text[pReader->position];
+}
+
+
+
+void skipBlanks(TextReader* pReader) {
+	for (;;) {
+		while (pReader->position < pReader->length) {
+			char c = pReader->text[pReader->position];
+			if (c != ' ' && c != '\t' && c != '\r')
+				return;
+			++pReader->position;
+		}
+		if (!refill(pReader))
+			return;
+	}
+}
+
+
+
+Boolean readNumber(TextReader* pReader, long double* pNumber) {
+	size_t end;
+
+	skipBlanks(pReader);
+
+	// find the end of the token, reading more of the line if it runs to the end of the buffer
+	end = pReader->position;
+	for (;;) {
+		while (end < pReader->length && isNumberCharacter(pReader->text[end]))
+			++end;
+		if (end < pReader->length)
+			break;
+		end -= pReader->position;
+		if (!refill(pReader)) {
+			end += pReader->position;
+			// a number that doesn't fit in the buffer
+			if (!pReader->endOfFile)
+				return FALSE;
+			break;
+		}
+		end += pReader->position;
+	}
+
+	// the number has to end at a blank, a comma, a newline or the end of the text
+	if (end < pReader->length) {
+		char c = pReader->text[end];
+		if (c != ' ' && c != '\t' && c != '\r' && c != '\n' && c != ',')
+			return FALSE;
+	}
+
+	const char* token = pReader->text + pReader->position;
+	size_t length = end - pReader->position;
+	pReader->position = end;
+
+	return parseNumber(token, length, pNumber);
+}
+
+
+
+Boolean readEndOfLine(TextReader* pReader) {
+	skipBlanks(pReader);
+
+	int c = peekCharacter(pReader);
+	if (c == '\n')
+		++pReader->position;
+
+	return c == '\n' || c == EOF;
+}
+
+
+
+void skipLine(TextReader* pReader) {
+	do {
+		const char* newline = memchr(pReader->text + pReader->position, '\n', pReader->length - pReader->position);
+		if (newline) {
+			pReader->position = newline - pReader->text + 1;
+			return;
+		}
+		pReader->position = pReader->length;
+	} while (refill(pReader));
+}
+
+
+
+Boolean readSeparator(TextReader* pReader, char separator) {
+	skipBlanks(pReader);
+	if (peekCharacter(pReader) != separator)
+		return FALSE;
+	++pReader->position;
+
+	return TRUE;
+}
+
+
+
+Boolean readWord(TextReader* pReader, char* word, size_t size) {
+	size_t length = 0;
+	int c;
+
+	skipBlanks(pReader);
+	while ((c = peekCharacter(pReader)) != EOF && c != ' ' && c != '\t' && c != '\r' && c != '\n') {
+		if (length + 1 >= size)
+			return FALSE;
+		word[length++] = (char)c;
+		++pReader->position;
+	}
+	word[length] = '\0';
+
+	return length > 0;
+}
+
+
+
+void initTextWriter(TextWriter* pWriter, FILE* fp) {
+	pWriter->fp = fp;
+	pWriter->length = 0;
+	pWriter->failed = FALSE;
+}
+
+
+
+void writeCharacters(TextWriter* pWriter, const char* characters, size_t length) {
+	while (length > 0) {
+		if (pWriter->length == TEXT_BUFFER_SIZE)
+			flushWriter(pWriter);
+		size_t copied = (length < TEXT_BUFFER_SIZE - pWriter->length) ? length : TEXT_BUFFER_SIZE - pWriter->length;
+		memcpy(pWriter->buffer + pWriter->length, characters, copied);
+		pWriter->length += copied;
+		characters += copied;
+		length -= copied;
+	}
+}
+
+
+
+void flushWriter(TextWriter* pWriter) {
+	if (pWriter->length > 0 && fwrite(pWriter->buffer, 1, pWriter->length, pWriter->fp) != pWriter->length)
+		pWriter->failed = TRUE;
+	pWriter->length = 0;
+}
+
+
+
+int writeUnsigned(uint64_t n, char* numString) {
+	char reversed[20];
+	int length = 0;
+
+	do {
+		reversed[length++] = (char)('0' + n % 10);
+		n /= 10;
+	} while (n != 0);
+	for (int i = 0; i < length; ++i)
+		numString[i] = reversed[length - 1 - i];
+
+	return length;
+}
+
+
+
+
+int formatShortest(long double n, char* numString) {
+	char digits[LDBL_DECIMAL_DIG + 1];         // significant digits, without the decimal point
+	int digitsSize;
+	int exponent;                              // power of ten of the first digit
+	int fewestDigits;                          // where the slow search starts
+	char* pNext = numString;
+
+	if (!isfinite(n))
+		return sprintf(numString, "%Lg", n);
+	if (signbit(n)) {
+		*pNext++ = '-';
+		n = -n;
+	}
+	// integers are written directly
+	if (n < powersOfTen[FAST_MAX_DIGITS] && n == floorl(n)) {
+		pNext += writeUnsigned((uint64_t)n, pNext);
+		*pNext = '\0';
+		return (int)(pNext - numString);
+	}
+	if (!shortestDigitsFast(n, digits, &digitsSize, &exponent, &fewestDigits))
+		shortestDigitsSlow(n, fewestDigits, digits, &digitsSize, &exponent);
+
+	// scientific notation
+	if (exponent < -5 || exponent > 20) {
+		*pNext++ = digits[0];
+		if (digitsSize > 1) {
+			*pNext++ = '.';
+			memcpy(pNext, digits + 1, digitsSize - 1);
+			pNext += digitsSize - 1;
+		}
+		pNext += sprintf(pNext, "e%+d", exponent);
+	}
+	// fixed notation with all of the digits before the decimal point
+	else if (exponent >= digitsSize - 1) {
+		memcpy(pNext, digits, digitsSize);
+		memset(pNext + digitsSize, '0', exponent + 1 - digitsSize);
+		pNext += exponent + 1;
+		*pNext = '\0';
+	}
+	// fixed notation with some digits before the decimal point
+	else if (exponent >= 0) {
+		memcpy(pNext, digits, exponent + 1);
+		pNext[exponent + 1] = '.';
+		memcpy(pNext + exponent + 2, digits + exponent + 1, digitsSize - exponent - 1);
+		pNext += digitsSize + 1;
+		*pNext = '\0';
+	}
+	// fixed notation with zeroes after the decimal point
+	else {
+		*pNext++ = '0';
+		*pNext++ = '.';
+		memset(pNext, '0', -exponent - 1);
+		pNext += -exponent - 1;
+		memcpy(pNext, digits, digitsSize);
+		pNext += digitsSize;
+		*pNext = '\0';
+	}
+
+	return (int)(pNext - numString);
+}
+
+
+
+
+/***** Helper functions used only in this file *****/
+static Boolean refill(TextReader* pReader) {
+	if (pReader->endOfFile)
+		return FALSE;
+
+	size_t kept = pReader->length - pReader->position;
+	memmove(pReader->buffer, pReader->buffer + pReader->position, kept);
+	pReader->length = kept;
+	pReader->position = 0;
+
+	// fgets stops at the end of the line, so an interactive stream isn't read past the row being parsed
+	if (kept == TEXT_BUFFER_SIZE)
+		return FALSE;
+	if (!fgets(pReader->buffer + kept, TEXT_BUFFER_SIZE + 1 - kept, pReader->fp)) {
+		pReader->endOfFile = TRUE;
+		return FALSE;
+	}
+	pReader->length += strlen(pReader->buffer + kept);
+
+	return pReader->length > kept;
+}
+
+
+
+static Boolean isNumberCharacter(char c) {
+	return isDigit(c) || c == '.' || c == '-' || c == '+' || c == 'e' || c == 'E';
+}
+
+
+
+static Boolean isDigit(char c) {
+	return c >= '0' && c <= '9';
+}
+
+
+
+static Boolean parseNumber(const char* token, size_t length, long double* pNumber) {
+	uint64_t digits = 0;                   // the significant digits as an integer
+	int significantDigits = 0;             // significant digits kept in digits
+	Boolean hasDigits = FALSE;             // the number has at least one digit before its exponent
+	Boolean exact = TRUE;                  // no nonzero digits were dropped
+	long exponent = 0;                     // power of ten digits is scaled by
+	Boolean negative = FALSE;
+	size_t i = 0;
+
+	if (i < length && (token[i] == '-' || token[i] == '+'))
+		negative = (token[i++] == '-');
+
+	// integer part - leading zeroes aren't significant and digits past the limit only scale the number
+	for (; i < length && isDigit(token[i]); ++i) {
+		hasDigits = TRUE;
+		if (significantDigits < FAST_MAX_DIGITS) {
+			if (digits != 0 || token[i] != '0') {
+				digits = digits * 10 + (uint64_t)(token[i] - '0');
+				++significantDigits;
+			}
+		}
+		else {
+			++exponent;
+			if (token[i] != '0')
+				exact = FALSE;
+		}
+	}
+
+	// fractional part
+	if (i < length && token[i] == '.') {
+		for (++i; i < length && isDigit(token[i]); ++i) {
+			hasDigits = TRUE;
+			if (significantDigits < FAST_MAX_DIGITS) {
+				if (digits != 0 || token[i] != '0') {
+					digits = digits * 10 + (uint64_t)(token[i] - '0');
+					++significantDigits;
+				}
+				--exponent;
+			}
+			else if (token[i] != '0')
+				exact = FALSE;
+		}
+	}
+	if (!hasDigits)
+		return FALSE;
+
+	// exponent - anything past the limit overflows or underflows regardless, so it stops growing there
+	if (i < length && (token[i] == 'e' || token[i] == 'E')) {
+		Boolean negativeExponent = FALSE;
+		long explicitExponent = 0;
+		if (++i < length && (token[i] == '-' || token[i] == '+'))
+			negativeExponent = (token[i++] == '-');
+		if (i == length || !isDigit(token[i]))
+			return FALSE;
+		for (; i < length && isDigit(token[i]); ++i)
+			if (explicitExponent < 100000)
+				explicitExponent = explicitExponent * 10 + (token[i] - '0');
+		exponent += negativeExponent ? -explicitExponent : explicitExponent;
+	}
+	if (i != length)
+		return FALSE;
+
+	if (digits == 0) {
+		*pNumber = negative ? -0.0L : 0.0L;
+		return TRUE;
+	}
+	if (!exact || exponent < -FAST_MAX_EXPONENT || exponent > FAST_MAX_EXPONENT)
+		return parseNumberSlow(token, length, pNumber);
+
+	long double number = (long double)digits;
+	number = (exponent < 0) ? number / powersOfTen[-exponent] : number * powersOfTen[exponent];
+	*pNumber = negative ? -number : number;
+
+	return TRUE;
+}
+
+
+
+static Boolean parseNumberSlow(const char* token, size_t length, long double* pNumber) {
+	char number[TEXT_NUMBER_MAX + 1];
+
+	if (length > TEXT_NUMBER_MAX)
+		return FALSE;
+	memcpy(number, token, length);
+	number[length] = '\0';
+
+	errno = 0;
+	*pNumber = strtold(number, NULL);
+
+	// underflow to 0 or a denormal is fine, overflow to infinity isn't
+	return !(errno == ERANGE && (*pNumber == HUGE_VALL || *pNumber == -HUGE_VALL));
+}
+
+
+
+static void writeRepeated(TextWriter* pWriter, char c, size_t count) {
+	while (count > 0) {
+		if (pWriter->length == TEXT_BUFFER_SIZE)
+			flushWriter(pWriter);
+		size_t copied = (count < TEXT_BUFFER_SIZE - pWriter->length) ? count : TEXT_BUFFER_SIZE - pWriter->length;
+		memset(pWriter->buffer + pWriter->length, c, copied);
+		pWriter->length += copied;
+		count -= copied;
+	}
+}
+
+
+
+static void writeBoxed(TextWriter* pWriter, Matrix* pMatrix) {
+	char numString[NUMBER_STRING_SIZE];        // each number as a string
+
+	// matrices read in bulk leave the max length to be worked out when it's first needed
+	if (pMatrix->maxLength == 0)
+		updateMaxLength(pMatrix);
+
+	// each number occupies the same fixed space, and the rules of dashes span the whole matrix
+	size_t maxLength = (size_t)pMatrix->maxLength;
+	size_t totalSpaces = (maxLength + 2) * pMatrix->columns + pMatrix->columns + 1;
+
+	writeRepeated(pWriter, '-', totalSpaces);
+	writeCharacters(pWriter, "\n", 1);
+	for (size_t i = 0; i < pMatrix->rows; ++i) {
+		for (size_t j = 0; j < pMatrix->columns; ++j) {
+			size_t length = (size_t)formatFixed(pMatrix->matrix[matrixIndex(pMatrix, i, j)], numString);
+			writeCharacters(pWriter, "|", 1);
+			writeCharacters(pWriter, numString, length);
+			writeRepeated(pWriter, ' ', (length < maxLength) ? maxLength - length + 2 : 2);
+		}
+		writeCharacters(pWriter, "|\n", 2);
+		writeRepeated(pWriter, '-', totalSpaces);
+		writeCharacters(pWriter, "\n", 1);
+		if (i % MATRIX_TILE_SIZE == MATRIX_TILE_SIZE - 1)
+			releaseRows(pMatrix, i + 1 - MATRIX_TILE_SIZE, i + 1);
+	}
+}
+
+
+
+static void writeSeparated(TextWriter* pWriter, const Matrix* pMatrix, char separator) {
+	char numString[NUMBER_STRING_SIZE];        // each number as a string
+
+	for (size_t i = 0; i < pMatrix->rows; ++i) {
+		for (size_t j = 0; j < pMatrix->columns; ++j) {
+			if (j > 0)
+				writeCharacters(pWriter, &separator, 1);
+			writeCharacters(pWriter, numString, (size_t)formatShortest(pMatrix->matrix[matrixIndex(pMatrix, i, j)], numString));
+		}
+		writeCharacters(pWriter, "\n", 1);
+		if (i % MATRIX_TILE_SIZE == MATRIX_TILE_SIZE - 1)
+			releaseRows(pMatrix, i + 1 - MATRIX_TILE_SIZE, i + 1);
+	}
+}
+
+
+
+static Boolean shortestDigitsFast(long double n, char* digits, int* pDigitsSize, int* pExponent, int* pFewestDigits) {
+	uint64_t shortest;
+	int scale;
+
+	// every number of digits has to be able to be scaled with an exact power of ten
+	*pFewestDigits = 1;
+	int exponent = (int)floorl(log10l(n));
+	if (exponent < FAST_MAX_DIGITS - 1 - FAST_MAX_EXPONENT || exponent > FAST_MAX_EXPONENT)
+		return FALSE;
+	// results of arithmetic usually need all of the digits, which rules out fewer than FAST_MAX_DIGITS (the rounding
+	// of the scaling can make FAST_MAX_DIGITS itself fail when a correctly rounded candidate wouldn't)
+	if (!roundsTrip(n, FAST_MAX_DIGITS, exponent, &shortest, &scale)) {
+		*pFewestDigits = FAST_MAX_DIGITS;
+		return FALSE;
+	}
+
+	// binary search for the fewest digits - if p digits convert back to n, so do p + 1
+	int low = 1;
+	int high = FAST_MAX_DIGITS;
+	while (low < high) {
+		int middle = (low + high) / 2;
+		if (roundsTrip(n, middle, exponent, &shortest, &scale))
+			high = middle;
+		else
+			low = middle + 1;
+	}
+	roundsTrip(n, high, exponent, &shortest, &scale);
+
+	int digitsSize = writeUnsigned(shortest, digits);
+	*pExponent = digitsSize - 1 - scale;
+	while (digitsSize > 1 && digits[digitsSize - 1] == '0')
+		--digitsSize;
+	*pDigitsSize = digitsSize;
+
+	return TRUE;
+}
+
+
+
+static void shortestDigitsSlow(long double n, int fewestDigits, char* digits, int* pDigitsSize, int* pExponent) {
+	char numString[LDBL_DECIMAL_DIG + 16];     // d.ddd...e+xxxx
+
+	int low = fewestDigits;
+	int high = LDBL_DECIMAL_DIG;
+	while (low < high) {
+		int middle = (low + high) / 2;
+		snprintf(numString, sizeof(numString), "%.*Le", middle - 1, n);
+		if (strtold(numString, NULL) == n)
+			high = middle;
+		else
+			low = middle + 1;
+	}
+	snprintf(numString, sizeof(numString), "%.*Le", high - 1, n);
+
+	// split the string into its digits and exponent
+	int digitsSize = 0;
+	char* pNext;
+	for (pNext = numString; *pNext != 'e'; ++pNext)
+		if (*pNext != '.')
+			digits[digitsSize++] = *pNext;
+	*pExponent = atoi(pNext + 1);
+	while (digitsSize > 1 && digits[digitsSize - 1] == '0')
+		--digitsSize;
+	*pDigitsSize = digitsSize;
+}
+
+
+
+static Boolean roundsTrip(long double n, int p, int exponent, uint64_t* pDigits, int* pScale) {
+	int scale = p - 1 - exponent;
+
+	if (scale < -FAST_MAX_EXPONENT || scale > FAST_MAX_EXPONENT)
+		return FALSE;
+	long double rounded = nearbyintl((scale >= 0) ? n * powersOfTen[scale] : n / powersOfTen[-scale]);
+	if (rounded >= powersOfTen[FAST_MAX_DIGITS])
+		return FALSE;
+
+	// converting back is exact up to a single rounding, the same as parseNumber
+	long double back = (scale >= 0) ? rounded / powersOfTen[scale] : rounded * powersOfTen[-scale];
+	if (back != n)
+		return FALSE;
+	*pDigits = (uint64_t)rounded;
+	*pScale = scale;
+
+	return TRUE;
+}
+
+
+
+static Status readRows(Matrix* pMatrix, TextReader* pReader, Status* pMemoryAllocation) {
+	Matrix parsed = *pMatrix;        // the matrix with a new storage array the entries are parsed straight into
+	*pMemoryAllocation = SUCCESS;
+
+	if (!(parsed.matrix = allocateStorage(pMatrix->rows, pMatrix->columns, pMatrix->layout))) {
+		*pMemoryAllocation = FAILURE;
+		return FAILURE;
+	}
+	parsed.fd = -1;
+	parsed.mapping = NULL;
+	parsed.mappingBytes = 0;
+	parsed.maxLength = 0;
+
+	for (size_t i = 0; i < parsed.rows; ++i) {
+		Boolean valid = TRUE;
+		for (size_t j = 0; valid && j < parsed.columns; ++j)
+			valid = readNumber(pReader, &parsed.matrix[matrixIndex(&parsed, i, j)]);
+		if (!valid || !readEndOfLine(pReader)) {
+			skipLine(pReader);
+			freeMemory(parsed.matrix);
+			return FAILURE;
+		}
+	}
+
+	// a mapped matrix keeps its file, anything else just takes the new array
+	if (isMapped(pMatrix)) {
+		copyStorage(pMatrix, &parsed);
+		freeMemory(parsed.matrix);
+		pMatrix->maxLength = 0;
+	}
+	else {
+		freeStorage(pMatrix);
+		*pMatrix = parsed;
+	}
+
+	return SUCCESS;
+}
+
+
+
+static Matrix* readMatrix(TextReader* pReader) {
+	long double* entries = NULL;     // the rows read so far in row-major order
+	size_t capacity = 0;
+	size_t size = 0;
+	size_t rows = 0;
+	size_t columns = 0;
+	Matrix* pMatrix;
+
+	while (peekCharacter(pReader) != EOF) {
+		// blank lines are ignored
+		if (readEndOfLine(pReader))
+			continue;
+
+		size_t rowStart = size;
+		do {
+			if (size == capacity) {
+				long double* newEntries;
+				size_t newCapacity = capacity ? capacity * 2 : 1024;
+				if (newCapacity > SIZE_MAX / 2 / sizeof(*entries)
+					|| !(newEntries = reallocateMemory(entries, newCapacity * sizeof(*entries)))) {
+					freeMemory(entries);
+					return NULL;
+				}
+				entries = newEntries;
+				capacity = newCapacity;
+			}
+			if (!readNumber(pReader, &entries[size++])) {
+				freeMemory(entries);
+				return NULL;
+			}
+		} while (!readEndOfLine(pReader));
+
+		// the first row sets the number of columns
+		if (rows == 0)
+			columns = size - rowStart;
+		else if (size - rowStart != columns) {
+			freeMemory(entries);
+			return NULL;
+		}
+		++rows;
+	}
+	if (rows == 0 || !(pMatrix = allocateMemory(sizeof(*pMatrix)))) {
+		freeMemory(entries);
+		return NULL;
+	}
+
+	pMatrix->matrix = entries;
+	pMatrix->rows = rows;
+	pMatrix->columns = columns;
+	pMatrix->maxLength = 0;
+	pMatrix->layout = MATRIX_ROW_MAJOR;
+	pMatrix->fd = -1;
+	pMatrix->mapping = NULL;
+	pMatrix->mappingBytes = 0;
+
+	return pMatrix;
+}
@@ -0,0 +1,403 @@
+/*
+  Author: Benjamin G. Friedman
+  Date: 10/18/2026
+  File: MatrixTrace.c
+  Description:
+	  - Implementation file for tracing the matrix interface, which records a span for each operation and the main
+		phases of the longer ones and writes them as a Chrome trace (JSON trace events), which Perfetto and
+		chrome://tracing load.
+	  - Each thread adds its spans to its own buffer, a list of chunks only it writes to, publishing each span with a
+		release store of the count of its chunk. Tracing takes no lock after a thread's first span, so it barely
+		changes the timings it records. While it's off a span only loads the mode.
+	  - Each buffer is held by the trace and by its thread, and freed by whichever lets go of it last: the trace when
+		it's written, the thread when it notices a new trace by its generation and starts a new buffer, or when it
+		exits. A thread that was adding a span while the trace was written can finish with its buffer that way.
+*/
+
+
+#define _DEFAULT_SOURCE        // clock_gettime and syscall
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/syscall.h>
+#include "MatrixInternal.h"
+
+
+#define TRACE_ENVIRONMENT "MATRIX_TRACE"      // set to a path to trace the whole program and write the trace there at exit
+#define TRACE_CHUNK_SIZE 4096                 // spans in each chunk of a thread's buffer
+
+
+
+
+/***** Structures *****/
+// TRACE_UNKNOWN until the environment is read by the first span
+typedef enum traceMode { TRACE_UNKNOWN = -1, TRACE_OFF, TRACE_ON } TraceMode;
+
+typedef struct traceEvent {
+	const char* name;
+	double start;                // seconds on the monotonic clock, made relative to the trace when it's written
+	double duration;             // microseconds
+	size_t rows;
+	size_t columns;
+} TraceEvent;
+
+typedef struct traceChunk {
+	struct traceChunk* _Atomic next;
+	atomic_size_t size;          // events published, only the owning thread adds to it
+	TraceEvent events[TRACE_CHUNK_SIZE];
+} TraceChunk;
+
+typedef struct traceBuffer {
+	struct traceBuffer* next;    // in the list of the buffers of the trace
+	atomic_int references;       // the trace's and the owning thread's
+	long threadId;
+	TraceChunk* first;
+	TraceChunk* last;            // chunk being added to, only used by the owning thread
+} TraceBuffer;
+
+
+
+
+/***** Global variables *****/
+static atomic_int traceMode = TRACE_UNKNOWN;
+static pthread_once_t environmentOnce = PTHREAD_ONCE_INIT;
+static pthread_mutex_t traceLock = PTHREAD_MUTEX_INITIALIZER;      // guards everything below but the mode
+static FILE* traceFile;
+static double traceStart;                    // time the trace started on the monotonic clock
+static atomic_uint traceGeneration;          // incremented by every trace, so threads know their buffer is stale
+static TraceBuffer* traceBuffers;            // buffers of the threads that have added spans to the trace
+static pthread_key_t bufferKey;              // lets go of a thread's buffer when it exits
+static Boolean bufferKeyCreated;
+
+static _Thread_local TraceBuffer* threadBuffer;
+static _Thread_local unsigned threadGeneration;
+
+
+
+
+/***** Helper functions used only in this file *****/
+/*
+PRECONDITION
+  - none.
+POSTCONDITION
+  - Starts tracing to the file the environment variable names, if it's set, and registers writing it at exit.
+  - Called once, before the mode is first used.
+*/
+static void readEnvironment(void);
+
+
+/*
+PRECONDITION
+  - path is the path of the file to write the trace to.
+POSTCONDITION
+  - Starts a trace the same as matrix_startTrace, without reading the environment.
+*/
+static Status startTrace(const char* path);
+
+
+/*
+PRECONDITION
+  - none.
+POSTCONDITION
+  - Writes the trace if it's still running, for atexit. A program that wants to know if writing it failed stops the
+    trace itself first.
+*/
+static void stopTraceAtExit(void);
+
+
+/*
+PRECONDITION
+  - none.
+POSTCONDITION
+  - Returns the mode of tracing, reading the environment first if it hasn't been.
+*/
+static TraceMode getMode(void);
+
+
+/*
+PRECONDITION
+  - none.
+POSTCONDITION
+  - Returns the buffer of this thread for the current trace, making it the first time it's needed.
+  - Returns NULL if memory allocation failed, in which case the thread's spans are left out of the trace.
+*/
+static TraceBuffer* getThreadBuffer(void);
+
+
+/*
+PRECONDITION
+  - pBuffer is a pointer to a thread's buffer, held by the caller (the trace or the thread).
+POSTCONDITION
+  - Lets go of the buffer, freeing it and its chunks if nothing else holds it. Also the destructor of bufferKey.
+*/
+static void releaseBuffer(void* pBuffer);
+
+
+/*
+PRECONDITION
+  - traceLock is held.
+  - fp is the file of the trace and pBuffer is a pointer to a buffer of the trace.
+  - pFirst is a pointer to TRUE before the first event of the trace is written, which is set to FALSE after it.
+POSTCONDITION
+  - Writes the events of the buffer as Chrome trace events.
+*/
+static void writeBuffer(FILE* fp, const TraceBuffer* pBuffer, Boolean* pFirst);
+
+
+/*
+PRECONDITION
+  - none.
+POSTCONDITION
+  - Returns the time of the monotonic clock in seconds.
+*/
+static double now(void);
+
+
+
+
+/***** Functions defined in Matrix.h *****/
+Status matrix_startTrace(const char* path) {
+	pthread_once(&environmentOnce, readEnvironment);
+
+	return startTrace(path);
+}
+
+
+
+Status matrix_stopTrace(void) {
+	pthread_once(&environmentOnce, readEnvironment);
+
+	pthread_mutex_lock(&traceLock);
+	if (!traceFile) {
+		pthread_mutex_unlock(&traceLock);
+		return FAILURE;
+	}
+	atomic_store(&traceMode, TRACE_OFF);
+
+	Boolean first = TRUE;
+	long processId = (long)getpid();
+	fprintf(traceFile, "{\"traceEvents\":[");
+	for (TraceBuffer* pBuffer = traceBuffers; pBuffer; pBuffer = pBuffer->next) {
+		// name the thread's track after its id, with the first thread to trace first
+		fprintf(traceFile, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%ld,\"tid\":%ld,\"args\":{\"name\":\"thread %ld\"}}",
+			first ? "" : ",", processId, pBuffer->threadId, pBuffer->threadId);
+		first = FALSE;
+		writeBuffer(traceFile, pBuffer, &first);
+	}
+	fprintf(traceFile, "\n],\"displayTimeUnit\":\"ms\"}\n");
+	Status status = (fflush(traceFile) || ferror(traceFile)) ? FAILURE : SUCCESS;
+	if (fclose(traceFile))
+		status = FAILURE;
+	traceFile = NULL;
+
+	// a thread may still be adding a span it began before tracing stopped, so its buffer is only freed once it's done
+	while (traceBuffers) {
+		TraceBuffer* pBuffer = traceBuffers;
+		traceBuffers = pBuffer->next;
+		releaseBuffer(pBuffer);
+	}
+	pthread_mutex_unlock(&traceLock);
+
+	return status;
+}
+
+
+
+
+Boolean matrix_traceIsStarted(void) {
+	return (getMode() == TRACE_ON) ? TRUE : FALSE;
+}
+
+
+
+
+/***** Helper functions shared with the other matrix implementation files - declared in MatrixInternal.h *****/
+void beginSpan(TraceSpan* pSpan, const char* name, size_t rows, size_t columns) {
+	pSpan->name = NULL;
+	if (getMode() != TRACE_ON)
+		return;
+
+	pSpan->name = name;
+	pSpan->rows = rows;
+	pSpan->columns = columns;
+	pSpan->start = now();
+}
+
+
+
+void endSpan(TraceSpan* pSpan) {
+	if (!pSpan->name)
+		return;
+
+	double end = now();
+	// a span that outlived its trace is dropped. The start of the trace is only used when it's written, since the
+	// next trace could be starting while this span is added.
+	if (atomic_load_explicit(&traceMode, memory_order_acquire) != TRACE_ON)
+		return;
+	TraceBuffer* pBuffer = getThreadBuffer();
+	if (!pBuffer)
+		return;
+
+	TraceChunk* pChunk = pBuffer->last;
+	size_t size = atomic_load_explicit(&pChunk->size, memory_order_relaxed);
+	if (size == TRACE_CHUNK_SIZE) {
+		// tracing is the only thing using the chunks, so they don't go through allocateMemory and the statistics
+		TraceChunk* pNext = malloc(sizeof(*pNext));
+		if (!pNext)
+			return;
+		atomic_init(&pNext->next, NULL);
+		atomic_init(&pNext->size, 0);
+		atomic_store_explicit(&pChunk->next, pNext, memory_order_release);
+		pBuffer->last = pChunk = pNext;
+		size = 0;
+	}
+
+	TraceEvent* pEvent = &pChunk->events[size];
+	pEvent->name = pSpan->name;
+	pEvent->start = pSpan->start;
+	pEvent->duration = (end - pSpan->start) * 1e6;
+	pEvent->rows = pSpan->rows;
+	pEvent->columns = pSpan->columns;
+	atomic_store_explicit(&pChunk->size, size + 1, memory_order_release);
+}
+
+
+
+
+/***** Helper functions used only in this file *****/
+static void readEnvironment(void) {
+	const char* path = getenv(TRACE_ENVIRONMENT);
+
+	// without the key, the buffers of threads that exit are kept until the process exits
+	bufferKeyCreated = pthread_key_create(&bufferKey, releaseBuffer) == 0;
+	atomic_store(&traceMode, TRACE_OFF);
+	if (path && *path) {
+		// a trace that can't be started is left off, which matrix_traceIsStarted shows
+		if (startTrace(path))
+			atexit(stopTraceAtExit);
+	}
+}
+
+
+
+static Status startTrace(const char* path) {
+	pthread_mutex_lock(&traceLock);
+	if (traceFile || !(traceFile = fopen(path, "w"))) {
+		pthread_mutex_unlock(&traceLock);
+		return FAILURE;
+	}
+	traceStart = now();
+	atomic_fetch_add(&traceGeneration, 1);
+	atomic_store(&traceMode, TRACE_ON);
+	pthread_mutex_unlock(&traceLock);
+
+	return SUCCESS;
+}
+
+
+
+static void stopTraceAtExit(void) {
+	matrix_stopTrace();
+}
+
+
+
+static TraceMode getMode(void) {
+	int mode = atomic_load_explicit(&traceMode, memory_order_relaxed);
+	if (mode == TRACE_UNKNOWN) {
+		pthread_once(&environmentOnce, readEnvironment);
+		mode = atomic_load(&traceMode);
+	}
+
+	return mode;
+}
+
+
+
+static TraceBuffer* getThreadBuffer(void) {
+	unsigned generation = atomic_load_explicit(&traceGeneration, memory_order_acquire);
+	if (threadBuffer && threadGeneration == generation)
+		return threadBuffer;
+
+	// the first span of the thread in this trace - it's done with its buffer of an earlier trace
+	if (threadBuffer) {
+		if (bufferKeyCreated)
+			pthread_setspecific(bufferKey, NULL);
+		releaseBuffer(threadBuffer);
+		threadBuffer = NULL;
+	}
+	threadGeneration = generation;
+	TraceBuffer* pBuffer = malloc(sizeof(*pBuffer));
+	TraceChunk* pChunk = malloc(sizeof(*pChunk));
+	if (!pBuffer || !pChunk) {
+		free(pBuffer);
+		free(pChunk);
+		return NULL;
+	}
+	atomic_init(&pChunk->next, NULL);
+	atomic_init(&pChunk->size, 0);
+	atomic_init(&pBuffer->references, 2);
+	pBuffer->threadId = (long)syscall(SYS_gettid);
+	pBuffer->first = pBuffer->last = pChunk;
+
+	pthread_mutex_lock(&traceLock);
+	// the trace could have been written since the generation was loaded
+	if (!traceFile || atomic_load(&traceGeneration) != generation) {
+		pthread_mutex_unlock(&traceLock);
+		free(pBuffer);
+		free(pChunk);
+		return NULL;
+	}
+	pBuffer->next = traceBuffers;
+	traceBuffers = pBuffer;
+	pthread_mutex_unlock(&traceLock);
+	if (bufferKeyCreated)
+		pthread_setspecific(bufferKey, pBuffer);
+
+	return threadBuffer = pBuffer;
+}
+
+
+
+static void releaseBuffer(void* pBuffer) {
+	TraceBuffer* pReleased = pBuffer;
+	if (atomic_fetch_sub(&pReleased->references, 1) != 1)
+		return;
+
+	while (pReleased->first) {
+		TraceChunk* pChunk = pReleased->first;
+		pReleased->first = atomic_load(&pChunk->next);
+		free(pChunk);
+	}
+	free(pReleased);
+}
+
+
+
+static void writeBuffer(FILE* fp, const TraceBuffer* pBuffer, Boolean* pFirst) {
+	long processId = (long)getpid();
+
+	for (TraceChunk* pChunk = pBuffer->first; pChunk; pChunk = atomic_load_explicit(&pChunk->next, memory_order_acquire)) {
+		size_t size = atomic_load_explicit(&pChunk->size, memory_order_acquire);
+		for (size_t i = 0; i < size; ++i) {
+			const TraceEvent* pEvent = &pChunk->events[i];
+			fprintf(fp, "%s\n{\"name\":\"%s\",\"cat\":\"matrix\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%ld,\"tid\":%ld,"
+				"\"args\":{\"rows\":%zu,\"columns\":%zu}}", *pFirst ? "" : ",", pEvent->name,
+				(pEvent->start - traceStart) * 1e6, pEvent->duration, processId, pBuffer->threadId, pEvent->rows,
+				pEvent->columns);
+			*pFirst = FALSE;
+		}
+	}
+}
+
+
+
+static double now(void) {
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec + time.tv_nsec / 1e9;
+}
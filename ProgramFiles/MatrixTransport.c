@@ -0,0 +1,692 @@
+/*
+  Author: Benjamin G. Friedman
+  Date: 10/18/2026
+  File: MatrixTransport.c
+  Description:
+	  - Implementation file for the transports the processes working on distributed matrices send each other their
+		entries through (see MatrixDistributed.c).
+	  - The shared memory transport maps one object holding a header, then a channel for each ordered pair of processes
+		(channel from * processes + to carries the bytes process from sends process to), then the ring buffer of each
+		channel. The mutexes and condition variables of the channels are shared between the processes.
+	  - The socket transport keeps a TCP connection to each of the other processes, the stream of each pair of them.
+*/
+
+
+#define _GNU_SOURCE            // sockets, getaddrinfo, shm_open, robust mutexes and clock_gettime
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <poll.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include "MatrixInternal.h"
+
+
+#define TRANSPORT_TIMEOUT 30.0                 // seconds the processes have to connect
+#define TRANSPORT_RETRY_INTERVAL 10            // milliseconds between attempts to attach or connect
+#define SHARED_MAGIC 0x4853584Du               // marks a shared memory object that's set up, "MXSH" on a little-endian machine
+#define SHARED_MAX_PROCESSES 64
+#define SHARED_NAME_MAX 201                    // characters of the name of the object, with the '/'
+#define SHARED_CHANNEL_SIZE (256 << 10)        // bytes of the ring buffer of each channel
+#define SHARED_WAIT_INTERVAL 1                 // seconds a blocked process waits before checking the other one is alive
+
+
+
+
+/***** Structures *****/
+// The start of the shared memory object
+typedef struct sharedHeader {
+	atomic_uint magic;                         // SHARED_MAGIC once process 0 has set up the channels
+	atomic_int attached;                       // processes that have attached
+	atomic_int closed[SHARED_MAX_PROCESSES];   // each process has closed its transport
+	pid_t pids[SHARED_MAX_PROCESSES];          // each process, written before it counts itself as attached
+} SharedHeader;
+
+// The ring buffer one process sends another bytes through
+typedef struct sharedChannel {
+	pthread_mutex_t lock;
+	pthread_cond_t changed;            // broadcast when bytes are written or read and when either process closes
+	size_t written;                    // bytes written to and read from the ring so far, so written - read are waiting
+	size_t read;
+} SharedChannel;
+
+typedef struct sharedTransport {
+	char* mapping;                     // the shared memory object
+	size_t mappingBytes;
+	SharedHeader* pHeader;
+	SharedChannel* channels;           // processes * processes channels
+	char* buffers;                     // their ring buffers, SHARED_CHANNEL_SIZE bytes each
+	int rank;
+	int processes;
+} SharedTransport;
+
+typedef struct socketTransport {
+	int processes;
+	int fds[];                         // connection to each process, -1 for this one
+} SocketTransport;
+
+
+
+
+/***** Helper functions used only in this file *****/
+/*
+PRECONDITION
+  - The same as for the hooks of MatrixTransport, with the context of a shared memory transport.
+POSTCONDITION
+  - The hooks of the shared memory transport.
+*/
+static Status sendShared(int to, const void* data, size_t bytes, void* context);
+static Status receiveShared(int from, void* data, size_t bytes, void* context);
+static void closeShared(void* context);
+
+
+/*
+PRECONDITION
+  - The same as for the hooks of MatrixTransport, with the context of a socket transport.
+POSTCONDITION
+  - The hooks of the socket transport.
+*/
+static Status sendSocket(int to, const void* data, size_t bytes, void* context);
+static Status receiveSocket(int from, void* data, size_t bytes, void* context);
+static void closeSocket(void* context);
+
+
+/*
+PRECONDITION
+  - fd is a connected socket and data is an array of bytes bytes.
+POSTCONDITION
+  - Sends/receives all of the bytes. Returns SUCCESS, else FAILURE if the connection failed or was closed.
+*/
+static Status sendAll(int fd, const void* data, size_t bytes);
+static Status receiveAll(int fd, void* data, size_t bytes);
+
+
+/*
+PRECONDITION
+  - pShared is a pointer to a shared memory transport with its rank, processes and mappingBytes set.
+  - name is the name of the shared memory object.
+POSTCONDITION
+  - createShared creates the object and sets up its header and channels, for process 0. attachShared waits until
+    the deadline for process 0 to set it up and maps it, for the others.
+  - Both return SUCCESS with the object mapped, else FAILURE with nothing mapped.
+*/
+static Status createShared(SharedTransport* pShared, const char* name);
+static Status attachShared(SharedTransport* pShared, const char* name, double deadline);
+
+
+/*
+PRECONDITION
+  - pShared is a pointer to an open shared memory transport and pChannel is one of its channels, locked by this
+    process, that this process and peer share.
+POSTCONDITION
+  - Waits for the channel to change, up to SHARED_WAIT_INTERVAL seconds. Returns TRUE, else FALSE without waiting if
+    either process has closed its transport or peer has exited.
+*/
+static Boolean waitChannel(SharedTransport* pShared, SharedChannel* pChannel, int peer);
+
+
+/*
+PRECONDITION
+  - pChannel is a pointer to a channel of a shared memory transport.
+POSTCONDITION
+  - Locks the channel, taking it over if a process that held the lock exited.
+*/
+static void lockChannel(SharedChannel* pChannel);
+
+
+/*
+PRECONDITION
+  - address is a string "host:port", with the host in brackets for an IPv6 address, i.e. "[::1]:7000".
+  - passive is TRUE to listen on the address, FALSE to connect to it.
+  - ppInfo is a pointer to the variable that receives the addresses.
+POSTCONDITION
+  - Looks up the address with getaddrinfo. Returns SUCCESS, else FAILURE if it's malformed or can't be found.
+*/
+static Status lookUpAddress(const char* address, Boolean passive, struct addrinfo** ppInfo);
+
+
+/*
+PRECONDITION
+  - pSockets is a pointer to a socket transport being opened by process rank.
+  - address is the address of process peer, before it, and deadline is the time on the monotonic clock to give up at.
+POSTCONDITION
+  - Connects to the process, retrying while it starts, and sends it this process's rank.
+  - Returns SUCCESS, else FAILURE if it couldn't be done by the deadline.
+*/
+static Status connectToProcess(SocketTransport* pSockets, const char* address, int peer, int rank, double deadline);
+
+
+/*
+PRECONDITION
+  - pSockets is a pointer to a socket transport being opened by process rank, and listener is the socket it listens
+    on.
+  - deadline is the time on the monotonic clock to give up at.
+POSTCONDITION
+  - Accepts a connection from each of the processes after this one, each identified by the rank it sends.
+  - Returns SUCCESS, else FAILURE if they didn't all connect by the deadline.
+*/
+static Status acceptProcesses(SocketTransport* pSockets, int listener, int rank, double deadline);
+
+
+/*
+PRECONDITION
+  - none.
+POSTCONDITION
+  - Returns the time in seconds on the monotonic clock.
+*/
+static double currentTime(void);
+
+
+/*
+PRECONDITION
+  - milliseconds >= 0.
+POSTCONDITION
+  - Sleeps for the given number of milliseconds.
+*/
+static void sleepMilliseconds(int milliseconds);
+
+
+
+
+/***** Functions defined in Matrix.h *****/
+Status matrix_openSharedMemoryTransport(const char* name, int rank, int processes, MatrixTransport* pTransport) {
+	if (!name || name[0] != '/' || strlen(name) > SHARED_NAME_MAX || processes < 1 || processes > SHARED_MAX_PROCESSES ||
+		rank < 0 || rank >= processes)
+		return FAILURE;
+
+	SharedTransport* pShared = allocateZeroedMemory(1, sizeof(*pShared));
+	if (!pShared)
+		return FAILURE;
+	size_t pairs = (size_t)processes * processes;
+	size_t channelsOffset = (sizeof(SharedHeader) + 63) & ~(size_t)63;
+	size_t buffersOffset = (channelsOffset + pairs * sizeof(SharedChannel) + 63) & ~(size_t)63;
+	pShared->rank = rank;
+	pShared->processes = processes;
+	pShared->mappingBytes = buffersOffset + pairs * SHARED_CHANNEL_SIZE;
+
+	double deadline = currentTime() + TRANSPORT_TIMEOUT;
+	Status status = (rank == 0) ? createShared(pShared, name) : attachShared(pShared, name, deadline);
+	if (!status) {
+		if (rank == 0)
+			shm_unlink(name);
+		freeMemory(pShared);
+		return FAILURE;
+	}
+	pShared->pHeader = (SharedHeader*)pShared->mapping;
+	pShared->channels = (SharedChannel*)(pShared->mapping + channelsOffset);
+	pShared->buffers = pShared->mapping + buffersOffset;
+
+	// every process waits for all of them, so process 0 can unlink the name and the pids are all there
+	SharedHeader* pHeader = pShared->pHeader;
+	pHeader->pids[rank] = getpid();
+	atomic_fetch_add(&pHeader->attached, 1);
+	while (atomic_load(&pHeader->attached) < processes && currentTime() < deadline)
+		sleepMilliseconds(TRANSPORT_RETRY_INTERVAL);
+	if (rank == 0)
+		shm_unlink(name);
+	if (atomic_load(&pHeader->attached) < processes) {
+		closeShared(pShared);
+		return FAILURE;
+	}
+
+	pTransport->send = sendShared;
+	pTransport->receive = receiveShared;
+	pTransport->close = closeShared;
+	pTransport->rank = rank;
+	pTransport->processes = processes;
+	pTransport->context = pShared;
+
+	return SUCCESS;
+}
+
+
+
+Status matrix_openSocketTransport(const char* const* addresses, int rank, int processes, MatrixTransport* pTransport) {
+	if (!addresses || processes < 1 || rank < 0 || rank >= processes)
+		return FAILURE;
+
+	SocketTransport* pSockets = allocateMemory(sizeof(*pSockets) + (size_t)processes * sizeof(int));
+	if (!pSockets)
+		return FAILURE;
+	pSockets->processes = processes;
+	for (int i = 0; i < processes; ++i)
+		pSockets->fds[i] = -1;
+
+	// each process listens before connecting, so the connections to it wait in its backlog until it accepts them
+	struct addrinfo* pInfo;
+	int listener = -1;
+	if (lookUpAddress(addresses[rank], TRUE, &pInfo)) {
+		for (struct addrinfo* p = pInfo; p && listener < 0; p = p->ai_next) {
+			int reuse = 1;
+			listener = socket(p->ai_family, p->ai_socktype | SOCK_CLOEXEC, p->ai_protocol);
+			if (listener >= 0 && (setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) ||
+				bind(listener, p->ai_addr, p->ai_addrlen) || listen(listener, processes))) {
+				close(listener);
+				listener = -1;
+			}
+		}
+		freeaddrinfo(pInfo);
+	}
+
+	double deadline = currentTime() + TRANSPORT_TIMEOUT;
+	Status status = (listener >= 0) ? SUCCESS : FAILURE;
+	for (int peer = 0; status && peer < rank; ++peer)
+		status = connectToProcess(pSockets, addresses[peer], peer, rank, deadline);
+	if (status)
+		status = acceptProcesses(pSockets, listener, rank, deadline);
+	if (listener >= 0)
+		close(listener);
+	if (!status) {
+		closeSocket(pSockets);
+		return FAILURE;
+	}
+
+	pTransport->send = sendSocket;
+	pTransport->receive = receiveSocket;
+	pTransport->close = closeSocket;
+	pTransport->rank = rank;
+	pTransport->processes = processes;
+	pTransport->context = pSockets;
+
+	return SUCCESS;
+}
+
+
+
+void matrix_closeTransport(MatrixTransport* pTransport) {
+	if (pTransport->close)
+		pTransport->close(pTransport->context);
+	pTransport->context = NULL;
+}
+
+
+
+
+/***** Helper functions used only in this file *****/
+static Status sendShared(int to, const void* data, size_t bytes, void* context) {
+	SharedTransport* pShared = context;
+	if (to < 0 || to >= pShared->processes || to == pShared->rank)
+		return FAILURE;
+
+	size_t channel = (size_t)pShared->rank * pShared->processes + to;
+	SharedChannel* pChannel = &pShared->channels[channel];
+	char* ring = pShared->buffers + channel * SHARED_CHANNEL_SIZE;
+	const char* next = data;
+	while (bytes) {
+		lockChannel(pChannel);
+		// bytes for a process that has closed are never read, so sending them fails
+		size_t space = 0;
+		while (!atomic_load(&pShared->pHeader->closed[to]) && !(space = SHARED_CHANNEL_SIZE - (pChannel->written - pChannel->read))) {
+			if (!waitChannel(pShared, pChannel, to))
+				break;
+		}
+		if (!space || atomic_load(&pShared->pHeader->closed[to])) {
+			pthread_mutex_unlock(&pChannel->lock);
+			return FAILURE;
+		}
+
+		size_t length = (bytes < space) ? bytes : space;
+		size_t position = pChannel->written % SHARED_CHANNEL_SIZE;
+		size_t first = (length < SHARED_CHANNEL_SIZE - position) ? length : SHARED_CHANNEL_SIZE - position;
+		memcpy(ring + position, next, first);
+		memcpy(ring, next + first, length - first);
+		pChannel->written += length;
+		pthread_cond_broadcast(&pChannel->changed);
+		pthread_mutex_unlock(&pChannel->lock);
+		next += length;
+		bytes -= length;
+	}
+
+	return SUCCESS;
+}
+
+
+
+static Status receiveShared(int from, void* data, size_t bytes, void* context) {
+	SharedTransport* pShared = context;
+	if (from < 0 || from >= pShared->processes || from == pShared->rank)
+		return FAILURE;
+
+	size_t channel = (size_t)from * pShared->processes + pShared->rank;
+	SharedChannel* pChannel = &pShared->channels[channel];
+	const char* ring = pShared->buffers + channel * SHARED_CHANNEL_SIZE;
+	char* next = data;
+	while (bytes) {
+		lockChannel(pChannel);
+		// bytes sent before the other process closed can still be received
+		size_t waiting;
+		while (!(waiting = pChannel->written - pChannel->read)) {
+			if (!waitChannel(pShared, pChannel, from))
+				break;
+		}
+		if (!waiting) {
+			pthread_mutex_unlock(&pChannel->lock);
+			return FAILURE;
+		}
+
+		size_t length = (bytes < waiting) ? bytes : waiting;
+		size_t position = pChannel->read % SHARED_CHANNEL_SIZE;
+		size_t first = (length < SHARED_CHANNEL_SIZE - position) ? length : SHARED_CHANNEL_SIZE - position;
+		memcpy(next, ring + position, first);
+		memcpy(next + first, ring, length - first);
+		pChannel->read += length;
+		pthread_cond_broadcast(&pChannel->changed);
+		pthread_mutex_unlock(&pChannel->lock);
+		next += length;
+		bytes -= length;
+	}
+
+	return SUCCESS;
+}
+
+
+
+static void closeShared(void* context) {
+	SharedTransport* pShared = context;
+
+	// wake up the other processes waiting on this one, so they see it has closed
+	atomic_store(&pShared->pHeader->closed[pShared->rank], 1);
+	for (int peer = 0; peer < pShared->processes; ++peer) {
+		if (peer == pShared->rank)
+			continue;
+		SharedChannel* pChannels[2] = {
+			&pShared->channels[(size_t)pShared->rank * pShared->processes + peer],
+			&pShared->channels[(size_t)peer * pShared->processes + pShared->rank]
+		};
+		for (int i = 0; i < 2; ++i) {
+			lockChannel(pChannels[i]);
+			pthread_cond_broadcast(&pChannels[i]->changed);
+			pthread_mutex_unlock(&pChannels[i]->lock);
+		}
+	}
+
+	munmap(pShared->mapping, pShared->mappingBytes);
+	freeMemory(pShared);
+}
+
+
+
+static Status sendSocket(int to, const void* data, size_t bytes, void* context) {
+	SocketTransport* pSockets = context;
+	if (to < 0 || to >= pSockets->processes || pSockets->fds[to] < 0)
+		return FAILURE;
+
+	return sendAll(pSockets->fds[to], data, bytes);
+}
+
+
+
+static Status receiveSocket(int from, void* data, size_t bytes, void* context) {
+	SocketTransport* pSockets = context;
+	if (from < 0 || from >= pSockets->processes || pSockets->fds[from] < 0)
+		return FAILURE;
+
+	return receiveAll(pSockets->fds[from], data, bytes);
+}
+
+
+
+static void closeSocket(void* context) {
+	SocketTransport* pSockets = context;
+
+	for (int i = 0; i < pSockets->processes; ++i) {
+		if (pSockets->fds[i] >= 0)
+			close(pSockets->fds[i]);
+	}
+	freeMemory(pSockets);
+}
+
+
+
+static Status sendAll(int fd, const void* data, size_t bytes) {
+	const char* next = data;
+
+	while (bytes) {
+		ssize_t sent = send(fd, next, bytes, MSG_NOSIGNAL);
+		if (sent < 0 && errno == EINTR)
+			continue;
+		if (sent <= 0)
+			return FAILURE;
+		next += sent;
+		bytes -= (size_t)sent;
+	}
+
+	return SUCCESS;
+}
+
+
+
+static Status receiveAll(int fd, void* data, size_t bytes) {
+	char* next = data;
+
+	while (bytes) {
+		ssize_t received = recv(fd, next, bytes, 0);
+		if (received < 0 && errno == EINTR)
+			continue;
+		// 0 is the other process closing its end
+		if (received <= 0)
+			return FAILURE;
+		next += received;
+		bytes -= (size_t)received;
+	}
+
+	return SUCCESS;
+}
+
+
+
+static Status createShared(SharedTransport* pShared, const char* name) {
+	// an object left by a group that crashed would be sized for it, so it's replaced
+	shm_unlink(name);
+	int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+	if (fd < 0)
+		return FAILURE;
+	void* mapping = MAP_FAILED;
+	if (!ftruncate(fd, (off_t)pShared->mappingBytes))
+		mapping = mmap(NULL, pShared->mappingBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (mapping == MAP_FAILED)
+		return FAILURE;
+	pShared->mapping = mapping;
+
+	pthread_mutexattr_t mutexAttributes;
+	pthread_condattr_t conditionAttributes;
+	pthread_mutexattr_init(&mutexAttributes);
+	pthread_mutexattr_setpshared(&mutexAttributes, PTHREAD_PROCESS_SHARED);
+	pthread_mutexattr_setrobust(&mutexAttributes, PTHREAD_MUTEX_ROBUST);
+	pthread_condattr_init(&conditionAttributes);
+	pthread_condattr_setpshared(&conditionAttributes, PTHREAD_PROCESS_SHARED);
+	pthread_condattr_setclock(&conditionAttributes, CLOCK_MONOTONIC);
+	size_t channelsOffset = (sizeof(SharedHeader) + 63) & ~(size_t)63;
+	SharedChannel* channels = (SharedChannel*)(pShared->mapping + channelsOffset);
+	for (size_t i = 0; i < (size_t)pShared->processes * pShared->processes; ++i) {
+		pthread_mutex_init(&channels[i].lock, &mutexAttributes);
+		pthread_cond_init(&channels[i].changed, &conditionAttributes);
+	}
+	pthread_mutexattr_destroy(&mutexAttributes);
+	pthread_condattr_destroy(&conditionAttributes);
+
+	atomic_store(&((SharedHeader*)pShared->mapping)->magic, SHARED_MAGIC);
+
+	return SUCCESS;
+}
+
+
+
+static Status attachShared(SharedTransport* pShared, const char* name, double deadline) {
+	// the object is ready to map once process 0 has created it and set its size
+	int fd;
+	struct stat info;
+	while ((fd = shm_open(name, O_RDWR | O_CLOEXEC, 0)) < 0 || fstat(fd, &info) ||
+		(size_t)info.st_size != pShared->mappingBytes) {
+		if (fd >= 0)
+			close(fd);
+		if (currentTime() >= deadline)
+			return FAILURE;
+		sleepMilliseconds(TRANSPORT_RETRY_INTERVAL);
+	}
+	void* mapping = mmap(NULL, pShared->mappingBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (mapping == MAP_FAILED)
+		return FAILURE;
+
+	SharedHeader* pHeader = mapping;
+	while (atomic_load(&pHeader->magic) != SHARED_MAGIC && currentTime() < deadline)
+		sleepMilliseconds(TRANSPORT_RETRY_INTERVAL);
+	if (atomic_load(&pHeader->magic) != SHARED_MAGIC) {
+		munmap(mapping, pShared->mappingBytes);
+		return FAILURE;
+	}
+	pShared->mapping = mapping;
+
+	return SUCCESS;
+}
+
+
+
+static Boolean waitChannel(SharedTransport* pShared, SharedChannel* pChannel, int peer) {
+	SharedHeader* pHeader = pShared->pHeader;
+	if (atomic_load(&pHeader->closed[peer]) || atomic_load(&pHeader->closed[pShared->rank]))
+		return FALSE;
+	// a process that crashed never closes, so the wait is cut short to check it's still there
+	if (kill(pHeader->pids[peer], 0) && errno == ESRCH)
+		return FALSE;
+
+	struct timespec timeout;
+	clock_gettime(CLOCK_MONOTONIC, &timeout);
+	timeout.tv_sec += SHARED_WAIT_INTERVAL;
+	if (pthread_cond_timedwait(&pChannel->changed, &pChannel->lock, &timeout) == EOWNERDEAD)
+		pthread_mutex_consistent(&pChannel->lock);
+
+	return TRUE;
+}
+
+
+
+static void lockChannel(SharedChannel* pChannel) {
+	// the counts of the channel are only changed after its bytes are copied, so they're still right
+	if (pthread_mutex_lock(&pChannel->lock) == EOWNERDEAD)
+		pthread_mutex_consistent(&pChannel->lock);
+}
+
+
+
+static Status lookUpAddress(const char* address, Boolean passive, struct addrinfo** ppInfo) {
+	char host[NI_MAXHOST];
+	const char* colon = strrchr(address, ':');
+	if (!colon || colon == address || !colon[1])
+		return FAILURE;
+
+	const char* first = address;
+	const char* end = colon;
+	if (*first == '[' && end[-1] == ']') {
+		++first;
+		--end;
+	}
+	if ((size_t)(end - first) >= sizeof(host))
+		return FAILURE;
+	memcpy(host, first, (size_t)(end - first));
+	host[end - first] = '\0';
+
+	struct addrinfo hints;
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	hints.ai_flags = passive ? AI_PASSIVE : 0;
+
+	return getaddrinfo(host, colon + 1, &hints, ppInfo) ? FAILURE : SUCCESS;
+}
+
+
+
+static Status connectToProcess(SocketTransport* pSockets, const char* address, int peer, int rank, double deadline) {
+	struct addrinfo* pInfo;
+	if (!lookUpAddress(address, FALSE, &pInfo))
+		return FAILURE;
+
+	int fd = -1;
+	while (fd < 0) {
+		for (struct addrinfo* p = pInfo; p && fd < 0; p = p->ai_next) {
+			fd = socket(p->ai_family, p->ai_socktype | SOCK_CLOEXEC, p->ai_protocol);
+			if (fd >= 0 && connect(fd, p->ai_addr, p->ai_addrlen)) {
+				close(fd);
+				fd = -1;
+			}
+		}
+		// the process isn't listening yet
+		if (fd < 0) {
+			if (currentTime() >= deadline)
+				break;
+			sleepMilliseconds(TRANSPORT_RETRY_INTERVAL);
+		}
+	}
+	freeaddrinfo(pInfo);
+	if (fd < 0)
+		return FAILURE;
+
+	// the blocks of SUMMA are sent as soon as they're written, so they aren't held back to be coalesced
+	int noDelay = 1;
+	int32_t sender = rank;
+	setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+	pSockets->fds[peer] = fd;
+
+	return sendAll(fd, &sender, sizeof(sender));
+}
+
+
+
+static Status acceptProcesses(SocketTransport* pSockets, int listener, int rank, double deadline) {
+	int remaining = pSockets->processes - 1 - rank;
+
+	while (remaining) {
+		struct pollfd pollFd = { listener, POLLIN, 0 };
+		double timeLeft = deadline - currentTime();
+		if (timeLeft <= 0 || (poll(&pollFd, 1, (int)(timeLeft * 1000) + 1) < 0 && errno != EINTR))
+			return FAILURE;
+		if (!(pollFd.revents & POLLIN))
+			continue;
+
+		int fd = accept4(listener, NULL, NULL, SOCK_CLOEXEC);
+		if (fd < 0)
+			continue;
+		// anything but a process after this one that hasn't connected yet is dropped
+		int32_t sender;
+		if (!receiveAll(fd, &sender, sizeof(sender)) || sender <= rank || sender >= pSockets->processes || pSockets->fds[sender] >= 0) {
+			close(fd);
+			continue;
+		}
+
+		int noDelay = 1;
+		setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+		pSockets->fds[sender] = fd;
+		--remaining;
+	}
+
+	return SUCCESS;
+}
+
+
+
+static double currentTime(void) {
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+
+
+static void sleepMilliseconds(int milliseconds) {
+	struct timespec duration = { milliseconds / 1000, (milliseconds % 1000) * 1000000L };
+	nanosleep(&duration, NULL);
+}
@@ -0,0 +1,422 @@
+/*
+  Author: Benjamin G. Friedman
+  Date: 10/18/2026
+  File: MatrixUpdate.c
+  Description:
+	  - Implementation file for the updates of the matrix interface, which keep the inverse and determinant of a matrix
+		up to date as entries, rows, columns or low rank terms of it change, in O(n^2 k) time instead of the O(n^3) of
+		recalculating them.
+	  - The inverse is updated with the Sherman-Morrison-Woodbury formula
+			(A + U * V^T)^-1 = A^-1 - A^-1 * U * C^-1 * V^T * A^-1,   C = I + V^T * A^-1 * U
+		and the determinant with the matrix determinant lemma det(A + U * V^T) = det(A) * det(C).
+	  - Rounding errors build up over many updates and a nearly singular C loses accuracy in one, so every update
+		measures the residual of the new inverse and recalculates it (and the determinant) from the matrix when it
+		has drifted too far.
+*/
+
+
+#include <stdlib.h>
+#include <math.h>
+#include "MatrixInternal.h"
+
+
+#define UPDATE_PIVOT_TOLERANCE 1e-10L          // smallest pivot of C, relative to the terms it's made of, that's trusted
+#define UPDATE_DRIFT_TOLERANCE 1e-10L          // largest relative residual of an updated inverse before it's recalculated
+
+
+
+
+/***** Helper functions used only in this file *****/
+/*
+PRECONDITION
+  - n is the order of the matrix and k the rank of the update.
+POSTCONDITION
+  - Returns a zero initialized block holding the n x k arrays U and V at its start followed by the work arrays of
+	finishUpdate, else NULL for any memory allocation failure.
+*/
+static long double* allocateUpdate(size_t n, size_t k);
+
+
+/*
+PRECONDITION
+  - pMatrix is a pointer to a valid n x n matrix object that has already had U * V^T added to it.
+  - pInverse is a pointer to a valid n x n matrix object holding the inverse of the matrix before the update.
+  - work is a block created by allocateUpdate(n, k) holding U and V in row-major order.
+  - pDeterminant is a pointer to the determinant of the matrix before the update, or NULL.
+  - pMatrixIsVertible is a pointer to a Boolean to indicate if the updated matrix is vertible or not.
+POSTCONDITION
+  - Updates the inverse and the determinant for the updated matrix, recalculating them if the update isn't accurate.
+  - Returns the same as matrix_updateInverse.
+*/
+static Status finishUpdate(Matrix* pMatrix, Matrix* pInverse, long double* work, size_t k, long double* pDeterminant,
+	Boolean* pMatrixIsVertible);
+
+
+/*
+PRECONDITION
+  - pMatrix is a pointer to a valid n x n matrix object.
+  - b is a row-major n x n array holding an approximation of its inverse.
+  - x/y are arrays of n long doubles.
+POSTCONDITION
+  - Returns TRUE if the relative residual ||A * (B * x) - x|| / (||A|| * ||B * x|| + ||x||) of a fixed vector x
+	exceeds UPDATE_DRIFT_TOLERANCE, else FALSE. This costs two matrix-vector products.
+*/
+static Boolean hasDrifted(const Matrix* pMatrix, const long double* b, long double* x, long double* y);
+
+
+/*
+PRECONDITION
+  - pMatrix/pInverse/pDeterminant/pMatrixIsVertible are the same as for finishUpdate.
+POSTCONDITION
+  - Recalculates the inverse and, if pDeterminant isn't NULL, the determinant of the matrix from scratch.
+  - Returns the same as matrix_updateInverse.
+*/
+static Status recalculate(Matrix* pMatrix, Matrix* pInverse, long double* pDeterminant, Boolean* pMatrixIsVertible);
+
+
+
+/*
+PRECONDITION
+  - The same as matrix_updateInverse.
+POSTCONDITION
+  - Updates the matrix, inverse and determinant the same as matrix_updateInverse, without measuring the call.
+*/
+static Status addLowRank(MATRIX hMatrix, MATRIX hU, MATRIX hV, MATRIX hInverse, long double* pDeterminant,
+	Boolean* pMatrixIsVertible);
+
+
+/*
+PRECONDITION
+  - The same as matrix_updateEntry.
+POSTCONDITION
+  - Updates the matrix, inverse and determinant the same as matrix_updateEntry, without measuring the call.
+*/
+static Status replaceEntry(MATRIX hMatrix, long double newEntry, size_t row, size_t column, MATRIX hInverse,
+	long double* pDeterminant, Boolean* pMatrixIsVertible);
+
+
+/*
+PRECONDITION
+  - The same as matrix_updateRow.
+POSTCONDITION
+  - Updates the matrix, inverse and determinant the same as matrix_updateRow, without measuring the call.
+*/
+static Status replaceRow(MATRIX hMatrix, MATRIX hRow, size_t row, MATRIX hInverse, long double* pDeterminant,
+	Boolean* pMatrixIsVertible);
+
+
+/*
+PRECONDITION
+  - The same as matrix_updateColumn.
+POSTCONDITION
+  - Updates the matrix, inverse and determinant the same as matrix_updateColumn, without measuring the call.
+*/
+static Status replaceColumn(MATRIX hMatrix, MATRIX hColumn, size_t column, MATRIX hInverse, long double* pDeterminant,
+	Boolean* pMatrixIsVertible);
+
+
+
+/***** Functions defined in Matrix.h *****/
+Status matrix_updateInverse(MATRIX hMatrix, MATRIX hU, MATRIX hV, MATRIX hInverse, long double* pDeterminant,
+	Boolean* pMatrixIsVertible) {
+	double n = ((Matrix*)hMatrix)->rows, k = ((Matrix*)hU)->columns;
+	MeasuredCall call;
+
+	beginCall(&call, MATRIX_OPERATION_UPDATE_INVERSE, hMatrix);
+	Status status = addLowRank(hMatrix, hU, hV, hInverse, pDeterminant, pMatrixIsVertible);
+	endCall(&call, status ? (6 * k + 4) * n * n : 0);
+
+	return status;
+}
+
+
+
+Status matrix_updateEntry(MATRIX hMatrix, long double newEntry, size_t row, size_t column, MATRIX hInverse,
+	long double* pDeterminant, Boolean* pMatrixIsVertible) {
+	double n = ((Matrix*)hMatrix)->rows;
+	MeasuredCall call;
+
+	beginCall(&call, MATRIX_OPERATION_UPDATE_ENTRY, hMatrix);
+	Status status = replaceEntry(hMatrix, newEntry, row, column, hInverse, pDeterminant, pMatrixIsVertible);
+	endCall(&call, status ? 10 * n * n : 0);
+
+	return status;
+}
+
+
+
+Status matrix_updateRow(MATRIX hMatrix, MATRIX hRow, size_t row, MATRIX hInverse, long double* pDeterminant,
+	Boolean* pMatrixIsVertible) {
+	double n = ((Matrix*)hMatrix)->rows;
+	MeasuredCall call;
+
+	beginCall(&call, MATRIX_OPERATION_UPDATE_ROW, hMatrix);
+	Status status = replaceRow(hMatrix, hRow, row, hInverse, pDeterminant, pMatrixIsVertible);
+	endCall(&call, status ? 10 * n * n : 0);
+
+	return status;
+}
+
+
+
+Status matrix_updateColumn(MATRIX hMatrix, MATRIX hColumn, size_t column, MATRIX hInverse, long double* pDeterminant,
+	Boolean* pMatrixIsVertible) {
+	double n = ((Matrix*)hMatrix)->rows;
+	MeasuredCall call;
+
+	beginCall(&call, MATRIX_OPERATION_UPDATE_COLUMN, hMatrix);
+	Status status = replaceColumn(hMatrix, hColumn, column, hInverse, pDeterminant, pMatrixIsVertible);
+	endCall(&call, status ? 10 * n * n : 0);
+
+	return status;
+}
+
+
+
+
+/***** Helper functions used only in this file *****/
+static long double* allocateUpdate(size_t n, size_t k) {
+	// U, V, B, W, Z, C, x and y, then the pivots of C
+	size_t entries = 4 * n * k + n * n + k * k + 2 * n;
+	return allocateZeroedMemory(1, entries * sizeof(long double) + k * sizeof(size_t));
+}
+
+
+
+static Status finishUpdate(Matrix* pMatrix, Matrix* pInverse, long double* work, size_t k, long double* pDeterminant,
+	Boolean* pMatrixIsVertible) {
+	size_t n = pMatrix->rows;
+	long double* u = work;                     // n x k
+	long double* v = u + n * k;                // n x k
+	long double* b = v + n * k;                // n x n inverse being updated
+	long double* w = b + n * n;                // n x k, A^-1 * U
+	long double* z = w + n * k;                // k x n, V^T * A^-1 and then C^-1 * V^T * A^-1
+	long double* c = z + k * n;                // k x k capacitance matrix
+	long double* x = c + k * k;                // probe vectors of hasDrifted
+	long double* y = x + n;
+	size_t* pivots = (size_t*)(y + n);
+
+	copyToRowMajor(pInverse, b);
+	multiplyKernel(FALSE, FALSE, n, k, n, 1, b, n, u, k, 0, w, k);
+	multiplyKernel(TRUE, FALSE, k, n, n, 1, v, k, b, n, 0, z, n);
+
+	// C = I + V^T * A^-1 * U, with the largest of the terms it's made of as the scale of its pivots so the
+	// cancellation in 1 + v^T * A^-1 * u of a rank one update that makes the matrix singular is seen
+	multiplyKernel(TRUE, FALSE, k, k, n, 1, v, k, w, k, 0, c, k);
+	long double largest = 1;
+	for (size_t i = 0; i < k; ++i) {
+		for (size_t j = 0; j < k; ++j)
+			if (fabsl(c[i * k + j]) > largest)
+				largest = fabsl(c[i * k + j]);
+		c[i * k + i] += 1;
+	}
+
+	// a nearly singular C means the updated matrix is nearly singular too, which the formula can't be trusted to tell
+	Boolean trusted = luFactor(c, k, pivots);
+	for (size_t i = 0; trusted && i < k; ++i)
+		if (fabsl(c[i * k + i]) < UPDATE_PIVOT_TOLERANCE * largest)
+			trusted = FALSE;
+
+	// B = B - W * C^-1 * Z
+	if (trusted) {
+		luSolve(c, k, pivots, z, n);
+		multiplyKernel(FALSE, FALSE, n, n, k, -1, w, k, z, n, 1, b, n);
+		trusted = !hasDrifted(pMatrix, b, x, y);
+	}
+	if (!trusted)
+		return recalculate(pMatrix, pInverse, pDeterminant, pMatrixIsVertible);
+
+	copyFromRowMajor(pInverse, b);
+	pInverse->maxLength = 0;
+
+	// det(A + U * V^T) = det(A) * det(C), with a sign change for each row interchange of the factorization of C
+	if (pDeterminant) {
+		long double product = *pDeterminant;
+		for (size_t i = 0; i < k; ++i)
+			product *= (pivots[i] != i) ? -c[i * k + i] : c[i * k + i];
+		*pDeterminant = product;
+	}
+
+	return SUCCESS;
+}
+
+
+
+static Boolean hasDrifted(const Matrix* pMatrix, const long double* b, long double* x, long double* y) {
+	size_t n = pMatrix->rows;
+	long double xNorm = 0, yNorm = 0, aNorm = 0, residualNorm = 0;
+
+	// a fixed vector with entries spread over [-1, 1] so no structure of the matrix hides the error
+	for (size_t i = 0; i < n; ++i) {
+		x[i] = (long double)((i * 2654435761u) % 2001) / 1000 - 1;
+		if (fabsl(x[i]) > xNorm)
+			xNorm = fabsl(x[i]);
+	}
+
+	// y = B * x
+	for (size_t i = 0; i < n; ++i) {
+		const long double* bRow = b + i * n;
+		long double sum = 0;
+		for (size_t j = 0; j < n; ++j)
+			sum += bRow[j] * x[j];
+		y[i] = sum;
+		if (fabsl(sum) > yNorm)
+			yNorm = fabsl(sum);
+	}
+
+	// r = A * y - x with the infinity norms of A and r
+	for (size_t i = 0; i < n; ++i) {
+		long double sum = -x[i], rowSum = 0;
+		for (size_t j = 0; j < n; ++j) {
+			long double entry = pMatrix->matrix[matrixIndex(pMatrix, i, j)];
+			sum += entry * y[j];
+			rowSum += fabsl(entry);
+		}
+		if (fabsl(sum) > residualNorm)
+			residualNorm = fabsl(sum);
+		if (rowSum > aNorm)
+			aNorm = rowSum;
+	}
+
+	// the comparison is written so a NaN residual counts as drifted
+	return !(residualNorm <= UPDATE_DRIFT_TOLERANCE * (aNorm * yNorm + xNorm));
+}
+
+
+
+static Status recalculate(Matrix* pMatrix, Matrix* pInverse, long double* pDeterminant, Boolean* pMatrixIsVertible) {
+	MATRIX hInverse = pInverse;       // matrix_inverse keeps the object since its dimensions are right
+
+	if (!matrix_inverse(pMatrix, &hInverse, pMatrixIsVertible)) {
+		if (!*pMatrixIsVertible && pDeterminant)
+			*pDeterminant = 0;
+		return FAILURE;
+	}
+
+	if (pDeterminant) {
+		Status memoryAllocation;
+		long double determinant = matrix_determinant(pMatrix, &memoryAllocation);
+		if (!memoryAllocation)
+			return FAILURE;
+		*pDeterminant = determinant;
+	}
+
+	return SUCCESS;
+}
+
+
+
+static Status addLowRank(MATRIX hMatrix, MATRIX hU, MATRIX hV, MATRIX hInverse, long double* pDeterminant,
+	Boolean* pMatrixIsVertible) {
+	Matrix* pMatrix = hMatrix;
+	size_t n = pMatrix->rows;
+	size_t k = ((Matrix*)hU)->columns;
+	long double* u;                   // U and V in row-major order, followed by the work arrays
+	long double* v;
+	*pMatrixIsVertible = TRUE;
+
+	if (!(u = allocateUpdate(n, k)))
+		return FAILURE;
+	v = u + n * k;
+	copyToRowMajor(hU, u);
+	copyToRowMajor(hV, v);
+
+	// A = A + U * V^T
+	for (size_t i = 0; i < n; ++i) {
+		const long double* uRow = u + i * k;
+		for (size_t j = 0; j < n; ++j) {
+			const long double* vRow = v + j * k;
+			long double sum = 0;
+			for (size_t l = 0; l < k; ++l)
+				sum += uRow[l] * vRow[l];
+			pMatrix->matrix[matrixIndex(pMatrix, i, j)] += sum;
+		}
+	}
+	pMatrix->maxLength = 0;
+
+	Status status = finishUpdate(pMatrix, hInverse, u, k, pDeterminant, pMatrixIsVertible);
+	freeMemory(u);
+
+	return status;
+}
+
+
+
+static Status replaceEntry(MATRIX hMatrix, long double newEntry, size_t row, size_t column, MATRIX hInverse,
+	long double* pDeterminant, Boolean* pMatrixIsVertible) {
+	Matrix* pMatrix = hMatrix;
+	size_t n = pMatrix->rows;
+	long double* u;                   // U = (newEntry - entry) * e_row and V = e_column, followed by the work arrays
+	*pMatrixIsVertible = TRUE;
+
+	if (row >= n || column >= n || !(u = allocateUpdate(n, 1)))
+		return FAILURE;
+
+	// the entry is set exactly, the update only accounts for it
+	long double* pEntry = &pMatrix->matrix[matrixIndex(pMatrix, row, column)];
+	u[row] = newEntry - *pEntry;
+	u[n + column] = 1;
+	*pEntry = newEntry;
+	pMatrix->maxLength = 0;
+
+	Status status = finishUpdate(pMatrix, hInverse, u, 1, pDeterminant, pMatrixIsVertible);
+	freeMemory(u);
+
+	return status;
+}
+
+
+
+static Status replaceRow(MATRIX hMatrix, MATRIX hRow, size_t row, MATRIX hInverse, long double* pDeterminant,
+	Boolean* pMatrixIsVertible) {
+	Matrix* pMatrix = hMatrix;
+	Matrix* pRow = hRow;
+	size_t n = pMatrix->rows;
+	long double* u;                   // U = e_row and V = newRow - row, followed by the work arrays
+	*pMatrixIsVertible = TRUE;
+
+	if (row >= n || !(u = allocateUpdate(n, 1)))
+		return FAILURE;
+
+	u[row] = 1;
+	for (size_t j = 0; j < n; ++j) {
+		long double* pEntry = &pMatrix->matrix[matrixIndex(pMatrix, row, j)];
+		long double newEntry = pRow->matrix[matrixIndex(pRow, 0, j)];
+		u[n + j] = newEntry - *pEntry;
+		*pEntry = newEntry;
+	}
+	pMatrix->maxLength = 0;
+
+	Status status = finishUpdate(pMatrix, hInverse, u, 1, pDeterminant, pMatrixIsVertible);
+	freeMemory(u);
+
+	return status;
+}
+
+
+
+static Status replaceColumn(MATRIX hMatrix, MATRIX hColumn, size_t column, MATRIX hInverse, long double* pDeterminant,
+	Boolean* pMatrixIsVertible) {
+	Matrix* pMatrix = hMatrix;
+	Matrix* pColumn = hColumn;
+	size_t n = pMatrix->rows;
+	long double* u;                   // U = newColumn - column and V = e_column, followed by the work arrays
+	*pMatrixIsVertible = TRUE;
+
+	if (column >= n || !(u = allocateUpdate(n, 1)))
+		return FAILURE;
+
+	for (size_t i = 0; i < n; ++i) {
+		long double* pEntry = &pMatrix->matrix[matrixIndex(pMatrix, i, column)];
+		long double newEntry = pColumn->matrix[matrixIndex(pColumn, i, 0)];
+		u[i] = newEntry - *pEntry;
+		*pEntry = newEntry;
+	}
+	u[n + column] = 1;
+	pMatrix->maxLength = 0;
+
+	Status status = finishUpdate(pMatrix, hInverse, u, 1, pDeterminant, pMatrixIsVertible);
+	freeMemory(u);
+
+	return status;
+}
@@ -27,7 +27,7 @@ static Boolean menuChoiceIsValid(const char* line, int rangeStart, int rangeEnd)
 
 
 
-/***** Helper functions defined in Matrix.c *****/
+/***** Helper functions defined in Prompt.c *****/
 void numberAppender(int n, char* append);
 Boolean inputIsValidPositiveInt(const char* line, int expectedNumbers);
 Boolean inputIsValidUnsignedInt(const char* line, int expectedNumbers);
@@ -68,7 +68,7 @@ int menu_getUserChoice(void) {
 
 
 Status menu_matrixMultiplication(void) {
-	int rows1, columns1, rows2, columns2;        // dimensions of the matrices to be multiplied
+	size_t rows1, columns1, rows2, columns2;     // dimensions of the matrices to be multiplied
 	Status m1ValidInput, m2ValidInput;           // checks if the input for the entries of the matrices is valid
 	Status memoryAllocation;                     // checks for memory allocation failure
 	Boolean canBeMultiplied;                     // checks if matrix1/matrix2 can be multiplied
@@ -80,14 +80,14 @@ Status menu_matrixMultiplication(void) {
 	printf("For matrix multiplication, the columns of the first matrix must equal the rows of the second matrix.\n");
 	do {
 		do { // matrix 1
-			m1ValidInput = matrix_getDimensions(&rows1, &columns1, 1, operations[0]);
+			m1ValidInput = prompt_getDimensions(&rows1, &columns1, 1, operations[0]);
 			if (!m1ValidInput) {
 				printf("Input error. Re-enter input.\n");
 			}
 		} while (!m1ValidInput);
 
 		do { // matrix2
-			m2ValidInput = matrix_getDimensions(&rows2, &columns2, 2, operations[0]);
+			m2ValidInput = prompt_getDimensions(&rows2, &columns2, 2, operations[0]);
 			if (!m2ValidInput) {
 				printf("Input error. Re-enter input.\n");
 			}
@@ -110,8 +110,8 @@ Status menu_matrixMultiplication(void) {
 
 	// fill up the entries of the matrices
 	do {
-		matrix_fillPrompt(hMatrix1, 1);
-		m1ValidInput = matrix_fillInput(hMatrix1, &memoryAllocation);
+		prompt_fillPrompt(hMatrix1, 1);
+		m1ValidInput = prompt_fillInput(hMatrix1, &memoryAllocation);
 		if (!m1ValidInput) {
 			if (!memoryAllocation) {
 				printf("\n\nMemory allocation failure during matrix multiplication.\n\n");
@@ -125,8 +125,8 @@ Status menu_matrixMultiplication(void) {
 	} while (!m1ValidInput);
 
 	do {
-		matrix_fillPrompt(hMatrix2, 2);
-		m2ValidInput = matrix_fillInput(hMatrix2, &memoryAllocation);
+		prompt_fillPrompt(hMatrix2, 2);
+		m2ValidInput = prompt_fillInput(hMatrix2, &memoryAllocation);
 		if (!m2ValidInput) {
 			if (!memoryAllocation) {
 				printf("\n\nMemory allocation failure during matrix multiplication.\n\n");
@@ -165,7 +165,7 @@ Status menu_matrixMultiplication(void) {
 
 
 Status menu_matrixAddition(void) {
-	int rows, columns;                // dimensions of the matrices
+	size_t rows, columns;             // dimensions of the matrices
 	int numMatrices;                  // number of matrices
 	Status validInput;                // valid input for the number of matrices, matrix dimensions, and matrix entries
 	Status memoryAllocation;          // checks for memory allocation failure
@@ -175,14 +175,14 @@ Status menu_matrixAddition(void) {
 
 	// get the number of matrices to add
 	do {
-		validInput = matrix_getNumMatrices("add", &numMatrices);
+		validInput = prompt_getNumMatrices("add", &numMatrices);
 		if (!validInput)
 			printf("Input error. Re-enter input.\n");
 	} while (!validInput);
 
 	// get the dimensions of each matrix (all are the same)
 	do {
-		validInput = matrix_getDimensions(&rows, &columns, 0, operations[1]);
+		validInput = prompt_getDimensions(&rows, &columns, 0, operations[1]);
 		if (!validInput)
 			printf("Input error. Re-enter input.\n");
 	} while (!validInput);
@@ -210,8 +210,8 @@ Status menu_matrixAddition(void) {
 	for (int i = 0; i < numMatrices; ++i) {
 		numberAppender(i + 1, append);
 		do {
-			matrix_fillPrompt(hMatrices[i], i + 1);
-			validInput = matrix_fillInput(hMatrices[i], &memoryAllocation);
+			prompt_fillPrompt(hMatrices[i], i + 1);
+			validInput = prompt_fillInput(hMatrices[i], &memoryAllocation);
 			if (!validInput) {
 				if (!memoryAllocation) {
 					printf("\n\nMemory allocation failure during matrix addition.\n\n");
@@ -255,7 +255,7 @@ Status menu_matrixAddition(void) {
 
 
 Status menu_matrixSubtraction(void) {
-	int rows, columns;                // dimensions of the matrices
+	size_t rows, columns;             // dimensions of the matrices
 	int numMatrices;                  // number of matrices
 	Status validInput;                // valid input for the number of matrices, matrix dimensions, and matrix entries
 	Status memoryAllocation;          // checks for memory allocation failure
@@ -265,14 +265,14 @@ Status menu_matrixSubtraction(void) {
 
 	// get the number of matrices to subtract
 	do {
-		validInput = matrix_getNumMatrices("subtract", &numMatrices);
+		validInput = prompt_getNumMatrices("subtract", &numMatrices);
 		if (!validInput)
 			printf("Input error.. Re-enter input.\n");
 	} while (!validInput);
 
 	// get the dimensions of each matrix (all are the same)
 	do {
-		validInput = matrix_getDimensions(&rows, &columns, 0, operations[2]);
+		validInput = prompt_getDimensions(&rows, &columns, 0, operations[2]);
 		if (!validInput)
 			printf("Input error. Re-enter input.\n");
 	} while (!validInput);
@@ -300,8 +300,8 @@ Status menu_matrixSubtraction(void) {
 	for (int i = 0; i < numMatrices; ++i) {
 		numberAppender(i + 1, append);
 		do {
-			matrix_fillPrompt(hMatrices[i], i + 1);
-			validInput = matrix_fillInput(hMatrices[i], &memoryAllocation);
+			prompt_fillPrompt(hMatrices[i], i + 1);
+			validInput = prompt_fillInput(hMatrices[i], &memoryAllocation);
 			if (!validInput) {
 				if (!memoryAllocation) {
 					printf("\n\nMemory allocation failure during matrix subtraction.\n\n");
@@ -345,7 +345,8 @@ Status menu_matrixSubtraction(void) {
 
 
 Status menu_matrixPower(void) {
-	int rows, columns, power;        // power and dimensions of the matrix
+	size_t rows, columns;            // dimensions of the matrix
+	int power;                       // power the matrix is raised to
 	char line[500];                  // buffer to get line of user input
 	Boolean validInputPower;         // valid input for the matrix power - inputIsValidPositiveInt returns a Boolean
 	Status validInput;               // valid input for the matrix dimensions and entries
@@ -365,7 +366,7 @@ Status menu_matrixPower(void) {
 	sscanf(line, "%d", &power);
 
 	do {
-		validInput = matrix_getDimensions(&rows, &columns, -1, operations[3]);
+		validInput = prompt_getDimensions(&rows, &columns, -1, operations[3]);
 		if (!validInput || rows != columns)
 			printf("Input error. Re-enter input.\n");
 	} while (!validInput || rows != columns);
@@ -376,8 +377,8 @@ Status menu_matrixPower(void) {
 
 	// fill up the entries of the matrix
 	do {
-		matrix_fillPrompt(hMatrix, 0);
-		validInput = matrix_fillInput(hMatrix, &memoryAllocation);
+		prompt_fillPrompt(hMatrix, 0);
+		validInput = prompt_fillInput(hMatrix, &memoryAllocation);
 		if (!validInput) {
 			if (!memoryAllocation) {
 				printf("\n\nMemory allocation failure during the matrix power operation.\n\n");
@@ -410,7 +411,7 @@ Status menu_matrixPower(void) {
 
 
 Status menu_matrixTranspose(void) {
-	int rows, columns;              // dimensions of the matrix
+	size_t rows, columns;           // dimensions of the matrix
 	Status validInput;              // valid input for the matrix dimensions and entries
 	Status memoryAllocation;        // checks for memory allocation failure
 	MATRIX hMatrix = NULL;          // matrix to be transposed
@@ -418,7 +419,7 @@ Status menu_matrixTranspose(void) {
 
 	// get the dimensions of the matrix to transpose
 	do {
-		validInput = matrix_getDimensions(&rows, &columns, -1, operations[4]);
+		validInput = prompt_getDimensions(&rows, &columns, -1, operations[4]);
 		if (!validInput)
 			printf("Input error. Re-enter input.\n");
 	} while (!validInput);
@@ -429,8 +430,8 @@ Status menu_matrixTranspose(void) {
 
 	// fill up the entries of the matrix
 	do {
-		matrix_fillPrompt(hMatrix, 0);
-		validInput = matrix_fillInput(hMatrix, &memoryAllocation);
+		prompt_fillPrompt(hMatrix, 0);
+		validInput = prompt_fillInput(hMatrix, &memoryAllocation);
 		if (!validInput) {
 			if (!memoryAllocation) {
 				printf("\n\nMemory allocation failure during the matrix transpose operation.\n\n");
@@ -463,7 +464,7 @@ Status menu_matrixTranspose(void) {
 
 
 Status menu_matrixDeterminant(void) {
-	int rows, columns;              // dimensions of the matrix
+	size_t rows, columns;           // dimensions of the matrix
 	long double determinant;        // the result of the determinant operation
 	Status validInput;              // valid input for the number of matrices/dimensions
 	Status memoryAllocation;        // checks for memory allocation failure
@@ -471,7 +472,7 @@ Status menu_matrixDeterminant(void) {
 
 	// get the dimensions
 	do {
-		validInput = matrix_getDimensions(&rows, &columns, -1, operations[5]);
+		validInput = prompt_getDimensions(&rows, &columns, -1, operations[5]);
 		if (!validInput || rows != columns) {
 			printf("Input error. Re-enter input.\n");
 		}
@@ -483,8 +484,8 @@ Status menu_matrixDeterminant(void) {
 
 	// fill up the entries of the matrix
 	do {
-		matrix_fillPrompt(hMatrix, 0);
-		validInput = matrix_fillInput(hMatrix, &memoryAllocation);
+		prompt_fillPrompt(hMatrix, 0);
+		validInput = prompt_fillInput(hMatrix, &memoryAllocation);
 		if (!validInput) {
 			if (!memoryAllocation) {
 				printf("\n\nMemory allocation failure during the matrix determinant operation.\n\n");
@@ -515,7 +516,7 @@ Status menu_matrixDeterminant(void) {
 
 
 Status menu_matrixInverse(void) {
-	int rows, columns;               // dimensions of the matrix
+	size_t rows, columns;            // dimensions of the matrix
 	Status validInput;               // valid input for the matrix dimensions and entries
 	Status memoryAllocation;         // checks for memory allocation failure
 	Boolean matrixIsVertible;        // checks if the matrix is vertible during the inverse operation
@@ -524,7 +525,7 @@ Status menu_matrixInverse(void) {
 
 	// get the dimensions
 	do {
-		validInput = matrix_getDimensions(&rows, &columns, -1, operations[6]);
+		validInput = prompt_getDimensions(&rows, &columns, -1, operations[6]);
 		if (!validInput || rows != columns) {
 			printf("Input error. Re-enter input.\n");
 		}
@@ -536,8 +537,8 @@ Status menu_matrixInverse(void) {
 
 	// fill up the entries of the matrix
 	do {
-		matrix_fillPrompt(hMatrix, 0);
-		validInput = matrix_fillInput(hMatrix, &memoryAllocation);
+		prompt_fillPrompt(hMatrix, 0);
+		validInput = prompt_fillInput(hMatrix, &memoryAllocation);
 		if (!validInput) {
 			if (!memoryAllocation) {
 				printf("\n\nMemory allocation failure during the matrix inverse operation.\n\n");
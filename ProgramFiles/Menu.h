@@ -11,7 +11,7 @@
 #define MENU_H
 
 
-#include "Matrix.h"
+#include "Prompt.h"
 
 
 
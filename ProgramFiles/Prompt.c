@@ -0,0 +1,258 @@
+/*
+  Author: Benjamin G. Friedman
+  Date: 10/18/2026
+  File: Prompt.c
+  Description:
+	  - Implementation file for the prompt interface.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <stdint.h>
+#include "Prompt.h"
+
+
+/***** Global variables *****/
+// The various matrix operations that can be performed
+const char* operations[] = { "multiplication", "addition", "subtraction", "power", "transpose", "determinant",  "inverse" };
+const int operationsSize = sizeof(operations) / sizeof(*operations);
+
+
+
+
+/***** Helper functions used in this file and Menu.c - definitions are in this file *****/
+/*
+PRECONDITION
+  - n is any integer
+  - append is the character array to hold the append string. It has a capacity of 3 with a null terminator
+	at index 2.
+POSTCONDITION
+  - Based on what n is, append now holds the append string.
+	For example, if n is 21 the append string is "st" for 21st.
+*/
+void numberAppender(int n, char* append);
+
+
+/*
+PRECONDITION
+  - line is a string containing any amount of potentially valid positive integers.
+  - expectedNumbers is the expected amount of positive integers to be found in the line.
+POSTCONDITION
+  - Returns TRUE if the input is valid, else FALSE.
+  - Valid input is integers > 0, and the amount of integers entered matches expectedNumbers.
+*/
+Boolean inputIsValidPositiveInt(const char* line, int expectedNumbers);
+
+
+/*
+PRECONDITION
+  - line is a string containing any amount of potentially valid unsigned integers.
+  - expectedNumbers is the expected amount of unsigned integers to be found in the line.
+POSTCONDITION
+  - Returns TRUE if the input is valid, else FALSE.
+  - Valid input is integers >= 0, and the amount of integers entered matches expectedNumbers.
+*/
+Boolean inputIsValidUnsignedInt(const char* line, int expectedNumbers);
+
+
+
+
+/***** Functions declared in Prompt.h *****/
+Status prompt_getDimensions(size_t* pRows, size_t* pColumns, int n, const char* operation) {
+	char append[3] = { '\0' };        // holds "st" for 1st, "nd" for 2nd etc.
+	char line[500];                   // buffer for line of user input
+
+	// prompt the user to enter the dimensions for the correct matrix
+	printf("Enter the desired rows and columns for the ");
+	if (n == -1)
+		printf("matrix ");
+	else if (n == 0)
+		printf("matrices ");
+	else {
+		numberAppender(n, append);
+		printf("%d%s matrix ", n, append);
+	}
+	printf("separated by a space.\n");
+
+	if (!strcmp(operation, operations[3])) {
+		printf("For the matrix %s operation, the rows must equal the columns.\n"
+			"For example, enter \"3 3\" to create a 3 x 3 matrix.\n", operations[3]);
+	}
+	else if (!strcmp(operation, operations[5])) {
+		printf("For the matrix %s operation, the rows must equal the columns.\n"
+			"For example, enter \"3 3\" to create a 3 x 3 matrix.\n", operations[5]);
+	}
+	else if (!strcmp(operation, operations[6])) {
+		printf("For the matrix %s operation, the rows must equal the columns.\n"
+			"For example, enter \"3 3\" to create a 3 x 3 matrix.\n", operations[6]);
+	}
+	else {
+		printf("For example, enter \"3 5\" to create a 3 x 5 matrix.\n");
+	}
+
+	// get and validate user input for the dimensions
+	fgets(line, 500, stdin);
+	line[strlen(line) - 1] = '\0';
+	if (!inputIsValidPositiveInt(line, 2)) {
+		*pRows = 0;
+		*pColumns = 0;
+		return FAILURE;
+	}
+	sscanf(line, "%zu%zu", pRows, pColumns);
+
+	return SUCCESS;
+}
+
+
+
+Status prompt_getNumMatrices(const char* operation, int* pNumMatrices) {
+	char line[500];        // holds line of user input
+
+	// get and validate user input for the number of matrices
+	printf("Enter the number of matrices to %s. Must be an integer that is at least 2.\n", operation);
+	fgets(line, 500, stdin);
+	line[strlen(line) - 1] = '\0';
+	if (!inputIsValidPositiveInt(line, 1) || atoi(line) < 2) {
+		*pNumMatrices = 0;
+		return FAILURE;
+	}
+	sscanf(line, "%d", pNumMatrices);
+
+	return SUCCESS;
+}
+
+
+
+Status prompt_fillInput(MATRIX hMatrix, Status* pMemoryAllocation) {
+	Status status = matrix_readText(hMatrix, stdin, pMemoryAllocation);
+	if (status)
+		printf("\n");
+
+	return status;
+}
+
+
+
+void prompt_fillPrompt(MATRIX hMatrix, int matrixNumber) {
+	char append[3] = { '\0' };
+
+	printf("Enter values for the ");
+	if (matrixNumber) {
+		numberAppender(matrixNumber, append);
+		printf("%d%s ", matrixNumber, append);
+	}
+	printf("%zu x %zu matrix with each row separated by a newline.\n", matrix_getRows(hMatrix),
+		matrix_getColumns(hMatrix));
+}
+
+
+
+
+/***** Helper functions used in this file and Menu.c *****/
+void numberAppender(int n, char* append) {
+	// special case
+	if (n >= 4 && n <= 20) {
+		append[0] = 't';
+		append[1] = 'h';
+	}
+	// st i.e. 21st
+	else if ((n - 1) % 10 == 0) {
+		append[0] = 's';
+		append[1] = 't';
+	}
+	// nd i.e. 22nd
+	else if ((n - 2) % 10 == 0) {
+		append[0] = 'n';
+		append[1] = 'd';
+	}
+	// rd i.e 23rd
+	else if ((n - 3) % 10 == 0) {
+		append[0] = 'r';
+		append[1] = 'd';
+	}
+	// th i.e. 20th, 24th, 25th, 26th etc.
+	else {
+		append[0] = 't';
+		append[1] = 'h';
+	}
+}
+
+
+
+Boolean inputIsValidPositiveInt(const char* line, int expectedNumbers) {
+	// user only pressed "enter" or whitespace followed by "enter" - space is the only valid whitespace character
+	int i = 0;
+	while (isspace(line[i])) {
+		if (line[i] != ' ')
+			return FALSE;
+		++i;
+	}
+	if (line[i] == '\0')
+		return FALSE;
+
+	// validate it's all numbers or spaces
+	while (line[i] != '\0') {
+		// something other than a digit or space
+		if (!isdigit(line[i]) && line[i] != ' ')
+			return FALSE;
+		++i;
+	}
+
+
+	// input has been validated - now verify an appropriate amount of numbers has been entered and that none of the numbers are 0.
+	// dimensions are read as size_t so a number that doesn't fit in one is rejected rather than wrapped
+	const char* pNum = line;
+	char* pEnd;
+	int totalNumbers = 0;
+	while (*pNum != '\0') {
+		errno = 0;
+		unsigned long long singleNum = strtoull(pNum, &pEnd, 10);
+		if (pEnd == pNum)
+			break;
+		if (singleNum == 0 || errno == ERANGE || singleNum > SIZE_MAX)
+			return FALSE;
+		++totalNumbers;
+		pNum = pEnd;
+	}
+
+	return totalNumbers == expectedNumbers;
+}
+
+
+
+Boolean inputIsValidUnsignedInt(const char* line, int expectedNumbers) {
+	// user only pressed "enter" or whitespace followed by "enter" - space is the only valid whitespace character
+	int i = 0;
+	while (isspace(line[i])) {
+		if (line[i] != ' ')
+			return FALSE;
+		++i;
+	}
+	if (line[i] == '\0')
+		return FALSE;
+
+	// validate it's all numbers in the correct format
+	while (line[i] != '\0') {
+		// something other than a digit or space
+		if (!isdigit(line[i]) && line[i] != ' ')
+			return FALSE;
+		++i;
+	}
+
+	// input has been validated - now verify an appropriate amount of numbers has been entered
+	int totalNumbers = 0;
+	i = 0;
+	while (line[i] != '\0') {
+		while (line[i] != ' ' && line[i] != '\0')
+			++i;
+		++totalNumbers;
+		if (line[i] != '\0')
+			++i;
+	}
+
+	return totalNumbers == expectedNumbers;
+}
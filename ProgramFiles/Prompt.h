@@ -0,0 +1,86 @@
+/*
+  Author: Benjamin G. Friedman
+  Date: 10/18/2026
+  File: Prompt.h
+  Description:
+      - Header file for the prompt interface, which asks the user for the dimensions and values of matrices on the
+        standard input for the menu. It's kept out of the matrix library, which never reads or writes the terminal
+        except when asked to with a stream.
+*/
+
+
+#ifndef PROMPT_H
+#define PROMPT_H
+
+
+#include "Matrix.h"
+
+
+
+
+/***** Global variables *****/
+extern const char* operations[];     // the various matrix operations that can be performed
+extern const int operationsSize;
+
+
+
+
+/***** Functions defined in Prompt.c *****/
+/*
+PRECONDITION
+  - pRows/pColumns are pointers to the size_t variables to store the dimenions.
+  - n dicates what the prompt looks like (described in the POSTCONDITION) and is in range [-1, ...).
+  - operation is a string that will be printed indicating which matrix operation is being performed.
+POSTCONDITION
+  - Prompts the user to enter the dimensions of the matrix. If n == -1, prints 'matrix' in the prompt.
+    If n == 0, prints 'matrices' in the prompt. If n is anything else like 1 for example, it would print
+    "1st" matrix.
+  - Valid input - Stores the desired rows and columns in the variables pointed to by pRows and pColumns
+    and returns SUCCESS.
+  - Invalid input - Stores 0 in the variables pointed to by pRows/pColumns and returns FAILURE.
+  - Valid input is two integers >= 1 that fit in a size_t.
+*/
+Status prompt_getDimensions(size_t* pRows, size_t* pColumns, int n, const char* operation);
+
+
+/*
+PRECONDITION
+  - operation is a string that will print indicating whether the function call is for addition or subtraction.
+  - pNumMatrices is a pointer to the integer that the number of matrices will be stored in.
+POSTCONDITION
+  - Prompts the user to enter the number of matrices to be added or subtracted.
+  - Valid input - Stores the desired number of matrices to add/subtract in the integer pointed to by
+    pNumMatrices and returns SUCCESS.
+  - Invalid input - Stores 0 in the variable pointed to by pNumMatrices and returns FAILURE.
+  - Valid input is a single integer >= 2.
+*/
+Status prompt_getNumMatrices(const char* operation, int* pNumMatrices);
+
+
+/*
+PRECONDITION
+  - hMatrix is a handle to a valid matrix object.
+  - pMemoryAllocation is a pointer to a status to check for memory allocation failure.
+POSTCONDITION
+  - Fills up the rows of the matrix by prompting the user for input, one line per row (see matrix_readText).
+  - Returns SUCCESS, else FAILURE for any invalid input or memory allocation failure.
+  - The status pointed to by pMemoryAllocationFailure is used to differentiate between the two situations.
+    If it is input failure, the variable pointed to by pMemoryAllocationFailure is set to SUCCESS.
+    If it is memory allocation failure, it is set to FAILURE.
+*/
+Status prompt_fillInput(MATRIX hMatrix, Status* pMemoryAllocation);
+
+
+/*
+PRECONDITION
+  - hMatrix is a handle to a valid matrix object.
+  - matrixNumber indicates the matrix for which numbers are being inputted (for example, the 4th matrix in a series
+    of 5 matrices being added). It is in range [0, ...).
+POSTCONDITION
+  - Prompts the user to enter values for the matrix based on the dimensions of the matrix.
+  - If matrixNumber is 0, it is ignored. If it is 1, 2... it will print "1st" matrix, "2nd" matrix etc.
+*/
+void prompt_fillPrompt(MATRIX hMatrix, int matrixNumber);
+
+
+#endif
@@ -0,0 +1,296 @@
+/*
+  Author: Benjamin G. Friedman
+  Date: 10/18/2026
+  File: Storage.c
+  Description:
+	  - Implementation file for the storage arrays of matrix objects. The array is either allocated on the heap
+		or mapped from a file so matrices larger than physical memory can be processed.
+*/
+
+
+#define _DEFAULT_SOURCE        // madvise and the MADV_* hints
+#include <stdlib.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "MatrixInternal.h"
+
+
+
+
+/***** Helper functions used only in this file *****/
+/*
+PRECONDITION
+  - pMatrix is a pointer to a valid matrix object.
+  - firstRow/endRow are the range [firstRow, endRow) of rows and are in bounds.
+  - pFirst/pEnd are pointers to the variables that receive the range of storage indices.
+POSTCONDITION
+  - If the rows are contiguous in the storage array (row-major and tiled layouts), stores the range of storage indices
+	holding them (including the padding of the tiles) and returns TRUE, else returns FALSE.
+*/
+static Boolean rowSpan(const Matrix* pMatrix, size_t firstRow, size_t endRow, size_t* pFirst, size_t* pEnd);
+
+
+/*
+PRECONDITION
+  - pMatrix is a pointer to a valid matrix object.
+  - first/end are the range [first, end) of storage indices.
+  - advice is one of the MADV_* hints.
+POSTCONDITION
+  - Gives the hint to the kernel for the whole pages in the range if the matrix is mapped from a file.
+*/
+static void adviseSpan(const Matrix* pMatrix, size_t first, size_t end, int advice);
+
+
+/*
+PRECONDITION
+  - fd is an open file descriptor of a file at least bytes long.
+POSTCONDITION
+  - Returns the file mapped for reading and writing, else NULL if it couldn't be mapped.
+*/
+static long double* mapFile(int fd, size_t bytes);
+
+
+
+
+/***** Functions defined in Matrix.h *****/
+MATRIX matrix_initMapped(const char* path, size_t rows, size_t columns, MatrixLayout layout) {
+	MATRIX hMatrix;
+	int fd;
+
+	if ((fd = open(path, O_RDWR | O_CREAT, 0644)) < 0)
+		return NULL;
+	if (!(hMatrix = matrix_initFromFd(fd, rows, columns, layout)))
+		close(fd);
+
+	return hMatrix;
+}
+
+
+
+MATRIX matrix_initFromFd(int fd, size_t rows, size_t columns, MatrixLayout layout) {
+	size_t matrixSize = storageSize(rows, columns, layout);
+	struct stat fileStatus;
+	Matrix* pMatrix;
+
+	// overflow - the size of the file must also fit in an off_t
+	if (matrixSize == 0 || matrixSize > (size_t)INTMAX_MAX / sizeof(long double))
+		return NULL;
+	size_t bytes = matrixSize * sizeof(long double);
+
+	// an empty file is extended with zeroes, a file of the right size is reused and anything else is left alone
+	if (fstat(fd, &fileStatus) || (fileStatus.st_size != 0 && (size_t)fileStatus.st_size != bytes)
+		|| (fileStatus.st_size == 0 && ftruncate(fd, (off_t)bytes)))
+		return NULL;
+
+	if (!(pMatrix = allocateMemory(sizeof(*pMatrix))))
+		return NULL;
+	if (!(pMatrix->matrix = mapFile(fd, bytes))) {
+		freeMemory(pMatrix);
+		return NULL;
+	}
+	pMatrix->rows = rows;
+	pMatrix->columns = columns;
+	pMatrix->layout = layout;
+	pMatrix->fd = fd;
+	pMatrix->mapping = pMatrix->matrix;
+	pMatrix->mappingBytes = bytes;
+	pMatrix->maxLength = 0;            // looking at every entry now would read the whole file in
+
+	return pMatrix;
+}
+
+
+
+Boolean matrix_isMapped(MATRIX hMatrix) {
+	Matrix* pMatrix = hMatrix;
+	return isMapped(pMatrix);
+}
+
+
+
+Status matrix_sync(MATRIX hMatrix) {
+	Matrix* pMatrix = hMatrix;
+
+	if (!isMapped(pMatrix))
+		return SUCCESS;
+
+	return msync(pMatrix->mapping, pMatrix->mappingBytes, MS_SYNC) ? FAILURE : SUCCESS;
+}
+
+
+
+
+/***** Helper functions shared with the other matrix implementation files - declared in MatrixInternal.h *****/
+long double* allocateStorage(size_t rows, size_t columns, MatrixLayout layout) {
+	size_t matrixSize = storageSize(rows, columns, layout);
+	TraceSpan span;
+
+	// overflow
+	if (matrixSize == 0)
+		return NULL;
+
+	beginSpan(&span, "allocate", rows, columns);
+	long double* storage;
+	// under a NUMA policy the array is zeroed where it's placed rather than by calloc
+	if (numaShares() > 1 && matrixSize <= SIZE_MAX / sizeof(*storage)) {
+		if ((storage = allocateMemory(matrixSize * sizeof(*storage))))
+			distributeMemory(storage, matrixSize * sizeof(*storage), TRUE);
+	}
+	else
+		storage = allocateZeroedMemory(matrixSize, sizeof(long double));
+	endSpan(&span);
+
+	return storage;
+}
+
+
+
+Status resizeStorage(Matrix* pMatrix, size_t rows, size_t columns, MatrixLayout layout) {
+	size_t matrixSize = storageSize(rows, columns, layout);
+	long double* matrix;
+
+	if (!isMapped(pMatrix)) {
+		// a matrix loaded from a file (see matrix_load) leaves its private mapping behind and moves to the heap
+		if (!(matrix = allocateStorage(rows, columns, layout)))
+			return FAILURE;
+		freeStorage(pMatrix);
+		pMatrix->mapping = NULL;
+		pMatrix->mappingBytes = 0;
+	}
+	else {
+		// the new mapping is made first so running out of address space leaves the matrix as it was
+		size_t oldBytes = pMatrix->mappingBytes;
+		if (matrixSize == 0 || matrixSize > (size_t)INTMAX_MAX / sizeof(*matrix))
+			return FAILURE;
+		size_t bytes = matrixSize * sizeof(*matrix);
+		if (!(matrix = mapFile(pMatrix->fd, bytes)))
+			return FAILURE;
+
+		// truncating the file to nothing first drops the old entries without writing zeroes to the disk
+		if (ftruncate(pMatrix->fd, 0) || ftruncate(pMatrix->fd, (off_t)bytes)) {
+			// the file is put back to the size of the old mapping so the matrix stays usable, but its entries may be zeroed
+			munmap(matrix, bytes);
+			(void)ftruncate(pMatrix->fd, (off_t)oldBytes);
+			pMatrix->maxLength = 1;
+			return FAILURE;
+		}
+		munmap(pMatrix->mapping, oldBytes);
+		pMatrix->mapping = matrix;
+		pMatrix->mappingBytes = bytes;
+	}
+
+	pMatrix->matrix = matrix;
+	pMatrix->rows = rows;
+	pMatrix->columns = columns;
+	pMatrix->layout = layout;
+	pMatrix->maxLength = 1;
+
+	return SUCCESS;
+}
+
+
+
+void freeStorage(Matrix* pMatrix) {
+	if (!pMatrix->mapping) {
+		freeMemory(pMatrix->matrix);
+		return;
+	}
+
+	munmap(pMatrix->mapping, pMatrix->mappingBytes);
+	if (isMapped(pMatrix))
+		close(pMatrix->fd);
+}
+
+
+
+void releaseSpan(const Matrix* pMatrix, size_t first, size_t end) {
+	adviseSpan(pMatrix, first, end, MADV_DONTNEED);
+}
+
+
+
+void releaseRows(const Matrix* pMatrix, size_t firstRow, size_t endRow) {
+	size_t first, end;
+
+	if (isMapped(pMatrix) && rowSpan(pMatrix, firstRow, endRow, &first, &end))
+		adviseSpan(pMatrix, first, end, MADV_DONTNEED);
+}
+
+
+
+void releaseColumns(const Matrix* pMatrix, size_t firstColumn, size_t endColumn) {
+	if (!isMapped(pMatrix))
+		return;
+
+	if (pMatrix->layout == MATRIX_COLUMN_MAJOR)
+		adviseSpan(pMatrix, firstColumn * pMatrix->rows, endColumn * pMatrix->rows, MADV_DONTNEED);
+	// the whole tiles holding the columns are contiguous within each row of tiles
+	else if (pMatrix->layout == MATRIX_TILED) {
+		size_t tileSize = MATRIX_TILE_SIZE * MATRIX_TILE_SIZE;
+		size_t tilesAcross = (pMatrix->columns + MATRIX_TILE_SIZE - 1) / MATRIX_TILE_SIZE;
+		size_t firstTile = (firstColumn + MATRIX_TILE_SIZE - 1) / MATRIX_TILE_SIZE;
+		size_t endTile = (endColumn == pMatrix->columns) ? tilesAcross : endColumn / MATRIX_TILE_SIZE;
+		for (size_t tileRow = 0; tileRow * MATRIX_TILE_SIZE < pMatrix->rows; ++tileRow) {
+			size_t rowStart = tileRow * tilesAcross * tileSize;
+			adviseSpan(pMatrix, rowStart + firstTile * tileSize, rowStart + endTile * tileSize, MADV_DONTNEED);
+		}
+	}
+}
+
+
+
+void prefetchRows(const Matrix* pMatrix, size_t firstRow, size_t endRow) {
+	size_t first, end;
+
+	if (isMapped(pMatrix) && rowSpan(pMatrix, firstRow, endRow, &first, &end))
+		adviseSpan(pMatrix, first, end, MADV_WILLNEED);
+}
+
+
+
+
+/***** Helper functions used only in this file *****/
+static Boolean rowSpan(const Matrix* pMatrix, size_t firstRow, size_t endRow, size_t* pFirst, size_t* pEnd) {
+	switch (pMatrix->layout) {
+	case MATRIX_ROW_MAJOR:
+		*pFirst = firstRow * pMatrix->columns;
+		*pEnd = endRow * pMatrix->columns;
+		return TRUE;
+	case MATRIX_TILED: {
+		// whole rows of tiles - the partial tile rows at either end are only partly covered by the range
+		size_t tileRowSize = (pMatrix->columns + MATRIX_TILE_SIZE - 1) / MATRIX_TILE_SIZE * MATRIX_TILE_SIZE * MATRIX_TILE_SIZE;
+		*pFirst = (firstRow + MATRIX_TILE_SIZE - 1) / MATRIX_TILE_SIZE * tileRowSize;
+		*pEnd = (endRow == pMatrix->rows) ? storageSize(pMatrix->rows, pMatrix->columns, MATRIX_TILED)
+			: endRow / MATRIX_TILE_SIZE * tileRowSize;
+		return *pFirst < *pEnd;
+	}
+	default:
+		return FALSE;
+	}
+}
+
+
+
+static void adviseSpan(const Matrix* pMatrix, size_t first, size_t end, int advice) {
+	if (!isMapped(pMatrix))
+		return;
+
+	// only whole pages inside the range, so the entries next to it that share a page aren't faulted in again
+	uintptr_t pageSize = (uintptr_t)sysconf(_SC_PAGESIZE);
+	uintptr_t start = (uintptr_t)(pMatrix->matrix + first);
+	uintptr_t stop = (uintptr_t)(pMatrix->matrix + end);
+	start = (start + pageSize - 1) / pageSize * pageSize;
+	stop = stop / pageSize * pageSize;
+	if (start < stop)
+		madvise((void*)start, stop - start, advice);
+}
+
+
+
+static long double* mapFile(int fd, size_t bytes) {
+	void* pMapping = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	return (pMapping == MAP_FAILED) ? NULL : pMapping;
+}